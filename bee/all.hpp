@@ -27,6 +27,7 @@
 #include "core/rooms.hpp"
 #include "core/window.hpp"
 
+#include "data/instancemap.hpp"
 #include "data/serialdata.hpp"
 #include "data/sidp.hpp"
 #include "data/statemachine.hpp"
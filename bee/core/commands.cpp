@@ -18,6 +18,8 @@
 
 #include "../messenger/messenger.hpp"
 
+#include "../data/instancemap.hpp"
+
 #include "../network/network.hpp"
 
 #include "../render/transition.hpp"
@@ -480,6 +482,33 @@ namespace bee{ namespace console {
 			}
 		);
 
+		/*
+		* console_compile_map "input" "output" - Compile the given instance map into the binary instance map format
+		* @"input": the path of the text instance map
+		* @"output": the path to save the binary instance map to
+		*/
+		add_command(
+			"compile_map",
+			"Compile the given instance map into the binary instance map format\n"
+			"Tile commands are expanded and !set blocks are kept as text",
+			[] (const MessageContents& msg) {
+				std::vector<SIDP> params = parse_parameters(msg.descr, true); // Parse the parameters from the given command
+
+				if (params.size() > 2) { // If both paths were provided, compile the map
+					InstanceMap map;
+					if (map.load(SIDP_s(params[1]))) {
+						messenger::send({"engine", "console"}, E_MESSAGE::WARNING, "Failed to load instance map \"" + SIDP_s(params[1]) + "\"");
+					} else if (map.save(SIDP_s(params[2]))) {
+						messenger::send({"engine", "console"}, E_MESSAGE::WARNING, "Failed to save instance map \"" + SIDP_s(params[2]) + "\"");
+					} else {
+						messenger::send({"engine", "console"}, E_MESSAGE::INFO, "Compiled " + bee_itos(map.get_amount()) + " instances");
+					}
+				} else { // If not enough arguments were provided, output a warning
+					messenger::send({"engine", "console"}, E_MESSAGE::WARNING, "Not enough arguments specified for compile_map");
+				}
+			}
+		);
+
 		/*
 		* console_netstatus - List information about the network session
 		*/
@@ -26,6 +26,7 @@
 
 #include "../data/sidp.hpp"
 #include "../data/serialdata.hpp"
+#include "../data/serialschema.hpp"
 
 #include "../render/drawing.hpp"
 
@@ -166,82 +167,180 @@ namespace bee {
 		return *this;
 	}
 
+	/*
+	* Instance::get_schema() - Return the schema of the instance record
+	*/
+	const SerialSchema& Instance::get_schema() {
+		static const SerialSchema schema ("Instance", {
+			{"id", E_DATA_TYPE::INT},
+			{"object", E_DATA_TYPE::STRING},
+			{"sprite", E_DATA_TYPE::STRING},
+			{"subimage_time", E_DATA_TYPE::INT},
+			{"body", &PhysicsBody::get_schema()},
+			{"is_solid", E_DATA_TYPE::CHAR},
+			{"depth", E_DATA_TYPE::INT},
+			{"pos_start", E_DATA_TYPE::VECTOR, E_DATA_TYPE::DOUBLE},
+			{"pos_previous", E_DATA_TYPE::VECTOR, E_DATA_TYPE::DOUBLE},
+			{"path", E_DATA_TYPE::STRING},
+			{"path_speed", E_DATA_TYPE::DOUBLE},
+			{"path_end_action", E_DATA_TYPE::INT},
+			{"path_current_node", E_DATA_TYPE::INT},
+			{"path_is_drawn", E_DATA_TYPE::CHAR},
+			{"path_is_pausable", E_DATA_TYPE::CHAR},
+			{"path_previous_mass", E_DATA_TYPE::DOUBLE},
+			{"path_pos_start", E_DATA_TYPE::VECTOR, E_DATA_TYPE::DOUBLE},
+			{"data", E_DATA_TYPE::MAP, E_DATA_TYPE::SIDP}
+		});
+		return schema;
+	}
+
 	std::string Instance::serialize(bool should_pretty_print) const {
-		std::map<std::string,SIDP> instance_info;
-		instance_info["id"] = id;
-		instance_info["object"] = object->get_name();
-		instance_info["sprite"] = "";
-		if (get_sprite() != nullptr) {
-			instance_info["sprite"] = get_sprite()->get_name();
+		SerialData sd (512, true);
+		serialize(&sd);
+		return get_schema().to_text(sd.get(), should_pretty_print);
+	}
+	std::string Instance::serialize() const {
+		return serialize(false);
+	}
+	/*
+	* Instance::serialize() - Append the instance record, including its physics body and data map, to the given compact data
+	* @sd: the data to store in
+	*/
+	int Instance::serialize(SerialData* sd) const {
+		if ((!sd->get_is_writing())||(!sd->get_is_compact())||(body == nullptr)) {
+			return 1; // Return 1 when the data can't be written to
+		}
+
+		get_schema().store_header(sd);
+
+		int i = id;
+		std::string object_name = object->get_name();
+		std::string sprite_name = (sprite != nullptr) ? sprite->get_name() : "";
+		int s = subimage_time;
+		sd->store_int(i);
+		sd->store_string(object_name);
+		sd->store_string(sprite_name);
+		sd->store_int(s);
+
+		body->serialize(sd);
+
+		unsigned char solid = is_solid;
+		int d = depth;
+		std::vector<double> start = {pos_start.x(), pos_start.y(), pos_start.z()};
+		std::vector<double> previous = {pos_previous.x(), pos_previous.y(), pos_previous.z()};
+		sd->store_char(solid);
+		sd->store_int(d);
+		sd->store_vector(start);
+		sd->store_vector(previous);
+
+		std::string path_name = (path != nullptr) ? path->get_name() : "";
+		double speed = path_speed;
+		int end_action = static_cast<int>(path_end_action);
+		int node = path_current_node;
+		unsigned char is_drawn = path_is_drawn;
+		unsigned char is_pausable = path_is_pausable;
+		double previous_mass = path_previous_mass;
+		std::vector<double> path_start = {path_pos_start.x(), path_pos_start.y(), path_pos_start.z()};
+		sd->store_string(path_name);
+		sd->store_double(speed);
+		sd->store_int(end_action);
+		sd->store_int(node);
+		sd->store_char(is_drawn);
+		sd->store_char(is_pausable);
+		sd->store_double(previous_mass);
+		sd->store_vector(path_start);
+
+		std::map<std::string,SIDP> m = data.get_map();
+		sd->store_map(m);
+
+		return 0; // Return 0 on success
+	}
+	/*
+	* Instance::deserialize() - Replace the instance state with the next record in the given compact data
+	* ! Resource names, vectors, and the body record are read into reused buffers so that only the data map allocates
+	* ! The body record is only applied once every field has been read successfully
+	* @sd: the data to read from
+	* @_object: the object to use instead of the stored one, or nullptr to look it up by name
+	*/
+	int Instance::deserialize(SerialData* sd, Object* _object) {
+		if ((sd->get_is_writing())||(!sd->get_is_compact())||(body == nullptr)) {
+			return 1; // Return 1 when the data can't be read from
+		}
+		if (get_schema().store_header(sd)) {
+			return 2; // Return 2 when the record has a different layout
 		}
-		instance_info["subimage_time"] = static_cast<int>(subimage_time);
 
-		std::string b = body->serialize(should_pretty_print);
-		if (should_pretty_print) {
-			b = debug_indent(b, 1);
+		thread_local std::string names[3]; // The object, sprite, and path names
+		thread_local std::vector<double> vectors[3]; // The start, previous, and path start positions
+		int i = 0, s = 0, d = 0;
+		int end_action = 0, node = 0;
+		unsigned char solid = 0, is_drawn = 0, is_pausable = 0;
+		double speed = 0.0, previous_mass = 0.0;
+		thread_local PhysicsBodyState body_state;
+		std::map<std::string,SIDP> m;
+
+		bool is_valid = (
+			(!sd->store_int(i))
+			&&(!sd->store_string(names[0]))
+			&&(!sd->store_string(names[1]))
+			&&(!sd->store_int(s))
+			&&(!body->read(sd, &body_state))
+			&&(!sd->store_char(solid))
+			&&(!sd->store_int(d))
+			&&(!sd->store_vector(vectors[0]))
+			&&(!sd->store_vector(vectors[1]))
+			&&(!sd->store_string(names[2]))
+			&&(!sd->store_double(speed))
+			&&(!sd->store_int(end_action))
+			&&(!sd->store_int(node))
+			&&(!sd->store_char(is_drawn))
+			&&(!sd->store_char(is_pausable))
+			&&(!sd->store_double(previous_mass))
+			&&(!sd->store_vector(vectors[2]))
+			&&(!sd->store_map(m))
+		);
+		for (auto& v : vectors) {
+			is_valid = is_valid && (v.size() == 3);
+		}
+		if (!is_valid) {
+			messenger::send({"engine", "instance"}, E_MESSAGE::WARNING, "Failed to deserialize instance");
+			return 3; // Return 3 when the record is invalid
 		}
-		instance_info["body"] = b;
 
-		instance_info["is_solid"] = is_solid;
-		instance_info["depth"] = depth;
-		instance_info["pos_start"].vector(new std::vector<SIDP>({pos_start.x(), pos_start.y(), pos_start.z()}));
-		instance_info["pos_previous"].vector(new std::vector<SIDP>({pos_previous.x(), pos_previous.y(), pos_previous.z()}));
+		body->apply(body_state, this);
 
-		instance_info["path"] = "";
-		if (path != nullptr) {
-			instance_info["path"] = path->get_name();
+		id = i;
+		object = (_object != nullptr) ? _object : get_object_by_name(names[0]);
+		sprite = get_texture_by_name(names[1]);
+		subimage_time = s;
+		is_solid = solid;
+		depth = d;
+		pos_start = btVector3(btScalar(vectors[0][0]), btScalar(vectors[0][1]), btScalar(vectors[0][2]));
+		pos_previous = btVector3(btScalar(vectors[1][0]), btScalar(vectors[1][1]), btScalar(vectors[1][2]));
+
+		path = get_path_by_name(names[2]);
+		path_speed = speed;
+		path_end_action = static_cast<E_PATH_END>(end_action);
+		path_current_node = node;
+		path_is_drawn = is_drawn;
+		path_is_pausable = is_pausable;
+		path_previous_mass = previous_mass;
+		path_pos_start = btVector3(btScalar(vectors[2][0]), btScalar(vectors[2][1]), btScalar(vectors[2][2]));
+
+		data.set_map(m);
+
+		if (get_current_room() != nullptr) {
+			get_current_room()->update_instance_grid(this);
 		}
-		instance_info["path_speed"] = path_speed;
-		instance_info["path_end_action"] = static_cast<int>(path_end_action);
-		instance_info["path_current_node"] = path_current_node;
-		instance_info["path_is_drawn"] = path_is_drawn;
-		instance_info["path_is_pausable"] = path_is_pausable;
-		instance_info["path_previous_mass"] = path_previous_mass;
-		instance_info["path_pos_start"].vector(new std::vector<SIDP>({path_pos_start.x(), path_pos_start.y(), path_pos_start.z()}));
 
-		return map_serialize(instance_info, should_pretty_print);
-	}
-	std::string Instance::serialize() const {
-		return serialize(false);
+		return 0; // Return 0 on success
 	}
 	int Instance::deserialize(std::map<SIDP,SIDP>& m, Object* _object) {
-		id = SIDP_i(m["id"]);
-		if (_object != nullptr) {
-			object = _object;
-		} else {
-			object = get_object_by_name(SIDP_s(m["object"]));
-		}
-		sprite = get_texture_by_name(SIDP_s(m["sprite"]));
-
-		subimage_time = SIDP_i(m["subimage_time"]);
-		body->deserialize(SIDP_m(m["body"]), this);
-		is_solid = SIDP_i(m["is_solid"]);
-		depth = SIDP_i(m["depth"]);
-		pos_start = btVector3(
-			btScalar(SIDP_cd(m["pos_start"], 0)),
-			btScalar(SIDP_cd(m["pos_start"], 1)),
-			btScalar(SIDP_cd(m["pos_start"], 2))
-		);
-		pos_previous = btVector3(
-			btScalar(SIDP_cd(m["pos_previous"], 0)),
-			btScalar(SIDP_cd(m["pos_previous"], 1)),
-			btScalar(SIDP_cd(m["pos_previous"], 2))
-		);
+		SerialData sd (512, true);
+		get_schema().store(&sd, &m);
 
-		path = get_path_by_name(SIDP_s(m["path"]));
-		path_speed = SIDP_d(m["path_speed"]);
-		path_end_action = static_cast<E_PATH_END>(SIDP_i(m["path_end_action"]));
-		path_current_node = SIDP_i(m["path_current_node"]);
-		path_is_drawn = SIDP_i(m["path_is_drawn"]);
-		path_is_pausable = SIDP_i(m["path_is_pausable"]);
-		path_previous_mass = SIDP_d(m["path_previous_mass"]);
-		path_pos_start = btVector3(
-			btScalar(SIDP_cd(m["path_pos_start"], 0)),
-			btScalar(SIDP_cd(m["path_pos_start"], 1)),
-			btScalar(SIDP_cd(m["path_pos_start"], 2))
-		);
-
-		return 0;
+		SerialData record (sd.get());
+		return deserialize(&record, _object);
 	}
 	int Instance::deserialize(const std::string& instance_info, Object* _object) {
 		std::map<SIDP,SIDP> m;
@@ -257,7 +356,7 @@ namespace bee {
 	}
 
 	std::vector<Uint8> Instance::serialize_net() {
-		SerialData sd (256);
+		SerialData sd (256, true);
 
 		std::string sprite_name = get_sprite()->get_name();
 		sd.store_string(sprite_name);
@@ -289,6 +388,9 @@ namespace bee {
 		std::vector<Uint8> body_data;
 		sd.store_serial_v(body_data);
 		body->deserialize_net(body_data);
+		if (get_current_room() != nullptr) {
+			get_current_room()->update_instance_grid(this);
+		}
 
 		std::vector<double> ppos;
 		sd.store_vector(ppos);
@@ -313,16 +415,27 @@ namespace bee {
 	}
 
 	int Instance::set_object(Object* _object) {
-		object->remove_instance(id);
+		if (object != nullptr) { // Default constructed instances don't have an object yet
+			object->remove_instance(id);
+		}
 
 		object = _object;
 		object->add_instance(id, this);
 		data["object"] = object->get_name();
 
+		if (get_current_room() != nullptr) {
+			get_current_room()->update_instance_grid(this); // Update the collision grid since the mask might have changed
+		}
+
 		return 0;
 	}
 	int Instance::set_sprite(Texture* _sprite) {
 		sprite = _sprite;
+
+		if (get_current_room() != nullptr) {
+			get_current_room()->update_instance_grid(this);
+		}
+
 		return 0;
 	}
 	int Instance::add_physbody() {
@@ -360,31 +473,52 @@ namespace bee {
 	/*
 	* Instance::get_data() - Return a reference to the data map
 	*/
-	std::map<std::string,SIDP>& Instance::get_data() {
+	DataMap& Instance::get_data() {
 		return data;
 	}
 	/*
 	* Instance::get_data() - Return the requested data field from the data map
+	* @field: the key id of the field to fetch, see DataMap::get_key()
+	* @default_value: the value to return if the field doesn't exist
+	* @should_output: whether a warning should be output if the field doesn't exist
+	*/
+	const SIDP& Instance::get_data(Uint32 field, const SIDP& default_value, bool should_output) const {
+		const SIDP* value = data.find(field);
+		if (value == nullptr) { // If the data field doesn't exist, output a warning and return the default value
+			if (should_output) {
+				messenger::send({"engine", "resource"}, E_MESSAGE::WARNING, "Failed to get the data field \"" + DataMap::get_key_name(field) + "\" from the instance of object \"" + get_object()->get_name() + "\", returning SIDP(0)");
+			}
+			return default_value;
+		}
+
+		return *value; // Return the data field value on success
+	}
+	/*
+	* Instance::get_data() - Return the requested data field from the data map
 	* @field: the name of the field to fetch
 	* @default_value: the value to return if the field doesn't exist
 	* @should_output: whether a warning should be output if the field doesn't exist
 	*/
 	const SIDP& Instance::get_data(const std::string& field, const SIDP& default_value, bool should_output) const {
-		if (data.find(field) == data.end()) { // If the data field doesn't exist, output a warning and return the default value
+		const SIDP* value = data.find(field);
+		if (value == nullptr) { // If the data field doesn't exist, output a warning and return the default value
 			if (should_output) {
 				messenger::send({"engine", "resource"}, E_MESSAGE::WARNING, "Failed to get the data field \"" + field + "\" from the instance of object \"" + get_object()->get_name() + "\", returning SIDP(0)");
 			}
 			return default_value;
 		}
 
-		return data.at(field); // Return the data field value on success
+		return *value; // Return the data field value on success
 	}
 	/*
 	* Instance::get_data() - Return the requested data field from the data map
 	* ! When the function is called without a default value, simply call it with a default value of 0 and with warning output enabled
 	* ! This function cannot return a const reference because the default value would be out of scope
-	* @field: the name of the field to fetch
+	* @field: the key id or name of the field to fetch
 	*/
+	SIDP Instance::get_data(Uint32 field) const {
+		return get_data(field, 0, true);
+	}
 	SIDP Instance::get_data(const std::string& field) const {
 		return get_data(field, 0, true);
 	}
@@ -393,14 +527,18 @@ namespace bee {
 	* @_data: the new data map to use
 	*/
 	int Instance::set_data(const std::map<std::string,SIDP>& _data) {
-		data = _data;
+		data.set_map(_data);
 		return 0;
 	}
 	/*
 	* Instance::set_data() - Set the requested data field
-	* @field: the name of the field to set
+	* @field: the key id or name of the field to set
 	* @value: the value to set the field to
 	*/
+	int Instance::set_data(Uint32 field, const SIDP& value) {
+		data[field] = value;
+		return 0;
+	}
 	int Instance::set_data(const std::string& field, const SIDP& value) {
 		data[field] = value;
 		return 0;
@@ -487,6 +625,10 @@ namespace bee {
 
 		body->get_body()->setCenterOfMassTransform(t);
 
+		if (get_current_room() != nullptr) {
+			get_current_room()->update_instance_grid(this);
+		}
+
 		return 0;
 	}
 	int Instance::set_position(double x, double y, double z) {
@@ -685,22 +827,28 @@ namespace bee {
 		return body->get_body()->getGravity();
 	}
 
+	/*
+	* Instance::is_place_free() - Return whether the given position is free of solid instances which would collide with this instance
+	* ! Only the instances in the nearby cells of the room's collision grid are checked
+	* @x: the x-coordinate of the mask's corner to check
+	* @y: the y-coordinate of the mask's corner to check
+	*/
 	bool Instance::is_place_free(int x, int y) const {
 		SDL_Rect mask = get_aabb();
 		mask.x = x;
 		mask.y = y;
 
-		for (auto& i : get_current_room()->get_instances()) {
-			if (i.second == this) {
+		for (auto& i : get_current_room()->get_instances_near(mask)) {
+			if (i == this) {
 				continue;
 			}
 
-			SDL_Rect other = i.second->get_aabb();
+			SDL_Rect other = i->get_aabb();
 
-			if (i.second->object->get_is_solid()) {
+			if (i->object->get_is_solid()) {
 				if (check_collision(mask, other)) {
-					if (object->check_collision_filter(this, i.second)) {
-						if (i.second->object->check_collision_filter(i.second, this)) {
+					if (object->check_collision_filter(this, i)) {
+						if (i->object->check_collision_filter(i, this)) {
 							return false;
 						}
 					}
@@ -710,17 +858,22 @@ namespace bee {
 
 		return true;
 	}
+	/*
+	* Instance::is_place_empty() - Return whether the given position is free of all other instances
+	* @x: the x-coordinate of the mask's corner to check
+	* @y: the y-coordinate of the mask's corner to check
+	*/
 	bool Instance::is_place_empty(int x, int y) const {
 		SDL_Rect mask = get_aabb();
 		mask.x = x;
 		mask.y = y;
 
-		for (auto& i : get_current_room()->get_instances()) {
-			if (i.second == this) {
+		for (auto& i : get_current_room()->get_instances_near(mask)) {
+			if (i == this) {
 				continue;
 			}
 
-			SDL_Rect other = i.second->get_aabb();
+			SDL_Rect other = i->get_aabb();
 
 			if (check_collision(mask, other)) {
 				return false;
@@ -729,17 +882,23 @@ namespace bee {
 
 		return true;
 	}
+	/*
+	* Instance::is_place_meeting() - Return whether the given position would collide with an instance of the given object
+	* @x: the x-coordinate of the mask's corner to check
+	* @y: the y-coordinate of the mask's corner to check
+	* @other: the object to check for
+	*/
 	bool Instance::is_place_meeting(int x, int y, Object* other) const {
 		SDL_Rect mask = get_aabb();
 		mask.x = x;
 		mask.y = y;
 
-		for (auto& i : other->get_instances()) {
-			if (i.second == this) {
+		for (auto& i : get_current_room()->get_instances_near(mask)) {
+			if ((i == this)||(i->object != other)) {
 				continue;
 			}
 
-			SDL_Rect other_rect = i.second->get_aabb();
+			SDL_Rect other_rect = i->get_aabb();
 
 			if (check_collision(mask, other_rect)) {
 				return true;
@@ -758,16 +917,16 @@ namespace bee {
 
 		bool r = false;
 
-		for (auto& i : other->get_instances()) {
-			if (i.second == this) {
+		for (auto& i : get_current_room()->get_instances_near(mask)) {
+			if ((i == this)||(i->object != other)) {
 				continue;
 			}
 
-			SDL_Rect other_rect = i.second->get_aabb();
+			SDL_Rect other_rect = i->get_aabb();
 
 			if (check_collision(mask, other_rect)) {
 				r = true;
-				func(this, i.second);
+				func(this, i);
 			}
 		}
 
@@ -19,6 +19,7 @@
 #include "../enum.hpp"
 
 #include "../data/sidp.hpp"
+#include "../data/datamap.hpp"
 
 #include "../render/rgba.hpp"
 
@@ -29,6 +30,8 @@ namespace bee {
 	class Texture;
 	class Object;
 	class PhysicsBody;
+	class SerialData;
+	class SerialSchema;
 
 	class Instance {
 			btVector3 pos_start;
@@ -49,7 +52,7 @@ namespace bee {
 			bool path_is_pausable;
 			double path_previous_mass;
 
-			std::map<std::string,SIDP> data;
+			DataMap data;
 		public:
 			int id;
 			Uint32 subimage_time;
@@ -69,8 +72,12 @@ namespace bee {
 			bool operator<(const Instance&) const;
 			Instance& operator=(const Instance&);
 
+			static const SerialSchema& get_schema();
+
 			std::string serialize(bool) const;
 			std::string serialize() const;
+			int serialize(SerialData*) const;
+			int deserialize(SerialData*, Object*);
 			int deserialize(std::map<SIDP,SIDP>&, Object*);
 			int deserialize(const std::string&, Object*);
 			int deserialize(const std::string&);
@@ -88,10 +95,13 @@ namespace bee {
 			int set_computation_type(E_COMPUTATION);
 			int set_is_persistent(bool);
 
-			std::map<std::string,SIDP>& get_data();
+			DataMap& get_data();
+			const SIDP& get_data(Uint32, const SIDP&, bool) const;
 			const SIDP& get_data(const std::string&, const SIDP&, bool) const;
+			SIDP get_data(Uint32) const;
 			SIDP get_data(const std::string&) const;
 			int set_data(const std::map<std::string,SIDP>&);
+			int set_data(Uint32, const SIDP&);
 			int set_data(const std::string&, const SIDP&);
 
 			btVector3 get_position() const;
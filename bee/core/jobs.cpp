@@ -0,0 +1,213 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef BEE_CORE_JOBS
+#define BEE_CORE_JOBS 1
+
+#include <vector> // Include the required library headers
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <algorithm>
+
+#include "jobs.hpp"
+
+namespace bee { namespace jobs {
+	namespace internal {
+		struct JobQueue { // The queue of index ranges which belongs to a single thread, other threads steal from the back when theirs is empty
+			std::deque<std::pair<size_t,size_t>> ranges;
+			std::mutex mutex;
+		};
+
+		std::vector<std::thread> workers;
+		std::vector<std::unique_ptr<JobQueue>> queues; // The queue for each thread, where the first queue belongs to the calling thread
+
+		std::function<void (size_t, size_t)> job; // The function of the current job
+		std::atomic<size_t> job_remaining (0); // The amount of ranges which haven't finished running
+		std::atomic<bool> is_running (false); // Whether a job is currently running
+		size_t job_generation = 0; // The amount of jobs that have been started, used to wake the workers
+		bool should_quit = false;
+
+		std::mutex state_mutex;
+		std::condition_variable job_start;
+		std::condition_variable job_done;
+	}
+
+	/*
+	* internal::init() - Start the given amount of worker threads
+	* @amount: the amount of worker threads, not including the calling thread
+	*/
+	int internal::init(size_t amount) {
+		if (!workers.empty()) {
+			return 1; // Return 1 when the workers have already been started
+		}
+
+		should_quit = false;
+		queues.clear();
+		for (size_t i=0; i<amount+1; ++i) {
+			queues.emplace_back(new JobQueue());
+		}
+		for (size_t i=0; i<amount; ++i) {
+			workers.emplace_back(worker_main, i+1);
+		}
+
+		return 0;
+	}
+	/*
+	* internal::close() - Stop and join all of the worker threads
+	*/
+	int internal::close() {
+		{
+			std::lock_guard<std::mutex> lock (state_mutex);
+			should_quit = true;
+		}
+		job_start.notify_all();
+
+		for (auto& w : workers) {
+			w.join();
+		}
+		workers.clear();
+		queues.clear();
+
+		return 0;
+	}
+
+	/*
+	* internal::take_range() - Take the next range from the given queue, or steal one from another queue when it's empty
+	* @queue: the queue of the calling thread
+	* @range: the pointer to store the range in
+	*/
+	bool internal::take_range(size_t queue, std::pair<size_t,size_t>* range) {
+		{
+			std::lock_guard<std::mutex> lock (queues[queue]->mutex);
+			if (!queues[queue]->ranges.empty()) {
+				*range = queues[queue]->ranges.front();
+				queues[queue]->ranges.pop_front();
+				return true;
+			}
+		}
+
+		// Steal from the back of the other queues since their owners take from the front
+		for (size_t i=1; i<queues.size(); ++i) {
+			JobQueue* q = queues[(queue+i) % queues.size()].get();
+			std::lock_guard<std::mutex> lock (q->mutex);
+			if (!q->ranges.empty()) {
+				*range = q->ranges.back();
+				q->ranges.pop_back();
+				return true;
+			}
+		}
+
+		return false;
+	}
+	/*
+	* internal::run_ranges() - Run the current job for every range that can be taken
+	* @queue: the queue of the calling thread
+	*/
+	int internal::run_ranges(size_t queue) {
+		std::pair<size_t,size_t> range;
+		while (take_range(queue, &range)) {
+			job(range.first, range.second);
+
+			if (--job_remaining == 0) {
+				std::lock_guard<std::mutex> lock (state_mutex);
+				job_done.notify_all();
+			}
+		}
+		return 0;
+	}
+	/*
+	* internal::worker_main() - Wait for jobs and run them until the pool is closed
+	* @queue: the queue of the worker
+	*/
+	void internal::worker_main(size_t queue) {
+		size_t generation = 0;
+		while (true) {
+			{
+				std::unique_lock<std::mutex> lock (state_mutex);
+				job_start.wait(lock, [&generation] () {
+					return ((should_quit)||(job_generation != generation));
+				});
+				if (should_quit) {
+					return;
+				}
+				generation = job_generation;
+			}
+
+			run_ranges(queue);
+		}
+	}
+
+	/*
+	* get_worker_amount() - Return the amount of worker threads
+	*/
+	size_t get_worker_amount() {
+		return internal::workers.size();
+	}
+	/*
+	* get_is_running() - Return whether a job is currently running
+	*/
+	bool get_is_running() {
+		return internal::is_running;
+	}
+
+	/*
+	* parallel_for() - Call the given function for ranges of indices across the worker threads and wait for all of them to finish
+	* ! The calling thread also runs ranges while it waits
+	* ! When there are no workers or a job is already running, the function is called once for the entire range on the calling thread
+	* @amount: the amount of indices to run
+	* @func: the function to call with the beginning and end of each range
+	*/
+	int parallel_for(size_t amount, const std::function<void (size_t, size_t)>& func) {
+		if (amount == 0) {
+			return 0;
+		}
+
+		bool expected = false;
+		if ((internal::workers.empty())||(!internal::is_running.compare_exchange_strong(expected, true))) {
+			func(0, amount);
+			return 0;
+		}
+
+		// Split the indices into several ranges per thread so that threads which finish early can steal from the others
+		const size_t grain = std::max<size_t>(1, amount / (internal::queues.size()*4));
+		const size_t range_amount = (amount + grain - 1) / grain;
+
+		internal::job = func;
+		internal::job_remaining = range_amount;
+		for (size_t i=0; i<range_amount; ++i) {
+			internal::JobQueue* q = internal::queues[i % internal::queues.size()].get();
+			std::lock_guard<std::mutex> lock (q->mutex);
+			q->ranges.emplace_back(i*grain, std::min(amount, (i+1)*grain));
+		}
+
+		{
+			std::lock_guard<std::mutex> lock (internal::state_mutex);
+			++internal::job_generation;
+		}
+		internal::job_start.notify_all();
+
+		internal::run_ranges(0);
+
+		{
+			std::unique_lock<std::mutex> lock (internal::state_mutex);
+			internal::job_done.wait(lock, [] () {
+				return (internal::job_remaining == 0);
+			});
+		}
+
+		internal::is_running = false;
+
+		return 0;
+	}
+}}
+
+#endif // BEE_CORE_JOBS
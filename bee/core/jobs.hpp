@@ -0,0 +1,30 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef BEE_CORE_JOBS_H
+#define BEE_CORE_JOBS_H 1
+
+#include <functional>
+
+namespace bee { namespace jobs {
+	namespace internal {
+		int init(size_t);
+		int close();
+
+		bool take_range(size_t, std::pair<size_t,size_t>*);
+		int run_ranges(size_t);
+		void worker_main(size_t);
+	}
+
+	size_t get_worker_amount();
+	bool get_is_running();
+
+	int parallel_for(size_t, const std::function<void (size_t, size_t)>&);
+}}
+
+#endif // BEE_CORE_JOBS_H
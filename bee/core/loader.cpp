@@ -9,11 +9,19 @@
 #ifndef BEE_CORE_LOADER
 #define BEE_CORE_LOADER 1
 
+#include "../defines.hpp"
+
 #include <vector>
 #include <memory>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <unordered_set>
 
 #include "loader.hpp"
 
+#include "../engine.hpp"
+
 #include "../util/platform.hpp"
 
 #include "../messenger/messenger.hpp"
@@ -22,8 +30,16 @@
 
 namespace bee { namespace loader {
 	namespace internal {
+		const int decode_pending = -1; // The decode result of resources which haven't been decoded yet
+
 		std::vector<Resource*> resources;
-		std::vector<Resource*>::iterator next_resource = resources.end();
+		size_t next_resource = 0; // The index of the next resource to finalize on the main thread
+
+		std::vector<Resource*> decode_list; // The snapshot of the queue which the decode threads work through, so that queue() can't move it
+		std::unique_ptr<std::atomic<int>[]> decode_results; // The return value of decode() for each resource in the snapshot
+		std::atomic<size_t> next_decode (0); // The index of the next resource for a decode thread to claim
+		std::atomic<size_t> amount_decoded (0);
+		std::vector<std::thread> decode_threads;
 
 		size_t amount_loaded = 0;
 		size_t total_amount = 0;
@@ -33,31 +49,136 @@ namespace bee { namespace loader {
 	}
 
 	/*
-	* internal::load_next() - Load the next resource and update the queue
+	* internal::decode_start() - Snapshot the queue and start the decode threads
+	* ! Dedicated threads are used instead of the job pool because jobs::parallel_for() blocks until the whole range is done
+	*/
+	int internal::decode_start() {
+		decode_stop();
+
+		// Only decode each resource once so that two threads never decode the same one at the same time
+		decode_list.clear();
+		std::unordered_set<Resource*> queued;
+		for (auto& res : resources) {
+			if (queued.insert(res).second) {
+				decode_list.push_back(res);
+			}
+		}
+
+		decode_results.reset(new std::atomic<int>[decode_list.size()]);
+		for (size_t i=0; i<decode_list.size(); ++i) {
+			decode_results[i].store(decode_pending, std::memory_order_relaxed);
+		}
+		next_decode.store(0);
+		amount_decoded.store(0);
+
+		size_t thread_amount = std::thread::hardware_concurrency();
+		if (thread_amount > 1) { // Leave a core for the main thread
+			--thread_amount;
+		}
+		thread_amount = std::max<size_t>(1, std::min(thread_amount, decode_list.size()));
+		if (decode_list.empty()) {
+			thread_amount = 0;
+		}
+
+		for (size_t i=0; i<thread_amount; ++i) {
+			decode_threads.emplace_back(decode_main);
+		}
+
+		return 0;
+	}
+	/*
+	* internal::decode_stop() - Stop claiming new resources and wait for the decode threads to finish their current ones
+	*/
+	int internal::decode_stop() {
+		next_decode.store(decode_list.size()); // Mark every remaining resource as claimed
+
+		for (auto& t : decode_threads) {
+			t.join();
+		}
+		decode_threads.clear();
+
+		return 0;
+	}
+	/*
+	* internal::decode_next() - Claim and decode the next resource in the snapshot
+	* ! This can be called from any thread
+	*/
+	int internal::decode_next() {
+		const size_t i = next_decode.fetch_add(1);
+		if (i >= decode_list.size()) {
+			return 1; // Return 1 when every resource has been claimed
+		}
+
+		const int r = decode_list[i]->decode();
+		decode_results[i].store(r, std::memory_order_release);
+		amount_decoded.fetch_add(1);
+
+		return 0; // Return 0 on success
+	}
+	/*
+	* internal::decode_main() - Decode resources until every one has been claimed
+	*/
+	void internal::decode_main() {
+		while (decode_next() == 0) {}
+	}
+	/*
+	* internal::get_is_decoded() - Return whether the given resource has finished decoding
+	* @index: the index of the resource in the snapshot
+	*/
+	bool internal::get_is_decoded(size_t index) {
+		return (decode_results[index].load(std::memory_order_acquire) != decode_pending);
+	}
+
+	/*
+	* internal::load_next() - Finalize the next resource and update the queue
+	* ! If the resource is still being decoded, the main thread helps decode the rest of the queue while it waits
 	*/
 	int internal::load_next() {
-		if (next_resource == resources.end()) {
-			return 1;
+		if (next_resource >= decode_list.size()) {
+			return 1; // Return 1 when the queue is finished
+		}
+
+		while (!get_is_decoded(next_resource)) {
+			if (decode_next() != 0) { // If there's nothing left to claim, wait for the decode threads
+				std::this_thread::yield();
+			}
 		}
 
-		messenger::send({"engine", "loader"}, E_MESSAGE::INTERNAL, "Loading resource \"" + (*next_resource)->get_name() + "\"...");
+		Resource* res = decode_list[next_resource];
+		messenger::send({"engine", "loader"}, E_MESSAGE::INTERNAL, "Loading resource \"" + res->get_name() + "\"...");
 
-		(*next_resource)->load();
+		if (decode_results[next_resource].load(std::memory_order_acquire) < 2) { // Skip resources which failed to decode since they have already output a warning
+			res->load();
+		}
 		++next_resource;
 		amount_loaded++;
 
-		return 0;
+		return 0; // Return 0 on success
 	}
 	/*
-	* internal::load_lazy() - Lazily load the next amount of resources from the queue
+	* internal::load_lazy() - Finalize the next amount of decoded resources from the queue within the frame budget
+	* ! Resources are finalized in queue order, so the frame ends early when the next one is still being decoded
 	*/
 	int internal::load_lazy() {
-		for (size_t i=0; i<lazy_amount; ++i) {
+		const Uint32 t = get_ticks();
+		for (size_t i=0; (lazy_amount == 0)||(i<lazy_amount); ++i) {
+			if (next_resource >= decode_list.size()) {
+				break;
+			}
+			if (!get_is_decoded(next_resource)) {
+				break;
+			}
+			if (get_ticks() - t >= BEE_LOADER_FRAME_BUDGET) {
+				break;
+			}
+
 			load_next();
 		}
 
-		if (next_resource != resources.end()) {
-			messenger::send({"engine", "loader", "lazysignal"}, E_MESSAGE::INTERNAL, "Lazily loading the next " + bee_itos(lazy_amount) + " resources");
+		if (next_resource < decode_list.size()) {
+			messenger::send({"engine", "loader", "lazysignal"}, E_MESSAGE::INTERNAL, "Lazily loading the next " + ((lazy_amount > 0) ? bee_itos(lazy_amount) + " " : "") + "resources");
+		} else {
+			decode_stop();
 		}
 
 		return 0;
@@ -74,10 +195,15 @@ namespace bee { namespace loader {
 	}
 	/*
 	* clear() - Clear the queue
+	* ! Resources which are already being decoded are finished before returning
 	*/
 	int clear() {
+		internal::decode_stop();
+
 		internal::resources.clear();
-		internal::next_resource = internal::resources.end();
+		internal::decode_list.clear();
+		internal::decode_results.reset();
+		internal::next_resource = 0;
 
 		internal::amount_loaded = 0;
 		internal::total_amount = 0;
@@ -90,18 +216,21 @@ namespace bee { namespace loader {
 	*/
 	int load() {
 		internal::amount_loaded = 0;
-		internal::total_amount = internal::resources.size();
-		internal::next_resource = internal::resources.begin();
+		internal::next_resource = 0;
 
-		while (internal::next_resource != internal::resources.end()) {
-			internal::load_next();
-		}
+		internal::decode_start();
+		internal::total_amount = internal::decode_list.size();
+
+		while (internal::load_next() == 0) {}
+
+		internal::decode_stop();
 
 		return 0;
 	}
 	/*
 	* load_lazy() - Load the given number of resources per frame from the queue
-	* @amount: the amount to load per frame
+	* ! The resources are decoded in the background and at most the given amount are finalized each frame within BEE_LOADER_FRAME_BUDGET
+	* @amount: the amount to load per frame, or 0 to only be limited by the frame budget
 	*/
 	int load_lazy(int amount) {
 		if (!internal::has_recipient) { // If lazy loading hasn't been initialized, register with the messenger
@@ -117,21 +246,32 @@ namespace bee { namespace loader {
 		}
 
 		internal::amount_loaded = 0;
-		internal::total_amount = internal::resources.size();
-		internal::lazy_amount = amount;
-		internal::next_resource = internal::resources.begin();
+		internal::lazy_amount = (amount > 0) ? amount : 0;
+		internal::next_resource = 0;
+
+		internal::decode_start();
+		internal::total_amount = internal::decode_list.size();
 
 		internal::load_lazy();
 
 		return 0;
 	}
 	/*
-	* load_lazy() - Load one resource per frame from the queue
+	* load_lazy() - Load as many decoded resources per frame as fit in the frame budget
 	*/
 	int load_lazy() {
-		return load_lazy(1);
+		return load_lazy(0);
 	}
 
+	/*
+	* get_amount_decoded() - Return the amount of resources which have been decoded by the decode threads
+	*/
+	size_t get_amount_decoded() {
+		return internal::amount_decoded.load();
+	}
+	/*
+	* get_amount_loaded() - Return the amount of resources which have been finalized on the main thread
+	*/
 	size_t get_amount_loaded() {
 		return internal::amount_loaded;
 	}
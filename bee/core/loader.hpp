@@ -14,6 +14,12 @@ namespace bee {
 	class Resource;
 namespace loader {
 	namespace internal {
+		int decode_start();
+		int decode_stop();
+		int decode_next();
+		void decode_main();
+		bool get_is_decoded(size_t);
+
 		int load_next();
 		int load_lazy();
 	}
@@ -25,6 +31,7 @@ namespace loader {
 	int load_lazy(int);
 	int load_lazy();
 
+	size_t get_amount_decoded();
 	size_t get_amount_loaded();
 	size_t get_total();
 }}
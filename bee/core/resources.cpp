@@ -195,135 +195,63 @@ namespace bee {
 	* @name: the name of the desired texture
 	*/
 	Texture* get_texture_by_name(const std::string& name) {
-		for (size_t i=0; i<Texture::get_amount(); ++i) { // Iterate over the textures in order to find the first one with the given name
-			Texture* t = Texture::get(i);
-			if (t != nullptr) {
-				if (t->get_name() == name) {
-					return t; // Return the desired texture on success
-				}
-			}
-		}
-		return nullptr; // Return nullptr on failure
+		return Texture::get_by_name(name);
 	}
 	/*
 	* get_sound_by_name() - Return the sound resource with the given name
 	* @name: the name of the desired sound
 	*/
 	Sound* get_sound_by_name(const std::string& name) {
-		for (size_t i=0; i<Sound::get_amount(); ++i) { // Iterate over the sounds in order to find the first one with the given name
-			Sound* s = Sound::get(i);
-			if (s != nullptr) {
-				if (s->get_name() == name) {
-					return s; // Return the desired sound on success
-				}
-			}
-		}
-		return nullptr; // Return nullptr on failure
+		return Sound::get_by_name(name);
 	}
 	/*
 	* get_font_by_name() - Return the font resource with the given name
 	* @name: the name of the desired font
 	*/
 	Font* get_font_by_name(const std::string& name) {
-		for (size_t i=0; i<Font::get_amount(); ++i) { // Iterate over the fonts in order to find the first one with the given name
-			Font* f = Font::get(i);
-			if (f != nullptr) {
-				if (f->get_name() == name) {
-					return f; // Return the desired font on success
-				}
-			}
-		}
-		return nullptr; // Return nullptr on failure
+		return Font::get_by_name(name);
 	}
 	/*
 	* get_path_by_name() - Return the path resource with the given name
 	* @name: the name of the desired path
 	*/
 	Path* get_path_by_name(const std::string& name) {
-		for (size_t i=0; i<Path::get_amount(); ++i) { // Iterate over the paths in order to find the first one with the given name
-			Path* p = Path::get(i);
-			if (p != nullptr) {
-				if (p->get_name() == name) {
-					return p; // Return the desired path on success
-				}
-			}
-		}
-		return nullptr; // Return nullptr on failure
+		return Path::get_by_name(name);
 	}
 	/*
 	* get_timeline_by_name() - Return the timeline resource with the given name
 	* @name: the name of the desired timeline
 	*/
 	Timeline* get_timeline_by_name(const std::string& name) {
-		for (size_t i=0; i<Timeline::get_amount(); ++i) { // Iterate over the timelines in order to find the first one with the given name
-			Timeline* t = Timeline::get(i);
-			if (t != nullptr) {
-				if (t->get_name() == name) {
-					return t; // Return the desired timeline on success
-				}
-			}
-		}
-		return nullptr; // Return nullptr on failure
+		return Timeline::get_by_name(name);
 	}
 	/*
 	* get_mesh_by_name() - Return the mesh resource with the given name
 	* @name: the name of the desired mesh
 	*/
 	Mesh* get_mesh_by_name(const std::string& name) {
-		for (size_t i=0; i<Mesh::get_amount(); ++i) { // Iterate over the meshes in order to find the first one with the given name
-			Mesh* m = Mesh::get(i);
-			if (m != nullptr) {
-				if (m->get_name() == name) {
-					return m; // Return the desired mesh on success
-				}
-			}
-		}
-		return nullptr; // Return nullptr on failure
+		return Mesh::get_by_name(name);
 	}
 	/*
 	* get_light_by_name() - Return the light resource with the given name
 	* @name: the name of the desired light
 	*/
 	Light* get_light_by_name(const std::string& name) {
-		for (size_t i=0; i<Light::get_amount(); ++i) { // Iterate over the lights in order to find the first one with the given name
-			Light* l = Light::get(i);
-			if (l != nullptr) {
-				if (l->get_name() == name) {
-					return l; // Return the desired light on success
-				}
-			}
-		}
-		return nullptr; // Return nullptr on failure
+		return Light::get_by_name(name);
 	}
 	/*
 	* get_object_by_name() - Return the object resource with the given name
 	* @name: the name of the desired object
 	*/
 	Object* get_object_by_name(const std::string& name) {
-		for (size_t i=0; i<Object::get_amount(); ++i) { // Iterate over the objects in order to find the first one with the given name
-			Object* o = Object::get(i);
-			if (o != nullptr) {
-				if (o->get_name() == name) {
-					return o; // Return the desired object on success
-				}
-			}
-		}
-		return nullptr; // Return nullptr on failure
+		return Object::get_by_name(name);
 	}
 	/*
 	* get_room_by_name() - Return the room resource with the given name
 	* @name: the name of the desired room
 	*/
 	Room* get_room_by_name(const std::string& name) {
-		for (size_t i=0; i<Room::get_amount(); ++i) { // Iterate over the rooms in order to find the first one with the given name
-			Room* r = Room::get(i);
-			if (r != nullptr) {
-				if (r->get_name() == name) {
-					return r; // Return the desired room on success
-				}
-			}
-		}
-		return nullptr; // Return nullptr on failure
+		return Room::get_by_name(name);
 	}
 }
 
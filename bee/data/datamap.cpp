@@ -0,0 +1,232 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef BEE_DATA_DATAMAP
+#define BEE_DATA_DATAMAP 1
+
+#include <unordered_map> // Include the required library headers
+#include <algorithm>
+#include <mutex>
+#include <shared_mutex>
+
+#include "datamap.hpp" // Include the engine headers
+
+namespace bee {
+	namespace internal {
+		std::shared_timed_mutex datamap_keys_mutex; // Interning can happen from the step job threads, lookups of existing keys only take a shared lock
+		std::unordered_map<std::string,Uint32> datamap_key_ids;
+		std::deque<std::string> datamap_key_names; // The name of each id, which doesn't move when new keys are added
+
+		/*
+		* datamap_compare() - Return whether the given key entry is before the given id
+		*/
+		bool datamap_compare(const std::pair<Uint32,size_t>& e, Uint32 key) {
+			return (e.first < key);
+		}
+	}
+
+	/*
+	* DataMap::get_key() - Return the id of the given key name, adding it to the global key table if it doesn't exist
+	* ! Object code should resolve its keys once, e.g. in a static variable, and then index the data with the id
+	* @name: the key name
+	*/
+	Uint32 DataMap::get_key(const std::string& name) {
+		Uint32 id;
+		if (get_key(name, &id)) {
+			return id;
+		}
+
+		std::lock_guard<std::shared_timed_mutex> lock (internal::datamap_keys_mutex);
+
+		auto it = internal::datamap_key_ids.find(name); // Check again in case another thread added the key before the exclusive lock
+		if (it != internal::datamap_key_ids.end()) {
+			return it->second;
+		}
+
+		id = internal::datamap_key_names.size();
+		internal::datamap_key_ids.emplace(name, id);
+		internal::datamap_key_names.push_back(name);
+
+		return id;
+	}
+	/*
+	* DataMap::get_key() - Fetch the id of the given key name without adding it to the key table
+	* @name: the key name
+	* @id: the location to store the id
+	*/
+	bool DataMap::get_key(const std::string& name, Uint32* id) {
+		std::shared_lock<std::shared_timed_mutex> lock (internal::datamap_keys_mutex);
+
+		auto it = internal::datamap_key_ids.find(name);
+		if (it == internal::datamap_key_ids.end()) {
+			return false; // Return false when the key has never been used
+		}
+
+		*id = it->second;
+
+		return true;
+	}
+	/*
+	* DataMap::get_key_name() - Return the name of the given key id
+	* @id: the key id
+	*/
+	std::string DataMap::get_key_name(Uint32 id) {
+		std::shared_lock<std::shared_timed_mutex> lock (internal::datamap_keys_mutex);
+		if (id >= internal::datamap_key_names.size()) {
+			return ""; // Return an empty string when the id is invalid
+		}
+
+		return internal::datamap_key_names[id];
+	}
+
+	DataMap::DataMap() :
+		keys(),
+		values(),
+		free_slots()
+	{}
+	/*
+	* DataMap::DataMap() - Construct the map from the given named values
+	* @m: the values to copy
+	*/
+	DataMap::DataMap(const std::map<std::string,SIDP>& m) :
+		DataMap()
+	{
+		set_map(m);
+	}
+
+	size_t DataMap::size() const {
+		return keys.size();
+	}
+	bool DataMap::empty() const {
+		return keys.empty();
+	}
+	int DataMap::clear() {
+		keys.clear();
+		values.clear();
+		free_slots.clear();
+		return 0;
+	}
+
+	/*
+	* DataMap::find_key() - Return the position of the given key id in the sorted key list, or the position where it would be inserted
+	* @key: the key id to find
+	*/
+	std::vector<std::pair<Uint32,size_t>>::const_iterator DataMap::find_key(Uint32 key) const {
+		return std::lower_bound(keys.begin(), keys.end(), key, internal::datamap_compare);
+	}
+
+	/*
+	* DataMap::operator[]() - Return the value of the given key, inserting an empty value if it doesn't exist
+	* ! Like std::map, references to the values stay valid when other keys are inserted
+	* @key: the key id
+	*/
+	SIDP& DataMap::operator[](Uint32 key) {
+		auto it = find_key(key);
+		if ((it != keys.end())&&(it->first == key)) {
+			return values[it->second];
+		}
+
+		size_t slot = values.size();
+		if (!free_slots.empty()) {
+			slot = free_slots.back();
+			free_slots.pop_back();
+		} else {
+			values.emplace_back();
+		}
+		keys.insert(it, std::make_pair(key, slot));
+
+		return values[slot];
+	}
+	SIDP& DataMap::operator[](const std::string& name) {
+		return (*this)[get_key(name)];
+	}
+	SIDP& DataMap::operator[](const char* name) {
+		return (*this)[get_key(name)];
+	}
+	/*
+	* DataMap::find() - Return a pointer to the value of the given key, or nullptr if it doesn't exist
+	* @key: the key id
+	*/
+	SIDP* DataMap::find(Uint32 key) {
+		auto it = find_key(key);
+		if ((it == keys.end())||(it->first != key)) {
+			return nullptr;
+		}
+		return &values[it->second];
+	}
+	const SIDP* DataMap::find(Uint32 key) const {
+		auto it = find_key(key);
+		if ((it == keys.end())||(it->first != key)) {
+			return nullptr;
+		}
+		return &values[it->second];
+	}
+	/*
+	* DataMap::find() - Return a pointer to the value of the given key name, or nullptr if it doesn't exist
+	* ! The name isn't added to the key table when it is missing
+	* @name: the key name
+	*/
+	const SIDP* DataMap::find(const std::string& name) const {
+		Uint32 key = 0;
+		if (!get_key(name, &key)) {
+			return nullptr;
+		}
+		return find(key);
+	}
+	/*
+	* DataMap::erase() - Remove the value of the given key
+	* @key: the key id
+	*/
+	int DataMap::erase(Uint32 key) {
+		auto it = find_key(key);
+		if ((it == keys.end())||(it->first != key)) {
+			return 1; // Return 1 when the key doesn't exist
+		}
+
+		values[it->second].reset();
+		free_slots.push_back(it->second);
+		keys.erase(it);
+
+		return 0; // Return 0 on success
+	}
+
+	/*
+	* DataMap::get_keys() - Return the ids of the keys in the map
+	*/
+	std::vector<Uint32> DataMap::get_keys() const {
+		std::vector<Uint32> k;
+		k.reserve(keys.size());
+		for (auto& e : keys) {
+			k.push_back(e.first);
+		}
+		return k;
+	}
+	/*
+	* DataMap::get_map() - Return a copy of the values keyed by their names, e.g. for serialization
+	*/
+	std::map<std::string,SIDP> DataMap::get_map() const {
+		std::map<std::string,SIDP> m;
+		for (auto& e : keys) {
+			m.emplace(get_key_name(e.first), values[e.second]);
+		}
+		return m;
+	}
+	/*
+	* DataMap::set_map() - Replace the values with the given named values
+	* @m: the values to copy
+	*/
+	int DataMap::set_map(const std::map<std::string,SIDP>& m) {
+		clear();
+		for (auto& e : m) {
+			(*this)[e.first] = e.second;
+		}
+		return 0;
+	}
+}
+
+#endif // BEE_DATA_DATAMAP
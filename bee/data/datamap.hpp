@@ -0,0 +1,56 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef BEE_DATA_DATAMAP_H
+#define BEE_DATA_DATAMAP_H 1
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+
+#include <SDL2/SDL.h> // Include the required SDL headers for Uint32
+
+#include "sidp.hpp"
+
+namespace bee {
+	class DataMap { // A map of SIDP values keyed by interned integer ids, which is used for instance data
+			std::vector<std::pair<Uint32,size_t>> keys; // The sorted key ids with the slot of each value
+			std::deque<SIDP> values; // The value slots, which don't move when other values are added
+			std::vector<size_t> free_slots; // The slots of erased values which can be reused
+
+			// See bee/data/datamap.cpp for function comments
+			std::vector<std::pair<Uint32,size_t>>::const_iterator find_key(Uint32) const;
+		public:
+			// See bee/data/datamap.cpp for function comments
+			static Uint32 get_key(const std::string&);
+			static bool get_key(const std::string&, Uint32*);
+			static std::string get_key_name(Uint32);
+
+			DataMap();
+			explicit DataMap(const std::map<std::string,SIDP>&);
+
+			size_t size() const;
+			bool empty() const;
+			int clear();
+
+			SIDP& operator[](Uint32);
+			SIDP& operator[](const std::string&);
+			SIDP& operator[](const char*);
+			SIDP* find(Uint32);
+			const SIDP* find(Uint32) const;
+			const SIDP* find(const std::string&) const;
+			int erase(Uint32);
+
+			std::vector<Uint32> get_keys() const;
+			std::map<std::string,SIDP> get_map() const;
+			int set_map(const std::map<std::string,SIDP>&);
+	};
+}
+
+#endif // BEE_DATA_DATAMAP_H
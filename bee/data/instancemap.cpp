@@ -0,0 +1,449 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef BEE_DATA_INSTANCEMAP
+#define BEE_DATA_INSTANCEMAP 1
+
+#include <fstream> // Include the required library headers
+#include <cstring>
+#include <cstdlib>
+
+#include "instancemap.hpp" // Include the engine headers
+
+#include "../util/string.hpp"
+
+#include "../messenger/messenger.hpp"
+
+namespace bee {
+	namespace internal {
+		/*
+		* The binary format is laid out as follows, where every value is in host byte order:
+		* 8 bytes: the magic string "BEE_IMAP"
+		* 4 bytes each: the version, the byte order mark, the amount of objects, the amount of instances, the amount of !set blocks, and padding
+		* for each object: the 4 byte length of the name followed by the name, then padding to an 8 byte boundary
+		* the 4 byte object index of each instance, then padding to an 8 byte boundary
+		* the 8 byte x-, y-, and z-coordinates of each instance as three separate arrays
+		* for each !set block: the 4 byte amount of instances before it, the 4 byte length of its text, and the text
+		*/
+		const char instancemap_magic[] = {'B', 'E', 'E', '_', 'I', 'M', 'A', 'P'};
+		const Uint32 instancemap_version = 2;
+		const Uint32 instancemap_byte_order = 0x01020304;
+
+		/*
+		* instancemap_append() - Append the given bytes to the given data
+		* @data: the data to append to
+		* @value: the bytes to append
+		* @size: the amount of bytes to append
+		*/
+		void instancemap_append(std::string* data, const void* value, size_t size) {
+			data->append(static_cast<const char*>(value), size);
+		}
+		/*
+		* instancemap_align() - Pad the given data with zeros until its size is a multiple of 8 bytes
+		* @data: the data to pad
+		*/
+		void instancemap_align(std::string* data) {
+			data->append((8 - data->size() % 8) % 8, '\0');
+		}
+		/*
+		* instancemap_read() - Copy bytes from the given offset of the given data and advance the offset
+		* @data: the data to read from
+		* @offset: the offset to read from, which is advanced by the size
+		* @value: the destination of the bytes
+		* @size: the amount of bytes to read
+		*/
+		bool instancemap_read(const std::string& data, size_t* offset, void* value, size_t size) {
+			if ((*offset > data.size())||(size > data.size() - *offset)) {
+				return false;
+			}
+			if (size > 0) {
+				memcpy(value, data.data() + *offset, size);
+			}
+			*offset += size;
+			return true;
+		}
+		/*
+		* instancemap_tokenize() - Split the given line into its tab separated values, ignoring empty values
+		* @line: the line to split
+		*/
+		std::vector<std::string> instancemap_tokenize(const std::string& line) {
+			std::vector<std::string> tokens;
+			size_t start = 0;
+			while (start <= line.size()) {
+				size_t end = line.find('\t', start);
+				if (end == std::string::npos) {
+					end = line.size();
+				}
+				if (end > start) {
+					tokens.push_back(line.substr(start, end-start));
+				}
+				start = end+1;
+			}
+			return tokens;
+		}
+	}
+
+	/*
+	* InstanceMap::InstanceMap() - Construct the empty instance map
+	*/
+	InstanceMap::InstanceMap() :
+		object_indices(),
+
+		objects(),
+		object_ids(),
+		x(),
+		y(),
+		z(),
+		sets(),
+		set_positions()
+	{}
+
+	/*
+	* InstanceMap::get_amount() - Return the amount of compiled instances
+	*/
+	size_t InstanceMap::get_amount() const {
+		return object_ids.size();
+	}
+	/*
+	* InstanceMap::clear() - Remove every object, instance, and !set block
+	*/
+	int InstanceMap::clear() {
+		object_indices.clear();
+		objects.clear();
+		object_ids.clear();
+		x.clear();
+		y.clear();
+		z.clear();
+		sets.clear();
+		set_positions.clear();
+		return 0;
+	}
+	/*
+	* InstanceMap::add() - Add an instance of the given object, adding the object to the object table if needed
+	* @object: the name of the object
+	* @_x: the x-coordinate of the instance
+	* @_y: the y-coordinate of the instance
+	* @_z: the z-coordinate of the instance
+	*/
+	int InstanceMap::add(const std::string& object, double _x, double _y, double _z) {
+		auto it = object_indices.find(object);
+		if (it == object_indices.end()) {
+			it = object_indices.emplace(object, static_cast<Uint32>(objects.size())).first;
+			objects.push_back(object);
+		}
+
+		object_ids.push_back(it->second);
+		x.push_back(_x);
+		y.push_back(_y);
+		z.push_back(_z);
+
+		return 0;
+	}
+	/*
+	* InstanceMap::add_set() - Add a !set block after the instances which have already been added
+	* @text: the text of the block, including the !set and !setend lines
+	*/
+	int InstanceMap::add_set(const std::string& text) {
+		sets.push_back(text);
+		set_positions.push_back(static_cast<Uint32>(get_amount()));
+		return 0;
+	}
+	/*
+	* InstanceMap::add_tiles() - Expand a !tilex, !tiley, or !tilez command into its instances
+	* @params: the parameters of the command, i.e. the command, the amount, the grid size, the object, and the coordinates
+	* @axis: the axis to repeat the instances on, where 0 is x, 1 is y, and 2 is z
+	*/
+	int InstanceMap::add_tiles(const std::vector<std::string>& params, int axis) {
+		if (params.size() < 7) {
+			messenger::send({"engine", "room"}, E_MESSAGE::WARNING, "Error while loading instance map: missing parameters for " + params[0]);
+			return 1; // Return 1 when there are not enough parameters
+		}
+
+		const long tile_amount = std::strtol(params[1].c_str(), nullptr, 10);
+		const double grid = std::strtod(params[2].c_str(), nullptr);
+		const double tx = std::strtod(params[4].c_str(), nullptr);
+		const double ty = std::strtod(params[5].c_str(), nullptr);
+		const double tz = std::strtod(params[6].c_str(), nullptr);
+
+		for (long i=0; i<tile_amount; ++i) {
+			add(
+				params[3],
+				tx + ((axis == 0) ? i*grid : 0.0),
+				ty + ((axis == 1) ? i*grid : 0.0),
+				tz + ((axis == 2) ? i*grid : 0.0)
+			);
+		}
+
+		return 0;
+	}
+
+	/*
+	* InstanceMap::compile() - Add the instances from the given text instance map
+	* ! Tile commands are expanded into their individual instances and !set blocks are kept as text since they contain per-instance data
+	* @text: the contents of the text instance map
+	*/
+	int InstanceMap::compile(const std::string& text) {
+		size_t start = 0;
+		bool is_set = false;
+		std::string set;
+		while (start < text.size()) {
+			size_t end = text.find('\n', start);
+			if (end == std::string::npos) {
+				end = text.size();
+			}
+			const std::string line = trim(text.substr(start, end-start));
+			start = end+1;
+
+			if (is_set) { // Copy every line of a !set block into its text
+				set += line + "\n";
+				if (line == "!setend") {
+					add_set(set);
+					is_set = false;
+				}
+				continue;
+			}
+
+			if ((line.empty())||(line[0] == '#')) {
+				continue;
+			}
+
+			std::vector<std::string> params = internal::instancemap_tokenize(line);
+			const std::string& v = params[0];
+
+			if (v[0] == '!') {
+				if (v == "!tilex") {
+					add_tiles(params, 0);
+				} else if (v == "!tiley") {
+					add_tiles(params, 1);
+				} else if (v == "!tilez") {
+					add_tiles(params, 2);
+				} else if (v == "!set") {
+					set = line + "\n";
+					is_set = true;
+				} else if (v == "!setend") {
+					messenger::send({"engine", "room"}, E_MESSAGE::WARNING, "Error while loading instance map: stray !setend");
+				} else {
+					messenger::send({"engine", "room"}, E_MESSAGE::WARNING, "Error while loading instance map: unknown command \"" + v + "\"");
+				}
+			} else if (params.size() < 4) {
+				messenger::send({"engine", "room"}, E_MESSAGE::WARNING, "Error while loading instance map: missing coordinates for " + v);
+			} else {
+				add(
+					v,
+					std::strtod(params[1].c_str(), nullptr),
+					std::strtod(params[2].c_str(), nullptr),
+					std::strtod(params[3].c_str(), nullptr)
+				);
+			}
+		}
+		if (is_set) { // Keep an unterminated block at the end of the text
+			add_set(set);
+		}
+
+		return 0;
+	}
+	/*
+	* InstanceMap::serialize() - Return the instance map in the binary format
+	* ! See the internal namespace above for the layout
+	*/
+	std::string InstanceMap::serialize() const {
+		std::string data;
+
+		const Uint32 header[] = {
+			internal::instancemap_version,
+			internal::instancemap_byte_order,
+			static_cast<Uint32>(objects.size()),
+			static_cast<Uint32>(get_amount()),
+			static_cast<Uint32>(sets.size()),
+			0
+		};
+		internal::instancemap_append(&data, internal::instancemap_magic, sizeof(internal::instancemap_magic));
+		internal::instancemap_append(&data, header, sizeof(header));
+
+		for (auto& o : objects) {
+			const Uint32 length = o.size();
+			internal::instancemap_append(&data, &length, sizeof(length));
+			data.append(o);
+		}
+		internal::instancemap_align(&data);
+
+		internal::instancemap_append(&data, object_ids.data(), object_ids.size()*sizeof(Uint32));
+		internal::instancemap_align(&data);
+
+		internal::instancemap_append(&data, x.data(), x.size()*sizeof(double));
+		internal::instancemap_append(&data, y.data(), y.size()*sizeof(double));
+		internal::instancemap_append(&data, z.data(), z.size()*sizeof(double));
+
+		for (size_t i=0; i<sets.size(); ++i) {
+			const Uint32 length = sets[i].size();
+			internal::instancemap_append(&data, &set_positions[i], sizeof(Uint32));
+			internal::instancemap_append(&data, &length, sizeof(length));
+			data.append(sets[i]);
+		}
+
+		return data;
+	}
+	/*
+	* InstanceMap::deserialize() - Replace the instance map with the given binary data
+	* @data: the binary instance map
+	*/
+	int InstanceMap::deserialize(const std::string& data) {
+		clear();
+
+		if (!get_is_compiled(data)) {
+			return 1; // Return 1 when the data is not a binary instance map
+		}
+
+		size_t offset = sizeof(internal::instancemap_magic);
+		Uint32 header[6];
+		if (!internal::instancemap_read(data, &offset, header, sizeof(header))) {
+			return 2; // Return 2 when the data is truncated
+		}
+		if ((header[0] != internal::instancemap_version)||(header[1] != internal::instancemap_byte_order)) {
+			return 3; // Return 3 when the data has an unsupported version or byte order
+		}
+
+		const Uint32 object_amount = header[2];
+		const Uint32 instance_amount = header[3];
+		const Uint32 set_amount = header[4];
+
+		// Check the amounts against the remaining data before allocating anything for them
+		if (object_amount > (data.size() - offset) / sizeof(Uint32)) {
+			return 2;
+		}
+
+		objects.reserve(object_amount);
+		for (Uint32 i=0; i<object_amount; ++i) {
+			Uint32 length = 0;
+			if ((!internal::instancemap_read(data, &offset, &length, sizeof(length)))||(length > data.size() - offset)) {
+				clear();
+				return 2;
+			}
+			std::string name (length, '\0');
+			if (!internal::instancemap_read(data, &offset, &name[0], length)) {
+				clear();
+				return 2;
+			}
+			object_indices.emplace(name, i);
+			objects.push_back(name);
+		}
+		offset += (8 - offset % 8) % 8;
+
+		const size_t instance_size = sizeof(Uint32) + 3*sizeof(double);
+		if ((offset > data.size())||(instance_amount > (data.size() - offset) / instance_size)) {
+			clear();
+			return 2;
+		}
+
+		// Copy each packed array in bulk
+		object_ids.resize(instance_amount);
+		x.resize(instance_amount);
+		y.resize(instance_amount);
+		z.resize(instance_amount);
+		bool is_read = internal::instancemap_read(data, &offset, object_ids.data(), instance_amount*sizeof(Uint32));
+		offset += (8 - offset % 8) % 8;
+		is_read = is_read && internal::instancemap_read(data, &offset, x.data(), instance_amount*sizeof(double));
+		is_read = is_read && internal::instancemap_read(data, &offset, y.data(), instance_amount*sizeof(double));
+		is_read = is_read && internal::instancemap_read(data, &offset, z.data(), instance_amount*sizeof(double));
+		if ((!is_read)||(set_amount > (data.size() - offset) / (2*sizeof(Uint32)))) {
+			clear();
+			return 2;
+		}
+
+		sets.reserve(set_amount);
+		set_positions.reserve(set_amount);
+		for (Uint32 i=0; i<set_amount; ++i) {
+			Uint32 position = 0, length = 0;
+			is_read = (
+				(internal::instancemap_read(data, &offset, &position, sizeof(position)))
+				&&(internal::instancemap_read(data, &offset, &length, sizeof(length)))
+				&&(length <= data.size() - offset)
+			);
+			if (!is_read) {
+				clear();
+				return 2;
+			}
+			if ((position > instance_amount)||((!set_positions.empty())&&(position < set_positions.back()))) {
+				clear();
+				return 4; // Return 4 when a !set block is outside of the instance list
+			}
+
+			set_positions.push_back(position);
+			sets.push_back(data.substr(offset, length));
+			offset += length;
+		}
+		if (offset != data.size()) {
+			clear();
+			return 2;
+		}
+
+		for (auto& id : object_ids) {
+			if (id >= object_amount) {
+				clear();
+				return 4; // Return 4 when an instance refers to an object which is not in the object table
+			}
+		}
+
+		return 0; // Return 0 on success
+	}
+
+	/*
+	* InstanceMap::load() - Add the instances from the given file, which may be either a text or binary instance map
+	* ! The entire file is read at once
+	* @fname: the path of the file
+	*/
+	int InstanceMap::load(const std::string& fname) {
+		std::ifstream input (fname, std::ios::binary | std::ios::ate);
+		if (!input.is_open()) {
+			return 1; // Return 1 when the file could not be opened
+		}
+
+		std::string data (static_cast<size_t>(input.tellg()), '\0');
+		input.seekg(0);
+		input.read(&data[0], data.size());
+		input.close();
+
+		if (get_is_compiled(data)) {
+			if (deserialize(data)) {
+				return 2; // Return 2 when the binary data is invalid
+			}
+			return 0;
+		}
+
+		return compile(data);
+	}
+	/*
+	* InstanceMap::save() - Write the instance map to the given file in the binary format
+	* @fname: the path of the file
+	*/
+	int InstanceMap::save(const std::string& fname) const {
+		std::ofstream output (fname, std::ios::binary | std::ios::trunc);
+		if (!output.good()) {
+			return 1; // Return 1 when the file could not be opened
+		}
+
+		const std::string data = serialize();
+		output.write(data.data(), data.size());
+		output.close();
+
+		return 0;
+	}
+
+	/*
+	* InstanceMap::get_is_compiled() - Return whether the given data is a binary instance map
+	* @data: the data to check
+	*/
+	bool InstanceMap::get_is_compiled(const std::string& data) {
+		return (
+			(data.size() >= sizeof(internal::instancemap_magic))
+			&&(memcmp(data.data(), internal::instancemap_magic, sizeof(internal::instancemap_magic)) == 0)
+		);
+	}
+}
+
+#endif // BEE_DATA_INSTANCEMAP
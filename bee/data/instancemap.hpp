@@ -0,0 +1,50 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef BEE_DATA_INSTANCEMAP_H
+#define BEE_DATA_INSTANCEMAP_H 1
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include <SDL2/SDL.h> // Include the required SDL headers for Uint32
+
+namespace bee {
+	class InstanceMap { // A compiled list of instances which can be saved in a binary format and loaded without any text parsing
+			std::unordered_map<std::string,Uint32> object_indices; // A map of the object names with their index in the object table
+
+			// See bee/data/instancemap.cpp for function comments
+			int add_tiles(const std::vector<std::string>&, int);
+		public:
+			std::vector<std::string> objects; // The object table, which contains each object name once
+			std::vector<Uint32> object_ids; // The object table index of each instance
+			std::vector<double> x, y, z; // The start coordinates of each instance
+			std::vector<std::string> sets; // The text of each !set block, which can't be compiled since it contains per-instance data
+			std::vector<Uint32> set_positions; // The amount of instances before each !set block, which keeps the blocks in file order
+
+			// See bee/data/instancemap.cpp for function comments
+			InstanceMap();
+
+			size_t get_amount() const;
+			int clear();
+			int add(const std::string&, double, double, double);
+			int add_set(const std::string&);
+
+			int compile(const std::string&);
+			std::string serialize() const;
+			int deserialize(const std::string&);
+
+			int load(const std::string&);
+			int save(const std::string&) const;
+
+			static bool get_is_compiled(const std::string&);
+	};
+}
+
+#endif // BEE_DATA_INSTANCEMAP_H
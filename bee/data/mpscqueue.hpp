@@ -0,0 +1,110 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef BEE_DATA_MPSCQUEUE_H
+#define BEE_DATA_MPSCQUEUE_H 1
+
+#include <memory>
+#include <atomic>
+
+namespace bee {
+	template <typename T>
+	class MPSCQueue { // A bounded ring buffer which passes items from any amount of producer threads to a single consumer thread without locking
+			struct Cell {
+				std::atomic<size_t> sequence; // The push count at which the cell can be written, or that count plus one once the item can be read
+				T item;
+			};
+
+			std::unique_ptr<Cell[]> cells;
+			size_t size;
+			size_t mask; // The capacity minus one, which is used to wrap the indices
+
+			alignas(64) std::atomic<size_t> tail; // The total amount of claimed cells, which the producers advance with compare-and-swap
+			alignas(64) size_t head; // The total amount of popped items, only used by the consumer
+		public:
+			/*
+			* MPSCQueue::MPSCQueue() - Construct the queue with at least the given capacity
+			* ! The capacity is rounded up to a power of two so that the indices can be wrapped with a mask
+			* @capacity: the minimum amount of items which can be queued at once
+			*/
+			explicit MPSCQueue(size_t capacity) :
+				cells(),
+				size(1),
+				mask(0),
+				tail(0),
+				head(0)
+			{
+				while (size < capacity) {
+					size <<= 1;
+				}
+				cells.reset(new Cell[size]);
+				mask = size - 1;
+
+				for (size_t i=0; i<size; ++i) {
+					cells[i].sequence.store(i, std::memory_order_relaxed);
+				}
+			}
+			MPSCQueue(const MPSCQueue&) = delete;
+			MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+			/*
+			* MPSCQueue::push() - Move the given item to the back of the queue
+			* ! This can be called from any thread
+			* @item: the item to push
+			*/
+			bool push(T&& item) {
+				size_t t = tail.load(std::memory_order_relaxed);
+				while (true) {
+					Cell& cell = cells[t & mask];
+					const size_t seq = cell.sequence.load(std::memory_order_acquire);
+
+					if (seq == t) { // If the cell is free, try to claim it
+						if (tail.compare_exchange_weak(t, t+1, std::memory_order_relaxed)) {
+							cell.item = std::move(item);
+							cell.sequence.store(t+1, std::memory_order_release);
+							return true;
+						}
+					} else if (seq < t) {
+						return false; // Return false when the queue is full
+					} else { // Otherwise another producer claimed the cell first
+						t = tail.load(std::memory_order_relaxed);
+					}
+				}
+			}
+			/*
+			* MPSCQueue::pop() - Move the item at the front of the queue into the given pointer
+			* ! This must only be called from the consumer thread
+			* @item: the location to move the item to
+			*/
+			bool pop(T* item) {
+				Cell& cell = cells[head & mask];
+				if (cell.sequence.load(std::memory_order_acquire) != head+1) {
+					return false; // Return false when the queue is empty or the next item is still being written
+				}
+
+				*item = std::move(cell.item);
+				cell.sequence.store(head+size, std::memory_order_release); // Free the cell for the next lap
+				++head;
+
+				return true;
+			}
+
+			size_t get_capacity() const {
+				return size;
+			}
+			/*
+			* MPSCQueue::get_is_empty() - Return whether there is no item which can be popped
+			* ! This must only be called from the consumer thread
+			*/
+			bool get_is_empty() const {
+				return (cells[head & mask].sequence.load(std::memory_order_acquire) != head+1);
+			}
+	};
+}
+
+#endif // BEE_DATA_MPSCQUEUE_H
@@ -0,0 +1,109 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef BEE_DATA_NAMEINDEX_H
+#define BEE_DATA_NAMEINDEX_H 1
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+
+namespace bee {
+	template <typename T>
+	class NameIndex { // A hash index from interned names to the resources which currently have them
+			std::unordered_map<std::string,size_t> handles; // The handle of each interned name
+			std::vector<std::vector<T*>> resources; // The resources with each name sorted by id, so that duplicate names resolve to the oldest resource
+		public:
+			NameIndex() :
+				handles(),
+				resources()
+			{}
+
+			/*
+			* NameIndex::get_handle() - Return the handle of the given name, interning it if it doesn't exist
+			* ! Handles stay valid for the lifetime of the index, even when no resource currently has the name
+			* @name: the name to intern
+			*/
+			size_t get_handle(const std::string& name) {
+				auto it = handles.find(name);
+				if (it != handles.end()) {
+					return it->second;
+				}
+
+				const size_t handle = resources.size();
+				handles.emplace(name, handle);
+				resources.emplace_back();
+
+				return handle;
+			}
+			/*
+			* NameIndex::get() - Return the resource with the given name handle, or nullptr if there isn't one
+			* @handle: the name handle
+			*/
+			T* get(size_t handle) const {
+				if ((handle >= resources.size())||(resources[handle].empty())) {
+					return nullptr;
+				}
+				return resources[handle].front();
+			}
+			/*
+			* NameIndex::find() - Return the resource with the given name, or nullptr if there isn't one
+			* ! The name isn't interned when it is missing
+			* @name: the name to find
+			*/
+			T* find(const std::string& name) const {
+				auto it = handles.find(name);
+				if (it == handles.end()) {
+					return nullptr;
+				}
+				return get(it->second);
+			}
+
+			/*
+			* NameIndex::add() - Index the given resource under the given name
+			* @name: the resource name
+			* @res: the resource to index
+			*/
+			int add(const std::string& name, T* res) {
+				if (name.empty()) {
+					return 1; // Return 1 when the resource hasn't been named yet
+				}
+
+				std::vector<T*>& v = resources[get_handle(name)];
+				auto it = std::upper_bound(v.begin(), v.end(), res, [] (const T* a, const T* b) {
+					return (a->get_id() < b->get_id());
+				});
+				v.insert(it, res);
+
+				return 0; // Return 0 on success
+			}
+			/*
+			* NameIndex::remove() - Remove the given resource from the given name
+			* @name: the name which the resource was indexed under
+			* @res: the resource to remove
+			*/
+			int remove(const std::string& name, T* res) {
+				auto it = handles.find(name);
+				if (it == handles.end()) {
+					return 1; // Return 1 when the name isn't indexed
+				}
+
+				std::vector<T*>& v = resources[it->second];
+				auto r = std::find(v.begin(), v.end(), res);
+				if (r == v.end()) {
+					return 2; // Return 2 when the resource doesn't have the name
+				}
+				v.erase(r);
+
+				return 0; // Return 0 on success
+			}
+	};
+}
+
+#endif // BEE_DATA_NAMEINDEX_H
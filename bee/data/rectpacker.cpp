@@ -0,0 +1,171 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef BEE_DATA_RECTPACKER
+#define BEE_DATA_RECTPACKER 1
+
+#include <algorithm> // Include the required library headers
+
+#include "rectpacker.hpp" // Include the engine headers
+
+namespace bee {
+	/*
+	* RectPacker::RectPacker() - Construct the packer with the given area
+	* @_width: the width of the area
+	* @_height: the height of the area
+	* @_padding: the amount of empty pixels to leave between rectangles
+	*/
+	RectPacker::RectPacker(int _width, int _height, int _padding) :
+		width(_width),
+		height(_height),
+		padding(_padding),
+		skyline(),
+		used_area(0)
+	{
+		clear();
+	}
+
+	int RectPacker::get_width() const {
+		return width;
+	}
+	int RectPacker::get_height() const {
+		return height;
+	}
+	/*
+	* RectPacker::get_occupancy() - Return the fraction of the area which is covered by packed rectangles
+	*/
+	double RectPacker::get_occupancy() const {
+		if ((width <= 0)||(height <= 0)) {
+			return 0.0;
+		}
+		return static_cast<double>(used_area) / (static_cast<Uint64>(width) * height);
+	}
+
+	/*
+	* RectPacker::clear() - Remove all rectangles so that the whole area is free
+	*/
+	int RectPacker::clear() {
+		skyline.clear();
+		skyline.push_back({0, 0, width});
+		used_area = 0;
+		return 0;
+	}
+
+	/*
+	* RectPacker::fit() - Determine the lowest position for a rectangle whose left edge is at the given skyline node
+	* @index: the index of the node
+	* @w: the width of the rectangle including its padding
+	* @h: the height of the rectangle without its padding
+	* @y: the location to store the top edge of the position
+	*/
+	bool RectPacker::fit(size_t index, int w, int h, int* y) const {
+		const int x = skyline[index].x;
+		if (x + w - padding > width) {
+			return false; // Return false when the rectangle would extend past the right edge
+		}
+
+		// Rest the rectangle on the highest node which it spans, the padding may hang past the right edge
+		int top = 0;
+		int width_left = std::min(w, width - x);
+		for (size_t i=index; (width_left > 0)&&(i<skyline.size()); ++i) {
+			top = std::max(top, skyline[i].y);
+			width_left -= skyline[i].w;
+		}
+
+		if (top + h > height) {
+			return false; // Return false when the rectangle would extend past the bottom edge
+		}
+
+		*y = top;
+		return true;
+	}
+	/*
+	* RectPacker::add_node() - Raise the skyline over the given rectangle
+	* @index: the index of the node at the left edge of the rectangle
+	* @rect: the rectangle including its padding
+	*/
+	int RectPacker::add_node(size_t index, const SDL_Rect& rect) {
+		const Node node = {rect.x, rect.y+rect.h, std::min(rect.w, width - rect.x)};
+		skyline.insert(skyline.begin()+index, node);
+
+		// Shrink or remove the nodes which are now covered by the new one
+		const int right = node.x + node.w;
+		for (size_t i=index+1; i<skyline.size(); ) {
+			if (skyline[i].x >= right) {
+				break;
+			}
+
+			const int overlap = right - skyline[i].x;
+			if (skyline[i].w <= overlap) {
+				skyline.erase(skyline.begin()+i);
+				continue;
+			}
+
+			skyline[i].x += overlap;
+			skyline[i].w -= overlap;
+			break;
+		}
+
+		// Merge neighboring nodes at the same height
+		for (size_t i=0; i+1<skyline.size(); ) {
+			if (skyline[i].y == skyline[i+1].y) {
+				skyline[i].w += skyline[i+1].w;
+				skyline.erase(skyline.begin()+i+1);
+			} else {
+				++i;
+			}
+		}
+
+		return 0;
+	}
+	/*
+	* RectPacker::insert() - Find a free position for a rectangle of the given size and reserve it
+	* ! The position with the lowest bottom edge is chosen, which keeps the skyline flat when the rectangles are inserted from tallest to shortest
+	* @w: the width of the rectangle
+	* @h: the height of the rectangle
+	* @rect: the location to store the position and size of the rectangle
+	*/
+	bool RectPacker::insert(int w, int h, SDL_Rect* rect) {
+		if ((w <= 0)||(h <= 0)) {
+			return false; // Return false for empty rectangles
+		}
+
+		const int pw = w + padding;
+		const int ph = h + padding;
+
+		size_t best_index = skyline.size();
+		int best_y = 0;
+		int best_bottom = height + 1;
+		int best_width = width + 1;
+		for (size_t i=0; i<skyline.size(); ++i) {
+			int y = 0;
+			if (!fit(i, pw, h, &y)) {
+				continue;
+			}
+
+			if ((y + h < best_bottom)||((y + h == best_bottom)&&(skyline[i].w < best_width))) {
+				best_index = i;
+				best_y = y;
+				best_bottom = y + h;
+				best_width = skyline[i].w;
+			}
+		}
+
+		if (best_index == skyline.size()) {
+			return false; // Return false when the rectangle doesn't fit
+		}
+
+		*rect = {skyline[best_index].x, best_y, w, h};
+		add_node(best_index, {rect->x, rect->y, pw, ph});
+		used_area += static_cast<Uint64>(w) * h;
+
+		return true;
+	}
+}
+
+#endif // BEE_DATA_RECTPACKER
@@ -0,0 +1,43 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef BEE_DATA_RECTPACKER_H
+#define BEE_DATA_RECTPACKER_H 1
+
+#include <vector>
+
+#include <SDL2/SDL.h> // Include the required SDL headers for SDL_Rect
+
+namespace bee {
+	class RectPacker { // A skyline packer which places rectangles into a fixed size area, e.g. a texture atlas page
+			struct Node { // A horizontal segment of the skyline
+				int x, y, w;
+			};
+
+			int width, height; // The dimensions of the area
+			int padding; // The empty space which is left to the right of and below each rectangle
+			std::vector<Node> skyline; // The top edge of the packed rectangles from left to right
+			Uint64 used_area; // The total area of the packed rectangles, not including the padding
+
+			// See bee/data/rectpacker.cpp for function comments
+			bool fit(size_t, int, int, int*) const;
+			int add_node(size_t, const SDL_Rect&);
+		public:
+			// See bee/data/rectpacker.cpp for function comments
+			RectPacker(int, int, int);
+
+			int get_width() const;
+			int get_height() const;
+			double get_occupancy() const;
+
+			int clear();
+			bool insert(int, int, SDL_Rect*);
+	};
+}
+
+#endif // BEE_DATA_RECTPACKER_H
@@ -12,39 +12,357 @@
 #include "serialdata.hpp" // Include the engine headers
 
 #include <sstream>
+#include <cstring>
+
+/*
+	Compact format {
+		header, // 1B, COMPACT_HEADER which is 0x80 | version
+		values... // Chars are single bytes, ints are zig-zag LEB128 varints,
+		          // floats and doubles are little-endian IEEE 754,
+		          // strings and serial vectors are a varint length followed by their bytes,
+		          // containers are a type tag for themselves and each of their element types followed by a varint length
+	}
+*/
 
 namespace bee {
+	const Uint8 SerialData::COMPACT_HEADER = 0x80 | 1;
+
 	SerialData::SerialData() :
 		data(),
 		pos(0),
-		is_writing(true)
+		is_writing(true),
+		is_compact(false)
 	{}
 	SerialData::SerialData(size_t initial_size) :
 		SerialData()
 	{
 		data.reserve(initial_size);
 	}
+	/*
+	* SerialData::SerialData() - Construct the data for writing in the given format
+	* @initial_size: the amount of bytes to reserve
+	* @_is_compact: whether to write the compact format
+	*/
+	SerialData::SerialData(size_t initial_size, bool _is_compact) :
+		SerialData(initial_size)
+	{
+		is_compact = _is_compact;
+		reset();
+	}
+	/*
+	* SerialData::SerialData() - Construct the data for reading
+	* ! The format is detected from the first byte since the compact header can't be a type tag
+	* @_data: the data to read
+	*/
 	SerialData::SerialData(const std::vector<Uint8>& _data) :
-		data(_data),
-		pos(0),
-		is_writing(false)
+		SerialData(std::vector<Uint8>(_data))
 	{}
+	/*
+	* SerialData::SerialData() - Construct the data for reading without copying it
+	* @_data: the data to read
+	*/
+	SerialData::SerialData(std::vector<Uint8>&& _data) :
+		data(std::move(_data)),
+		pos(0),
+		is_writing(false),
+		is_compact(false)
+	{
+		if ((!data.empty())&&(data[0] & 0x80)) {
+			is_compact = true;
+			pos = 1;
+
+			if (data[0] != COMPACT_HEADER) {
+				messenger::send({"engine", "serialdata"}, E_MESSAGE::ERROR, "Deserialization failed: unsupported compact version " + std::to_string(data[0] & 0x7f));
+				pos = data.size(); // Make every read fail
+			}
+		}
+	}
 
 	int SerialData::reset() {
 		data.clear();
+		if (is_compact) {
+			data.push_back(COMPACT_HEADER);
+		}
 		rewind();
 		return 0;
 	}
 	int SerialData::rewind() {
-		pos = 0;
+		pos = (is_compact) ? 1 : 0; // Skip the compact header
 		return 0;
 	}
 	int SerialData::set_writing(bool _is_writing) {
 		is_writing = _is_writing;
 		return 0;
 	}
+	bool SerialData::get_is_writing() const {
+		return is_writing;
+	}
+	bool SerialData::get_is_compact() const {
+		return is_compact;
+	}
+
+	/*
+	* SerialData::write_varint() - Append the given value as an LEB128 varint
+	* @v: the value to write
+	*/
+	int SerialData::write_varint(Uint64 v) {
+		while (v >= 0x80) {
+			data.push_back(static_cast<Uint8>(v | 0x80));
+			v >>= 7;
+		}
+		data.push_back(static_cast<Uint8>(v));
+
+		pos = data.size();
+
+		return 0;
+	}
+	/*
+	* SerialData::read_varint() - Read an LEB128 varint
+	* @v: the location to store the value
+	*/
+	int SerialData::read_varint(Uint64* v) {
+		*v = 0;
+		for (size_t shift=0; shift<64; shift+=7) {
+			if (pos >= data.size()) {
+				return 1; // Return 1 when the varint is out of bounds
+			}
+
+			const Uint8 b = data[pos++];
+			*v |= static_cast<Uint64>(b & 0x7f) << shift;
+			if (!(b & 0x80)) {
+				return 0; // Return 0 on success
+			}
+		}
+		return 2; // Return 2 when the varint is too long
+	}
+	/*
+	* SerialData::write_fixed() - Append the given amount of bytes of the given value in little-endian order
+	* @v: the value to write
+	* @size: the amount of bytes
+	*/
+	int SerialData::write_fixed(Uint64 v, size_t size) {
+		for (size_t i=0; i<size; ++i) {
+			data.push_back(static_cast<Uint8>(v >> (i*8)));
+		}
+
+		pos = data.size();
+
+		return 0;
+	}
+	/*
+	* SerialData::read_fixed() - Read the given amount of bytes as a little-endian value
+	* @v: the location to store the value
+	* @size: the amount of bytes
+	*/
+	int SerialData::read_fixed(Uint64* v, size_t size) {
+		if (pos+size > data.size()) {
+			return 1; // Return 1 when the value is out of bounds
+		}
+
+		*v = 0;
+		for (size_t i=0; i<size; ++i) {
+			*v |= static_cast<Uint64>(data[pos++]) << (i*8);
+		}
+
+		return 0;
+	}
+	/*
+	* SerialData::write_length() - Append the given container length as a varint
+	* @size: the length to write
+	*/
+	int SerialData::write_length(size_t size) {
+		if (size > 0xffffffff) {
+			messenger::send({"engine", "serialdata"}, E_MESSAGE::WARNING, "Serialization warning: length is larger than 32 bits");
+		}
+		return write_varint(size);
+	}
+	/*
+	* SerialData::read_length() - Read a container length
+	* ! Every element uses at least a byte so lengths which are larger than the remaining data are rejected before allocating
+	* @size: the location to store the length
+	*/
+	int SerialData::read_length(size_t* size) {
+		Uint64 v = 0;
+		if (read_varint(&v)) {
+			return 1; // Return 1 when the length is out of bounds
+		}
+		if ((v > 0xffffffff)||(v > data.size() - pos)) {
+			return 2; // Return 2 when the length is too large
+		}
+
+		*size = static_cast<size_t>(v);
+
+		return 0;
+	}
+	/*
+	* SerialData::write_tag() - Append the given type tag
+	* @type: the type to write
+	*/
+	int SerialData::write_tag(E_DATA_TYPE type) {
+		data.push_back(static_cast<Uint8>(type));
+		pos = data.size();
+		return 0;
+	}
+	/*
+	* SerialData::read_tag() - Read a type tag and check that it matches the given type
+	* @type: the expected type
+	*/
+	int SerialData::read_tag(E_DATA_TYPE type) {
+		if (pos >= data.size()) {
+			return 1; // Return 1 when the tag is out of bounds
+		}
+		if (data[pos++] != static_cast<Uint8>(type)) {
+			return 2; // Return 2 when the tag doesn't match
+		}
+		return 0;
+	}
+
+	E_DATA_TYPE SerialData::get_type(const unsigned char*) {
+		return E_DATA_TYPE::CHAR;
+	}
+	E_DATA_TYPE SerialData::get_type(const int*) {
+		return E_DATA_TYPE::INT;
+	}
+	E_DATA_TYPE SerialData::get_type(const float*) {
+		return E_DATA_TYPE::FLOAT;
+	}
+	E_DATA_TYPE SerialData::get_type(const double*) {
+		return E_DATA_TYPE::DOUBLE;
+	}
+	E_DATA_TYPE SerialData::get_type(const std::string*) {
+		return E_DATA_TYPE::STRING;
+	}
+	E_DATA_TYPE SerialData::get_type(const SIDP*) {
+		return E_DATA_TYPE::SIDP;
+	}
+
+	/*
+	* SerialData::store_sidp() - Store the given SIDP along with a tag for its type in the compact format
+	* ! Plain pointers can't be restored so they are stored as their string representation like in the tagged format
+	* @d: the SIDP to store
+	*/
+	int SerialData::store_sidp(SIDP& d) {
+		if (is_writing) {
+			if (d.get_type() == 3) {
+				if (d.get_container_type() == 1) {
+					std::vector<SIDP>& v = SIDP_v(d);
+					write_tag(E_DATA_TYPE::VECTOR);
+					write_length(v.size());
+					for (auto& e : v) {
+						store_sidp(e);
+					}
+					return 0;
+				} else if (d.get_container_type() == 2) {
+					std::map<SIDP,SIDP>& m = SIDP_m(d);
+					write_tag(E_DATA_TYPE::MAP);
+					write_length(m.size());
+					for (auto& e : m) {
+						SIDP k (e.first);
+						store_sidp(k);
+						store_sidp(e.second);
+					}
+					return 0;
+				}
+			} else if (d.get_type() == 1) {
+				int i = SIDP_i(d);
+				write_tag(E_DATA_TYPE::INT);
+				return store_int(i);
+			} else if (d.get_type() == 2) {
+				double f = SIDP_d(d);
+				write_tag(E_DATA_TYPE::DOUBLE);
+				return store_double(f);
+			}
+
+			std::string s = d.to_str();
+			write_tag(E_DATA_TYPE::STRING);
+			return store_string(s);
+		}
+
+		if (pos >= data.size()) {
+			messenger::send({"engine", "serialdata"}, E_MESSAGE::ERROR, "SIDP deserialization failed: out of bounds");
+			return 1;
+		}
+		switch (static_cast<E_DATA_TYPE>(data[pos++])) {
+			case E_DATA_TYPE::INT: {
+				int i = 0;
+				if (store_int(i)) {
+					return 1;
+				}
+				d = i;
+				return 0;
+			}
+			case E_DATA_TYPE::DOUBLE: {
+				double f = 0.0;
+				if (store_double(f)) {
+					return 1;
+				}
+				d = f;
+				return 0;
+			}
+			case E_DATA_TYPE::STRING: {
+				std::string s;
+				if (store_string(s)) {
+					return 1;
+				}
+				d = SIDP(s, false);
+				return 0;
+			}
+			case E_DATA_TYPE::VECTOR: {
+				size_t size = 0;
+				if (read_length(&size)) {
+					messenger::send({"engine", "serialdata"}, E_MESSAGE::ERROR, "SIDP deserialization failed: out of bounds size");
+					return 1;
+				}
+
+				std::vector<SIDP>* v = new std::vector<SIDP>(size);
+				d.vector(v); // Take ownership before reading the elements so that the vector is freed on failure
+				for (auto& e : *v) {
+					if (store_sidp(e)) {
+						return 1;
+					}
+				}
+				return 0;
+			}
+			case E_DATA_TYPE::MAP: {
+				size_t size = 0;
+				if (read_length(&size)) {
+					messenger::send({"engine", "serialdata"}, E_MESSAGE::ERROR, "SIDP deserialization failed: out of bounds size");
+					return 1;
+				}
+
+				std::map<SIDP,SIDP>* m = new std::map<SIDP,SIDP>();
+				d.map(m);
+				for (size_t i=0; i<size; ++i) {
+					SIDP k, v;
+					if ((store_sidp(k))||(store_sidp(v))) {
+						return 1;
+					}
+					m->emplace(k, v);
+				}
+				return 0;
+			}
+			default: {
+				messenger::send({"engine", "serialdata"}, E_MESSAGE::ERROR, "SIDP deserialization failed: incorrect type");
+				return 2;
+			}
+		}
+	}
 
 	int SerialData::store_char(unsigned char& d) {
+		if (is_compact) {
+			if (is_writing) {
+				data.push_back(d);
+				pos = data.size();
+			} else {
+				if (pos >= data.size()) {
+					messenger::send({"engine", "serialdata"}, E_MESSAGE::ERROR, "Char deserialization failed: out of bounds");
+					return 1;
+				}
+				d = data[pos++];
+			}
+			return 0;
+		}
+
 		if (is_writing) {
 			data.push_back(static_cast<Uint8>(E_DATA_TYPE::CHAR));
 			data.push_back(d);
@@ -70,6 +388,22 @@ namespace bee {
 		/*int min = -32767;
 		int max = 32767;*/
 
+		if (is_compact) { // Store the full 32-bit value as a zig-zag varint so that small negative values stay small
+			if (is_writing) {
+				const Uint32 u = static_cast<Uint32>(d);
+				write_varint((u << 1) ^ static_cast<Uint32>(-static_cast<Sint32>(u >> 31)));
+			} else {
+				Uint64 v = 0;
+				if (read_varint(&v)) {
+					messenger::send({"engine", "serialdata"}, E_MESSAGE::ERROR, "Int deserialization failed: out of bounds");
+					return 1;
+				}
+				const Uint32 u = static_cast<Uint32>(v);
+				d = static_cast<int>((u >> 1) ^ static_cast<Uint32>(-static_cast<Sint32>(u & 1)));
+			}
+			return 0;
+		}
+
 		if (is_writing) {
 			data.push_back(static_cast<Uint8>(E_DATA_TYPE::INT));
 			data.push_back(d >> 8);
@@ -97,6 +431,23 @@ namespace bee {
 		/*int min = -32767;
 		int max = 32767;*/
 
+		if (is_compact) { // Store the exact value
+			Uint32 u = 0;
+			if (is_writing) {
+				memcpy(&u, &d, sizeof(u));
+				write_fixed(u, sizeof(u));
+			} else {
+				Uint64 v = 0;
+				if (read_fixed(&v, sizeof(u))) {
+					messenger::send({"engine", "serialdata"}, E_MESSAGE::ERROR, "Float deserialization failed: out of bounds");
+					return 1;
+				}
+				u = static_cast<Uint32>(v);
+				memcpy(&d, &u, sizeof(d));
+			}
+			return 0;
+		}
+
 		float factor = 100.0f;
 
 		if (is_writing) {
@@ -126,6 +477,21 @@ namespace bee {
 		return 0;
 	}
 	int SerialData::store_double(double& d) {
+		if (is_compact) { // Store the exact value instead of its text
+			Uint64 u = 0;
+			if (is_writing) {
+				memcpy(&u, &d, sizeof(u));
+				write_fixed(u, sizeof(u));
+			} else {
+				if (read_fixed(&u, sizeof(u))) {
+					messenger::send({"engine", "serialdata"}, E_MESSAGE::ERROR, "Double deserialization failed: out of bounds");
+					return 1;
+				}
+				memcpy(&d, &u, sizeof(d));
+			}
+			return 0;
+		}
+
 		if (is_writing) {
 			data.push_back(static_cast<Uint8>(E_DATA_TYPE::DOUBLE));
 
@@ -175,6 +541,23 @@ namespace bee {
 		return 0;
 	}
 	int SerialData::store_string(std::string& d) {
+		if (is_compact) {
+			if (is_writing) {
+				write_length(d.size());
+				data.insert(data.end(), d.begin(), d.end());
+				pos = data.size();
+			} else {
+				size_t size = 0;
+				if (read_length(&size)) {
+					messenger::send({"engine", "serialdata"}, E_MESSAGE::ERROR, "String deserialization failed: out of bounds size");
+					return 1;
+				}
+				d.assign(reinterpret_cast<const char*>(data.data()+pos), size);
+				pos += size;
+			}
+			return 0;
+		}
+
 		if (is_writing) {
 			data.reserve(data.size() + d.size() + 1);
 			data.push_back(static_cast<Uint8>(E_DATA_TYPE::STRING));
@@ -217,6 +600,23 @@ namespace bee {
 		return 0;
 	}
 	int SerialData::store_serial_v(std::vector<Uint8>& d) {
+		if (is_compact) {
+			if (is_writing) {
+				write_length(d.size());
+				data.insert(data.end(), d.begin(), d.end());
+				pos = data.size();
+			} else {
+				size_t size = 0;
+				if (read_length(&size)) {
+					messenger::send({"engine", "serialdata"}, E_MESSAGE::ERROR, "SVector deserialization failed: out of bounds size");
+					return 1;
+				}
+				d.assign(data.begin()+pos, data.begin()+pos+size);
+				pos += size;
+			}
+			return 0;
+		}
+
 		if (is_writing) {
 			data.reserve(data.size() + d.size() + 1);
 			data.push_back(static_cast<Uint8>(E_DATA_TYPE::SERIAL));
@@ -260,6 +660,40 @@ namespace bee {
 		return 0;
 	}
 	int SerialData::store_serial_m(std::map<std::string,std::vector<Uint8>>& d) {
+		if (is_compact) {
+			if (is_writing) {
+				write_tag(E_DATA_TYPE::SERIAL);
+				write_length(d.size());
+				for (auto& e : d) {
+					std::string k (e.first);
+					this->store_string(k);
+					this->store_serial_v(e.second);
+				}
+				return 0;
+			}
+
+			size_t size = 0;
+			if (read_tag(E_DATA_TYPE::SERIAL)) {
+				messenger::send({"engine", "serialdata"}, E_MESSAGE::ERROR, "SMap deserialization failed: incorrect type");
+				return 2;
+			}
+			if (read_length(&size)) {
+				messenger::send({"engine", "serialdata"}, E_MESSAGE::ERROR, "SMap deserialization failed: out of bounds size");
+				return 1;
+			}
+
+			d.clear();
+			for (size_t i=0; i<size; ++i) {
+				std::string k;
+				std::vector<Uint8> v;
+				if ((this->store_string(k))||(this->store_serial_v(v))) {
+					return 1;
+				}
+				d.emplace(std::move(k), std::move(v));
+			}
+			return 0;
+		}
+
 		if (is_writing) {
 			data.reserve(data.size() + d.size() + 1);
 			data.push_back(static_cast<Uint8>(E_DATA_TYPE::SERIAL));
@@ -335,6 +769,13 @@ namespace bee {
 		return 3;
 	}
 	int SerialData::store(SIDP d) {
+		if (is_compact) {
+			if (is_writing) {
+				return store_sidp(d);
+			}
+			return 3;
+		}
+
 		if (is_writing) {
 			std::string s = d.to_str();
 			return store_string(s);
@@ -373,6 +814,13 @@ namespace bee {
 		return 3;
 	}
 	int SerialData::get(SIDP& d) {
+		if (is_compact) {
+			if (!is_writing) {
+				return store_sidp(d);
+			}
+			return 3;
+		}
+
 		if (!is_writing) {
 			std::string s;
 			int r = store_string(s);
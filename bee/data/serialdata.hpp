@@ -11,6 +11,8 @@
 
 #include <vector>
 #include <map>
+#include <type_traits>
+#include <cstring>
 
 #include <SDL2/SDL_net.h>
 
@@ -25,14 +27,50 @@ namespace bee {
 			std::vector<Uint8> data;
 			size_t pos;
 			bool is_writing;
+			bool is_compact; // Whether the data uses the compact format, which stores varints and only tags containers
+
+			// See bee/data/serialdata.cpp for function comments
+			int write_varint(Uint64);
+			int read_varint(Uint64*);
+			int write_fixed(Uint64, size_t);
+			int read_fixed(Uint64*, size_t);
+			int write_length(size_t);
+			int read_length(size_t*);
+			int write_tag(E_DATA_TYPE);
+			int read_tag(E_DATA_TYPE);
+			int store_sidp(SIDP&);
+
+			static E_DATA_TYPE get_type(const unsigned char*);
+			static E_DATA_TYPE get_type(const int*);
+			static E_DATA_TYPE get_type(const float*);
+			static E_DATA_TYPE get_type(const double*);
+			static E_DATA_TYPE get_type(const std::string*);
+			static E_DATA_TYPE get_type(const SIDP*);
+			template <typename A>
+			static E_DATA_TYPE get_type(const std::vector<A>*);
+			template <typename A, typename B>
+			static E_DATA_TYPE get_type(const std::map<A,B>*);
+
+			template <typename A>
+			typename std::enable_if<std::is_floating_point<A>::value||std::is_same<A, unsigned char>::value, int>::type
+			store_elements(std::vector<A>&, size_t);
+			template <typename A>
+			typename std::enable_if<!(std::is_floating_point<A>::value||std::is_same<A, unsigned char>::value), int>::type
+			store_elements(std::vector<A>&, size_t);
 		public:
+			static const Uint8 COMPACT_HEADER; // The first byte of compact data, which contains the format version and can't be mistaken for a type tag
+
 			SerialData();
 			explicit SerialData(size_t);
+			SerialData(size_t, bool);
 			explicit SerialData(const std::vector<Uint8>&);
+			explicit SerialData(std::vector<Uint8>&&);
 
 			int reset();
 			int rewind();
 			int set_writing(bool);
+			bool get_is_writing() const;
+			bool get_is_compact() const;
 
 			int store_char(unsigned char&);
 			int store_int(int&);
@@ -72,8 +110,97 @@ namespace bee {
 			Uint8 peek() const;
 	};
 
+	template <typename A>
+	E_DATA_TYPE SerialData::get_type(const std::vector<A>*) {
+		return E_DATA_TYPE::VECTOR;
+	}
+	template <typename A, typename B>
+	E_DATA_TYPE SerialData::get_type(const std::map<A,B>*) {
+		return E_DATA_TYPE::MAP;
+	}
+
+	/*
+	* SerialData::store_elements() - Store the given amount of floating point or byte elements of a compact vector
+	* ! Since these are stored in little-endian order with a fixed width, they can be copied directly on little-endian platforms
+	* @d: the vector to store, which must already have the given size when reading
+	* @size: the amount of elements
+	*/
+	template <typename A>
+	typename std::enable_if<std::is_floating_point<A>::value||std::is_same<A, unsigned char>::value, int>::type
+	SerialData::store_elements(std::vector<A>& d, size_t size) {
+		#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+			const size_t bytes = size * sizeof(A);
+			if (is_writing) {
+				const Uint8* p = reinterpret_cast<const Uint8*>(d.data());
+				data.insert(data.end(), p, p+bytes);
+				pos = data.size();
+			} else {
+				if (pos+bytes > data.size()) {
+					return 1; // Return 1 when the elements are out of bounds
+				}
+				if (bytes > 0) {
+					memcpy(d.data(), data.data()+pos, bytes);
+				}
+				pos += bytes;
+			}
+		#else
+			for (size_t i=0; i<size; ++i) {
+				int r = (is_writing) ? this->store(d[i]) : this->get(d[i]);
+				if (r != 0) {
+					return r;
+				}
+			}
+		#endif
+
+		return 0;
+	}
+	/*
+	* SerialData::store_elements() - Store the given amount of elements of a compact vector individually
+	* @d: the vector to store, which must already have the given size when reading
+	* @size: the amount of elements
+	*/
+	template <typename A>
+	typename std::enable_if<!(std::is_floating_point<A>::value||std::is_same<A, unsigned char>::value), int>::type
+	SerialData::store_elements(std::vector<A>& d, size_t size) {
+		for (size_t i=0; i<size; ++i) {
+			int r = (is_writing) ? this->store(d[i]) : this->get(d[i]);
+			if (r != 0) {
+				return r;
+			}
+		}
+		return 0;
+	}
+
 	template <typename A>
 	int SerialData::store_vector(std::vector<A>& d) {
+		if (is_compact) { // Store the element type once for the entire vector
+			if (is_writing) {
+				write_tag(E_DATA_TYPE::VECTOR);
+				write_tag(get_type(static_cast<A*>(nullptr)));
+				write_length(d.size());
+				return store_elements(d, d.size());
+			}
+
+			size_t size = 0;
+			if ((read_tag(E_DATA_TYPE::VECTOR))||(read_tag(get_type(static_cast<A*>(nullptr))))) {
+				messenger::send({"engine", "serialdata"}, E_MESSAGE::ERROR, "Vector deserialization failed: incorrect type");
+				return 2;
+			}
+			if (read_length(&size)) {
+				messenger::send({"engine", "serialdata"}, E_MESSAGE::ERROR, "Vector deserialization failed: out of bounds size");
+				return 1;
+			}
+
+			d.clear();
+			d.resize(size);
+			if (store_elements(d, size)) {
+				messenger::send({"engine", "serialdata"}, E_MESSAGE::ERROR, "Vector deserialization failed: out of bounds");
+				return 1;
+			}
+
+			return 0;
+		}
+
 		if (is_writing) {
 			data.reserve(data.size() + d.size() + 1);
 			data.push_back(static_cast<Uint8>(E_DATA_TYPE::VECTOR));
@@ -112,6 +239,51 @@ namespace bee {
 	}
 	template <typename A, typename B>
 	int SerialData::store_map(std::map<A,B>& d) {
+		if (is_compact) { // Store the key and value types once for the entire map
+			if (is_writing) {
+				write_tag(E_DATA_TYPE::MAP);
+				write_tag(get_type(static_cast<A*>(nullptr)));
+				write_tag(get_type(static_cast<B*>(nullptr)));
+				write_length(d.size());
+
+				for (auto& kv : d) {
+					A k = kv.first;
+					B v = kv.second;
+					this->store(k);
+					this->store(v);
+				}
+
+				return 0;
+			}
+
+			size_t size = 0;
+			if (
+				(read_tag(E_DATA_TYPE::MAP))
+				||(read_tag(get_type(static_cast<A*>(nullptr))))
+				||(read_tag(get_type(static_cast<B*>(nullptr))))
+			) {
+				messenger::send({"engine", "serialdata"}, E_MESSAGE::ERROR, "Map deserialization failed: incorrect type");
+				return 2;
+			}
+			if (read_length(&size)) {
+				messenger::send({"engine", "serialdata"}, E_MESSAGE::ERROR, "Map deserialization failed: out of bounds size");
+				return 1;
+			}
+
+			d.clear();
+			for (size_t i=0; i<size; ++i) {
+				A k;
+				B v;
+				if ((this->get(k))||(this->get(v))) {
+					messenger::send({"engine", "serialdata"}, E_MESSAGE::ERROR, "Map deserialization failed: out of bounds");
+					return 1;
+				}
+				d.emplace(k, v);
+			}
+
+			return 0;
+		}
+
 		if (is_writing) {
 			data.reserve(data.size() + d.size() + 1);
 			data.push_back(static_cast<Uint8>(E_DATA_TYPE::MAP));
@@ -155,6 +327,51 @@ namespace bee {
 	}
 	template <typename T, typename A, typename B>
 	int SerialData::store_map_v(std::map<A,B>& d) {
+		if (is_compact) { // Store the key type once for the entire map, each vector stores its own element type
+			if (is_writing) {
+				write_tag(E_DATA_TYPE::MAP);
+				write_tag(get_type(static_cast<A*>(nullptr)));
+				write_tag(E_DATA_TYPE::VECTOR);
+				write_length(d.size());
+
+				for (auto& kv : d) {
+					A k = kv.first;
+					B v = kv.second;
+					this->store(k);
+					this->store_vector(v);
+				}
+
+				return 0;
+			}
+
+			size_t size = 0;
+			if (
+				(read_tag(E_DATA_TYPE::MAP))
+				||(read_tag(get_type(static_cast<A*>(nullptr))))
+				||(read_tag(E_DATA_TYPE::VECTOR))
+			) {
+				messenger::send({"engine", "serialdata"}, E_MESSAGE::ERROR, "Map deserialization failed: incorrect type");
+				return 2;
+			}
+			if (read_length(&size)) {
+				messenger::send({"engine", "serialdata"}, E_MESSAGE::ERROR, "Map deserialization failed: out of bounds size");
+				return 1;
+			}
+
+			d.clear();
+			for (size_t i=0; i<size; ++i) {
+				A k;
+				B v;
+				if ((this->get(k))||(this->store_vector(v))) {
+					messenger::send({"engine", "serialdata"}, E_MESSAGE::ERROR, "Map deserialization failed: out of bounds");
+					return 1;
+				}
+				d.emplace(k, v);
+			}
+
+			return 0;
+		}
+
 		if (is_writing) {
 			data.reserve(data.size() + d.size() + 1);
 			data.push_back(static_cast<Uint8>(E_DATA_TYPE::MAP));
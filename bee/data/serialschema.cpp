@@ -0,0 +1,414 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef BEE_DATA_SERIALSCHEMA
+#define BEE_DATA_SERIALSCHEMA 1
+
+#include "serialschema.hpp" // Include the engine headers
+
+#include "sidp.hpp"
+#include "serialdata.hpp"
+
+#include "../util/template/string.hpp"
+
+#include "../messenger/messenger.hpp"
+
+/*
+	Record format {
+		hash, // The schema hash as an int, which is checked before reading the fields
+		fields... // Each field in the schema order without any names or scalar type tags,
+		          // nested records are stored inline with their own hash
+	}
+*/
+
+namespace bee {
+	namespace internal {
+		/*
+		* serialschema_get() - Convert the given SIDP to the given field type
+		* ! Missing fields are represented by an empty SIDP and are converted to the default value of the type
+		* @s: the SIDP to convert
+		* @d: the location to store the value
+		*/
+		void serialschema_get(const SIDP& s, unsigned char* d) {
+			*d = (s.get_type() == -1) ? 0 : static_cast<unsigned char>(SIDP_i(s));
+		}
+		void serialschema_get(const SIDP& s, int* d) {
+			*d = (s.get_type() == -1) ? 0 : SIDP_i(s);
+		}
+		void serialschema_get(const SIDP& s, float* d) {
+			*d = (s.get_type() == -1) ? 0.0f : static_cast<float>(SIDP_d(s));
+		}
+		void serialschema_get(const SIDP& s, double* d) {
+			*d = (s.get_type() == -1) ? 0.0 : SIDP_d(s);
+		}
+		void serialschema_get(const SIDP& s, std::string* d) {
+			*d = (s.get_type() == -1) ? std::string() : s.to_str();
+		}
+		void serialschema_get(const SIDP& s, SIDP* d) {
+			*d = s;
+		}
+
+		/*
+		* serialschema_set() - Convert the given field value to an SIDP
+		* @d: the value to convert
+		*/
+		SIDP serialschema_set(unsigned char d) {
+			return SIDP(static_cast<int>(d));
+		}
+		SIDP serialschema_set(int d) {
+			return SIDP(d);
+		}
+		SIDP serialschema_set(float d) {
+			return SIDP(static_cast<double>(d));
+		}
+		SIDP serialschema_set(double d) {
+			return SIDP(d);
+		}
+		SIDP serialschema_set(const std::string& d) {
+			return SIDP(d, false);
+		}
+		SIDP serialschema_set(const SIDP& d) {
+			return d;
+		}
+
+		/*
+		* serialschema_store_vector() - Store the given SIDP as a vector with the given element type
+		* @sd: the data to store in or read from
+		* @v: the SIDP to store
+		*/
+		template <typename A>
+		int serialschema_store_vector(SerialData* sd, SIDP* v) {
+			std::vector<A> d;
+			if (sd->get_is_writing()) {
+				if ((v->get_type() == 3)&&(v->get_container_type() == 1)) {
+					for (auto& e : SIDP_v((*v))) {
+						A a;
+						serialschema_get(e, &a);
+						d.push_back(a);
+					}
+				}
+				return sd->store_vector(d);
+			}
+
+			if (sd->store_vector(d)) {
+				return 1;
+			}
+
+			std::vector<SIDP>* sv = new std::vector<SIDP>();
+			sv->reserve(d.size());
+			for (auto& e : d) {
+				sv->push_back(serialschema_set(e));
+			}
+			v->vector(sv);
+
+			return 0;
+		}
+		/*
+		* serialschema_store_map() - Store the given SIDP as a map of strings to the given value type
+		* @sd: the data to store in or read from
+		* @v: the SIDP to store
+		*/
+		template <typename A>
+		int serialschema_store_map(SerialData* sd, SIDP* v) {
+			std::map<std::string,A> d;
+			if (sd->get_is_writing()) {
+				if ((v->get_type() == 3)&&(v->get_container_type() == 2)) {
+					for (auto& e : SIDP_m((*v))) {
+						A a;
+						serialschema_get(e.second, &a);
+						d.emplace(e.first.to_str(), a);
+					}
+				}
+				return sd->store_map(d);
+			}
+
+			if (sd->store_map(d)) {
+				return 1;
+			}
+
+			std::map<SIDP,SIDP>* sm = new std::map<SIDP,SIDP>();
+			for (auto& e : d) {
+				sm->emplace(SIDP(e.first, false), serialschema_set(e.second));
+			}
+			v->map(sm);
+
+			return 0;
+		}
+		/*
+		* serialschema_store_scalar() - Store the given SIDP as the given scalar type
+		* @sd: the data to store in or read from
+		* @v: the SIDP to store
+		*/
+		template <typename A>
+		int serialschema_store_scalar(SerialData* sd, SIDP* v) {
+			A d;
+			if (sd->get_is_writing()) {
+				serialschema_get(*v, &d);
+				return sd->store(d);
+			}
+
+			if (sd->get(d)) {
+				return 1;
+			}
+			*v = serialschema_set(d);
+
+			return 0;
+		}
+		/*
+		* serialschema_store_elements() - Store the given SIDP as a container of the given element type
+		* @sd: the data to store in or read from
+		* @is_map: whether to store a map instead of a vector
+		* @type: the element type
+		* @v: the SIDP to store
+		*/
+		int serialschema_store_elements(SerialData* sd, bool is_map, E_DATA_TYPE type, SIDP* v) {
+			switch (type) {
+				case E_DATA_TYPE::CHAR: {
+					return (is_map) ? serialschema_store_map<unsigned char>(sd, v) : serialschema_store_vector<unsigned char>(sd, v);
+				}
+				case E_DATA_TYPE::INT: {
+					return (is_map) ? serialschema_store_map<int>(sd, v) : serialschema_store_vector<int>(sd, v);
+				}
+				case E_DATA_TYPE::FLOAT: {
+					return (is_map) ? serialschema_store_map<float>(sd, v) : serialschema_store_vector<float>(sd, v);
+				}
+				case E_DATA_TYPE::DOUBLE: {
+					return (is_map) ? serialschema_store_map<double>(sd, v) : serialschema_store_vector<double>(sd, v);
+				}
+				case E_DATA_TYPE::STRING: {
+					return (is_map) ? serialschema_store_map<std::string>(sd, v) : serialschema_store_vector<std::string>(sd, v);
+				}
+				case E_DATA_TYPE::SIDP: {
+					return (is_map) ? serialschema_store_map<SIDP>(sd, v) : serialschema_store_vector<SIDP>(sd, v);
+				}
+				default: {
+					return 2; // Return 2 when the element type can't be stored
+				}
+			}
+		}
+	}
+
+	/*
+	* SerialField::SerialField() - Construct a scalar field
+	* @_name: the name of the field
+	* @_type: the type of the field
+	*/
+	SerialField::SerialField(const std::string& _name, E_DATA_TYPE _type) :
+		name(_name),
+		type(_type),
+		element_type(E_DATA_TYPE::CHAR),
+		schema(nullptr)
+	{}
+	/*
+	* SerialField::SerialField() - Construct a vector or map field
+	* @_name: the name of the field
+	* @_type: the type of the field, either VECTOR or MAP
+	* @_element_type: the type of the elements
+	*/
+	SerialField::SerialField(const std::string& _name, E_DATA_TYPE _type, E_DATA_TYPE _element_type) :
+		name(_name),
+		type(_type),
+		element_type(_element_type),
+		schema(nullptr)
+	{}
+	/*
+	* SerialField::SerialField() - Construct a nested record field
+	* @_name: the name of the field
+	* @_schema: the schema of the nested record
+	*/
+	SerialField::SerialField(const std::string& _name, const SerialSchema* _schema) :
+		name(_name),
+		type(E_DATA_TYPE::SERIAL),
+		element_type(E_DATA_TYPE::CHAR),
+		schema(_schema)
+	{}
+
+	/*
+	* SerialSchema::SerialSchema() - Construct the schema and hash its fields
+	* ! Nested schemas must be constructed first since their hashes are included
+	* @_name: the name of the record type
+	* @_fields: the ordered fields of the record
+	*/
+	SerialSchema::SerialSchema(const std::string& _name, const std::vector<SerialField>& _fields) :
+		name(_name),
+		fields(_fields),
+		hash(2166136261u)
+	{
+		// Compute the FNV-1a hash of the layout so that records from a different layout are rejected
+		auto add = [this] (Uint32 c) {
+			hash = (hash ^ c) * 16777619u;
+		};
+		for (char c : name) {
+			add(static_cast<Uint8>(c));
+		}
+		for (auto& f : fields) {
+			add(0);
+			for (char c : f.name) {
+				add(static_cast<Uint8>(c));
+			}
+			add(static_cast<Uint32>(f.type));
+			add(static_cast<Uint32>(f.element_type));
+			if (f.schema != nullptr) {
+				add(f.schema->get_hash());
+			}
+		}
+	}
+
+	const std::string& SerialSchema::get_name() const {
+		return name;
+	}
+	const std::vector<SerialField>& SerialSchema::get_fields() const {
+		return fields;
+	}
+	Uint32 SerialSchema::get_hash() const {
+		return hash;
+	}
+
+	/*
+	* SerialSchema::store_header() - Store the schema hash at the start of a record or verify it when reading
+	* @sd: the data to store in or read from
+	*/
+	int SerialSchema::store_header(SerialData* sd) const {
+		int h = static_cast<int>(hash);
+		if (sd->store_int(h)) {
+			return 1; // Return 1 when the header is out of bounds
+		}
+
+		if (static_cast<Uint32>(h) != hash) {
+			messenger::send({"engine", "serialschema"}, E_MESSAGE::WARNING, "Failed to read " + name + " record: the schema doesn't match");
+			return 2; // Return 2 when the record has a different layout
+		}
+
+		return 0; // Return 0 on success
+	}
+	/*
+	* SerialSchema::store_field() - Store the given SIDP as the type of the given field
+	* @sd: the data to store in or read from
+	* @field: the field to store
+	* @v: the value of the field, which is converted to or from the field type
+	*/
+	int SerialSchema::store_field(SerialData* sd, const SerialField& field, SIDP* v) const {
+		switch (field.type) {
+			case E_DATA_TYPE::CHAR: {
+				return internal::serialschema_store_scalar<unsigned char>(sd, v);
+			}
+			case E_DATA_TYPE::INT: {
+				return internal::serialschema_store_scalar<int>(sd, v);
+			}
+			case E_DATA_TYPE::FLOAT: {
+				return internal::serialschema_store_scalar<float>(sd, v);
+			}
+			case E_DATA_TYPE::DOUBLE: {
+				return internal::serialschema_store_scalar<double>(sd, v);
+			}
+			case E_DATA_TYPE::STRING: {
+				return internal::serialschema_store_scalar<std::string>(sd, v);
+			}
+			case E_DATA_TYPE::SIDP: {
+				return internal::serialschema_store_scalar<SIDP>(sd, v);
+			}
+			case E_DATA_TYPE::VECTOR: {
+				return internal::serialschema_store_elements(sd, false, field.element_type, v);
+			}
+			case E_DATA_TYPE::MAP: {
+				return internal::serialschema_store_elements(sd, true, field.element_type, v);
+			}
+			case E_DATA_TYPE::SERIAL: {
+				if (field.schema == nullptr) {
+					return 2;
+				}
+
+				if (sd->get_is_writing()) {
+					if ((v->get_type() == 3)&&(v->get_container_type() == 2)) {
+						return field.schema->store(sd, &SIDP_m((*v)));
+					}
+
+					std::map<SIDP,SIDP> empty;
+					return field.schema->store(sd, &empty);
+				}
+
+				std::map<SIDP,SIDP>* m = new std::map<SIDP,SIDP>();
+				v->map(m);
+				return field.schema->store(sd, m);
+			}
+		}
+
+		return 2; // Return 2 when the field type can't be stored
+	}
+	/*
+	* SerialSchema::store() - Store a record from the given map of field names or read a record into it
+	* ! This is only used for the debugging text format, the serialized types store their fields directly
+	* @sd: the compact data to store in or read from
+	* @m: the map of field names to values
+	*/
+	int SerialSchema::store(SerialData* sd, std::map<SIDP,SIDP>* m) const {
+		if (!sd->get_is_compact()) {
+			return 3; // Return 3 when the data is not in the compact format
+		}
+
+		int r = store_header(sd);
+		if (r) {
+			return r; // Return 1 or 2 when the header is invalid
+		}
+
+		for (auto& f : fields) {
+			const SIDP key (f.name, false);
+			if (sd->get_is_writing()) {
+				SIDP v;
+				auto it = m->find(key);
+				if (it != m->end()) {
+					v = it->second;
+				}
+				store_field(sd, f, &v);
+			} else {
+				SIDP v;
+				if (store_field(sd, f, &v)) {
+					messenger::send({"engine", "serialschema"}, E_MESSAGE::WARNING, "Failed to read " + name + " record: invalid field \"" + f.name + "\"");
+					return 1; // Return 1 when a field is out of bounds or has the wrong type
+				}
+				(*m)[key] = v;
+			}
+		}
+
+		return 0; // Return 0 on success
+	}
+
+	/*
+	* SerialSchema::to_text() - Convert the given record to the text map format for debugging
+	* @data: the compact record
+	* @should_pretty_print: whether the map should be printed in a human readable format
+	*/
+	std::string SerialSchema::to_text(const std::vector<Uint8>& data, bool should_pretty_print) const {
+		SerialData sd (data);
+		std::map<SIDP,SIDP> m;
+		if (store(&sd, &m)) {
+			return std::string(); // Return an empty string when the record is invalid
+		}
+		return map_serialize(m, should_pretty_print);
+	}
+	/*
+	* SerialSchema::from_text() - Convert the given text map to a compact record
+	* ! Missing fields are stored as their default value
+	* @text: the text map
+	* @data: the location to store the record
+	*/
+	int SerialSchema::from_text(const std::string& text, std::vector<Uint8>* data) const {
+		std::map<SIDP,SIDP> m;
+		if (map_deserialize(text, &m)) {
+			return 1; // Return 1 when the text is not a map
+		}
+
+		SerialData sd (256, true);
+		store(&sd, &m);
+		*data = sd.get();
+
+		return 0; // Return 0 on success
+	}
+}
+
+#endif // BEE_DATA_SERIALSCHEMA
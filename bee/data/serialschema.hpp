@@ -0,0 +1,60 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef BEE_DATA_SERIALSCHEMA_H
+#define BEE_DATA_SERIALSCHEMA_H 1
+
+#include <string>
+#include <vector>
+#include <map>
+
+#include <SDL2/SDL.h> // Include the required SDL headers for Uint8
+
+#include "../enum.hpp"
+
+namespace bee {
+	// Forward declarations
+	class SIDP;
+	class SerialData;
+	class SerialSchema;
+
+	struct SerialField { // A single typed field of a record
+		std::string name;
+		E_DATA_TYPE type;
+		E_DATA_TYPE element_type; // The element type of vectors and the value type of maps, whose keys are always strings
+		const SerialSchema* schema; // The schema of nested records, which are stored inline when the type is SERIAL
+
+		SerialField(const std::string&, E_DATA_TYPE);
+		SerialField(const std::string&, E_DATA_TYPE, E_DATA_TYPE);
+		SerialField(const std::string&, const SerialSchema*);
+	};
+
+	class SerialSchema { // An ordered list of typed fields which describes a record in the compact SerialData format
+			std::string name;
+			std::vector<SerialField> fields;
+			Uint32 hash; // A hash of the field names and types which is stored at the start of each record
+
+			// See bee/data/serialschema.cpp for function comments
+			int store_field(SerialData*, const SerialField&, SIDP*) const;
+		public:
+			// See bee/data/serialschema.cpp for function comments
+			SerialSchema(const std::string&, const std::vector<SerialField>&);
+
+			const std::string& get_name() const;
+			const std::vector<SerialField>& get_fields() const;
+			Uint32 get_hash() const;
+
+			int store_header(SerialData*) const;
+			int store(SerialData*, std::map<SIDP,SIDP>*) const;
+
+			std::string to_text(const std::vector<Uint8>&, bool) const;
+			int from_text(const std::string&, std::vector<Uint8>*) const;
+	};
+}
+
+#endif // BEE_DATA_SERIALSCHEMA_H
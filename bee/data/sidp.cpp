@@ -10,6 +10,8 @@
 #define BEE_DATA_SIDP 1
 
 #include <regex>
+#include <cstring>
+#include <algorithm>
 
 #include "sidp.hpp" // Include the engine headers
 
@@ -23,40 +25,36 @@
 #include "../messenger/messenger.hpp"
 
 namespace bee {
+	static_assert(sizeof(SIDP) <= 24, "SIDP should fit in 24 bytes so that containers of them stay compact");
+
 	SIDP::SIDP() :
-		type(-1), // Possible types: 0=string, 1=int, 2=double, 3=pointer
-		container_type(0), // Possible containers: 0=plain, 1=vector, 2=map
-		str(),
-		integer(0),
-		floating(0.0),
-		pointer(nullptr)
+		pointer(nullptr),
+		length(0),
+		type(-1), // Possible types: -1=none, 0=string, 1=int, 2=double, 3=pointer
+		container_type(0) // Possible containers: 0=plain, 1=vector, 2=map
 	{}
 	SIDP::SIDP(const SIDP& sidp) :
-		type(sidp.type),
-		container_type(sidp.container_type),
-		str(sidp.str),
-		integer(sidp.integer),
-		floating(sidp.floating),
-		pointer(nullptr)
+		SIDP()
 	{
-		if (container_type == 1) {
-			pointer = new std::vector<SIDP>(*static_cast<std::vector<SIDP>*>(sidp.pointer));
-		} else if (container_type == 2) {
-			pointer = new std::map<SIDP,SIDP>(*static_cast<std::map<SIDP,SIDP>*>(sidp.pointer));
-		} else {
-			pointer = sidp.pointer;
-		}
+		*this = sidp;
+	}
+	/*
+	* SIDP::SIDP() - Construct the SIDP by taking the value of the given SIDP
+	* ! Strings and containers are moved without copying, and the given SIDP is left without a type
+	* @sidp: the SIDP to move from
+	*/
+	SIDP::SIDP(SIDP&& sidp) noexcept :
+		SIDP()
+	{
+		take(&sidp);
 	}
 	SIDP::SIDP(const std::string& ns, bool should_interpret) :
-		type(0),
-		container_type(0),
-		str(ns),
-		integer(0),
-		floating(0.0),
-		pointer(nullptr)
+		SIDP()
 	{
 		if (should_interpret) {
 			interpret(ns);
+		} else {
+			set_str(ns.data(), ns.length());
 		}
 	}
 	SIDP::SIDP(const std::string& ns) :
@@ -66,29 +64,23 @@ namespace bee {
 		SIDP(std::string(c_str), true)
 	{}
 	SIDP::SIDP(int ni) :
-		type(1),
-		container_type(0),
-		str(),
-		integer(ni),
-		floating(0.0),
-		pointer(nullptr)
-	{}
+		SIDP()
+	{
+		type = 1;
+		integer = ni;
+	}
 	SIDP::SIDP(double nf) :
-		type(2),
-		container_type(0),
-		str(),
-		integer(0),
-		floating(nf),
-		pointer(nullptr)
-	{}
+		SIDP()
+	{
+		type = 2;
+		floating = nf;
+	}
 	SIDP::SIDP(void* np) :
-		type(3),
-		container_type(0),
-		str(),
-		integer(0),
-		floating(0.0),
-		pointer(np)
-	{}
+		SIDP()
+	{
+		type = 3;
+		pointer = np;
+	}
 	SIDP::SIDP(std::vector<SIDP>* nv) :
 		SIDP()
 	{
@@ -104,7 +96,9 @@ namespace bee {
 	}
 
 	int SIDP::reset() {
-		if (pointer != nullptr) {
+		if ((type == 0)&&(length > SSO_SIZE)) {
+			delete[] chars;
+		} else if ((type == 3)&&(pointer != nullptr)) {
 			if (container_type == 1) {
 				delete static_cast<std::vector<SIDP>*>(pointer);
 			} else if (container_type == 2) {
@@ -115,10 +109,88 @@ namespace bee {
 		type = -1;
 		container_type = 0;
 
-		str.clear();
-		integer = 0;
-		floating = 0.0;
 		pointer = nullptr;
+		length = 0;
+
+		return 0;
+	}
+
+	/*
+	* SIDP::set_str() - Replace the value with a copy of the given string
+	* ! Strings up to SSO_SIZE characters are stored inline and longer ones are copied to a heap buffer
+	* @cs: the characters of the string, which must not point into this SIDP
+	* @len: the length of the string
+	*/
+	int SIDP::set_str(const char* cs, size_t len) {
+		reset();
+
+		type = 0;
+		length = static_cast<Uint32>(len);
+
+		char* dest = sso;
+		if (len > SSO_SIZE) {
+			chars = new char[len+1];
+			dest = chars;
+		}
+		if (len > 0) {
+			std::memcpy(dest, cs, len);
+		}
+		dest[len] = '\0';
+
+		return 0;
+	}
+	/*
+	* SIDP::get_chars() - Return the null-terminated characters of the string value
+	* ! This must only be called when the type is a string
+	*/
+	const char* SIDP::get_chars() const {
+		if (length > SSO_SIZE) {
+			return chars;
+		}
+		return sso;
+	}
+	/*
+	* SIDP::take() - Replace the value with the value of the given SIDP, which is left without a type
+	* @sidp: the SIDP to take the value from
+	*/
+	int SIDP::take(SIDP* sidp) {
+		reset();
+
+		type = sidp->type;
+		container_type = sidp->container_type;
+		length = sidp->length;
+
+		switch (type) {
+			case 0: {
+				if (length > SSO_SIZE) {
+					chars = sidp->chars;
+				} else {
+					std::memcpy(sso, sidp->sso, length+1);
+				}
+				break;
+			}
+			case 1: {
+				integer = sidp->integer;
+				break;
+			}
+			case 2: {
+				floating = sidp->floating;
+				break;
+			}
+			case 3: {
+				pointer = sidp->pointer;
+				break;
+			}
+			default: {
+				break;
+			}
+		}
+
+		// Clear the given SIDP without freeing the value which now belongs to this one
+		sidp->type = -1;
+		sidp->container_type = 0;
+		sidp->pointer = nullptr;
+		sidp->length = 0;
 
 		return 0;
 	}
@@ -126,9 +198,10 @@ namespace bee {
 	int SIDP::interpret(const std::string& ns) {
 		reset();
 		try {
-			if ((ns[0] == '"')&&(ns[ns.length()-1] == '"')) { // String
-				str = ns.substr(1, ns.length()-2);
-				type = 0;
+			if (ns.empty()) { // Empty string
+				set_str(ns.data(), 0);
+			} else if ((ns.length() >= 2)&&(ns[0] == '"')&&(ns[ns.length()-1] == '"')) { // String
+				set_str(ns.data()+1, ns.length()-2);
 			} else if ((ns[0] == '[')&&(ns[ns.length()-1] == ']')) { // Array
 				std::vector<SIDP>* v = new std::vector<SIDP>();
 				vector_deserialize(ns, v);
@@ -151,15 +224,13 @@ namespace bee {
 					integer = 0;
 				}
 			} else { // Probably a string
-				str = ns;
-				type = 0;
+				set_str(ns.data(), ns.length());
 			}
 		} catch (const std::invalid_argument) {}
 
 		if (type == -1) { // No possible type, this will only occur when std::stod or std::stoi fails
 			messenger::send({"engine", "sidp"}, E_MESSAGE::WARNING, "WARN: SIDP type not determined, storing as string: \"" + ns + "\"");
-			type = 0;
-			str = ns;
+			set_str(ns.data(), ns.length());
 		}
 
 		return 0; // Return 0 on success
@@ -181,7 +252,7 @@ namespace bee {
 	std::string SIDP::to_str() const {
 		switch (type) {
 			case 0: {
-				return str;
+				return std::string(get_chars(), length);
 			}
 			case 1: {
 				return std::to_string(integer);
@@ -206,12 +277,20 @@ namespace bee {
 		}
 	}
 
+	int SIDP::get_type() const {
+		return type;
+	}
+	int SIDP::get_container_type() const {
+		return container_type;
+	}
+
 	// Return the requested type
 	std::string SIDP::s(const std::string& file, int line) const {
 		if (type != 0) {
 			messenger::send({"engine", "sidp"}, E_MESSAGE::WARNING, "Type is " + bee_itos(type) + ", not a string but the string was requested, called from " + file + ":" + bee_itos(line));
+			return std::string();
 		}
-		return str;
+		return std::string(get_chars(), length);
 	}
 	int SIDP::i(const std::string& file, int line) const {
 		if ((type != 1)&&(type != 2)) {
@@ -219,6 +298,8 @@ namespace bee {
 		}
 		if (type == 2) {
 			return static_cast<int>(floating);
+		} else if (type != 1) {
+			return 0;
 		}
 		return integer;
 	}
@@ -228,12 +309,15 @@ namespace bee {
 		}
 		if (type == 1) {
 			return static_cast<double>(integer);
+		} else if (type != 2) {
+			return 0.0;
 		}
 		return floating;
 	}
 	void* SIDP::p(const std::string& file, int line) const {
 		if (type != 3) {
 			messenger::send({"engine", "sidp"}, E_MESSAGE::WARNING, "Type is " + bee_itos(type) + ", not a pointer but the pointer was requested, called from " + file + ":" + bee_itos(line));
+			return nullptr;
 		}
 		return pointer;
 	}
@@ -285,15 +369,16 @@ namespace bee {
 			return *this;
 		}
 
+		if (rhs.type == 0) {
+			set_str(rhs.get_chars(), rhs.length);
+			return *this;
+		}
+
 		reset();
 		this->type = rhs.type;
 		this->container_type = rhs.container_type;
 
 		switch (rhs.type) {
-			case 0: {
-				this->str = rhs.str;
-				break;
-			}
 			case 1: {
 				this->integer = rhs.integer;
 				break;
@@ -320,16 +405,18 @@ namespace bee {
 
 		return *this;
 	}
+	SIDP& SIDP::operator=(SIDP&& rhs) noexcept {
+		if (this != &rhs) {
+			take(&rhs);
+		}
+		return *this;
+	}
 	SIDP& SIDP::operator=(const std::string& rhs) {
-		reset();
-		type = 0;
-		str = rhs;
+		set_str(rhs.data(), rhs.length());
 		return *this;
 	}
 	SIDP& SIDP::operator=(const char* rhs) {
-		reset();
-		type = 0;
-		str = std::string(rhs);
+		set_str(rhs, std::strlen(rhs));
 		return *this;
 	}
 	SIDP& SIDP::operator=(int rhs) {
@@ -351,17 +438,19 @@ namespace bee {
 		return *this;
 	}
 	SIDP& SIDP::operator=(const std::vector<SIDP>& rhs) {
+		std::vector<SIDP>* c = new std::vector<SIDP>(rhs); // Copy before resetting in case rhs is the current container
 		reset();
 		type = 3;
 		container_type = 1;
-		pointer = new std::vector<SIDP>(rhs);
+		pointer = c;
 		return *this;
 	}
 	SIDP& SIDP::operator=(const std::map<SIDP,SIDP>& rhs) {
+		std::map<SIDP,SIDP>* c = new std::map<SIDP,SIDP>(rhs); // Copy before resetting in case rhs is the current container
 		reset();
 		type = 3;
 		container_type = 2;
-		pointer = new std::map<SIDP,SIDP>(rhs);
+		pointer = c;
 		return *this;
 	}
 
@@ -372,7 +461,9 @@ namespace bee {
 
 		switch (this->type) {
 			case 0: {
-				this->str += rhs.str;
+				std::string ns (get_chars(), length);
+				ns.append(rhs.get_chars(), rhs.length);
+				set_str(ns.data(), ns.length());
 				break;
 			}
 			case 1: {
@@ -473,7 +564,11 @@ namespace bee {
 		} else {
 			switch (a.type) {
 				case 0: {
-					return (a.str < b.str);
+					const int c = std::memcmp(a.get_chars(), b.get_chars(), std::min(a.length, b.length));
+					if (c != 0) {
+						return (c < 0);
+					}
+					return (a.length < b.length);
 				}
 				case 1: {
 					return (a.integer < b.integer);
@@ -493,7 +588,7 @@ namespace bee {
 	std::ostream& operator<<(std::ostream& os, const SIDP& sidp) {
 		switch (sidp.type) {
 			case 0: {
-				os << sidp.str;
+				os.write(sidp.get_chars(), sidp.length);
 				break;
 			}
 			case 1: {
@@ -9,22 +9,35 @@
 #ifndef BEE_DATA_SIDP_H
 #define BEE_DATA_SIDP_H 1
 
+#include <string>
 #include <map>
 #include <vector>
 
+#include <SDL2/SDL.h> // Include the required SDL headers for Uint32
+
 namespace bee {
 	class SIDP { // This class can hold a string, integer, double, or pointer and is meant to allow multiple types in the same container
-		int type; // Possible types: 0=string, 1=int, 2=double, 3=pointer
-		int container_type;
-
-		std::string str;
-		int integer;
-		double floating;
-		void* pointer;
-
+		static const size_t SSO_SIZE = 15; // The maximum length of strings which are stored without allocating
+
+		union { // Only the member for the current type is valid
+			int integer;
+			double floating;
+			void* pointer; // Either a plain pointer or an owned vector or map, see container_type
+			char* chars; // The null-terminated heap buffer of long strings
+			char sso[SSO_SIZE+1]; // The null-terminated inline buffer of short strings
+		};
+		Uint32 length; // The length of the string
+		Sint8 type; // Possible types: -1=none, 0=string, 1=int, 2=double, 3=pointer
+		Uint8 container_type; // Possible containers: 0=plain, 1=vector, 2=map
+
+		// See bee/data/sidp.cpp for function comments
+		int set_str(const char*, size_t);
+		const char* get_chars() const;
+		int take(SIDP*);
 	public:
 		SIDP();
 		SIDP(const SIDP&);
+		SIDP(SIDP&&) noexcept;
 		SIDP(const std::string&, bool);
 		SIDP(const std::string&);
 		SIDP(const char*);
@@ -40,6 +53,8 @@ namespace bee {
 		int vector(std::vector<SIDP>*);
 		int map(std::map<SIDP,SIDP>*);
 		std::string to_str() const;
+		int get_type() const;
+		int get_container_type() const;
 
 		// Return the requested type
 		std::string s(const std::string&, int) const;
@@ -52,6 +67,7 @@ namespace bee {
 		std::map<SIDP,SIDP>& m(const std::string&, int) const;
 
 		SIDP& operator=(const SIDP&);
+		SIDP& operator=(SIDP&&) noexcept;
 		SIDP& operator=(const std::string&);
 		SIDP& operator=(const char*);
 		SIDP& operator=(int);
@@ -90,7 +106,7 @@ namespace bee {
 #define SIDP_v(x) x.v(__FILE__, __LINE__)
 #define SIDP_m(x) x.m(__FILE__, __LINE__)
 
-// Shorthand for easier Instance data debugging
+// Shorthand for easier Instance data debugging, the keys can be either names or ids from DataMap::get_key()
 #define _a(x) (*s)[x]
 #define _s(x) (*s)[x].s(__FILE__, __LINE__)
 #define _i(x) (*s)[x].i(__FILE__, __LINE__)
@@ -0,0 +1,226 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef BEE_DATA_SPATIALGRID
+#define BEE_DATA_SPATIALGRID 1
+
+#include "../defines.hpp"
+
+#include <algorithm> // Include the required library headers
+
+#include "spatialgrid.hpp" // Include the engine headers
+
+namespace bee {
+	/*
+	* SpatialGridEntry::SpatialGridEntry() - Construct the data struct and initialize all values
+	*/
+	SpatialGridEntry::SpatialGridEntry() :
+		rect({0, 0, 0, 0}),
+		x1(0),
+		y1(0),
+		x2(-1),
+		y2(-1)
+	{}
+
+	/*
+	* SpatialGrid::SpatialGrid() - Construct the grid with the default cell size
+	*/
+	SpatialGrid::SpatialGrid() :
+		SpatialGrid(BEE_GRID_CELL_SIZE)
+	{}
+	/*
+	* SpatialGrid::SpatialGrid() - Construct the grid with the given cell size
+	* @_cell_size: the width and height of each cell
+	*/
+	SpatialGrid::SpatialGrid(int _cell_size) :
+		cell_size(std::max(_cell_size, 1)),
+		cells(),
+		entries()
+	{}
+
+	/*
+	* SpatialGrid::get_key() - Return the map key for the given cell coordinates
+	* @cx: the x-coordinate of the cell
+	* @cy: the y-coordinate of the cell
+	*/
+	Uint64 SpatialGrid::get_key(int cx, int cy) const {
+		return (static_cast<Uint64>(static_cast<Uint32>(cx)) << 32) | static_cast<Uint32>(cy);
+	}
+	/*
+	* SpatialGrid::get_cell() - Return the cell coordinate which contains the given coordinate
+	* ! Negative coordinates are rounded down so that cell 0 doesn't cover twice the area
+	* @p: the coordinate to convert
+	*/
+	int SpatialGrid::get_cell(int p) const {
+		if (p < 0) {
+			return -((-p-1) / cell_size) - 1;
+		}
+		return p / cell_size;
+	}
+	/*
+	* SpatialGrid::add_cells() - Add the given id to every cell in the entry's range
+	* @id: the id to add
+	* @e: the entry which contains the cell range
+	*/
+	int SpatialGrid::add_cells(int id, const SpatialGridEntry& e) {
+		for (int cx=e.x1; cx<=e.x2; ++cx) {
+			for (int cy=e.y1; cy<=e.y2; ++cy) {
+				cells[get_key(cx, cy)].push_back(id);
+			}
+		}
+		return 0;
+	}
+	/*
+	* SpatialGrid::remove_cells() - Remove the given id from every cell in the entry's range
+	* @id: the id to remove
+	* @e: the entry which contains the cell range
+	*/
+	int SpatialGrid::remove_cells(int id, const SpatialGridEntry& e) {
+		for (int cx=e.x1; cx<=e.x2; ++cx) {
+			for (int cy=e.y1; cy<=e.y2; ++cy) {
+				auto cell = cells.find(get_key(cx, cy));
+				if (cell == cells.end()) {
+					continue;
+				}
+
+				std::vector<int>& ids = cell->second;
+				auto it = std::find(ids.begin(), ids.end(), id);
+				if (it != ids.end()) { // Swap the id with the last element since the order of the cell doesn't matter
+					*it = ids.back();
+					ids.pop_back();
+				}
+
+				if (ids.empty()) {
+					cells.erase(cell);
+				}
+			}
+		}
+		return 0;
+	}
+
+	/*
+	* SpatialGrid::get_*() - Return the requested grid information
+	*/
+	int SpatialGrid::get_cell_size() const {
+		return cell_size;
+	}
+	size_t SpatialGrid::get_amount() const {
+		return entries.size();
+	}
+	bool SpatialGrid::has(int id) const {
+		return (entries.find(id) != entries.end());
+	}
+
+	/*
+	* SpatialGrid::set_cell_size() - Change the cell size and rebuild the grid
+	* @new_cell_size: the new width and height of each cell
+	*/
+	int SpatialGrid::set_cell_size(int new_cell_size) {
+		if (new_cell_size < 1) {
+			return 1; // Return 1 when the cell size is invalid
+		}
+
+		std::unordered_map<int,SpatialGridEntry> old_entries (entries);
+		clear();
+		cell_size = new_cell_size;
+
+		for (auto& e : old_entries) {
+			update(e.first, e.second.rect);
+		}
+
+		return 0;
+	}
+	/*
+	* SpatialGrid::clear() - Remove all ids from the grid
+	*/
+	int SpatialGrid::clear() {
+		cells.clear();
+		entries.clear();
+		return 0;
+	}
+
+	/*
+	* SpatialGrid::update() - Set the bounds of the given id, adding it to the grid if necessary
+	* ! The cells are only modified when the id moves into a different range of cells
+	* ! Since check_collision() includes the rectangle edges, the cell range does as well
+	* @id: the id to update
+	* @rect: the new bounds of the id
+	*/
+	int SpatialGrid::update(int id, const SDL_Rect& rect) {
+		SpatialGridEntry e;
+		e.rect = rect;
+		e.x1 = get_cell(rect.x);
+		e.y1 = get_cell(rect.y);
+		e.x2 = get_cell(rect.x + std::max(rect.w, 0));
+		e.y2 = get_cell(rect.y + std::max(rect.h, 0));
+
+		auto it = entries.find(id);
+		if (it == entries.end()) { // If the id is new, add it to all of its cells
+			add_cells(id, e);
+			entries.emplace(id, e);
+			return 0;
+		}
+
+		SpatialGridEntry& old = it->second;
+		if ((old.x1 != e.x1)||(old.y1 != e.y1)||(old.x2 != e.x2)||(old.y2 != e.y2)) {
+			remove_cells(id, old);
+			add_cells(id, e);
+		}
+		old = e;
+
+		return 0;
+	}
+	/*
+	* SpatialGrid::remove() - Remove the given id from the grid
+	* @id: the id to remove
+	*/
+	int SpatialGrid::remove(int id) {
+		auto it = entries.find(id);
+		if (it == entries.end()) {
+			return 1; // Return 1 when the id is not in the grid
+		}
+
+		remove_cells(id, it->second);
+		entries.erase(it);
+
+		return 0;
+	}
+
+	/*
+	* SpatialGrid::query() - Fill the given vector with the ids whose cells overlap the given rectangle
+	* ! The results are only candidates and should still be checked with check_collision()
+	* ! The ids are returned in ascending order without duplicates
+	* @rect: the rectangle to search
+	* @ids: the vector to fill with the found ids
+	*/
+	size_t SpatialGrid::query(const SDL_Rect& rect, std::vector<int>& ids) const {
+		ids.clear();
+
+		const int x1 = get_cell(rect.x);
+		const int y1 = get_cell(rect.y);
+		const int x2 = get_cell(rect.x + std::max(rect.w, 0));
+		const int y2 = get_cell(rect.y + std::max(rect.h, 0));
+
+		for (int cx=x1; cx<=x2; ++cx) {
+			for (int cy=y1; cy<=y2; ++cy) {
+				auto cell = cells.find(get_key(cx, cy));
+				if (cell != cells.end()) {
+					ids.insert(ids.end(), cell->second.begin(), cell->second.end());
+				}
+			}
+		}
+
+		// Remove the duplicates of ids which span multiple cells
+		std::sort(ids.begin(), ids.end());
+		ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+		return ids.size();
+	}
+}
+
+#endif // BEE_DATA_SPATIALGRID
@@ -0,0 +1,55 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef BEE_DATA_SPATIALGRID_H
+#define BEE_DATA_SPATIALGRID_H 1
+
+#include <vector>
+#include <unordered_map>
+
+#include <SDL2/SDL.h> // Include the required SDL headers for SDL_Rect
+
+namespace bee {
+	struct SpatialGridEntry { // The data struct which is used to store the last known bounds of each id in the SpatialGrid class
+		SDL_Rect rect; // The bounding box of the entry
+		int x1, y1, x2, y2; // The inclusive range of cells which contain the entry
+
+		// See bee/data/spatialgrid.cpp for function comments
+		SpatialGridEntry();
+	};
+
+	class SpatialGrid { // A uniform grid of cells which is used to find nearby bounding boxes without checking every one
+			int cell_size; // The width and height of each cell
+			std::unordered_map<Uint64,std::vector<int>> cells; // A map of cell coordinates with the ids which overlap each cell
+			std::unordered_map<int,SpatialGridEntry> entries; // A map of the ids in the grid with their last known bounds
+
+			// See bee/data/spatialgrid.cpp for function comments
+			Uint64 get_key(int, int) const;
+			int get_cell(int) const;
+			int add_cells(int, const SpatialGridEntry&);
+			int remove_cells(int, const SpatialGridEntry&);
+		public:
+			// See bee/data/spatialgrid.cpp for function comments
+			SpatialGrid();
+			explicit SpatialGrid(int);
+
+			int get_cell_size() const;
+			size_t get_amount() const;
+			bool has(int) const;
+
+			int set_cell_size(int);
+			int clear();
+
+			int update(int, const SDL_Rect&);
+			int remove(int);
+
+			size_t query(const SDL_Rect&, std::vector<int>&) const;
+	};
+}
+
+#endif // BEE_DATA_SPATIALGRID_H
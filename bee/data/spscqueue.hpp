@@ -0,0 +1,87 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef BEE_DATA_SPSCQUEUE_H
+#define BEE_DATA_SPSCQUEUE_H 1
+
+#include <vector>
+#include <atomic>
+
+namespace bee {
+	template <typename T>
+	class SPSCQueue { // A bounded ring buffer which passes items from a single producer thread to a single consumer thread without locking
+			std::vector<T> items;
+			size_t mask; // The capacity minus one, which is used to wrap the indices
+
+			alignas(64) std::atomic<size_t> head; // The total amount of popped items, only written by the consumer
+			alignas(64) std::atomic<size_t> tail; // The total amount of pushed items, only written by the producer
+		public:
+			/*
+			* SPSCQueue::SPSCQueue() - Construct the queue with at least the given capacity
+			* ! The capacity is rounded up to a power of two so that the indices can be wrapped with a mask
+			* @capacity: the minimum amount of items which can be queued at once
+			*/
+			explicit SPSCQueue(size_t capacity) :
+				items(),
+				mask(0),
+				head(0),
+				tail(0)
+			{
+				size_t size = 1;
+				while (size < capacity) {
+					size <<= 1;
+				}
+				items.resize(size);
+				mask = size - 1;
+			}
+			SPSCQueue(const SPSCQueue&) = delete;
+			SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+			/*
+			* SPSCQueue::push() - Move the given item to the back of the queue
+			* ! This must only be called from the producer thread
+			* @item: the item to push
+			*/
+			bool push(T&& item) {
+				const size_t t = tail.load(std::memory_order_relaxed);
+				if (t - head.load(std::memory_order_acquire) == items.size()) {
+					return false; // Return false when the queue is full
+				}
+
+				items[t & mask] = std::move(item);
+				tail.store(t+1, std::memory_order_release);
+
+				return true;
+			}
+			/*
+			* SPSCQueue::pop() - Move the item at the front of the queue into the given pointer
+			* ! This must only be called from the consumer thread
+			* @item: the location to move the item to
+			*/
+			bool pop(T* item) {
+				const size_t h = head.load(std::memory_order_relaxed);
+				if (h == tail.load(std::memory_order_acquire)) {
+					return false; // Return false when the queue is empty
+				}
+
+				*item = std::move(items[h & mask]);
+				head.store(h+1, std::memory_order_release);
+
+				return true;
+			}
+
+			size_t get_capacity() const {
+				return items.size();
+			}
+			bool get_is_empty() const {
+				return (head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire));
+			}
+	};
+}
+
+#endif // BEE_DATA_SPSCQUEUE_H
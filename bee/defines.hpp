@@ -20,9 +20,35 @@
 
 #define BEE_ALARM_COUNT 8
 
+#define BEE_GRID_CELL_SIZE 64 // Define the default cell size of the instance collision grid
+
 #define BEE_MAX_LIGHTS 8 // Define the maximum amount of processed lights
 #define BEE_MAX_LIGHTABLES 96
 #define BEE_MAX_MASK_VERTICES 8
+#define BEE_LIGHT_BINDING 0 // Define the uniform block binding points for the lights and lightables
+#define BEE_LIGHTABLE_BINDING 1
+
+#define BEE_FONT_ATLAS_FIRST 32 // Define the range of characters which are rasterized into the glyph atlas of each font
+#define BEE_FONT_ATLAS_LAST 126
+
+#define BEE_ATLAS_PAGE_SIZE 2048 // Define the width and height of each texture atlas page
+#define BEE_ATLAS_PADDING 1 // Define the width of the border around each packed texture which is filled with its edge pixels so that linear filtering doesn't bleed between them
+
+#define BEE_PARTICLE_INSTANCE_SIZE 10 // Define the amount of floats which are streamed to the particle buffer for each particle
+#define BEE_PARTICLE_BUFFER_SIZE 16384 // Define the initial amount of particles which fit in the particle buffer before it wraps
+
+#define BEE_NET_SNAPSHOT_HISTORY 32 // Define the amount of snapshots which are kept as possible delta baselines
+#define BEE_NET_POSITION_SCALE 64.0 // Define the quantization steps per unit of the positions and velocities in snapshots
+#define BEE_NET_ROTATION_SCALE 4096.0
+#define BEE_NET_BATCH_SIZE 64 // Define the maximum amount of datagrams which are received per batch
+#define BEE_NET_QUEUE_SIZE 4096 // Define the amount of packets which can wait in each direction between the main thread and the network thread
+#define BEE_NET_MAX_FRAGMENTS 1024 // Define the maximum amount of fragments per packet, which limits each message to about 1.4MB
+#define BEE_NET_MAX_PARTIAL_PACKETS 16 // Define the maximum amount of partially received packets which are buffered for each sender
+
+#define BEE_LOG_QUEUE_SIZE 4096 // Define the amount of log records which can wait for the log thread before new ones are dropped
+#define BEE_LOG_BATCH_SIZE 256 // Define the maximum amount of log records which are written before the log files are flushed
+
+#define BEE_LOADER_FRAME_BUDGET 8 // Define the amount of milliseconds per frame which lazy loading can spend finalizing decoded resources
 
 #define MACRO_TO_STR_(x) #x
 #define MACRO_TO_STR(x) MACRO_TO_STR_(x)
@@ -10,6 +10,8 @@
 #define BEE_ENGINE 1
 
 #include <iostream>
+#include <thread>
+#include <algorithm>
 
 #include <SDL2/SDL_image.h> // Include the required SDL headers
 #include <SDL2/SDL_mixer.h>
@@ -26,6 +28,7 @@
 #include "core/console.hpp"
 #include "core/enginestate.hpp"
 #include "core/input.hpp"
+#include "core/jobs.hpp"
 #include "core/resources.hpp"
 #include "core/rooms.hpp"
 
@@ -82,6 +85,14 @@ namespace bee {
 			net::init();
 		}
 
+		if (get_options().job_threads != 0) {
+			size_t thread_amount = get_options().job_threads;
+			if (get_options().job_threads < 0) {
+				thread_amount = std::max(std::thread::hardware_concurrency(), 1u) - 1; // Leave a core for the main thread
+			}
+			jobs::internal::init(thread_amount);
+		}
+
 		if (!get_options().is_headless) {
 			int r = internal::init_sdl(); // Initialize SDL
 			if (r) {
@@ -248,6 +259,8 @@ namespace bee {
 			net::close();
 		}
 
+		jobs::internal::close();
+
 		engine->free();
 
 		if (!get_options().is_headless) {
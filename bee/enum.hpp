@@ -202,7 +202,8 @@ namespace bee {
 		NAME,
 		PLAYERS,
 		KEYFRAME,
-		DELTA
+		DELTA,
+		ACK
 	};
 
 	enum class E_DATA_TYPE : unsigned int {
@@ -213,7 +214,8 @@ namespace bee {
 		STRING,
 		VECTOR,
 		MAP,
-		SERIAL
+		SERIAL,
+		SIDP
 	};
 
 	// Particles
@@ -45,7 +45,9 @@ namespace bee {
 		is_basic_shaders_enabled(false),
 
 		is_network_enabled(true),
+		is_network_threaded(false),
 		is_debug_enabled(false),
+		job_threads(0),
 
 		should_assert(true),
 		single_run(false),
@@ -65,7 +67,9 @@ namespace bee {
 		is_basic_shaders_enabled(bs),
 
 		is_network_enabled(n),
+		is_network_threaded(false),
 		is_debug_enabled(d),
+		job_threads(0),
 
 		should_assert(true),
 		single_run(false),
@@ -170,6 +174,10 @@ namespace bee {
 				net::close();
 			}
 		}
+		// Change network thread state
+		if (get_options().is_network_threaded != new_options.is_network_threaded) {
+			engine->options->is_network_threaded = new_options.is_network_threaded; // The new state will be used by the next session
+		}
 		// Change debugging state
 		if (get_options().is_debug_enabled != new_options.is_debug_enabled) {
 			engine->options->is_debug_enabled = new_options.is_debug_enabled;
@@ -26,7 +26,9 @@ namespace bee {
 
 		// Miscellaneous options
 		bool is_network_enabled;
+		bool is_network_threaded; // Whether sockets are handled on a separate network thread, which is useful for dedicated servers
 		bool is_debug_enabled;
+		int job_threads; // The amount of worker threads for reentrant step events, 0 to disable them or negative to use all available cores
 
 		// Commandline flags
 		bool should_assert;
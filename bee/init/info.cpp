@@ -42,6 +42,8 @@ namespace bee {
 			"		Disable fullscreen mode\n"
 			"	--headless\n"
 			"		Run the engine in headless mode without any SDL/OpenGL initialization\n"
+			"	--threads n\n"
+			"		Run the step events of reentrant objects on n worker threads, or on every core when n is negative\n"
 			"Exit Status:\n"
 			"	0       Success\n"
 			"	1       Failure to initialize the engine\n"
@@ -185,8 +185,18 @@ namespace bee {
 					engine->options->is_headless = true;
 				}
 			);
+			ProgramFlag* f_netthread = new ProgramFlag(
+				"net-thread", '\0', true, E_FLAGARG::NONE, [] (const std::string& arg) -> void {
+					engine->options->is_network_threaded = true;
+				}
+			);
+			ProgramFlag* f_threads = new ProgramFlag(
+				"threads", '\0', true, E_FLAGARG::REQUIRED, [] (const std::string& arg) -> void {
+					engine->options->job_threads = bee_stoi(arg);
+				}
+			);
 
-			flag_list = {f_help, f_debug, f_dimensions, f_fullscreen, f_noassert, f_singlerun, f_windowed, f_headless};
+			flag_list = {f_help, f_debug, f_dimensions, f_fullscreen, f_noassert, f_singlerun, f_windowed, f_headless, f_netthread, f_threads};
 		}
 		return flag_list;
 	}
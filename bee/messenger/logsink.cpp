@@ -0,0 +1,530 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef BEE_MESSENGER_LOGSINK
+#define BEE_MESSENGER_LOGSINK 1
+
+#include <iostream> // Include the required library headers
+#include <sstream>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <memory>
+#include <unordered_map>
+
+#include "logsink.hpp" // Include the engine headers
+
+#include "../defines.hpp"
+#include "../engine.hpp"
+
+#include "../util/string.hpp"
+#include "../util/platform.hpp"
+#include "../util/debug.hpp"
+#include "../util/files.hpp"
+
+#include "../data/mpscqueue.hpp"
+#include "../data/serialdata.hpp"
+
+#include "messenger.hpp"
+
+namespace bee { namespace messenger {
+	namespace internal {
+		std::unordered_map<std::string,LogFile> logfiles = {{"stdout", {E_OUTPUT::NORMAL, nullptr, false}}};
+		std::mutex logfiles_mutex; // The mutex which protects the log files since they are written by the log thread
+		std::atomic<Uint32> log_types (log_get_types()); // A mask of the message types which at least one log file prints
+
+		std::thread log_thread;
+		std::mutex log_thread_mutex; // The mutex which prevents two threads from starting or stopping the log thread at once
+		std::atomic<bool> is_log_running (false);
+		std::atomic<bool> is_log_closed (false); // Whether the program is exiting, after which records are written immediately
+		std::unique_ptr<MPSCQueue<LogRecord>> log_queue; // The records which are waiting to be written by the log thread
+		std::atomic<size_t> log_pushed (0);
+		std::atomic<size_t> log_written (0);
+		std::atomic<size_t> log_dropped (0); // The amount of records which didn't fit in the queue since the last batch
+
+		struct LogThreadGuard { // Join the log thread at exit before the log files are destroyed
+			~LogThreadGuard() {
+				is_log_closed = true;
+				log_stop();
+			}
+		} log_thread_guard;
+	}
+
+	namespace internal {
+		LogRecord::LogRecord() :
+			tickstamp(0),
+			type(E_MESSAGE::GENERAL),
+			tags(),
+			descr(),
+			is_brief(false)
+		{}
+		LogRecord::LogRecord(Uint32 tm, E_MESSAGE tp, const std::vector<std::string>& tg, const std::string& de, bool br) :
+			tickstamp(tm),
+			type(tp),
+			tags(tg),
+			descr(de),
+			is_brief(br)
+		{}
+	}
+
+	/*
+	* internal::print_msg() - Queue the given record to be written to the log files by the log thread
+	* ! The log thread is started on the first record so that the caller never waits for terminal or disk output
+	* @record: the record to print
+	*/
+	int internal::print_msg(LogRecord&& record) {
+		if ((log_types & (1u << static_cast<Uint32>(record.type))) == 0) {
+			return 1; // Return 1 when no log file prints the message type
+		}
+
+		if (is_log_closed) { // If the program is exiting, write the record immediately
+			std::lock_guard<std::mutex> lock (logfiles_mutex);
+			log_write(record);
+			log_flush_files();
+			return 0;
+		}
+
+		if (!is_log_running) {
+			log_start();
+		}
+
+		if (!log_queue->push(std::move(record))) {
+			++log_dropped;
+			return 2; // Return 2 when the queue is full
+		}
+		++log_pushed;
+
+		return 0; // Return 0 on success
+	}
+	/*
+	* internal::should_print() - Determine whether a message of the given type should print during the given output level
+	* @level: the output level
+	* @type: the message type
+	*/
+	bool internal::should_print(E_OUTPUT level, E_MESSAGE type) {
+		switch (level) {
+			case E_OUTPUT::NONE: { // When the verbosity is NONE, skip all message types
+				return false;
+			}
+			case E_OUTPUT::QUIET: { // When the verbosity is QUIET, skip all types except warnings and errors
+				if (
+					(type != E_MESSAGE::WARNING)
+					&&(type != E_MESSAGE::ERROR)
+				) 		{
+					return false;
+				}
+				break;
+			}
+			case E_OUTPUT::NORMAL: // When the verbosity is NORMAL, skip internal messages
+			default: {
+				if (type == E_MESSAGE::INTERNAL) {
+					return false;
+				}
+				break;
+			}
+			case E_OUTPUT::VERBOSE: { // When the verbosity is VERBOSE, skip no message types
+				break;
+			}
+		}
+		return true;
+	}
+
+	/*
+	* internal::log_start() - Start the log thread which writes the queued records
+	*/
+	int internal::log_start() {
+		std::lock_guard<std::mutex> lock (log_thread_mutex);
+		if ((is_log_running)||(is_log_closed)) {
+			return 1; // Return 1 when the thread is already running or the program is exiting
+		}
+
+		if (log_queue == nullptr) {
+			log_queue = std::make_unique<MPSCQueue<LogRecord>>(BEE_LOG_QUEUE_SIZE);
+		}
+
+		is_log_running = true;
+		log_thread = std::thread(log_main);
+
+		return 0; // Return 0 on success
+	}
+	/*
+	* internal::log_stop() - Join the log thread and write any records which were queued after its last batch
+	*/
+	int internal::log_stop() {
+		std::lock_guard<std::mutex> lock (log_thread_mutex);
+		if (!log_thread.joinable()) {
+			return 1; // Return 1 when the thread isn't running
+		}
+
+		is_log_running = false;
+		log_thread.join();
+
+		// The queue has no other consumer now so the remaining records can be written from this thread
+		std::lock_guard<std::mutex> files_lock (logfiles_mutex);
+		LogRecord record;
+		while (log_queue->pop(&record)) {
+			log_write(record);
+			++log_written;
+		}
+		log_flush_files();
+
+		return 0; // Return 0 on success
+	}
+	/*
+	* internal::get_is_log_threaded() - Return whether records are currently being written by the log thread
+	*/
+	bool internal::get_is_log_threaded() {
+		return is_log_running;
+	}
+	/*
+	* internal::log_flush() - Wait until the log thread has written every record which was queued before the call
+	* ! This blocks so it should only be used before changing the log files or when the program is about to crash
+	*/
+	int internal::log_flush() {
+		const size_t pushed = log_pushed;
+		while ((is_log_running)&&(log_written < pushed)) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return 0;
+	}
+
+	/*
+	* internal::log_get_types() - Return a mask of the message types which at least one log file prints
+	* ! The log files must be locked when this is called after initialization
+	*/
+	Uint32 internal::log_get_types() {
+		Uint32 types = 0;
+		for (Uint32 t=0; t<=static_cast<Uint32>(E_MESSAGE::INTERNAL); ++t) {
+			for (auto& lf : logfiles) {
+				if (should_print(lf.second.level, static_cast<E_MESSAGE>(t))) {
+					types |= (1u << t);
+					break;
+				}
+			}
+		}
+		return types;
+	}
+	/*
+	* internal::log_format() - Return the text of the given record
+	* @record: the record to format
+	*/
+	std::string internal::log_format(const LogRecord& record) {
+		std::stringstream text; // Combine the message metadata
+		if (record.is_brief) {
+			text << record.tickstamp << "ms> ";
+		} else {
+			text << "MSG (" << record.tickstamp << "ms)[" << get_type_string(record.type) << "]<" << joinv(record.tags, ',') << ">: ";
+		}
+
+		if (record.descr.find("\n") != std::string::npos) { // If the description is multiple liness, indent it as necessary
+			text << "\n";
+			text << debug_indent(record.descr, 1);
+		} else { // Otherwise, output it as normal
+			text << record.descr << "\n";
+		}
+
+		return text.str();
+	}
+	/*
+	* internal::log_encode() - Append the binary form of the given record to the given buffer
+	* ! Each record is a little-endian 4 byte size followed by the record in the compact SerialData format
+	* @record: the record to encode
+	* @bytes: the buffer to append to
+	*/
+	int internal::log_encode(const LogRecord& record, std::vector<Uint8>* bytes) {
+		int tickstamp = static_cast<int>(record.tickstamp);
+		unsigned char type = static_cast<unsigned char>(record.type);
+		std::vector<std::string> tags = record.tags;
+		std::string descr = record.descr;
+
+		SerialData data (16 + descr.length(), true);
+		data.store_int(tickstamp);
+		data.store_char(type);
+		data.store_vector(tags);
+		data.store_string(descr);
+
+		const std::vector<Uint8> r = data.get();
+		const Uint32 size = r.size();
+		for (size_t i=0; i<4; ++i) {
+			bytes->push_back(static_cast<Uint8>(size >> (8*i)));
+		}
+		bytes->insert(bytes->end(), r.begin(), r.end());
+
+		return 0; // Return 0 on success
+	}
+	/*
+	* internal::log_write() - Write the given record to every log file which prints its type
+	* ! The log files must be locked when this is called
+	* @record: the record to write
+	*/
+	int internal::log_write(const LogRecord& record) {
+		std::string text;
+		std::vector<Uint8> bytes;
+
+		for (auto& lf : logfiles) {
+			if (!should_print(lf.second.level, record.type)) {
+				continue;
+			}
+
+			if (lf.second.is_binary) {
+				if (bytes.empty()) {
+					log_encode(record, &bytes);
+				}
+				lf.second.file->write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+				continue;
+			}
+
+			if (text.empty()) {
+				text = log_format(record);
+			}
+
+			if (lf.first == "stdout") {
+				// Change the output color depending on the message type
+				if (record.type == E_MESSAGE::WARNING) {
+					bee_commandline_color(11); // Yellow
+				} else if (record.type == E_MESSAGE::ERROR) {
+					bee_commandline_color(9); // Red
+				}
+
+				// Output to the appropriate stream
+				if ((record.type == E_MESSAGE::WARNING)||(record.type == E_MESSAGE::ERROR)) {
+					std::cerr << text;
+				} else {
+					std::cout << text;
+				}
+
+				bee_commandline_color_reset(); // Reset the output color
+			} else {
+				*lf.second.file << text;
+			}
+		}
+
+		return 0; // Return 0 on success
+	}
+	/*
+	* internal::log_flush_files() - Flush the output buffers of every log file
+	* ! The log files must be locked when this is called
+	*/
+	int internal::log_flush_files() {
+		for (auto& lf : logfiles) {
+			if (lf.second.file != nullptr) {
+				lf.second.file->flush();
+			}
+		}
+		std::cout.flush();
+		std::cerr.flush();
+		return 0;
+	}
+	/*
+	* internal::log_main() - Write the queued records in batches until the thread is stopped
+	*/
+	void internal::log_main() {
+		LogRecord record;
+		while (true) {
+			const bool is_running = is_log_running;
+			size_t amount = 0;
+
+			{
+				std::lock_guard<std::mutex> lock (logfiles_mutex);
+				while ((amount < BEE_LOG_BATCH_SIZE)&&(log_queue->pop(&record))) {
+					log_write(record);
+					++amount;
+				}
+
+				const size_t dropped = log_dropped.exchange(0);
+				if (dropped > 0) {
+					log_write(LogRecord(get_ticks(), E_MESSAGE::WARNING, {"engine", "messenger"}, "Dropped " + bee_itos(dropped) + " log messages because the log queue was full", false));
+				}
+
+				if ((amount > 0)||(dropped > 0)) {
+					log_flush_files(); // Flush once per batch instead of after every record
+				}
+			}
+			log_written += amount;
+
+			if (amount == 0) {
+				if (!is_running) {
+					break;
+				}
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		}
+	}
+
+	/*
+	* add_log() - Add a filename as a text log file
+	* ! This function can also be used to change the output level of existing log files
+	* @filename: the file to log to
+	* @level: the output level to log
+	*/
+	int add_log(const std::string& filename, E_OUTPUT level) {
+		return add_log(filename, level, false);
+	}
+	/*
+	* add_log() - Add a filename as a log file
+	* ! Binary log files can be read with decode_log()
+	* @filename: the file to log to
+	* @level: the output level to log
+	* @is_binary: whether to write binary records instead of text
+	*/
+	int add_log(const std::string& filename, E_OUTPUT level, bool is_binary) {
+		if (filename == "stdout") { // Deny overwriting stdout via this function
+			return 1;
+		}
+
+		std::ofstream* logfile = new std::ofstream(filename, (is_binary) ? std::ios::out | std::ios::binary : std::ios::out);
+		if (!logfile->is_open()) {
+			delete logfile;
+			send({"engine", "messenger"}, E_MESSAGE::ERROR, "Failed to open log file \"" + filename + "\"");
+			return 2;
+		}
+
+		internal::log_flush(); // Write the earlier records before the new log file starts receiving them
+
+		std::lock_guard<std::mutex> lock (internal::logfiles_mutex);
+		auto lf = internal::logfiles.find(filename);
+		if (lf != internal::logfiles.end()) { // Replace the stream of an existing log file
+			lf->second.file->close();
+			delete lf->second.file;
+		}
+		internal::logfiles[filename] = {level, logfile, is_binary};
+		internal::log_types = internal::log_get_types();
+
+		return 0;
+	}
+	/*
+	* remove_log() - Remove the given filename from being a log file
+	* @filename: the filename to remove
+	* @should_delete: whether the file should also be deleted
+	*/
+	int remove_log(const std::string& filename, bool should_delete) {
+		if (filename == "stdout") { // Deny removing stdout via this function
+			return 1;
+		}
+
+		internal::log_flush(); // Write the queued records before the log file is closed
+
+		{
+			std::lock_guard<std::mutex> lock (internal::logfiles_mutex);
+			auto lf = internal::logfiles.find(filename);
+			if (lf == internal::logfiles.end()) {
+				send({"engine", "messenger"}, E_MESSAGE::WARNING, "The log file \"" + filename + "\" could not be removed because it has not been added");
+				return 2;
+			}
+
+			lf->second.file->close();
+			delete lf->second.file;
+
+			internal::logfiles.erase(lf);
+			internal::log_types = internal::log_get_types();
+		}
+
+		if (should_delete) {
+			file_delete(filename);
+		}
+
+		return 0;
+	}
+	/*
+	* clear_logs() - Clear all log files except stdout
+	* @should_delete: Whether the log files should be deleted
+	*/
+	int clear_logs(bool should_delete) {
+		internal::log_flush();
+
+		std::lock_guard<std::mutex> lock (internal::logfiles_mutex);
+		for (auto it=internal::logfiles.begin(); it!=internal::logfiles.end(); ) {
+			if (it->first == "stdout") {
+				++it;
+				continue;
+			}
+
+			it->second.file->close();
+			delete it->second.file;
+
+			if (should_delete) {
+				file_delete(it->first);
+			}
+
+			internal::logfiles.erase(it++);
+		}
+		internal::log_types = internal::log_get_types();
+
+		return 0;
+	}
+	/*
+	* decode_log() - Read the messages from the given binary log file
+	* ! The tickstamps are the original ones and the message data is always nullptr
+	* @filename: the binary log file to read
+	* @messages: the vector to append the messages to
+	*/
+	int decode_log(const std::string& filename, std::vector<MessageContents>* messages) {
+		std::ifstream input (filename, std::ios::in | std::ios::binary);
+		if (!input.is_open()) {
+			return 1; // Return 1 when the file couldn't be opened
+		}
+
+		const std::vector<Uint8> bytes ((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+		size_t pos = 0;
+		while (pos < bytes.size()) {
+			if (bytes.size() - pos < 4) {
+				return 2; // Return 2 when the last record is truncated
+			}
+
+			Uint32 size = 0;
+			for (size_t i=0; i<4; ++i) {
+				size |= static_cast<Uint32>(bytes[pos+i]) << (8*i);
+			}
+			pos += 4;
+			if (bytes.size() - pos < size) {
+				return 2;
+			}
+
+			SerialData data (std::vector<Uint8>(bytes.begin()+pos, bytes.begin()+pos+size));
+			pos += size;
+
+			int tickstamp = 0;
+			unsigned char type = 0;
+			std::vector<std::string> tags;
+			std::string descr;
+			if (
+				(data.store_int(tickstamp))
+				||(data.store_char(type))
+				||(data.store_vector(tags))
+				||(data.store_string(descr))
+			) {
+				return 3; // Return 3 when a record is malformed
+			}
+
+			messages->emplace_back(static_cast<Uint32>(tickstamp), tags, static_cast<E_MESSAGE>(type), descr, nullptr);
+		}
+
+		return 0; // Return 0 on success
+	}
+
+	/*
+	* set_level() - Set the output level when printing message descriptions
+	* @level: the output level to use
+	*/
+	int set_level(E_OUTPUT level) {
+		std::lock_guard<std::mutex> lock (internal::logfiles_mutex);
+		internal::logfiles["stdout"] = {level, nullptr, false};
+		internal::log_types = internal::log_get_types();
+		return 0;
+	}
+	/*
+	* get_level() - Return the output level when printing message descriptions
+	*/
+	E_OUTPUT get_level() {
+		std::lock_guard<std::mutex> lock (internal::logfiles_mutex);
+		return internal::logfiles["stdout"].level;
+	}
+}}
+
+#endif // BEE_MESSENGER_LOGSINK
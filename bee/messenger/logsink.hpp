@@ -0,0 +1,53 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef BEE_MESSENGER_LOGSINK_H
+#define BEE_MESSENGER_LOGSINK_H 1
+
+#include <string>
+#include <vector>
+#include <fstream>
+
+#include <SDL2/SDL.h> // Include the required SDL headers
+
+#include "../enum.hpp"
+
+namespace bee { namespace messenger { namespace internal {
+	struct LogFile { // An output which receives message descriptions
+		E_OUTPUT level;
+		std::ofstream* file; // The file stream, which is nullptr for stdout
+		bool is_binary; // Whether records are written in the compact SerialData format instead of as text
+	};
+	struct LogRecord { // The part of a message which is needed to print it
+		Uint32 tickstamp;
+		E_MESSAGE type;
+		std::vector<std::string> tags;
+		std::string descr;
+		bool is_brief; // Whether the text header only contains the tickstamp, e.g. in headless mode
+
+		LogRecord();
+		LogRecord(Uint32, E_MESSAGE, const std::vector<std::string>&, const std::string&, bool);
+	};
+
+	int print_msg(LogRecord&&);
+	bool should_print(E_OUTPUT, E_MESSAGE);
+
+	int log_start();
+	int log_stop();
+	bool get_is_log_threaded();
+	int log_flush();
+
+	Uint32 log_get_types();
+	std::string log_format(const LogRecord&);
+	int log_encode(const LogRecord&, std::vector<Uint8>*);
+	int log_write(const LogRecord&);
+	int log_flush_files();
+	void log_main();
+}}}
+
+#endif // BEE_MESSENGER_LOGSINK_H
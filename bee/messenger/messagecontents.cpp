@@ -14,10 +14,13 @@
 
 #include "messagecontents.hpp"
 
+#include "messenger.hpp"
+
 namespace bee {
 	MessageContents::MessageContents() :
 		tickstamp(0),
 		tags(),
+		tag_ids(),
 		type(E_MESSAGE::GENERAL),
 		descr(),
 		data(nullptr)
@@ -25,6 +28,7 @@ namespace bee {
 	MessageContents::MessageContents(Uint32 tm, const std::vector<std::string>& tg, E_MESSAGE tp, const std::string& de, std::shared_ptr<void> da) :
 		tickstamp(tm),
 		tags(tg),
+		tag_ids(messenger::internal::get_tag_ids(tg)),
 		type(tp),
 		descr(de),
 		data(da)
@@ -20,6 +20,7 @@ namespace bee {
 	struct MessageContents {
 		Uint32 tickstamp;
 		std::vector<std::string> tags;
+		std::vector<Uint32> tag_ids; // The interned ids of the tags which are used for routing
 		E_MESSAGE type;
 		std::string descr;
 		std::shared_ptr<void> data;
@@ -16,16 +16,22 @@
 
 #include "messagerecipient.hpp"
 
+#include "messenger.hpp"
+
 namespace bee {
 	MessageRecipient::MessageRecipient() :
 		name(),
 		tags(),
+		tag_ids(),
+		name_id(messenger::internal::get_tag_id("")),
 		is_strict(false),
 		func(nullptr)
 	{}
 	MessageRecipient::MessageRecipient(const std::string& n, const std::vector<std::string>& t, bool s, std::function<void (const MessageContents&)> f) :
 		name(n),
 		tags(t),
+		tag_ids(messenger::internal::get_tag_ids(t)),
+		name_id(messenger::internal::get_tag_id(n)),
 		is_strict(s),
 		func(f)
 	{}
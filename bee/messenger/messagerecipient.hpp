@@ -17,6 +17,8 @@ namespace bee {
 	struct MessageRecipient {
 		std::string name;
 		std::vector<std::string> tags;
+		std::vector<Uint32> tag_ids; // The interned ids of the tags which are used for routing
+		Uint32 name_id; // The interned id of the name which is used for routing direct messages
 		bool is_strict;
 		std::function<void (const MessageContents&)> func = nullptr;
 
@@ -14,8 +14,11 @@
 #include <fstream>
 #include <sstream>
 #include <set>
+#include <deque>
+#include <mutex>
 
 #include "messenger.hpp"
+#include "logsink.hpp"
 
 #include "../engine.hpp"
 
@@ -33,14 +36,35 @@
 
 namespace bee { namespace messenger{
 	namespace internal {
-		std::unordered_map<std::string,std::list<MessageRecipient>> recipients;
+		struct RecipientSlot { // A registered recipient along with its dispatch state
+			MessageRecipient recv;
+			bool is_used;
+			Uint32 serial; // The serial of the last message which was passed to the recipient, which prevents calling it twice for the same message
+		};
+		struct TagListHash { // A hash of interned tag lists for looking up strict recipients
+			size_t operator()(const std::vector<Uint32>& tags) const {
+				size_t h = 2166136261u; // Use FNV-1a over the tag ids
+				for (auto& t : tags) {
+					h = (h ^ t) * 16777619u;
+				}
+				return h;
+			}
+		};
+
+		std::deque<RecipientSlot> recipients; // The recipient slots, which don't move when recipients register from inside recipient functions
+		std::vector<size_t> free_recipients; // The slots of unregistered recipients which can be reused
+		std::vector<std::vector<size_t>> tag_routes; // The slots of the recipients of each tag id, excluding strict recipients
+		std::vector<std::vector<size_t>> direct_routes; // The slots of the recipients who accept direct messages, indexed by their name id
+		std::unordered_map<std::vector<Uint32>,std::vector<size_t>,TagListHash> strict_routes; // The slots of strict recipients, keyed by their exact tag list
+		Uint32 message_serial = 0;
+
 		const std::set<std::string> protected_tags = {"engine", "console"};
 		std::vector<MessageContents> messages;
+		std::vector<MessageContents> handled_messages; // The second message buffer which is swapped with the queue during handle() so that neither is reallocated each frame
+		std::mutex messages_mutex; // The mutex which protects the message queue since the network thread can also send messages
 
 		std::list<std::string> filter;
 		bool is_filter_blacklist = true;
-
-		std::unordered_map<std::string,std::pair<E_OUTPUT,std::ofstream*>> logfiles = {{"stdout", {E_OUTPUT::NORMAL, nullptr}}};
 	}
 
 	/*
@@ -57,14 +81,54 @@ namespace bee { namespace messenger{
 			));
 		}
 
+		internal::log_stop(); // Write the remaining records before the log files are closed
 		clear_logs(false);
 
 		internal::recipients.clear();
+		internal::free_recipients.clear();
+		internal::tag_routes.clear();
+		internal::direct_routes.clear();
+		internal::strict_routes.clear();
 		internal::messages.clear();
+		internal::handled_messages.clear();
 
 		return 0; // Return 0 on success
 	}
 
+	/*
+	* internal::get_tag_id() - Return the interned id of the given tag, adding it to the tag table if it doesn't exist
+	* ! Recipient names are interned in the same table so that direct messages can be routed by id
+	* @tag: the tag to intern
+	*/
+	Uint32 internal::get_tag_id(const std::string& tag) {
+		static std::mutex tags_mutex; // Messages can be constructed on the network thread
+		static std::unordered_map<std::string,Uint32> tag_ids;
+
+		std::lock_guard<std::mutex> lock (tags_mutex);
+
+		auto it = tag_ids.find(tag);
+		if (it != tag_ids.end()) {
+			return it->second;
+		}
+
+		const Uint32 id = tag_ids.size();
+		tag_ids.emplace(tag, id);
+
+		return id;
+	}
+	/*
+	* internal::get_tag_ids() - Return the interned ids of the given tags
+	* @tags: the tags to intern
+	*/
+	std::vector<Uint32> internal::get_tag_ids(const std::vector<std::string>& tags) {
+		std::vector<Uint32> ids;
+		ids.reserve(tags.size());
+		for (auto& tag : tags) {
+			ids.push_back(get_tag_id(tag));
+		}
+		return ids;
+	}
+
 	/*
 	* internal::output_msg() - Output the given message if the verbosity level is high enough
 	* @msg: the message to process
@@ -87,160 +151,103 @@ namespace bee { namespace messenger{
 			return 2; // Return 2 when the message got filtered
 		}
 
+		// The record is formatted and written by the log thread
 		if ((engine != nullptr)&&((get_options().is_headless)&&(!get_options().is_debug_enabled))) {
-			std::stringstream h; // Combine the message metadata
-			h << msg.tickstamp << "ms> ";
-
-			print_msg(h.str(), msg);
+			print_msg(LogRecord(msg.tickstamp, msg.type, msg.tags, msg.descr, true));
 
 			return 3; // Return 3 when in headless mode
 		}
 
-		// Create a string of the message's tags
-		std::string tags = joinv(msg.tags, ',');
-
-		std::stringstream h; // Combine the message metadata
-		h << "MSG (" << msg.tickstamp << "ms)[" << get_type_string(msg.type) << "]<" << tags << ">: ";
-
-		print_msg(h.str(), msg);
+		print_msg(LogRecord(msg.tickstamp, msg.type, msg.tags, msg.descr, false));
 
 		return 0; // Return 0 on success
 	}
 	/*
-	* internal::print_msg() - Print the given message description with the given header
-	* @header: the metadata to print before the message description
-	* @msg: the message whose description should be printed
+	* internal::call_recipients() - Call the recipients who are registered for the given message's tags
+	* @msg: the message to pass to the recipients
 	*/
-	int internal::print_msg(const std::string& header, const MessageContents& msg) {
-		for (auto& lf : logfiles) {
-			if (!should_print(lf.second.first, msg.type)) {
-				continue;
-			}
+	std::exception_ptr internal::call_recipients(const MessageContents& msg) {
+		static const Uint32 direct_tag = get_tag_id("direct");
 
-			std::ostream* o = lf.second.second;
+		if (msg.tags.empty()) {
+			return nullptr;
+		}
+		if (msg.tag_ids.size() != msg.tags.size()) { // If the message was constructed without interning its tags, intern them now
+			MessageContents m (msg);
+			m.tag_ids = get_tag_ids(m.tags);
+			return call_recipients(m);
+		}
 
-			if (lf.first == "stdout") {
-				// Change the output color depending on the message type
-				if (msg.type == E_MESSAGE::WARNING) {
-					bee_commandline_color(11); // Yellow
-				} else if (msg.type == E_MESSAGE::ERROR) {
-					bee_commandline_color(9); // Red
-				}
+		const Uint32 serial = ++message_serial;
+		std::exception_ptr ep = nullptr;
 
-				// Output to the appropriate stream
-				o = &std::cout;
-				if ((msg.type == E_MESSAGE::WARNING)||(msg.type == E_MESSAGE::ERROR)) {
-					o = &std::cerr;
+		if (msg.tag_ids[0] == direct_tag) { // Send the message directly to a recipient rather than handling tags
+			for (auto& tag : msg.tag_ids) { // Recipients must register for the direct tag in order to receive direct messages
+				ep = call_route(&direct_routes, tag, serial, msg);
+				if (ep != nullptr) {
+					break;
 				}
 			}
-
-			// Output the message metadata
-			*o << header;
-
-			// Output the message description
-			if (msg.descr.find("\n") != std::string::npos) { // If the description is multiple liness, indent it as necessary
-				*o << "\n";
-				*o << debug_indent(msg.descr, 1);
-			} else { // Otherwise, output it as normal
-				*o << msg.descr << "\n";
+		} else {
+			for (auto& tag : msg.tag_ids) { // Iterate over the message's tags
+				ep = call_route(&tag_routes, tag, serial, msg);
+				if (ep != nullptr) {
+					break;
+				}
 			}
 
-			bee_commandline_color_reset(); // Reset the output color
-
-			std::flush(*o); // Flush the output buffer after printing
+			if (ep == nullptr) { // Call the strict recipients whose tags exactly match the message
+				auto rt = strict_routes.find(msg.tag_ids);
+				if (rt != strict_routes.end()) {
+					ep = call_route(&rt->second, serial, msg);
+				}
+			}
 		}
 
-		return 0;
+		return ep;
 	}
 	/*
-	* internal::should_print() - Determine whether a message of the given type should print during the given output level
-	* @level: the output level
-	* @type: the message type
+	* internal::call_route() - Call the recipients of the given route id who haven't received the message yet
+	* @routes: the routing table
+	* @id: the tag id or name id of the route
+	* @serial: the serial of the message
+	* @msg: the message to pass to the recipients
 	*/
-	bool internal::should_print(E_OUTPUT level, E_MESSAGE type) {
-		switch (level) {
-			case E_OUTPUT::NONE: { // When the verbosity is NONE, skip all message types
-				return false;
-			}
-			case E_OUTPUT::QUIET: { // When the verbosity is QUIET, skip all types except warnings and errors
-				if (
-					(type != E_MESSAGE::WARNING)
-					&&(type != E_MESSAGE::ERROR)
-				) 		{
-					return false;
-				}
-				break;
-			}
-			case E_OUTPUT::NORMAL: // When the verbosity is NORMAL, skip internal messages
-			default: {
-				if (type == E_MESSAGE::INTERNAL) {
-					return false;
-				}
-				break;
+	std::exception_ptr internal::call_route(std::vector<std::vector<size_t>>* routes, Uint32 id, Uint32 serial, const MessageContents& msg) {
+		for (size_t i=0; (id < routes->size())&&(i < (*routes)[id].size()); ++i) { // Index the table each time since recipient functions can register new tags
+			RecipientSlot& rs = recipients[(*routes)[id][i]];
+			if (rs.serial == serial) {
+				continue;
 			}
-			case E_OUTPUT::VERBOSE: { // When the verbosity is VERBOSE, skip no message types
-				break;
+			rs.serial = serial;
+
+			std::exception_ptr ep = handle_recipient(rs.recv, msg);
+			if (ep != nullptr) {
+				return ep;
 			}
 		}
-		return true;
+		return nullptr;
 	}
 	/*
-	* internal::call_recipients() - Call the recipients who are registered for the given message's tags
+	* internal::call_route() - Call the recipients of the given route who haven't received the message yet
+	* @route: the recipient slots
+	* @serial: the serial of the message
 	* @msg: the message to pass to the recipients
 	*/
-	std::exception_ptr internal::call_recipients(const MessageContents& msg) {
-		std::exception_ptr ep = nullptr;
-
-		if (msg.tags.empty()) {
-			return nullptr;
-		}
-
-		if (msg.tags.at(0) == "direct") { // Send the message directly to a recipient rather than handling tags
-			auto rt = recipients.find("direct"); // Recipients must register for the direct tag in order to receive direct messages
-			if (rt != recipients.end()) {
-				for (auto& tag : msg.tags) { // Iterate over the message's tags
-					for (auto& recv : rt->second) {
-						if (recv.name == tag) {
-							std::exception_ptr e = handle_recipient(recv, msg);
-							if (e != nullptr) {
-								ep = e;
-								break;
-							}
-						}
-
-						if (ep != nullptr) {
-							break;
-						}
-					}
-				}
+	std::exception_ptr internal::call_route(std::vector<size_t>* route, Uint32 serial, const MessageContents& msg) {
+		for (size_t i=0; i<route->size(); ++i) {
+			RecipientSlot& rs = recipients[(*route)[i]];
+			if (rs.serial == serial) {
+				continue;
 			}
-		} else {
-			std::set<MessageRecipient> has_received;
-			for (auto& tag : msg.tags) { // Iterate over the message's tags
-				auto rt = recipients.find(tag); // Make sure that the message tag exists
-				if (rt != recipients.end()) {
-					for (auto& recv : recipients.at(tag)) { // Iterate over the recipients who wish to process the tag
-						if (has_received.find(recv) != has_received.end()) {
-							continue;
-						}
-
-						std::exception_ptr e = handle_recipient(recv, msg);
-						if (e != nullptr) {
-							ep = e;
-							break;
-						}
-
-						has_received.insert(recv);
-					}
-				}
+			rs.serial = serial;
 
-				if (ep != nullptr) {
-					break;
-				}
+			std::exception_ptr ep = handle_recipient(rs.recv, msg);
+			if (ep != nullptr) {
+				return ep;
 			}
 		}
-
-		return ep;
+		return nullptr;
 	}
 	/*
 	* internal::handle_recipient() - Handle the individual recipient
@@ -250,12 +257,14 @@ namespace bee { namespace messenger{
 	std::exception_ptr internal::handle_recipient(const MessageRecipient& recv, const MessageContents& msg) {
 		std::exception_ptr ep = nullptr;
 
-		if ((recv.is_strict)&&(msg.tags != recv.tags)) { // If the recipient is strict but the tags don't match
-			if (recv.tags.at(0) != "direct") {
+		static const Uint32 direct_tag = get_tag_id("direct");
+
+		if ((recv.is_strict)&&(msg.tag_ids != recv.tag_ids)) { // If the recipient is strict but the tags don't match
+			if (recv.tag_ids.at(0) != direct_tag) {
 				return nullptr; // Return nullptr if the recipient does not accept direct messages
 			}
 
-			if (std::find(msg.tags.begin(), msg.tags.end(), recv.name) == msg.tags.end()) {
+			if (std::find(msg.tag_ids.begin(), msg.tag_ids.end(), recv.name_id) == msg.tag_ids.end()) {
 				return nullptr; // Return nullptr if the message is not intended for the recipient
 			}
 		}
@@ -286,17 +295,104 @@ namespace bee { namespace messenger{
 		return ep;
 	}
 
+	/*
+	* internal::add_recipient() - Store the given recipient in a slot and add it to the routing tables
+	* ! Strict recipients are only routed by their exact tag list unless they accept direct messages
+	* @recv: the recipient to add
+	*/
+	int internal::add_recipient(const MessageRecipient& recv) {
+		static const Uint32 direct_tag = get_tag_id("direct");
+
+		if (recv.tags.empty()) {
+			return 1; // Return 1 when the recipient has no tags to receive
+		}
+
+		size_t slot = recipients.size();
+		if (!free_recipients.empty()) {
+			slot = free_recipients.back();
+			free_recipients.pop_back();
+		} else {
+			recipients.emplace_back();
+		}
+
+		RecipientSlot& rs = recipients[slot];
+		rs.recv = recv;
+		if (rs.recv.tag_ids.size() != rs.recv.tags.size()) { // Intern the tags if the recipient was constructed without them
+			rs.recv.tag_ids = get_tag_ids(rs.recv.tags);
+			rs.recv.name_id = get_tag_id(rs.recv.name);
+		}
+		rs.is_used = true;
+		rs.serial = 0;
+
+		if ((rs.recv.is_strict)&&(rs.recv.tag_ids[0] != direct_tag)) {
+			strict_routes[rs.recv.tag_ids].push_back(slot);
+		} else {
+			for (auto& tag : rs.recv.tag_ids) {
+				if (tag >= tag_routes.size()) {
+					tag_routes.resize(tag+1);
+				}
+				tag_routes[tag].push_back(slot);
+			}
+		}
+
+		if (std::find(rs.recv.tag_ids.begin(), rs.recv.tag_ids.end(), direct_tag) != rs.recv.tag_ids.end()) {
+			if (rs.recv.name_id >= direct_routes.size()) {
+				direct_routes.resize(rs.recv.name_id+1);
+			}
+			direct_routes[rs.recv.name_id].push_back(slot);
+		}
+
+		return 0; // Return 0 on success
+	}
+	/*
+	* internal::remove_recipient() - Remove the recipient in the given slot from the routing tables and free the slot
+	* @slot: the slot of the recipient
+	*/
+	int internal::remove_recipient(size_t slot) {
+		if ((slot >= recipients.size())||(!recipients[slot].is_used)) {
+			return 1; // Return 1 when the slot is not in use
+		}
+
+		const MessageRecipient& recv = recipients[slot].recv;
+		for (auto& tag : recv.tag_ids) {
+			remove_route(&tag_routes, tag, slot);
+		}
+		remove_route(&direct_routes, recv.name_id, slot);
+
+		auto rt = strict_routes.find(recv.tag_ids);
+		if (rt != strict_routes.end()) { // Leave the empty route in the table so that it doesn't get erased while it is being called
+			rt->second.erase(std::remove(rt->second.begin(), rt->second.end(), slot), rt->second.end());
+		}
+
+		recipients[slot].recv = MessageRecipient();
+		recipients[slot].is_used = false;
+		free_recipients.push_back(slot);
+
+		return 0; // Return 0 on success
+	}
+	/*
+	* internal::remove_route() - Remove the given recipient slot from the route of the given id
+	* @routes: the routing table
+	* @id: the tag id or name id of the route
+	* @slot: the slot of the recipient
+	*/
+	int internal::remove_route(std::vector<std::vector<size_t>>* routes, Uint32 id, size_t slot) {
+		if (id >= routes->size()) {
+			return 1; // Return 1 when the route doesn't exist
+		}
+
+		std::vector<size_t>& route = (*routes)[id];
+		route.erase(std::remove(route.begin(), route.end(), slot), route.end());
+
+		return 0; // Return 0 on success
+	}
+
 	/*
 	* internal::register_protected() - Register the given recipient with protected tags within the messaging system
 	* @recv: the recipient to register
 	*/
 	int internal::register_protected(const MessageRecipient& recv) {
-		for (auto& tag : recv.tags) { // Iterate over the requested tags
-			if (recipients.find(tag) == recipients.end()) { // If the tag doesn't exist, then create it
-				recipients.emplace(tag, std::list<MessageRecipient>()); // Emplace an empty set of recipients
-			}
-			recipients[tag].push_back(recv); // Add the recipient to the list
-		}
+		add_recipient(recv);
 		return 0; // Return 0 on success
 	}
 	/*
@@ -314,10 +410,10 @@ namespace bee { namespace messenger{
 	* @recv: the recipient to unregister
 	*/
 	int internal::unregister_protected(const std::string& name) {
-		for (auto& tag : internal::recipients) { // Iterate over all tags
-			tag.second.erase(std::remove_if(tag.second.begin(), tag.second.end(), [&name] (const MessageRecipient& recv) {
-				return (recv.name == name);
-			}), tag.second.end());
+		for (size_t slot=0; slot<recipients.size(); ++slot) { // Iterate over all recipients
+			if ((recipients[slot].is_used)&&(recipients[slot].recv.name == name)) {
+				remove_recipient(slot);
+			}
 		}
 
 		return 0; // Return 0 on success
@@ -333,6 +429,7 @@ namespace bee { namespace messenger{
 		std::exception_ptr ep = call_recipients(msg);
 
 		if (ep != nullptr) { // If an exception was thrown, throw it after finishing processing the message
+			internal::log_flush(); // Write the queued messages in case the exception isn't caught
 			std::flush(std::cout);
 			std::rethrow_exception(ep);
 		}
@@ -373,6 +470,8 @@ namespace bee { namespace messenger{
 	int register_recipient(const MessageRecipient& recv) {
 		int r = 0; // Store any attempts to register a protected tag
 
+		MessageRecipient allowed (recv); // Store the recipient with only its allowed tags
+		allowed.tags.clear();
 		for (auto& tag : recv.tags) { // Iterate over the requested tags
 			if (internal::protected_tags.find(tag) != internal::protected_tags.end()) { // If the requested tag is protected, deny registration
 				// Output an error message
@@ -385,11 +484,13 @@ namespace bee { namespace messenger{
 				continue; // Skip to the next tag
 			}
 
-			if (internal::recipients.find(tag) == internal::recipients.end()) { // If the tag doesn't exist, then create it
-				internal::recipients.emplace(tag, std::list<MessageRecipient>()); // Emplace an empty set of recipients
-			}
-			internal::recipients[tag].push_back(recv); // Add the recipient to the list
+			allowed.tags.push_back(tag);
+		}
+
+		if (r > 0) { // Re-intern the tags if any were removed
+			allowed.tag_ids = internal::get_tag_ids(allowed.tags);
 		}
+		internal::add_recipient(allowed);
 
 		return r; // Return the amount of attempts to register a protected tag
 	}
@@ -418,16 +519,17 @@ namespace bee { namespace messenger{
 	*/
 	int unregister(const std::string& name) {
 		std::string protected_tag = "";
-		for (auto& tag : internal::recipients) { // Iterate over all tags
-			tag.second.erase(std::remove_if(tag.second.begin(), tag.second.end(), [&name, &tag, &protected_tag] (const MessageRecipient& recv) {
-				if (recv.name == name) {
-					if (internal::protected_tags.find(tag.first) != internal::protected_tags.end()) { // If the specific tag is protected, deny removal for any tags
-						protected_tag = tag.first;
-					}
-					return protected_tag.empty();
+		for (auto& rs : internal::recipients) { // Iterate over all recipients
+			if ((!rs.is_used)||(rs.recv.name != name)) {
+				continue;
+			}
+
+			for (auto& tag : rs.recv.tags) {
+				if (internal::protected_tags.find(tag) != internal::protected_tags.end()) { // If the specific tag is protected, deny removal for any tags
+					protected_tag = tag;
+					break;
 				}
-				return false;
-			}), tag.second.end());
+			}
 		}
 
 		if (!protected_tag.empty()) {
@@ -439,6 +541,8 @@ namespace bee { namespace messenger{
 			return 1; // Return 1 on denial by protected tag
 		}
 
+		internal::unregister_protected(name);
+
 		return 0;
 	}
 	/*
@@ -448,27 +552,35 @@ namespace bee { namespace messenger{
 	*   This function may be protected in the future
 	*/
 	int unregister_all() {
-		int r = 0; // Store any attempts to unregister a protected tag
+		std::set<std::string> denied_tags; // Store the protected tags which couldn't be unregistered
+		for (size_t slot=0; slot<internal::recipients.size(); ++slot) { // Iterate over all recipients
+			if (!internal::recipients[slot].is_used) {
+				continue;
+			}
 
-		for (auto& tag : internal::recipients) { // Iterate over all recipient tags
-			if (internal::protected_tags.find(tag.first) != internal::protected_tags.end()) { // If the specific tag is protected, deny removal
-				r++; // Increment the protection counter
-				continue; // Skip to the next tag
+			const MessageRecipient& recv = internal::recipients[slot].recv;
+			bool is_protected = false;
+			for (auto& tag : recv.tags) {
+				if (internal::protected_tags.find(tag) != internal::protected_tags.end()) {
+					is_protected = true;
+					denied_tags.insert(tag);
+				}
 			}
 
-			tag.second.clear(); // Remove all recipients who are registered with this tag
-		}
+			if (!is_protected) {
+				internal::remove_recipient(slot);
+				continue;
+			}
 
-		// Remove all non-protected tags
-		for (auto tag=internal::recipients.begin(); tag!=internal::recipients.end();) {
-			if (internal::protected_tags.find((*tag).first) == internal::protected_tags.end()) { // If the tag is not protected, remove it
-				tag = internal::recipients.erase(tag);
-			} else { // It the tag is protected, skip it
-				++tag;
+			// Only keep the routes of the protected tags
+			for (size_t i=0; i<recv.tags.size(); ++i) {
+				if (internal::protected_tags.find(recv.tags[i]) == internal::protected_tags.end()) {
+					internal::remove_route(&internal::tag_routes, recv.tag_ids[i], slot);
+				}
 			}
+			internal::remove_route(&internal::direct_routes, recv.name_id, slot);
 		}
-
-		return r; // Return the amount of attempts to unregister a protected tag
+		return denied_tags.size(); // Return the amount of attempts to unregister a protected tag
 	}
 
 	/*
@@ -476,6 +588,7 @@ namespace bee { namespace messenger{
 	* @m: the message to queue
 	*/
 	int send(const MessageContents& m) {
+		std::lock_guard<std::mutex> lock (internal::messages_mutex);
 		internal::messages.push_back(m); // Add the message to the list
 		return 0; // Return 0 on success
 	}
@@ -532,91 +645,6 @@ namespace bee { namespace messenger{
 		return 0;
 	}
 
-	/*
-	* add_log() - Add a filename as a log file
-	* ! This function can also be used to change the output level of existing log files
-	* @filename: the file to log to
-	* @level: the output level to log
-	*/
-	int add_log(const std::string& filename, E_OUTPUT level) {
-		if (filename == "stdout") { // Deny overwriting stdout via this function
-			return 1;
-		}
-
-		std::ofstream* logfile = new std::ofstream(filename);
-		if (!logfile->is_open()) {
-			send({"engine", "messenger"}, E_MESSAGE::ERROR, "Failed to open log file \"" + filename + "\"");
-			return 2;
-		}
-
-		internal::logfiles[filename] = std::make_pair(level, logfile);
-
-		return 0;
-	}
-	/*
-	* remove_log() - Remove the given filename from being a log file
-	* @filename: the filename to remove
-	* @should_delete: whether the file should also be deleted
-	*/
-	int remove_log(const std::string& filename, bool should_delete) {
-		if (filename == "stdout") { // Deny removing stdout via this function
-			return 1;
-		}
-
-		if (internal::logfiles.find(filename) == internal::logfiles.end()) {
-			send({"engine", "messenger"}, E_MESSAGE::WARNING, "The log file \"" + filename + "\" could not be removed because it has not been added");
-			return 2;
-		}
-
-		internal::logfiles.at(filename).second->close();
-		delete internal::logfiles.at(filename).second;
-
-		internal::logfiles.erase(filename);
-
-		if (should_delete) {
-			file_delete(filename);
-		}
-
-		return 0;
-	}
-	/*
-	* clear_logs() - Clear all log files except stdout
-	* @should_delete: Whether the log files should be deleted
-	*/
-	int clear_logs(bool should_delete) {
-		for (auto it=internal::logfiles.begin(); it!=internal::logfiles.end(); ) {
-			if (it->first == "stdout") {
-				++it;
-				continue;
-			}
-
-			it->second.second->close();
-			delete it->second.second;
-
-			if (should_delete) {
-				file_delete(it->first);
-			}
-
-			internal::logfiles.erase(it++);
-		}
-		return 0;
-	}
-
-	/*
-	* set_level() - Set the output level when printing message descriptions
-	* @level: the output level to use
-	*/
-	int set_level(E_OUTPUT level) {
-		internal::logfiles["stdout"] = std::make_pair(level, nullptr);
-		return 0;
-	}
-	/*
-	* get_level() - Return the output level when printing message descriptions
-	*/
-	E_OUTPUT get_level() {
-		return internal::logfiles["stdout"].first;
-	}
-
 	/*
 	* handle() - Handle all queued messaged and execute the recipients' functions
 	* ! This function will be called from the main loop at the end of every frame
@@ -625,33 +653,36 @@ namespace bee { namespace messenger{
 	*/
 	int handle() {
 		const Uint32 t = get_ticks(); // Get the current tick to compare with message tickstamps
-		const std::vector<MessageContents> messages (internal::messages); // Swap the message list to prevent immediate processing of messages sent from recipients
-		internal::messages.clear();
-
-		// Print message descriptions
-		for (auto& msg : messages) { // Iterate over the messages
-			if ((t < msg.tickstamp)&&(engine != nullptr)) { // If the message should be processed in the future, skip it
-				continue;
-			}
-
-			internal::output_msg(msg);
+		std::vector<MessageContents> messages;
+		messages.swap(internal::handled_messages); // Take the spare buffer, which is empty if handle() is being called from a recipient
+		{
+			std::lock_guard<std::mutex> lock (internal::messages_mutex);
+			messages.swap(internal::messages); // Swap the message list to prevent immediate processing of messages sent from recipients
 		}
 
-		// Process messages with recipient functions
+		// Print the message descriptions and process them with the recipient functions
 		std::exception_ptr ep = nullptr; // Store any thrown values
 		for (auto& msg : messages) { // Iterate over the messages
 			if ((t < msg.tickstamp)&&(engine != nullptr)) { // If the message should be processed in the future, skip it
-				internal::messages.push_back(msg); // Append it to the new message list
+				send(msg); // Append it to the new message list
 				continue;
 			}
 
+			internal::output_msg(msg);
+
 			std::exception_ptr e = internal::call_recipients(msg);
 			if (e != nullptr) {
 				ep = e;
 			}
 		}
 
+		messages.clear(); // Keep the buffer's capacity for the next frame
+		if (internal::handled_messages.capacity() < messages.capacity()) {
+			messages.swap(internal::handled_messages);
+		}
+
 		if (ep != nullptr) { // If an exception was thrown, throw it after finishing processing the message
+			internal::log_flush(); // Write the queued messages in case the exception isn't caught
 			std::flush(std::cout);
 			std::rethrow_exception(ep);
 		}
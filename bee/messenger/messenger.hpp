@@ -21,12 +21,19 @@ namespace bee { namespace messenger {
 	int clear();
 
 	namespace internal {
+		Uint32 get_tag_id(const std::string&);
+		std::vector<Uint32> get_tag_ids(const std::vector<std::string>&);
+
 		int output_msg(const MessageContents&);
-		int print_msg(const std::string&, const MessageContents&);
-		bool should_print(E_OUTPUT, E_MESSAGE);
 		std::exception_ptr call_recipients(const MessageContents&);
+		std::exception_ptr call_route(std::vector<std::vector<size_t>>*, Uint32, Uint32, const MessageContents&);
+		std::exception_ptr call_route(std::vector<size_t>*, Uint32, const MessageContents&);
 		std::exception_ptr handle_recipient(const MessageRecipient&, const MessageContents&);
 
+		int add_recipient(const MessageRecipient&);
+		int remove_recipient(size_t);
+		int remove_route(std::vector<std::vector<size_t>>*, Uint32, size_t);
+
 		int register_protected(const MessageRecipient&);
 		int register_protected(const std::string&, const std::vector<std::string>&, bool, std::function<void (const MessageContents&)>);
 		int unregister_protected(const std::string&);
@@ -52,8 +59,10 @@ namespace bee { namespace messenger {
 	int reset_filter();
 
 	int add_log(const std::string&, E_OUTPUT);
+	int add_log(const std::string&, E_OUTPUT, bool);
 	int remove_log(const std::string&, bool);
 	int clear_logs(bool);
+	int decode_log(const std::string&, std::vector<MessageContents>*);
 
 	int set_level(E_OUTPUT);
 	E_OUTPUT get_level();
@@ -17,14 +17,16 @@ namespace bee {
 		channel(-1),
 		last_recv(0),
 		id(-1),
-		name()
+		name(),
+		snapshot_ack(-1)
 	{}
 	NetworkClient::NetworkClient(UDPsocket _sock, int _channel) :
 		sock(_sock),
 		channel(_channel),
 		last_recv(0),
 		id(-1),
-		name()
+		name(),
+		snapshot_ack(-1)
 	{}
 }
 
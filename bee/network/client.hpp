@@ -20,6 +20,7 @@ namespace bee {
 		Uint32 last_recv;
 		int id;
 		std::string name;
+		int snapshot_ack; // The sequence of the latest snapshot which the client has acknowledged, or -1 when it needs a keyframe
 
 		NetworkClient();
 		NetworkClient(UDPsocket, int);
@@ -18,6 +18,9 @@ namespace bee {
 	NetworkConnection::NetworkConnection() :
 		udp_sock(nullptr),
 		udp_data(nullptr),
+		udp_batch(nullptr),
+		udp_batch_size(0),
+		udp_batch_index(0),
 
 		is_connected(false),
 		is_host(false),
@@ -32,7 +35,10 @@ namespace bee {
 
 		buffer(),
 		data(),
-		instances()
+		instances(),
+
+		snapshot_sequence(0),
+		snapshots()
 	{}
 
 	int NetworkConnection::get_new_player_id() const {
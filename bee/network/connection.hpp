@@ -11,12 +11,15 @@
 
 #include <string>
 #include <map>
+#include <unordered_map>
 #include <memory>
 
 #include <SDL2/SDL_net.h>
 
 #include "../data/sidp.hpp"
 
+#include "snapshot.hpp"
+
 namespace bee {
 	// Forward declarations
 	struct NetworkClient;
@@ -25,7 +28,10 @@ namespace bee {
 
 	struct NetworkConnection {
 		UDPsocket udp_sock;
-		UDPpacket* udp_data;
+		UDPpacket* udp_data; // The received datagram which is currently being handled
+		UDPpacket** udp_batch; // The buffers which are filled by each batch of received datagrams
+		int udp_batch_size;
+		int udp_batch_index;
 
 		bool is_connected;
 		bool is_host;
@@ -38,10 +44,13 @@ namespace bee {
 		int self_id;
 		std::map<int,NetworkClient> players;
 
-		std::map<Uint16,std::unique_ptr<NetworkPacket>> buffer;
+		std::unordered_map<Uint32,std::unique_ptr<NetworkPacket>> buffer; // The partially received packets, keyed by the sender id and packet id
 		std::map<std::string,SIDP> data;
 		std::map<std::string,Instance*> instances;
 
+		Uint16 snapshot_sequence; // The sequence of the next snapshot for the host, or of the latest snapshot for clients
+		std::map<Uint16,NetworkSnapshot> snapshots; // The recent snapshots which can be used as delta baselines
+
 		NetworkConnection();
 
 		int get_new_player_id() const;
@@ -9,7 +9,9 @@
 #ifndef BEE_NETWORK_DATA
 #define BEE_NETWORK_DATA 1
 
-#include "data.hpp"
+#include <cstring> // Include the required library headers
+
+#include "data.hpp" // Include the engine headers
 
 #include "../messenger/messenger.hpp"
 
@@ -40,6 +42,11 @@ namespace bee {
 	{
 		append_data(_data);
 	}
+	NetworkData::NetworkData(E_NETSIG1 signal1, E_NETSIG2 signal2, std::vector<Uint8>&& _data) :
+		NetworkData(signal1, signal2)
+	{
+		data = std::move(_data);
+	}
 	NetworkData::NetworkData(const NetworkData& other) :
 		signals(other.signals),
 		data(other.data)
@@ -77,7 +84,23 @@ namespace bee {
 		return 0;
 	}
 
-	std::vector<Uint8> NetworkData::get() const {
+	/*
+	* NetworkData::set_data() - Copy the given bytes to the given offset, growing the data if necessary
+	* @offset: the offset to copy to
+	* @new_data: the bytes to copy
+	* @size: the amount of bytes to copy
+	*/
+	int NetworkData::set_data(size_t offset, const Uint8* new_data, size_t size) {
+		if (data.size() < offset + size) {
+			data.resize(offset + size);
+		}
+		if (size > 0) {
+			memcpy(data.data()+offset, new_data, size);
+		}
+		return 0;
+	}
+
+	const std::vector<Uint8>& NetworkData::get() const {
 		return data;
 	}
 
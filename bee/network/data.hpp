@@ -28,6 +28,7 @@ namespace bee {
 		explicit NetworkData(Uint8);
 		NetworkData(E_NETSIG1, E_NETSIG2);
 		NetworkData(E_NETSIG1, E_NETSIG2, const std::vector<Uint8>&);
+		NetworkData(E_NETSIG1, E_NETSIG2, std::vector<Uint8>&&);
 		NetworkData(const NetworkData&);
 		~NetworkData();
 		int reset();
@@ -36,8 +37,9 @@ namespace bee {
 
 		int append_data(const std::vector<Uint8>&);
 		int append_data(const std::vector<Uint8>&, size_t);
+		int set_data(size_t, const Uint8*, size_t);
 
-		std::vector<Uint8> get() const;
+		const std::vector<Uint8>& get() const;
 
 		Uint8 get_signals() const;
 		E_NETSIG1 get_signal1() const;
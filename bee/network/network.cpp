@@ -35,6 +35,8 @@
 #include "connection.hpp"
 #include "event.hpp"
 #include "packet.hpp"
+#include "snapshot.hpp"
+#include "thread.hpp"
 
 #include "../resource/room.hpp"
 
@@ -51,6 +53,7 @@
 	4	client info update
 		3	keyframe data update
 		4	delta data update
+		5	snapshot acknowledgement
 */
 
 namespace bee { namespace net {
@@ -130,9 +133,18 @@ namespace bee { namespace net {
 		}
 
 		std::unique_ptr<NetworkPacket> packet;
-		while ((packet = recv_packet(internal::connection)) != nullptr) { // Iterate over the received packets
-			if (internal::connection->udp_data->len < static_cast<int>(NetworkPacket::META_SIZE)) {
-				continue; // Continue when the data doesn't contain metadata
+		while (true) { // Iterate over the received packets
+			if (internal::get_is_threaded()) {
+				packet = internal::thread_recv(); // Take the packets which the network thread has already decoded and reassembled
+			} else {
+				packet = recv_packet(internal::connection);
+			}
+			if (packet == nullptr) {
+				break;
+			}
+
+			if (packet->get_signal1() == E_NETSIG1::INVALID) {
+				continue; // Continue when the data was malformed
 			}
 
 			if (internal::connection->is_host) { // Handle session hosting signals
@@ -142,6 +154,12 @@ namespace bee { namespace net {
 			}
 		}
 
+		if (internal::connection == nullptr) {
+			return 2; // Return 2 when the session ended while handling the received packets
+		}
+
+		internal::prune_buffer(); // Drop packets whose remaining fragments were lost
+
 		if (internal::has_data_update) {
 			if (internal::connection->is_host) {
 				internal::host_send_data(-1);
@@ -188,6 +206,10 @@ namespace bee { namespace net {
 		internal::connection->is_connected = true;
 		internal::connection->is_host = true;
 
+		if (get_options().is_network_threaded) {
+			internal::thread_start(internal::connection->udp_sock, -1, true, internal::timeout);
+		}
+
 		return 0; // Return 0 on success
 	}
 	/*
@@ -227,35 +249,17 @@ namespace bee { namespace net {
 		}
 		p.reset();
 
-		internal::connection->udp_data = network_packet_realloc(internal::connection->udp_data, NetworkPacket::MAX_SIZE);
-		if (internal::connection->udp_data == nullptr) { // Attempt to allocate space to receive data
-			network_udp_close(&internal::connection->udp_sock); // Close the socket
-
-			messenger::send({"engine", "network"}, E_MESSAGE::WARNING, "net::session_find() : Failed to allocate space to receive data");
-			return internal::servers; // Return an empty map if the allocation failed
-		}
-
 		Uint32 t = get_ticks(); // Get the current time
-		int r = network_udp_recv(internal::connection->udp_sock, internal::connection->udp_data); // Attempt to receive data
 		while (get_ticks() - t < internal::timeout) { // Continue receiving until we timeout
+			p = recv_packet(internal::connection); // Attempt to receive data
 			if (
-				(r == 1)
-				&&(internal::connection->udp_data->len > static_cast<int>(NetworkPacket::META_SIZE))
+				(p != nullptr)
+				&&(p->get_signal1() == E_NETSIG1::SERVER_INFO)
+				&&(p->get_signal2() == E_NETSIG2::NAME)
 			) {
-				p = std::make_unique<NetworkPacket>(
-					internal::connection->udp_data
-				);
-
-				if (
-					(p->get_signal1() == E_NETSIG1::SERVER_INFO)
-					&&(p->get_signal2() == E_NETSIG2::NAME)
-				) {
-					std::string name = chra(p->get_raw()); // Get the server name from the data
-					internal::servers.emplace(network_get_address(internal::connection->udp_data->address.host), name); // Add the server to the list of available servers
-				}
+				std::string name = chra(p->get_raw()); // Get the server name from the data
+				internal::servers.emplace(network_get_address(p->address.host), name); // Add the server to the list of available servers
 			}
-
-			r = network_udp_recv(internal::connection->udp_sock, internal::connection->udp_data); // Attempt to receive more data
 		}
 
 		network_udp_close(&internal::connection->udp_sock); // Close the socket
@@ -302,6 +306,10 @@ namespace bee { namespace net {
 
 		internal::connection->last_recv = get_ticks();
 
+		if (get_options().is_network_threaded) {
+			internal::thread_start(internal::connection->udp_sock, internal::connection->channel, false, internal::timeout);
+		}
+
 		return 0; // Return 0 on success
 	}
 	/*
@@ -353,15 +361,21 @@ namespace bee { namespace net {
 			}
 		}
 
+		internal::thread_stop(); // Stop the network thread after it sends the disconnection signals
+
 		// Close socket and free data
 		if (internal::connection->udp_sock != nullptr) {
 			network_udp_close(&internal::connection->udp_sock);
 			internal::connection->udp_sock = nullptr;
 		}
-		if (internal::connection->udp_data != nullptr) {
-			network_packet_free(internal::connection->udp_data);
-			internal::connection->udp_data = nullptr;
+		if (internal::connection->udp_batch != nullptr) {
+			network_packet_free_vector(internal::connection->udp_batch);
+			internal::connection->udp_batch = nullptr;
 		}
+		internal::connection->udp_data = nullptr;
+		internal::connection->udp_batch_size = 0;
+		internal::connection->udp_batch_index = 0;
+		internal::free_packet_pool();
 
 		// Reset connection and client info
 		internal::connection->is_connected = false;
@@ -459,9 +473,10 @@ namespace bee { namespace net {
 
 	/*
 	* internal::host_handle_packet() - Handle clients and data syncing
+	* ! Complete data packets are moved out of the given pointer, which is left empty
 	* @packet: the packet to handle
 	*/
-	int internal::host_handle_packet(std::unique_ptr<NetworkPacket> const & packet) {
+	int internal::host_handle_packet(std::unique_ptr<NetworkPacket>& packet) {
 		switch (packet->get_signal1()) {
 			case E_NETSIG1::CONNECT: {
 				if (internal::connection->players.size() < internal::connection->max_players) { // If there is still room for clients then allow the current one to connect
@@ -475,7 +490,7 @@ namespace bee { namespace net {
 						break;
 					}
 
-					IPaddress ipa = internal::connection->udp_data->address;
+					IPaddress ipa = packet->address;
 					//ipa.port = port;
 					c.channel = network_udp_bind(&c.sock, c.id, &ipa); // Bind a sending socket to the client who is requesting a connection
 					if (c.channel == -1) {
@@ -564,7 +579,7 @@ namespace bee { namespace net {
 				switch (packet->get_signal2()) {
 					case E_NETSIG2::KEEPALIVE: {
 						NetworkClient& c = internal::connection->players[packet->id];
-						c.last_recv = get_ticks();
+						c.last_recv = packet->get_recv_time(); // Use the time that the packet arrived in case the frame was slow
 						break;
 					}
 					case E_NETSIG2::NAME: {
@@ -613,35 +628,19 @@ namespace bee { namespace net {
 			case E_NETSIG1::CLIENT_INFO: { // Client info update
 				switch (packet->get_signal2()) {
 					case E_NETSIG2::KEYFRAME: {
-						std::map<Uint16,std::unique_ptr<NetworkPacket>>& buffer = internal::connection->buffer;
-
-						// Buffer the received data if necessary
-						if (buffer.find(packet->get_packet_id()) == buffer.end()) {
-							buffer.emplace(
-								packet->get_packet_id(),
-								std::make_unique<NetworkPacket>(
-									internal::connection->udp_data
-								)
-							);
-						} else {
-							buffer[packet->get_packet_id()]->append_net(internal::connection->udp_data);
-						}
-
-						if (!buffer[packet->get_packet_id()]->get_is_sequence_complete()) { // Break when only a partial map has been received
+						std::unique_ptr<NetworkPacket> full_packet = internal::buffer_packet(packet);
+						if (full_packet == nullptr) { // Break when only a partial map has been received
 							break;
 						}
 
 						NetworkEvent e (E_NETEVENT::DATA_UPDATE);
-						e.id = packet->id;
+						e.id = full_packet->id;
 
-						SerialData d (buffer[packet->get_packet_id()]->get_raw());
+						SerialData d (full_packet->get_raw());
 						d.store_serial_m(e.instances);
 
-						buffer[packet->get_packet_id()].reset();
-						buffer.erase(packet->get_packet_id());
-
 						internal::has_data_update = true;
-						internal::connection->players[packet->id].last_recv = get_ticks();
+						internal::connection->players[full_packet->id].last_recv = get_ticks();
 
 						messenger::send({"engine", "network"}, E_MESSAGE::INTERNAL, "Received data map:\n" + map_serialize(e.instances, true));
 
@@ -652,6 +651,23 @@ namespace bee { namespace net {
 					case E_NETSIG2::DELTA: {
 						break;
 					}
+					case E_NETSIG2::ACK: {
+						std::vector<Uint8> data = packet->get_raw();
+						if (data.size() < 2) {
+							break;
+						}
+
+						NetworkClient& c = internal::connection->players[packet->id];
+						c.last_recv = get_ticks();
+
+						// Only move the baseline forward since acknowledgements can arrive out of order
+						const Uint16 sequence = static_cast<Uint16>((data[0] << 8) | data[1]);
+						if ((c.snapshot_ack < 0)||(NetworkSnapshot::get_is_newer(sequence, static_cast<Uint16>(c.snapshot_ack)))) {
+							c.snapshot_ack = sequence;
+						}
+
+						break;
+					}
 					default: {
 						messenger::send({"engine", "network"}, E_MESSAGE::WARNING, "Unknown network signal: 3." + bee_itos(static_cast<int>(packet->get_signal2())));
 					}
@@ -675,7 +691,7 @@ namespace bee { namespace net {
 		for (auto& p : internal::connection->players) { // Iterate over the connected players and insert their id and name into the new map
 			t.emplace(p.first, p.second.name);
 		}
-		SerialData player_map (32); // Encode the data map as a series of Uint8's
+		SerialData player_map (32, true); // Encode the data map as a series of Uint8's
 		player_map.store_map(t);
 
 		// See Network Message Format at the top of this file for details
@@ -716,25 +732,18 @@ namespace bee { namespace net {
 		return (has_failed) ? 1 : 0;
 	}
 	/*
-	* internal::host_send_data() - Send the data map to the given client
-	* @id: the id of the given client, -1 will send to all clients
+	* internal::host_send_data() - Send a snapshot of the synced instances to the given client
+	* ! Clients which have acknowledged a recent snapshot only receive the fields which changed since then,
+	*   all other clients receive a keyframe of every instance
+	* @id: the id of the given client, -1 will send to all clients, otherwise the client will always receive a keyframe
 	*/
 	int internal::host_send_data(int id) {
-		//std::vector<Uint8> data_map = network_map_encode(internal::connection->data); // Encode the data map as a series of Uint8's
-		std::map<std::string,std::vector<Uint8>> instances;
-		for (auto& inst : internal::connection->instances) {
-			instances.emplace(inst.first, inst.second->serialize_net());
-		}
-		SerialData data_map (32); // Encode the data map as a series of Uint8's
-		data_map.store_serial_m(instances);
-
-		// See Network Message Format at the top of this file for details
-		auto p = std::make_unique<NetworkPacket>(
-			internal::connection->self_id,
-			E_NETSIG1::SERVER_INFO,
-			E_NETSIG2::KEYFRAME,
-			data_map.get()
-		);
+		// Capture the current state as the next snapshot and forget the snapshots which are too old to be baselines
+		const Uint16 sequence = internal::connection->snapshot_sequence++;
+		std::map<Uint16,NetworkSnapshot>& snapshots = internal::connection->snapshots;
+		snapshots.erase(static_cast<Uint16>(sequence - BEE_NET_SNAPSHOT_HISTORY));
+		snapshots[sequence] = NetworkSnapshot(sequence, internal::connection->instances);
+		const NetworkSnapshot& snapshot = snapshots[sequence];
 
 		std::vector<int> ids;
 		if (id < 1) {
@@ -747,11 +756,35 @@ namespace bee { namespace net {
 			ids.push_back(id);
 		}
 
+		std::unique_ptr<NetworkPacket> keyframe; // The keyframe is only encoded once for all of the clients which need it
 		bool has_failed = false;
 		for (auto& i : ids) {
 			NetworkClient& c = internal::connection->players[i];
 
-			if (send_packet(c, p) == 0) { // Send the entire message
+			auto baseline = snapshots.end();
+			if ((id < 1)&&(c.snapshot_ack >= 0)) {
+				baseline = snapshots.find(static_cast<Uint16>(c.snapshot_ack));
+			}
+
+			std::unique_ptr<NetworkPacket> delta;
+			if (baseline != snapshots.end()) {
+				// See Network Message Format at the top of this file for details
+				delta = std::make_unique<NetworkPacket>(
+					internal::connection->self_id,
+					E_NETSIG1::SERVER_INFO,
+					E_NETSIG2::DELTA,
+					snapshot.serialize_delta(baseline->second)
+				);
+			} else if (keyframe == nullptr) {
+				keyframe = std::make_unique<NetworkPacket>(
+					internal::connection->self_id,
+					E_NETSIG1::SERVER_INFO,
+					E_NETSIG2::KEYFRAME,
+					snapshot.serialize_keyframe()
+				);
+			}
+
+			if (queue_packet(c, (delta != nullptr) ? delta : keyframe) == 0) { // Queue the entire message so that every client is sent to in a single batch
 				network_udp_close(&c.sock);
 				internal::connection->instances.erase("player_"+bee_itos(i));
 				internal::connection->players.erase(i);
@@ -762,6 +795,8 @@ namespace bee { namespace net {
 			}
 		}
 
+		flush_packets(internal::connection->udp_sock);
+
 		return (has_failed) ? 1 : 0;
 	}
 	/*
@@ -809,16 +844,18 @@ namespace bee { namespace net {
 
 	/*
 	* internal::client_handle_packet() - Handle the connection to the host and data syncing
+	* ! Complete data packets are moved out of the given pointer, which is left empty
 	* @packet: the packet to handle
 	*/
-	int internal::client_handle_packet(std::unique_ptr<NetworkPacket> const & packet) {
-		internal::connection->last_recv = get_ticks();
+	int internal::client_handle_packet(std::unique_ptr<NetworkPacket>& packet) {
+		internal::connection->last_recv = packet->get_recv_time();
 		switch (packet->get_signal1()) {
 			case E_NETSIG1::CONNECT: { // Connection accepted
 				internal::connection->self_id = packet->get_raw()[0]; // Read the id that the server assigned to us
 				internal::connection->is_connected = true; // Mark our networking as connected
+				internal::thread_set_id(internal::connection->self_id);
 
-				internal::time_offset = packet->get_time() - get_ticks();
+				internal::time_offset = packet->get_time() - packet->get_recv_time();
 
 				NetworkEvent e (E_NETEVENT::CONNECT);
 				e.id = packet->id;
@@ -841,6 +878,10 @@ namespace bee { namespace net {
 			case E_NETSIG1::SERVER_INFO: { // Server info received
 				switch (packet->get_signal2()) {
 					case E_NETSIG2::KEEPALIVE: {
+						if (internal::get_is_threaded()) {
+							break; // Break when the network thread has already replied
+						}
+
 						NetworkClient c (internal::connection->udp_sock, internal::connection->channel);
 
 						// See Network Message Format at the top of this file for details
@@ -857,7 +898,7 @@ namespace bee { namespace net {
 						break;
 					}
 					case E_NETSIG2::NAME: {
-						std::string ip = network_get_address(internal::connection->udp_data->address.host); // Get the server IP
+						std::string ip = network_get_address(packet->address.host); // Get the server IP
 						std::string name = chra(packet->get_raw()); // Get the server name from the data
 
 						internal::servers.emplace(ip, name); // Add the server to the list of available servers
@@ -882,44 +923,17 @@ namespace bee { namespace net {
 
 						break;
 					}
-					case E_NETSIG2::KEYFRAME: {
-						std::map<Uint16,std::unique_ptr<NetworkPacket>>& buffer = internal::connection->buffer;
-
-						// Buffer the received data if necessary
-						if (buffer.find(packet->get_packet_id()) == buffer.end()) {
-							buffer.emplace(
-								packet->get_packet_id(),
-								std::make_unique<NetworkPacket>(
-									internal::connection->udp_data
-								)
-							);
-						} else {
-							buffer[packet->get_packet_id()]->append_net(internal::connection->udp_data);
-						}
-
-						if (!buffer[packet->get_packet_id()]->get_is_sequence_complete()) { // Break when only a partial map has been received
+					case E_NETSIG2::KEYFRAME:
+					case E_NETSIG2::DELTA: {
+						std::unique_ptr<NetworkPacket> full_packet = internal::buffer_packet(packet);
+						if (full_packet == nullptr) { // Break when only a partial snapshot has been received
 							break;
 						}
 
-						NetworkEvent e (E_NETEVENT::DATA_UPDATE);
-
-						/*internal::connection->data.clear();
-						SerialData(buffer[packet->get_packet_id()]->get_raw()).store_map(internal::connection->data); // Decode the data map directly
-						e.data = std::map<std::string,SIDP>(internal::connection->data);*/
-						SerialData(buffer[packet->get_packet_id()]->get_raw()).store_serial_m(e.instances);
-
-						buffer[packet->get_packet_id()].reset();
-						buffer.erase(packet->get_packet_id());
-
-						messenger::send({"engine", "network"}, E_MESSAGE::INTERNAL, "Received data map:\n" + map_serialize(e.instances, true));
-
-						get_current_room()->network(e);
+						internal::client_handle_snapshot(full_packet);
 
 						break;
 					}
-					case E_NETSIG2::DELTA: {
-						break;
-					}
 					default: {
 						messenger::send({"engine", "network"}, E_MESSAGE::WARNING, "Unknown network signal: 3." + bee_itos(static_cast<int>(packet->get_signal2())));
 					}
@@ -934,6 +948,89 @@ namespace bee { namespace net {
 		return 0;
 	}
 	/*
+	* internal::client_handle_snapshot() - Apply a received keyframe or delta snapshot and send the data map to the room
+	* @packet: the complete snapshot packet
+	*/
+	int internal::client_handle_snapshot(std::unique_ptr<NetworkPacket> const & packet) {
+		std::map<Uint16,NetworkSnapshot>& snapshots = internal::connection->snapshots;
+
+		NetworkSnapshot snapshot;
+		if (packet->get_signal2() == E_NETSIG2::KEYFRAME) {
+			if (snapshot.deserialize_keyframe(packet->get_raw())) {
+				messenger::send({"engine", "network"}, E_MESSAGE::WARNING, "Failed to read keyframe from server");
+				return 1; // Return 1 when the keyframe is invalid
+			}
+		} else {
+			int r = snapshot.deserialize_delta(snapshots, packet->get_raw());
+			if (r == 2) { // Request a keyframe when the baseline has already been forgotten
+				NetworkClient c (internal::connection->udp_sock, internal::connection->channel);
+				auto p = std::make_unique<NetworkPacket>(
+					internal::connection->self_id,
+					E_NETSIG1::SERVER_INFO,
+					E_NETSIG2::KEYFRAME
+				);
+				send_packet(c, p);
+				return 2; // Return 2 when the delta can't be applied
+			} else if (r) {
+				messenger::send({"engine", "network"}, E_MESSAGE::WARNING, "Failed to read delta from server");
+				return 1;
+			}
+		}
+
+		if ((!snapshots.empty())&&(!NetworkSnapshot::get_is_newer(snapshot.sequence, internal::connection->snapshot_sequence))) {
+			return 3; // Return 3 when the snapshot arrived out of order
+		}
+
+		const Uint16 sequence = snapshot.sequence;
+		internal::client_send_ack(sequence);
+
+		NetworkEvent e (E_NETEVENT::DATA_UPDATE);
+		e.instances = snapshot.get_instances();
+
+		// Keep the snapshot as a possible baseline for future deltas
+		// Every snapshot outside of the window is forgotten since lost or reordered sequences leave gaps
+		const Uint16 oldest = static_cast<Uint16>(sequence - BEE_NET_SNAPSHOT_HISTORY);
+		for (auto it=snapshots.begin(); it!=snapshots.end(); ) {
+			if (!NetworkSnapshot::get_is_newer(it->first, oldest)) {
+				it = snapshots.erase(it);
+			} else {
+				++it;
+			}
+		}
+		snapshots[sequence] = std::move(snapshot);
+		internal::connection->snapshot_sequence = sequence;
+
+		messenger::send({"engine", "network"}, E_MESSAGE::INTERNAL, "Received data map:\n" + map_serialize(e.instances, true));
+
+		get_current_room()->network(e);
+
+		return 0; // Return 0 on success
+	}
+	/*
+	* internal::client_send_ack() - Acknowledge the given snapshot so that the server can use it as a delta baseline
+	* @sequence: the sequence of the received snapshot
+	*/
+	int internal::client_send_ack(Uint16 sequence) {
+		std::vector<Uint8> data = {static_cast<Uint8>(sequence >> 8), static_cast<Uint8>(sequence)};
+
+		// See Network Message Format at the top of this file for details
+		auto p = std::make_unique<NetworkPacket>(
+			internal::connection->self_id,
+			E_NETSIG1::CLIENT_INFO,
+			E_NETSIG2::ACK,
+			data
+		);
+
+		NetworkClient c (internal::connection->udp_sock, internal::connection->channel);
+
+		if (send_packet(c, p) == 0) {
+			messenger::send({"engine", "network"}, E_MESSAGE::WARNING, "Could not send snapshot acknowledgement to server");
+			return 1; // Return 1 when the acknowledgement failed to send
+		}
+
+		return 0; // Return 0 on success
+	}
+	/*
 	* internal::client_send_data() - Send the client data map to the server
 	*/
 	int internal::client_send_data() {
@@ -942,7 +1039,7 @@ namespace bee { namespace net {
 		for (auto& inst : internal::connection->instances) {
 			instances.emplace(inst.first, inst.second->serialize_net());
 		}
-		SerialData data_map (32); // Encode the data map as a series of Uint8's
+		SerialData data_map (32, true); // Encode the data map as a series of Uint8's
 		data_map.store_serial_m(instances);
 
 		// See Network Message Format at the top of this file for details
@@ -976,6 +1073,63 @@ namespace bee { namespace net {
 		return 0;
 	}
 
+	/*
+	* internal::buffer_packet() - Add the given packet to the buffer of partially received packets
+	* ! When the packet completes its sequence, it is removed from the buffer and returned
+	* ! When the packet was already complete, it is moved out of the given pointer, which is left empty
+	* @packet: the received packet
+	*/
+	std::unique_ptr<NetworkPacket> internal::buffer_packet(std::unique_ptr<NetworkPacket>& packet) {
+		if (packet->get_is_sequence_complete()) {
+			return std::move(packet); // Return the packet itself when it was already reassembled or only had a single fragment
+		}
+
+		std::unordered_map<Uint32,std::unique_ptr<NetworkPacket>>& buffer = internal::connection->buffer;
+
+		// Buffer the received data if necessary, packet ids are only unique per sender
+		const Uint32 key = (static_cast<Uint32>(packet->id) << 16) | packet->get_packet_id();
+		auto it = buffer.find(key);
+		if (it == buffer.end()) {
+			if (!internal::get_can_buffer(buffer, packet->id)) {
+				messenger::send({"engine", "network"}, E_MESSAGE::WARNING, "Dropped packet " + bee_itos(packet->get_packet_id()) + " from " + bee_itos(packet->id) + ": too many incomplete packets");
+				return nullptr; // Return nullptr when the sender already has too many incomplete packets
+			}
+
+			it = buffer.emplace(
+				key,
+				std::make_unique<NetworkPacket>(
+					internal::connection->udp_data
+				)
+			).first;
+		} else {
+			it->second->append_net(internal::connection->udp_data);
+		}
+
+		if (!it->second->get_is_sequence_complete()) {
+			return nullptr; // Return nullptr when only part of the sequence has been received
+		}
+
+		std::unique_ptr<NetworkPacket> full_packet = std::move(it->second);
+		buffer.erase(it);
+
+		return full_packet;
+	}
+	/*
+	* internal::prune_buffer() - Remove the partially received packets which haven't received a fragment before the timeout
+	*/
+	int internal::prune_buffer() {
+		const Uint32 now = get_ticks();
+		std::unordered_map<Uint32,std::unique_ptr<NetworkPacket>>& buffer = internal::connection->buffer;
+		for (auto it=buffer.begin(); it!=buffer.end(); ) {
+			if (now - it->second->get_recv_time() > internal::timeout) {
+				messenger::send({"engine", "network"}, E_MESSAGE::WARNING, "Dropped incomplete packet " + bee_itos(it->second->get_packet_id()) + " from " + bee_itos(it->second->id));
+				it = buffer.erase(it);
+				continue;
+			}
+			++it;
+		}
+		return 0;
+	}
 	/*
 	* internal::destroy_instance() - Remove the given instance from any internal lists before it is destroyed
 	* @inst: the instance that is being destroyed
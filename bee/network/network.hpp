@@ -41,15 +41,19 @@ namespace net {
 	const std::map<int,NetworkClient>& get_players();
 
 	namespace internal {
-		int host_handle_packet(std::unique_ptr<NetworkPacket> const &);
+		int host_handle_packet(std::unique_ptr<NetworkPacket>&);
 		int host_send_players(int);
 		int host_send_data(int);
 		int host_send_keepalive();
 
-		int client_handle_packet(std::unique_ptr<NetworkPacket> const &);
+		int client_handle_packet(std::unique_ptr<NetworkPacket>&);
+		int client_handle_snapshot(std::unique_ptr<NetworkPacket> const &);
+		int client_send_ack(Uint16);
 		int client_send_data();
 		int client_send_keepalive();
 
+		std::unique_ptr<NetworkPacket> buffer_packet(std::unique_ptr<NetworkPacket>&);
+		int prune_buffer();
 		int destroy_instance(Instance*);
 	}
 }}
@@ -9,7 +9,13 @@
 #ifndef BEE_NETWORK_PACKET
 #define BEE_NETWORK_PACKET 1
 
-#include "packet.hpp"
+#include <algorithm> // Include the required library headers
+#include <cstring>
+
+#include "packet.hpp" // Include the engine headers
+
+#include "../defines.hpp"
+#include "../engine.hpp"
 
 #include "../util/platform.hpp"
 #include "../util/networking.hpp"
@@ -21,34 +27,108 @@
 #include "client.hpp"
 #include "connection.hpp"
 #include "data.hpp"
+#include "thread.hpp"
 
 /*
 	Network packet format {
-		total message length,
-		sequence data, // 10b for packet id, 3b for multipacket amount, 3b for multipacket index
-		timestamp (in network time),
-		sender id,
-		signals,
-		data
+		checksum, // 4B
+		fragment length, // 2B, including the metadata
+		packet id, // 2B
+		fragment index, // 2B
+		fragment amount, // 2B
+		timestamp (in network time), // 4B
+		sender id, // 1B
+		signals, // 1B
+		data // Up to MAX_SIZE-META_SIZE bytes per fragment
 	}
 */
 
 namespace bee {
-	Uint16 NetworkPacket::next_id = 0;
-	//const size_t NetworkPacket::MAX_SIZE = 65536;
-	const size_t NetworkPacket::MAX_SIZE = 1024;
-	const size_t NetworkPacket::META_SIZE = 14;
+	/*
+	* NetworkPacketView::NetworkPacketView() - Construct a view of the given fragment data
+	* @_data: the received data
+	* @_size: the amount of received bytes
+	*/
+	NetworkPacketView::NetworkPacketView(const Uint8* _data, size_t _size) :
+		data(_data),
+		size(_size)
+	{}
+	/*
+	* NetworkPacketView::NetworkPacketView() - Construct a view of the given received UDP packet
+	* @udp_data: the received packet
+	*/
+	NetworkPacketView::NetworkPacketView(const UDPpacket* udp_data) :
+		NetworkPacketView(udp_data->data, (udp_data->len > 0) ? udp_data->len : 0)
+	{}
 
-	NetworkPacket::NetworkPacket() :
-		packet(),
+	/*
+	* NetworkPacketView::get_is_valid() - Return whether the fragment is complete and matches its checksum
+	*/
+	bool NetworkPacketView::get_is_valid() const {
+		if (size < NetworkPacket::META_SIZE) {
+			return false;
+		}
+
+		const size_t length = get_length();
+		if ((length < NetworkPacket::META_SIZE)||(length > size)) {
+			return false;
+		}
+
+		if (get_fragment_index() >= get_fragment_amount()) {
+			return false;
+		}
+
+		return (::get_checksum(data+4, length-4) == get_checksum()); // The checksum covers everything after itself
+	}
+
+	Uint32 NetworkPacketView::get_checksum() const {
+		return (data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
+	}
+	size_t NetworkPacketView::get_length() const {
+		return (data[4] << 8) | data[5];
+	}
+	Uint16 NetworkPacketView::get_packet_id() const {
+		return (data[6] << 8) | data[7];
+	}
+	Uint16 NetworkPacketView::get_fragment_index() const {
+		return (data[8] << 8) | data[9];
+	}
+	Uint16 NetworkPacketView::get_fragment_amount() const {
+		return (data[10] << 8) | data[11];
+	}
+	Uint32 NetworkPacketView::get_time() const {
+		return (data[12] << 24) | (data[13] << 16) | (data[14] << 8) | data[15];
+	}
+	Uint8 NetworkPacketView::get_sender() const {
+		return data[16];
+	}
+	Uint8 NetworkPacketView::get_signals() const {
+		return data[17];
+	}
+	const Uint8* NetworkPacketView::get_payload() const {
+		return data + NetworkPacket::META_SIZE;
+	}
+	size_t NetworkPacketView::get_payload_size() const {
+		return get_length() - NetworkPacket::META_SIZE;
+	}
+
+	std::atomic<Uint16> NetworkPacket::next_id (0);
+	const size_t NetworkPacket::MAX_SIZE = 1400; // Keep each fragment below the common Ethernet MTU after the IP and UDP headers
+	const size_t NetworkPacket::META_SIZE = 18;
+	const size_t NetworkPacket::FRAGMENT_SIZE = NetworkPacket::MAX_SIZE - NetworkPacket::META_SIZE;
 
+	NetworkPacket::NetworkPacket() :
 		data(nullptr),
-		multi_packet(),
 
 		sequence(0),
+		fragment_amount(0),
+		fragments_received(0),
+		fragments(),
 		timestamp(0),
+		recv_time(0),
 
-		id(0)
+		id(0),
+		address({0, 0})
 	{}
 	NetworkPacket::NetworkPacket(Uint8 _id) :
 		NetworkPacket()
@@ -71,28 +151,27 @@ namespace bee {
 		NetworkPacket()
 	{
 		id = _id;
-		data = new NetworkData(signal1, signal2, _data);
+		data = new NetworkData(signal1, signal2, std::move(_data));
 	}
 	NetworkPacket::NetworkPacket(UDPpacket* udp_data) :
 		NetworkPacket()
 	{
-		if (static_cast<size_t>(udp_data->len) < META_SIZE) {
-			reset();
-			messenger::send({"engine", "network"}, E_MESSAGE::ERROR, "Malformed UDP packet, the packet is now empty");
-			return;
+		if (load_net(udp_data) != 0) {
+			reset(); // Leave the packet empty when the datagram is malformed
 		}
-
-		load_net(udp_data);
 	}
 	NetworkPacket::NetworkPacket(const NetworkPacket& other) :
-		packet(other.packet),
+		data((other.data != nullptr) ? new NetworkData(*other.data) : nullptr),
 
-		data(new NetworkData(*other.data)),
-		multi_packet(other.multi_packet),
 		sequence(other.sequence),
+		fragment_amount(other.fragment_amount),
+		fragments_received(other.fragments_received),
+		fragments(other.fragments),
 		timestamp(other.timestamp),
+		recv_time(other.recv_time),
 
-		id(other.id)
+		id(other.id),
+		address(other.address)
 	{}
 	NetworkPacket::~NetworkPacket() {
 		reset();
@@ -103,77 +182,88 @@ namespace bee {
 			data = nullptr;
 		}
 
-		packet.clear();
-
-		free_multi();
+		fragments.clear();
+		fragments_received = 0;
 
 		return 0;
 	}
-	int NetworkPacket::free_multi() {
-		for (auto& p : multi_packet) {
-			p.clear();
-		}
-		multi_packet.clear();
-		return 0;
-	}
 
 	NetworkPacket& NetworkPacket::operator=(const NetworkPacket& rhs) {
 		if (this != &rhs) {
 			this->reset();
-			this->packet = rhs.packet;
 
-			this->data = new NetworkData(*rhs.data);
-			this->multi_packet = rhs.multi_packet;
+			this->data = (rhs.data != nullptr) ? new NetworkData(*rhs.data) : nullptr;
 			this->sequence = rhs.sequence;
+			this->fragment_amount = rhs.fragment_amount;
+			this->fragments_received = rhs.fragments_received;
+			this->fragments = rhs.fragments;
 			this->timestamp = rhs.timestamp;
+			this->recv_time = rhs.recv_time;
 
 			this->id = rhs.id;
+			this->address = rhs.address;
 		}
 		return *this;
 	}
 
 	int NetworkPacket::load_net(UDPpacket* udp_data) {
-		Uint8* new_data = udp_data->data;
+		NetworkPacketView view (udp_data);
 
-		sequence = new_data[6] << 8;
-		sequence += new_data[7];
+		reset();
 
-		timestamp = new_data[8] << 24;
-		timestamp += new_data[9] << 16;
-		timestamp += new_data[10] << 8;
-		timestamp += new_data[11];
+		if (!view.get_is_valid()) { // Check the length before reading any of the metadata
+			messenger::send({"engine", "network"}, E_MESSAGE::ERROR, "Failed to load net data: packet checksum failed");
+			return 1; // Return 1 when the fragment is truncated or corrupted
+		}
 
-		id = new_data[12];
+		if ((view.get_fragment_amount() == 0)||(view.get_fragment_amount() > BEE_NET_MAX_FRAGMENTS)) {
+			messenger::send({"engine", "network"}, E_MESSAGE::ERROR, "Failed to load net data: invalid fragment amount " + bee_itos(view.get_fragment_amount()));
+			return 3; // Return 3 when the packet would be too large to reassemble
+		}
 
-		data = new NetworkData(new_data[13]);
+		sequence = view.get_packet_id();
+		fragment_amount = view.get_fragment_amount();
+		timestamp = view.get_time();
+		id = view.get_sender();
+		address = udp_data->address;
 
-		append_net(udp_data);
+		data = new NetworkData(view.get_signals());
 
-		return 0;
+		// Track each fragment by index so that they can be received in any order
+		fragments.assign(fragment_amount, false);
+
+		return append_net(udp_data);
 	}
 	int NetworkPacket::append_net(UDPpacket* udp_data) {
-		Uint8* new_data = udp_data->data;
+		NetworkPacketView view (udp_data);
 
-		size_t data_size = new_data[4] << 8;
-		data_size += new_data[5];
+		if (!view.get_is_valid()) {
+			messenger::send({"engine", "network"}, E_MESSAGE::ERROR, "Failed to append net data: packet checksum failed");
+			return 1; // Return 1 when the fragment is truncated or corrupted
+		}
 
-		std::vector<Uint8> p;
-		p.reserve(data_size);
-		for (size_t i=0; i<data_size; ++i) {
-			p.push_back(new_data[i]);
+		const size_t index = view.get_fragment_index();
+		if ((view.get_packet_id() != sequence)||(index >= fragments.size())) {
+			messenger::send({"engine", "network"}, E_MESSAGE::ERROR, "Failed to append net data: fragment does not belong to the sequence");
+			return 2; // Return 2 when the fragment is from a different packet
 		}
 
-		if (!verify_data(p)) {
-			messenger::send({"engine", "network"}, E_MESSAGE::ERROR, "Failed to append net data: packet checksum failed");
+		if ((index+1 < fragments.size())&&(view.get_payload_size() != FRAGMENT_SIZE)) {
+			messenger::send({"engine", "network"}, E_MESSAGE::ERROR, "Failed to append net data: fragment is too short");
 			return 1;
 		}
 
-		multi_packet.push_back(p);
-
-		if (get_is_sequence_complete()) {
-			get_data();
+		if (fragments[index]) {
+			return 0; // Return 0 when the fragment is a duplicate
 		}
 
+		// Copy the payload directly to its final position since every fragment except the last is full
+		data->set_data(index*FRAGMENT_SIZE, view.get_payload(), view.get_payload_size());
+
+		fragments[index] = true;
+		++fragments_received;
+		recv_time = get_ticks();
+
 		return 0;
 	}
 	int NetworkPacket::load_data(NetworkData* _data) {
@@ -185,194 +275,116 @@ namespace bee {
 		return 0;
 	}
 
-	bool NetworkPacket::get_is_sequence_complete() {
-		Uint8 amount = (sequence - (sequence >> 6 << 6)) >> 3;
-		if (multi_packet.size() == amount) {
-			return true;
-		}
-		return false;
+	bool NetworkPacket::get_is_sequence_complete() const {
+		return ((fragment_amount > 0)&&(fragments_received == fragment_amount));
 	}
 
 	Uint16 NetworkPacket::get_next_id() {
-		int id = next_id++;
-		if (next_id >= 1024) {
-			next_id = 0;
-		}
-		return id;
-	}
-	bool NetworkPacket::verify_data(std::vector<Uint8>& data) {
-		Uint32 checksum = data[0] << 24;
-		checksum += data[1] << 16;
-		checksum += data[2] << 8;
-		checksum += data[3];
-
-		data[0] = -1;
-		data[1] = -1;
-		data[2] = -1;
-		data[3] = -1;
-
-		bool r = verify_checksum(data, checksum);
-
-		data[0] = checksum >> 24;
-		data[1] = checksum >> 16;
-		data[2] = checksum >> 8;
-		data[3] = checksum;
-
-		return r;
+		return next_id++;
 	}
 
-	std::vector<Uint8> NetworkPacket::get() {
-		std::vector<Uint8> d = data->get();
-		size_t size = META_SIZE + d.size();
-
-		packet.clear();
-		packet.resize(META_SIZE);
-
-		packet[0] = -1;
-		packet[1] = -1;
-		packet[2] = -1;
-		packet[3] = -1;
-
-		packet[4] = static_cast<Uint8>(size >> 8);
-		packet[5] = static_cast<Uint8>(size);
-
-		sequence = get_next_id() << 6;
-		sequence += 1 << 3;
-		packet[6] = sequence >> 8;
-		packet[7] = static_cast<Uint8>(sequence);
-
-		timestamp = net::get_time();
-		packet[8] = timestamp >> 24;
-		packet[9] = timestamp >> 16;
-		packet[10] = timestamp >> 8;
-		packet[11] = timestamp;
-
-		packet[12] = id;
-		packet[13] = data->get_signals();
+	/*
+	* NetworkPacket::prepare_net() - Assign a new packet id and timestamp and return the amount of fragments to send
+	* ! The return value will be 0 when the data is too large to be split
+	*/
+	size_t NetworkPacket::prepare_net() {
+		if (data == nullptr) {
+			return 0;
+		}
 
-		for (auto& e : d) {
-			packet.push_back(e);
+		const size_t size = data->get().size();
+		size_t amount = (size + FRAGMENT_SIZE - 1) / FRAGMENT_SIZE;
+		if (amount == 0) {
+			amount = 1; // Send a single fragment for packets without data
+		}
+		if (amount > BEE_NET_MAX_FRAGMENTS) {
+			messenger::send({"engine", "network"}, E_MESSAGE::ERROR, "Failed to split packet: " + bee_itos(size) + " bytes is too large");
+			return 0;
 		}
 
-		Uint32 checksum = get_checksum(packet);
-		packet[0] = checksum >> 24;
-		packet[1] = checksum >> 16;
-		packet[2] = checksum >> 8;
-		packet[3] = checksum;
+		sequence = get_next_id();
+		fragment_amount = static_cast<Uint16>(amount);
+		timestamp = net::get_time();
 
-		return packet;
+		return amount;
 	}
-	const std::vector<std::vector<Uint8>>& NetworkPacket::get_multi() {
-		free_multi();
-
-		std::vector<Uint8> d = data->get();
-
-		size_t size = d.size() + META_SIZE;
-		int amount = size/MAX_SIZE;
-		if (size % MAX_SIZE != 0) {
-			++amount;
+	/*
+	* NetworkPacket::write_net() - Write the metadata and data of the given fragment directly into the given UDP packet
+	* ! prepare_net() must be called first
+	* @udp_data: the packet to write to, which must hold at least MAX_SIZE bytes
+	* @index: the index of the fragment to write
+	*/
+	int NetworkPacket::write_net(UDPpacket* udp_data, size_t index) const {
+		if ((data == nullptr)||(index >= fragment_amount)) {
+			return 1; // Return 1 when the fragment doesn't exist
 		}
-		sequence = get_next_id() << 6;
-		sequence += amount << 3;
-
-		Uint8 sig = data->get_signals();
 
-		timestamp = net::get_time();
-
-		size_t remaining_size = size;
-		while (remaining_size > 0) {
-			size_t s = remaining_size;
-			if (s > MAX_SIZE) {
-				s = MAX_SIZE;
-			}
-			remaining_size -= s;
+		const std::vector<Uint8>& d = data->get();
+		const size_t offset = index*FRAGMENT_SIZE;
+		const size_t s = META_SIZE + std::min(FRAGMENT_SIZE, d.size() - std::min(offset, d.size()));
 
-			std::vector<Uint8> p;
-			p.resize(META_SIZE);
+		Uint8* p = udp_data->data;
 
-			p[0] = -1;
-			p[1] = -1;
-			p[2] = -1;
-			p[3] = -1;
+		p[4] = static_cast<Uint8>(s >> 8);
+		p[5] = static_cast<Uint8>(s);
 
-			p[4] = static_cast<Uint8>(s >> 8);
-			p[5] = static_cast<Uint8>(s);
+		p[6] = sequence >> 8;
+		p[7] = static_cast<Uint8>(sequence);
 
-			p[6] = sequence >> 8;
-			p[7] = static_cast<Uint8>(sequence + multi_packet.size());
+		p[8] = static_cast<Uint8>(index >> 8);
+		p[9] = static_cast<Uint8>(index);
+		p[10] = fragment_amount >> 8;
+		p[11] = static_cast<Uint8>(fragment_amount);
 
-			p[8] = timestamp >> 24;
-			p[9] = timestamp >> 16;
-			p[10] = timestamp >> 8;
-			p[11] = timestamp;
+		p[12] = timestamp >> 24;
+		p[13] = timestamp >> 16;
+		p[14] = timestamp >> 8;
+		p[15] = timestamp;
 
-			p[12] = id;
-			p[13] = sig;
+		p[16] = id;
+		p[17] = data->get_signals();
 
-			for (size_t i=META_SIZE; i<s; ++i) {
-				p.push_back(d[i-META_SIZE + multi_packet.size()*MAX_SIZE]);
-			}
+		if (s > META_SIZE) {
+			memcpy(p+META_SIZE, d.data()+offset, s-META_SIZE);
+		}
 
-			Uint32 checksum = get_checksum(p);
-			p[0] = checksum >> 24;
-			p[1] = checksum >> 16;
-			p[2] = checksum >> 8;
-			p[3] = checksum;
+		Uint32 checksum = get_checksum(p+4, s-4);
+		p[0] = checksum >> 24;
+		p[1] = checksum >> 16;
+		p[2] = checksum >> 8;
+		p[3] = checksum;
 
-			multi_packet.push_back(p);
-		}
+		udp_data->len = s;
 
-		return multi_packet;
+		return 0; // Return 0 on success
 	}
+
 	NetworkData* NetworkPacket::get_data() {
 		if (!get_is_sequence_complete()) {
 			messenger::send({"engine", "network"}, E_MESSAGE::ERROR, "Failed to construct net data: incomplete sequence");
 			return nullptr;
 		}
 
-		Uint8 sig = 0;
-		if (data != nullptr) {
-			sig = data->get_signals();
-			delete data;
-			data = nullptr;
-		}
-		data = new NetworkData(sig);
-
-		Uint8 amount = (sequence - (sequence >> 6 << 6)) >> 3;
-		for (size_t i=0; i<amount; ++i) {
-			bool has_found_data = false;
-			for (auto& p : multi_packet) {
-				Uint8 pid = p[7] - (p[7] >> 3 << 3);
-				if (pid == i) {
-					data->append_data(p, META_SIZE); // Append only the raw data
-
-					has_found_data = true;
-					break;
-				}
-			}
-
-			if (!has_found_data) {
-				messenger::send({"engine", "network"}, E_MESSAGE::ERROR, "Failed to assemble packet sequence: missing piece " + bee_itos(i) + " of " + bee_itos(amount));
-				return nullptr;
-			}
-		}
-
 		return data;
 	}
-	std::vector<Uint8> NetworkPacket::get_raw() const {
+	const std::vector<Uint8>& NetworkPacket::get_raw() const {
+		static const std::vector<Uint8> empty;
 		if (data == nullptr) {
-			return std::vector<Uint8>();
+			return empty;
 		}
 
 		return data->get();
 	}
 
 	Uint16 NetworkPacket::get_packet_id() const {
-		return sequence >> 6;
+		return sequence;
 	}
 	Uint32 NetworkPacket::get_time() const {
 		return timestamp;
 	}
+	Uint32 NetworkPacket::get_recv_time() const {
+		return recv_time;
+	}
 
 	E_NETSIG1 NetworkPacket::get_signal1() const {
 		if (data == nullptr) {
@@ -397,45 +409,195 @@ namespace bee {
 	}
 
 namespace net {
+	namespace internal {
+		// These are separate for each thread so that the network thread never shares buffers with the main thread
+		thread_local std::vector<UDPpacket*> packet_pool; // The UDP packets which are available to be reused for sending
+		thread_local std::vector<UDPpacket*> send_queue; // The written UDP packets which will be sent by the next flush
+	}
+
+	/*
+	* internal::acquire_packet() - Return a UDP packet of MAX_SIZE from the pool, or allocate one when the pool is empty
+	*/
+	UDPpacket* internal::acquire_packet() {
+		if (packet_pool.empty()) {
+			return network_packet_alloc(NetworkPacket::MAX_SIZE);
+		}
+
+		UDPpacket* p = packet_pool.back();
+		packet_pool.pop_back();
+		return p;
+	}
+	/*
+	* internal::release_packet() - Return the given UDP packet to the pool
+	* @packet: the packet to release
+	*/
+	int internal::release_packet(UDPpacket* packet) {
+		if (packet == nullptr) {
+			return 1; // Return 1 when there is no packet to release
+		}
+
+		packet_pool.push_back(packet);
+
+		return 0;
+	}
+	/*
+	* internal::free_packet_pool() - Free every UDP packet in the pool
+	*/
+	int internal::free_packet_pool() {
+		for (auto& p : packet_pool) {
+			network_packet_free(p);
+		}
+		packet_pool.clear();
+
+		return 0;
+	}
+	/*
+	* internal::get_can_buffer() - Return whether another partially received packet from the given sender fits in the given buffer
+	* ! This prevents a single sender from holding an unbounded amount of reassembly memory until the timeout
+	* @buffer: the partially received packets, keyed by the sender id and packet id
+	* @sender: the id of the sender
+	*/
+	bool internal::get_can_buffer(const std::unordered_map<Uint32,std::unique_ptr<NetworkPacket>>& buffer, Uint8 sender) {
+		size_t amount = 0;
+		for (auto& p : buffer) {
+			if ((p.first >> 16) == sender) {
+				++amount;
+			}
+		}
+		return (amount < BEE_NET_MAX_PARTIAL_PACKETS);
+	}
+
 	/*
 	* send_packet() - Send the given packet to the given client
+	* ! Each fragment is written directly into a pooled UDP packet so that the data is only copied once
+	* @client: the client to send to
+	* @packet: the packet to send
 	*/
 	int send_packet(const NetworkClient& client, std::unique_ptr<NetworkPacket> const & packet) {
-		if (packet->get_size() > NetworkPacket::MAX_SIZE) {
-			const std::vector<std::vector<Uint8>>& packets = packet->get_multi();
-			for (auto& p : packets) {
-				network_udp_send(client.sock, client.channel, p.size(), p.data());
+		if (internal::get_is_threaded()) {
+			return internal::thread_send(client, packet); // Let the network thread write and send the packet
+		}
+
+		const size_t amount = packet->prepare_net();
+		if (amount == 0) {
+			return 0; // Return 0 when the packet couldn't be split into fragments
+		}
+
+		UDPpacket* udp_data = internal::acquire_packet();
+		if (udp_data == nullptr) {
+			return 0; // Return 0 when the UDP packet couldn't be allocated
+		}
+
+		int r = 0;
+		for (size_t i=0; i<amount; ++i) {
+			packet->write_net(udp_data, i);
+			r = network_udp_send(client.sock, client.channel, udp_data);
+			if (r == 0) {
+				break; // Stop sending when a fragment fails
+			}
+		}
+
+		internal::release_packet(udp_data);
+
+		return r; // Return the amount of destinations of the last fragment, which will be 0 on failure
+	}
+	/*
+	* queue_packet() - Write the given packet for the given address into the send queue
+	* ! The fragments are addressed individually so that the entire queue can be sent through a single socket
+	* @address: the address to send to
+	* @packet: the packet to send
+	*/
+	int queue_packet(const IPaddress& address, std::unique_ptr<NetworkPacket> const & packet) {
+		const size_t amount = packet->prepare_net();
+		for (size_t i=0; i<amount; ++i) {
+			UDPpacket* udp_data = internal::acquire_packet();
+			if (udp_data == nullptr) {
+				return 0; // Return 0 when the UDP packet couldn't be allocated
 			}
-			int r = packets.size();
-			packet->free_multi();
-			return r;
+
+			packet->write_net(udp_data, i);
+			udp_data->address = address;
+
+			internal::send_queue.push_back(udp_data);
 		}
 
-		return network_udp_send(client.sock, client.channel, packet->get_size(), packet->get().data());
+		return amount; // Return the amount of queued fragments, which will be 0 on failure
+	}
+	/*
+	* queue_packet() - Write the given packet for the given client into the send queue
+	* ! When the network thread is running, the packet is passed to it instead
+	* @client: the client to send to
+	* @packet: the packet to send
+	*/
+	int queue_packet(const NetworkClient& client, std::unique_ptr<NetworkPacket> const & packet) {
+		if (internal::get_is_threaded()) {
+			return internal::thread_send(client, packet);
+		}
+
+		IPaddress* ipa = network_get_peer_address(client.sock, client.channel);
+		if (ipa == nullptr) {
+			return 0; // Return 0 when the client isn't bound
+		}
+
+		return queue_packet(*ipa, packet);
+	}
+	/*
+	* flush_packets() - Send every queued packet through the given socket
+	* @sock: the socket to send through
+	*/
+	int flush_packets(UDPsocket sock) {
+		if (internal::send_queue.empty()) {
+			return 0; // Return 0 when there is nothing to send
+		}
+
+		const int amount = internal::send_queue.size();
+		int r = network_udp_send_batch(sock, internal::send_queue.data(), amount);
+		if (r < amount) {
+			messenger::send({"engine", "network"}, E_MESSAGE::WARNING, "Failed to send " + bee_itos(amount - r) + " queued packets");
+		}
+
+		for (auto& p : internal::send_queue) {
+			internal::release_packet(p);
+		}
+		internal::send_queue.clear();
+
+		return r; // Return the amount of packets which were sent
 	}
 	/*
 	* recv_packet() - Attempt to receive a packet from the UDP socket
+	* ! Datagrams are received in batches and then returned one at a time until the batch is empty
 	*/
 	std::unique_ptr<NetworkPacket> recv_packet(NetworkConnection* connection) {
 		if (connection == nullptr) {
 			return nullptr;
 		}
 
-		connection->udp_data = network_packet_realloc(connection->udp_data, NetworkPacket::MAX_SIZE); // Attempt to allocate more space to receive data
-		if (connection->udp_data == nullptr) {
-			return nullptr; // Return nullptr when failed to allocate
+		if (connection->udp_batch == nullptr) { // Only allocate space to receive data once per connection
+			connection->udp_batch = network_packet_alloc_vector(BEE_NET_BATCH_SIZE, NetworkPacket::MAX_SIZE);
+			if (connection->udp_batch == nullptr) {
+				return nullptr; // Return nullptr when failed to allocate
+			}
 		}
 
-		int r = network_udp_recv(connection->udp_sock, connection->udp_data); // Attempt to receive data over the UDP socket
-		if (r == 0) {
-			return nullptr; // Return nullptr when there is no message to receive
-		}
+		if (connection->udp_batch_index >= connection->udp_batch_size) {
+			connection->udp_batch_index = 0;
+			connection->udp_batch_size = 0;
 
-		if (r == -1) { // If receiving failed, attempt to allocate more space for the packet
-			messenger::send({"engine", "network"}, E_MESSAGE::WARNING, "Failed to receive packet");
-			return nullptr; // Return nullptr when the message still could not be received
+			int r = network_udp_recv_batch(connection->udp_sock, connection->udp_batch, BEE_NET_BATCH_SIZE); // Attempt to receive a batch of data over the UDP socket
+			if (r == 0) {
+				return nullptr; // Return nullptr when there is no message to receive
+			}
+
+			if (r < 0) {
+				messenger::send({"engine", "network"}, E_MESSAGE::WARNING, "Failed to receive packet");
+				return nullptr; // Return nullptr when the messages could not be received
+			}
+
+			connection->udp_batch_size = r;
 		}
 
+		connection->udp_data = connection->udp_batch[connection->udp_batch_index++];
+
 		return std::make_unique<NetworkPacket>(
 			connection->udp_data
 		);
@@ -11,6 +11,8 @@
 
 #include <vector>
 #include <memory>
+#include <atomic>
+#include <unordered_map>
 
 #include <SDL2/SDL_net.h>
 
@@ -22,24 +24,46 @@ namespace bee {
 	struct NetworkClient;
 	struct NetworkConnection;
 
-	class NetworkPacket {
-		std::vector<Uint8> packet;
+	class NetworkPacketView { // A read-only view of a received fragment which parses the metadata in place
+		const Uint8* data;
+		size_t size;
+	public:
+		NetworkPacketView(const Uint8*, size_t);
+		explicit NetworkPacketView(const UDPpacket*);
+
+		bool get_is_valid() const;
+
+		Uint32 get_checksum() const;
+		size_t get_length() const;
+		Uint16 get_packet_id() const;
+		Uint16 get_fragment_index() const;
+		Uint16 get_fragment_amount() const;
+		Uint32 get_time() const;
+		Uint8 get_sender() const;
+		Uint8 get_signals() const;
+		const Uint8* get_payload() const;
+		size_t get_payload_size() const;
+	};
 
+	class NetworkPacket {
 		NetworkData* data;
-		std::vector<std::vector<Uint8>> multi_packet;
 
-		Uint16 sequence;
+		Uint16 sequence; // The packet id which is shared by each fragment
+		Uint16 fragment_amount;
+		Uint16 fragments_received;
+		std::vector<bool> fragments; // Whether each fragment has been received
 		Uint32 timestamp;
+		Uint32 recv_time; // The local time when the latest fragment was received
 
-		static Uint16 next_id;
+		static std::atomic<Uint16> next_id;
 		static Uint16 get_next_id();
-
-		static bool verify_data(std::vector<Uint8>&);
 	public:
 		static const size_t MAX_SIZE;
 		static const size_t META_SIZE;
+		static const size_t FRAGMENT_SIZE;
 
 		Uint8 id;
+		IPaddress address; // The address which the packet was received from, or which it will be sent to by the network thread
 
 		NetworkPacket();
 		explicit NetworkPacket(Uint8);
@@ -50,7 +74,6 @@ namespace bee {
 		explicit NetworkPacket(UDPpacket*);
 		~NetworkPacket();
 		int reset();
-		int free_multi();
 
 		NetworkPacket& operator=(const NetworkPacket&);
 
@@ -59,15 +82,17 @@ namespace bee {
 		int load_data(NetworkData*);
 		int append_data(NetworkData*);
 
-		bool get_is_sequence_complete();
+		bool get_is_sequence_complete() const;
+
+		size_t prepare_net();
+		int write_net(UDPpacket*, size_t) const;
 
-		std::vector<Uint8> get();
-		const std::vector<std::vector<Uint8>>& get_multi();
 		NetworkData* get_data();
-		std::vector<Uint8> get_raw() const;
+		const std::vector<Uint8>& get_raw() const;
 
 		Uint16 get_packet_id() const;
 		Uint32 get_time() const;
+		Uint32 get_recv_time() const;
 
 		E_NETSIG1 get_signal1() const;
 		E_NETSIG2 get_signal2() const;
@@ -75,7 +100,18 @@ namespace bee {
 	};
 
 namespace net {
+	namespace internal {
+		UDPpacket* acquire_packet();
+		int release_packet(UDPpacket*);
+		int free_packet_pool();
+
+		bool get_can_buffer(const std::unordered_map<Uint32,std::unique_ptr<NetworkPacket>>&, Uint8);
+	}
+
 	int send_packet(const NetworkClient&, std::unique_ptr<NetworkPacket> const &);
+	int queue_packet(const IPaddress&, std::unique_ptr<NetworkPacket> const &);
+	int queue_packet(const NetworkClient&, std::unique_ptr<NetworkPacket> const &);
+	int flush_packets(UDPsocket);
 	std::unique_ptr<NetworkPacket> recv_packet(NetworkConnection*);
 }}
 
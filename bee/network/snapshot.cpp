@@ -0,0 +1,500 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef BEE_NETWORK_SNAPSHOT
+#define BEE_NETWORK_SNAPSHOT 1
+
+#include <cmath> // Include the required library headers
+#include <cstring>
+#include <limits>
+#include <algorithm>
+
+#include "snapshot.hpp" // Include the engine headers
+
+#include "../defines.hpp"
+
+#include "../data/serialdata.hpp"
+
+#include "../core/instance.hpp"
+
+#include "../physics/body.hpp"
+
+#include "../resource/texture.hpp"
+
+namespace bee {
+	namespace internal {
+		/*
+		* Snapshots are encoded as follows, where every integer is a zigzag encoded varint:
+		* keyframe: the sequence, the amount of instances, then for each instance its key followed by every field
+		* delta: the sequence, the baseline sequence, the amount of changed instances,
+		*        then for each changed instance its key, a byte with a bit for each changed field, and the changed fields,
+		*        followed by the amount of removed instances and the key of each one
+		* Each integer field is stored as the difference from its baseline value, where a keyframe uses a zeroed baseline
+		*/
+		enum E_SNAPSHOT_FIELD : Uint8 {
+			SNAPSHOT_SPRITE = 0x01,
+			SNAPSHOT_SUBIMAGE = 0x02,
+			SNAPSHOT_MASS = 0x04,
+			SNAPSHOT_POSITION = 0x08,
+			SNAPSHOT_ROTATION = 0x10,
+			SNAPSHOT_VELOCITY = 0x20,
+			SNAPSHOT_VELOCITY_ANG = 0x40,
+			SNAPSHOT_POSITION_PREVIOUS = 0x80,
+			SNAPSHOT_ALL = 0xff
+		};
+
+		/*
+		* snapshot_quantize() - Return the given value rounded to the given scale
+		* ! The result is clamped to half of the int range so that the difference between two values can't overflow,
+		*   and non-finite values are stored as 0
+		* @value: the value to quantize
+		* @scale: the amount of steps per unit
+		*/
+		int snapshot_quantize(double value, double scale) {
+			const double v = std::round(value * scale);
+			if (!std::isfinite(v)) {
+				return 0;
+			}
+
+			const double limit = std::numeric_limits<int>::max() / 2;
+			return static_cast<int>(std::min(std::max(v, -limit), limit));
+		}
+
+		/*
+		* snapshot_write_varint() - Append the given value as a zigzag encoded varint
+		* @data: the data to append to
+		* @value: the value to append
+		*/
+		void snapshot_write_varint(std::vector<Uint8>* data, Sint32 value) {
+			Uint32 v = (static_cast<Uint32>(value) << 1) ^ static_cast<Uint32>(value >> 31);
+			while (v >= 0x80) {
+				data->push_back(static_cast<Uint8>(v | 0x80));
+				v >>= 7;
+			}
+			data->push_back(static_cast<Uint8>(v));
+		}
+		/*
+		* snapshot_write_string() - Append the given string prefixed by its length
+		* @data: the data to append to
+		* @value: the string to append
+		*/
+		void snapshot_write_string(std::vector<Uint8>* data, const std::string& value) {
+			snapshot_write_varint(data, static_cast<Sint32>(value.size()));
+			data->insert(data->end(), value.begin(), value.end());
+		}
+		/*
+		* snapshot_write_double() - Append the given value as 8 little-endian bytes
+		* @data: the data to append to
+		* @value: the value to append
+		*/
+		void snapshot_write_double(std::vector<Uint8>* data, double value) {
+			Uint64 v;
+			memcpy(&v, &value, sizeof(v));
+			for (size_t i=0; i<8; ++i) {
+				data->push_back(static_cast<Uint8>(v >> (i*8)));
+			}
+		}
+
+		/*
+		* snapshot_read_varint() - Read a zigzag encoded varint and advance the offset
+		* @data: the data to read from
+		* @offset: the offset to read from, which is advanced past the value
+		* @value: the pointer to store the value in
+		*/
+		bool snapshot_read_varint(const std::vector<Uint8>& data, size_t* offset, Sint32* value) {
+			Uint32 v = 0;
+			for (size_t shift=0; shift<35; shift+=7) {
+				if (*offset >= data.size()) {
+					return false;
+				}
+
+				const Uint8 b = data[(*offset)++];
+				v |= static_cast<Uint32>(b & 0x7f) << shift;
+				if ((b & 0x80) == 0) {
+					*value = static_cast<Sint32>((v >> 1) ^ (~(v & 1) + 1));
+					return true;
+				}
+			}
+			return false;
+		}
+		/*
+		* snapshot_read_string() - Read a string prefixed by its length and advance the offset
+		* @data: the data to read from
+		* @offset: the offset to read from, which is advanced past the string
+		* @value: the pointer to store the string in
+		*/
+		bool snapshot_read_string(const std::vector<Uint8>& data, size_t* offset, std::string* value) {
+			Sint32 size = 0;
+			if ((!snapshot_read_varint(data, offset, &size))||(size < 0)||(static_cast<size_t>(size) > data.size() - *offset)) {
+				return false;
+			}
+			value->assign(data.begin()+*offset, data.begin()+*offset+size);
+			*offset += size;
+			return true;
+		}
+		/*
+		* snapshot_read_double() - Read 8 little-endian bytes as a double and advance the offset
+		* @data: the data to read from
+		* @offset: the offset to read from, which is advanced past the value
+		* @value: the pointer to store the value in
+		*/
+		bool snapshot_read_double(const std::vector<Uint8>& data, size_t* offset, double* value) {
+			if (data.size() - *offset < 8) {
+				return false;
+			}
+			Uint64 v = 0;
+			for (size_t i=0; i<8; ++i) {
+				v |= static_cast<Uint64>(data[(*offset)++]) << (i*8);
+			}
+			memcpy(value, &v, sizeof(v));
+			return true;
+		}
+
+		/*
+		* snapshot_write_fields() - Append the given fields of the state relative to the baseline
+		* @data: the data to append to
+		* @state: the state to write
+		* @baseline: the state which the receiver already has
+		* @fields: the bitmask of the fields to write
+		*/
+		void snapshot_write_fields(std::vector<Uint8>* data, const NetworkInstanceState& state, const NetworkInstanceState& baseline, Uint8 fields) {
+			if (fields & SNAPSHOT_SPRITE) {
+				snapshot_write_string(data, state.sprite);
+			}
+			if (fields & SNAPSHOT_SUBIMAGE) {
+				snapshot_write_varint(data, static_cast<Sint32>(static_cast<Uint32>(state.subimage_time) - static_cast<Uint32>(baseline.subimage_time)));
+			}
+			if (fields & SNAPSHOT_MASS) {
+				snapshot_write_double(data, state.mass);
+				snapshot_write_double(data, state.friction);
+			}
+			for (size_t i=0; i<5; ++i) { // Write each changed vector
+				if (fields & (SNAPSHOT_POSITION << i)) {
+					for (size_t j=i*3; j<i*3+3; ++j) {
+						snapshot_write_varint(data, static_cast<Sint32>(static_cast<Uint32>(state.values[j]) - static_cast<Uint32>(baseline.values[j])));
+					}
+				}
+			}
+		}
+		/*
+		* snapshot_read_fields() - Read the given fields of the state relative to the baseline
+		* @data: the data to read from
+		* @offset: the offset to read from, which is advanced past the fields
+		* @state: the state to read into, which should already contain the baseline
+		* @fields: the bitmask of the fields to read
+		*/
+		bool snapshot_read_fields(const std::vector<Uint8>& data, size_t* offset, NetworkInstanceState* state, Uint8 fields) {
+			Sint32 d = 0;
+			if ((fields & SNAPSHOT_SPRITE)&&(!snapshot_read_string(data, offset, &state->sprite))) {
+				return false;
+			}
+			if (fields & SNAPSHOT_SUBIMAGE) {
+				if (!snapshot_read_varint(data, offset, &d)) {
+					return false;
+				}
+				state->subimage_time = static_cast<int>(static_cast<Uint32>(state->subimage_time) + static_cast<Uint32>(d));
+			}
+			if (fields & SNAPSHOT_MASS) {
+				if ((!snapshot_read_double(data, offset, &state->mass))||(!snapshot_read_double(data, offset, &state->friction))) {
+					return false;
+				}
+			}
+			for (size_t i=0; i<5; ++i) { // Read each changed vector
+				if (fields & (SNAPSHOT_POSITION << i)) {
+					for (size_t j=i*3; j<i*3+3; ++j) {
+						if (!snapshot_read_varint(data, offset, &d)) {
+							return false;
+						}
+						state->values[j] = static_cast<int>(static_cast<Uint32>(state->values[j]) + static_cast<Uint32>(d));
+					}
+				}
+			}
+			return true;
+		}
+	}
+
+	/*
+	* NetworkInstanceState::NetworkInstanceState() - Construct the zeroed state
+	*/
+	NetworkInstanceState::NetworkInstanceState() :
+		sprite(),
+		subimage_time(0),
+		mass(0.0),
+		friction(0.0),
+		values()
+	{}
+	/*
+	* NetworkInstanceState::NetworkInstanceState() - Capture the quantized state of the given instance
+	* @inst: the instance to capture
+	*/
+	NetworkInstanceState::NetworkInstanceState(Instance* inst) :
+		NetworkInstanceState()
+	{
+		if (inst->get_sprite() != nullptr) {
+			sprite = inst->get_sprite()->get_name();
+		}
+		subimage_time = inst->subimage_time;
+
+		PhysicsBody* body = inst->get_physbody();
+		mass = body->get_mass();
+		friction = body->get_friction();
+
+		const btVector3 pos = body->get_position();
+		const btVector3 rot (body->get_rotation_x(), body->get_rotation_y(), body->get_rotation_z());
+		const btVector3 vel = body->get_body()->getLinearVelocity();
+		const btVector3 vel_ang = body->get_body()->getAngularVelocity();
+		const btVector3 vectors[] = {pos, rot, vel, vel_ang, inst->pos_previous};
+		const double scales[] = {BEE_NET_POSITION_SCALE, BEE_NET_ROTATION_SCALE, BEE_NET_POSITION_SCALE, BEE_NET_ROTATION_SCALE, BEE_NET_POSITION_SCALE};
+		for (size_t i=0; i<5; ++i) {
+			values[i*3] = internal::snapshot_quantize(vectors[i].x(), scales[i]);
+			values[i*3+1] = internal::snapshot_quantize(vectors[i].y(), scales[i]);
+			values[i*3+2] = internal::snapshot_quantize(vectors[i].z(), scales[i]);
+		}
+	}
+
+	/*
+	* NetworkInstanceState::get_changes() - Return a bitmask of the fields which differ from the given baseline
+	* @baseline: the state to compare against
+	*/
+	Uint8 NetworkInstanceState::get_changes(const NetworkInstanceState& baseline) const {
+		Uint8 fields = 0;
+		if (sprite != baseline.sprite) {
+			fields |= internal::SNAPSHOT_SPRITE;
+		}
+		if (subimage_time != baseline.subimage_time) {
+			fields |= internal::SNAPSHOT_SUBIMAGE;
+		}
+		if ((mass != baseline.mass)||(friction != baseline.friction)) {
+			fields |= internal::SNAPSHOT_MASS;
+		}
+		for (size_t i=0; i<15; ++i) {
+			if (values[i] != baseline.values[i]) {
+				fields |= internal::SNAPSHOT_POSITION << (i/3);
+			}
+		}
+		return fields;
+	}
+	/*
+	* NetworkInstanceState::get_net() - Return the state in the format of Instance::serialize_net() so that it can be passed to Instance::deserialize_net()
+	*/
+	std::vector<Uint8> NetworkInstanceState::get_net() const {
+		std::vector<double> vectors[5];
+		const double scales[] = {BEE_NET_POSITION_SCALE, BEE_NET_ROTATION_SCALE, BEE_NET_POSITION_SCALE, BEE_NET_ROTATION_SCALE, BEE_NET_POSITION_SCALE};
+		for (size_t i=0; i<5; ++i) {
+			vectors[i] = {values[i*3] / scales[i], values[i*3+1] / scales[i], values[i*3+2] / scales[i]};
+		}
+
+		SerialData body_data (128, true);
+		double m = mass;
+		double f = friction;
+		body_data.store_double(m);
+		body_data.store_double(f);
+		for (size_t i=0; i<4; ++i) {
+			body_data.store_vector(vectors[i]);
+		}
+		std::vector<Uint8> body = body_data.get();
+
+		SerialData sd (256, true);
+		std::string s = sprite;
+		int t = subimage_time;
+		sd.store_string(s);
+		sd.store_int(t);
+		sd.store_serial_v(body);
+		sd.store_vector(vectors[4]);
+
+		return sd.get();
+	}
+
+	/*
+	* NetworkSnapshot::NetworkSnapshot() - Construct the empty snapshot
+	*/
+	NetworkSnapshot::NetworkSnapshot() :
+		sequence(0),
+		instances()
+	{}
+	/*
+	* NetworkSnapshot::NetworkSnapshot() - Capture the state of the given instances
+	* @_sequence: the sequence number of the snapshot
+	* @_instances: the synced instances to capture
+	*/
+	NetworkSnapshot::NetworkSnapshot(Uint16 _sequence, const std::map<std::string,Instance*>& _instances) :
+		sequence(_sequence),
+		instances()
+	{
+		for (auto& inst : _instances) {
+			instances.emplace(inst.first, NetworkInstanceState(inst.second));
+		}
+	}
+
+	/*
+	* NetworkSnapshot::serialize_keyframe() - Return every instance state in the snapshot
+	*/
+	std::vector<Uint8> NetworkSnapshot::serialize_keyframe() const {
+		const NetworkInstanceState zero;
+
+		std::vector<Uint8> data;
+		data.reserve(16 + instances.size()*64);
+		internal::snapshot_write_varint(&data, sequence);
+		internal::snapshot_write_varint(&data, static_cast<Sint32>(instances.size()));
+		for (auto& inst : instances) {
+			internal::snapshot_write_string(&data, inst.first);
+			internal::snapshot_write_fields(&data, inst.second, zero, internal::SNAPSHOT_ALL);
+		}
+
+		return data;
+	}
+	/*
+	* NetworkSnapshot::deserialize_keyframe() - Replace the snapshot with the given keyframe
+	* @data: the keyframe to load
+	*/
+	int NetworkSnapshot::deserialize_keyframe(const std::vector<Uint8>& data) {
+		instances.clear();
+
+		size_t offset = 0;
+		Sint32 seq = 0, amount = 0;
+		if ((!internal::snapshot_read_varint(data, &offset, &seq))||(!internal::snapshot_read_varint(data, &offset, &amount))) {
+			return 1; // Return 1 when the header is truncated
+		}
+		sequence = static_cast<Uint16>(seq);
+
+		for (Sint32 i=0; i<amount; ++i) {
+			std::string key;
+			NetworkInstanceState state;
+			if (
+				(!internal::snapshot_read_string(data, &offset, &key))
+				||(!internal::snapshot_read_fields(data, &offset, &state, internal::SNAPSHOT_ALL))
+			) {
+				instances.clear();
+				return 2; // Return 2 when an instance is truncated
+			}
+			instances.emplace(key, state);
+		}
+
+		return 0; // Return 0 on success
+	}
+	/*
+	* NetworkSnapshot::serialize_delta() - Return only the instance fields which changed since the given baseline
+	* @baseline: the snapshot which the receiver has acknowledged
+	*/
+	std::vector<Uint8> NetworkSnapshot::serialize_delta(const NetworkSnapshot& baseline) const {
+		const NetworkInstanceState zero;
+
+		std::vector<Uint8> changes;
+		Sint32 change_amount = 0;
+		for (auto& inst : instances) {
+			auto base = baseline.instances.find(inst.first);
+			const NetworkInstanceState& base_state = (base != baseline.instances.end()) ? base->second : zero;
+
+			const Uint8 fields = (base != baseline.instances.end()) ? inst.second.get_changes(base_state) : static_cast<Uint8>(internal::SNAPSHOT_ALL);
+			if (fields == 0) {
+				continue;
+			}
+
+			internal::snapshot_write_string(&changes, inst.first);
+			changes.push_back(fields);
+			internal::snapshot_write_fields(&changes, inst.second, base_state, fields);
+			++change_amount;
+		}
+
+		std::vector<Uint8> data;
+		data.reserve(16 + changes.size());
+		internal::snapshot_write_varint(&data, sequence);
+		internal::snapshot_write_varint(&data, baseline.sequence);
+		internal::snapshot_write_varint(&data, change_amount);
+		data.insert(data.end(), changes.begin(), changes.end());
+
+		std::vector<const std::string*> removed;
+		for (auto& inst : baseline.instances) {
+			if (instances.find(inst.first) == instances.end()) {
+				removed.push_back(&inst.first);
+			}
+		}
+		internal::snapshot_write_varint(&data, static_cast<Sint32>(removed.size()));
+		for (auto& key : removed) {
+			internal::snapshot_write_string(&data, *key);
+		}
+
+		return data;
+	}
+	/*
+	* NetworkSnapshot::deserialize_delta() - Replace the snapshot with the given delta applied to its baseline
+	* @history: the previously received snapshots, one of which should be the baseline
+	* @data: the delta to apply
+	*/
+	int NetworkSnapshot::deserialize_delta(const std::map<Uint16,NetworkSnapshot>& history, const std::vector<Uint8>& data) {
+		size_t offset = 0;
+		Sint32 seq = 0, baseline_seq = 0, amount = 0;
+		if (
+			(!internal::snapshot_read_varint(data, &offset, &seq))
+			||(!internal::snapshot_read_varint(data, &offset, &baseline_seq))
+			||(!internal::snapshot_read_varint(data, &offset, &amount))
+		) {
+			return 1; // Return 1 when the header is truncated
+		}
+
+		auto baseline = history.find(static_cast<Uint16>(baseline_seq));
+		if (baseline == history.end()) {
+			return 2; // Return 2 when the baseline is no longer available
+		}
+
+		sequence = static_cast<Uint16>(seq);
+		instances = baseline->second.instances;
+
+		for (Sint32 i=0; i<amount; ++i) {
+			std::string key;
+			if ((!internal::snapshot_read_string(data, &offset, &key))||(offset >= data.size())) {
+				instances.clear();
+				return 3; // Return 3 when an instance is truncated
+			}
+			const Uint8 fields = data[offset++];
+
+			NetworkInstanceState& state = instances[key];
+			if (!internal::snapshot_read_fields(data, &offset, &state, fields)) {
+				instances.clear();
+				return 3;
+			}
+		}
+
+		if (!internal::snapshot_read_varint(data, &offset, &amount)) {
+			instances.clear();
+			return 3;
+		}
+		for (Sint32 i=0; i<amount; ++i) {
+			std::string key;
+			if (!internal::snapshot_read_string(data, &offset, &key)) {
+				instances.clear();
+				return 3;
+			}
+			instances.erase(key);
+		}
+
+		return 0; // Return 0 on success
+	}
+
+	/*
+	* NetworkSnapshot::get_instances() - Return the map of every instance state in the format of Instance::serialize_net()
+	*/
+	std::map<std::string,std::vector<Uint8>> NetworkSnapshot::get_instances() const {
+		std::map<std::string,std::vector<Uint8>> m;
+		for (auto& inst : instances) {
+			m.emplace(inst.first, inst.second.get_net());
+		}
+		return m;
+	}
+
+	/*
+	* NetworkSnapshot::get_is_newer() - Return whether the first sequence number is newer than the second, accounting for wraparound
+	* @a: the first sequence number
+	* @b: the second sequence number
+	*/
+	bool NetworkSnapshot::get_is_newer(Uint16 a, Uint16 b) {
+		return (static_cast<Sint16>(a - b) > 0);
+	}
+}
+
+#endif // BEE_NETWORK_SNAPSHOT
@@ -0,0 +1,54 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef BEE_NETWORK_SNAPSHOT_H
+#define BEE_NETWORK_SNAPSHOT_H 1
+
+#include <string>
+#include <vector>
+#include <map>
+
+#include <SDL2/SDL_net.h>
+
+namespace bee {
+	// Forward declaration
+	class Instance;
+
+	struct NetworkInstanceState { // The quantized state of a single synced instance
+		std::string sprite;
+		int subimage_time;
+		double mass;
+		double friction;
+		int values[15]; // The quantized position, rotation, velocity, angular velocity, and previous position
+
+		NetworkInstanceState();
+		explicit NetworkInstanceState(Instance*);
+
+		Uint8 get_changes(const NetworkInstanceState&) const;
+		std::vector<Uint8> get_net() const;
+	};
+
+	struct NetworkSnapshot { // The state of every synced instance at the time that it was sent
+		Uint16 sequence;
+		std::map<std::string,NetworkInstanceState> instances;
+
+		NetworkSnapshot();
+		NetworkSnapshot(Uint16, const std::map<std::string,Instance*>&);
+
+		std::vector<Uint8> serialize_keyframe() const;
+		int deserialize_keyframe(const std::vector<Uint8>&);
+		std::vector<Uint8> serialize_delta(const NetworkSnapshot&) const;
+		int deserialize_delta(const std::map<Uint16,NetworkSnapshot>&, const std::vector<Uint8>&);
+
+		std::map<std::string,std::vector<Uint8>> get_instances() const;
+
+		static bool get_is_newer(Uint16, Uint16);
+	};
+}
+
+#endif // BEE_NETWORK_SNAPSHOT_H
@@ -0,0 +1,258 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef BEE_NETWORK_THREAD
+#define BEE_NETWORK_THREAD 1
+
+#include <thread> // Include the required library headers
+#include <atomic>
+#include <chrono>
+#include <unordered_map>
+
+#include "thread.hpp" // Include the engine headers
+
+#include "../defines.hpp"
+#include "../engine.hpp"
+
+#include "../util/networking.hpp"
+
+#include "../messenger/messenger.hpp"
+
+#include "../data/spscqueue.hpp"
+
+#include "client.hpp"
+#include "packet.hpp"
+
+namespace bee { namespace net {
+	namespace internal {
+		std::thread network_thread;
+		std::atomic<bool> is_thread_running (false);
+		std::atomic<int> thread_self_id (-1); // The id which the network thread uses to reply to keepalives
+
+		UDPsocket thread_sock = nullptr;
+		IPaddress thread_server; // The address of the host when the thread belongs to a client
+		bool thread_is_host = false;
+		Uint32 thread_timeout = 0;
+
+		std::unique_ptr<SPSCQueue<std::unique_ptr<NetworkPacket>>> incoming_queue; // The decoded packets which are waiting to be handled by the main thread
+		std::unique_ptr<SPSCQueue<std::unique_ptr<NetworkPacket>>> outgoing_queue; // The addressed packets which are waiting to be sent by the network thread
+		std::unordered_map<Uint32,std::unique_ptr<NetworkPacket>> thread_buffer; // The partially received packets, keyed by the sender id and packet id
+	}
+
+	/*
+	* internal::thread_start() - Start the network thread which sends and receives over the given socket
+	* ! While the thread is running, the main thread must not use the socket directly
+	* @sock: the socket to use
+	* @channel: the channel which is bound to the host, only used by clients
+	* @is_host: whether the thread belongs to the host
+	* @timeout: the time after which partially received packets are dropped
+	*/
+	int internal::thread_start(UDPsocket sock, int channel, bool is_host, Uint32 timeout) {
+		if (internal::is_thread_running) {
+			return 1; // Return 1 when the thread is already running
+		}
+
+		if (!is_host) {
+			IPaddress* ipa = network_get_peer_address(sock, channel);
+			if (ipa == nullptr) {
+				messenger::send({"engine", "network"}, E_MESSAGE::WARNING, "Failed to start network thread: the socket is not bound");
+				return 2; // Return 2 when the host address is unknown
+			}
+			internal::thread_server = *ipa;
+		}
+
+		internal::thread_sock = sock;
+		internal::thread_is_host = is_host;
+		internal::thread_timeout = timeout;
+		internal::thread_self_id = (is_host) ? 0 : -1;
+
+		internal::incoming_queue = std::make_unique<SPSCQueue<std::unique_ptr<NetworkPacket>>>(BEE_NET_QUEUE_SIZE);
+		internal::outgoing_queue = std::make_unique<SPSCQueue<std::unique_ptr<NetworkPacket>>>(BEE_NET_QUEUE_SIZE);
+
+		internal::is_thread_running = true;
+		internal::network_thread = std::thread(internal::thread_main);
+
+		return 0; // Return 0 on success
+	}
+	/*
+	* internal::thread_stop() - Send the remaining queued packets and join the network thread
+	*/
+	int internal::thread_stop() {
+		if (!internal::network_thread.joinable()) {
+			return 1; // Return 1 when the thread isn't running
+		}
+
+		internal::is_thread_running = false;
+		internal::network_thread.join();
+
+		internal::incoming_queue.reset();
+		internal::outgoing_queue.reset();
+		internal::thread_sock = nullptr;
+		internal::thread_self_id = -1;
+
+		return 0; // Return 0 on success
+	}
+	/*
+	* internal::get_is_threaded() - Return whether packets are currently being exchanged through the network thread
+	*/
+	bool internal::get_is_threaded() {
+		return internal::is_thread_running;
+	}
+	/*
+	* internal::thread_set_id() - Set the id which the network thread uses in its replies
+	* @id: the id which the host assigned to us
+	*/
+	int internal::thread_set_id(int id) {
+		internal::thread_self_id = id;
+		return 0;
+	}
+
+	/*
+	* internal::thread_send() - Queue a copy of the given packet to be sent to the given client by the network thread
+	* ! The destination is resolved here since the client sockets are only used by the main thread
+	* @client: the client to send to
+	* @packet: the packet to send
+	*/
+	int internal::thread_send(const NetworkClient& client, std::unique_ptr<NetworkPacket> const & packet) {
+		IPaddress* ipa = network_get_peer_address(client.sock, client.channel);
+		if (ipa == nullptr) {
+			return 0; // Return 0 when the client isn't bound
+		}
+
+		std::unique_ptr<NetworkPacket> p = std::make_unique<NetworkPacket>(*packet);
+		p->address = *ipa;
+
+		if (!internal::outgoing_queue->push(std::move(p))) {
+			messenger::send({"engine", "network"}, E_MESSAGE::WARNING, "Failed to send packet: the network thread queue is full");
+			return 0; // Return 0 when the queue is full
+		}
+
+		return 1; // Return 1 when the packet was queued for its single destination
+	}
+	/*
+	* internal::thread_recv() - Return the next packet which was completely received by the network thread
+	*/
+	std::unique_ptr<NetworkPacket> internal::thread_recv() {
+		std::unique_ptr<NetworkPacket> packet;
+		if ((internal::incoming_queue == nullptr)||(!internal::incoming_queue->pop(&packet))) {
+			return nullptr; // Return nullptr when there are no waiting packets
+		}
+		return packet;
+	}
+
+	/*
+	* internal::thread_handle_datagram() - Decode the given datagram and pass it to the main thread once its sequence is complete
+	* ! Clients reply to keepalives immediately so that a slow frame doesn't cause them to time out
+	* @udp_data: the received datagram
+	*/
+	int internal::thread_handle_datagram(UDPpacket* udp_data) {
+		std::unique_ptr<NetworkPacket> packet = std::make_unique<NetworkPacket>(udp_data);
+		if (packet->get_signal1() == E_NETSIG1::INVALID) {
+			return 1; // Return 1 when the datagram is malformed
+		}
+
+		if (!packet->get_is_sequence_complete()) {
+			const Uint32 key = (static_cast<Uint32>(packet->id) << 16) | packet->get_packet_id();
+			auto it = internal::thread_buffer.find(key);
+			if (it == internal::thread_buffer.end()) {
+				if (!get_can_buffer(internal::thread_buffer, packet->id)) {
+					return 3; // Return 3 when the sender already has too many incomplete packets
+				}
+
+				internal::thread_buffer.emplace(key, std::move(packet));
+				return 0;
+			}
+
+			it->second->append_net(udp_data);
+			if (!it->second->get_is_sequence_complete()) {
+				return 0; // Return 0 when only part of the sequence has been received
+			}
+
+			packet = std::move(it->second);
+			internal::thread_buffer.erase(it);
+		}
+
+		if (
+			(!internal::thread_is_host)
+			&&(internal::thread_self_id >= 0)
+			&&(packet->get_signal1() == E_NETSIG1::SERVER_INFO)
+			&&(packet->get_signal2() == E_NETSIG2::KEEPALIVE)
+		) {
+			auto p = std::make_unique<NetworkPacket>(
+				static_cast<Uint8>(internal::thread_self_id.load()),
+				E_NETSIG1::SERVER_INFO,
+				E_NETSIG2::KEEPALIVE
+			);
+			queue_packet(internal::thread_server, p);
+		}
+
+		if (!internal::incoming_queue->push(std::move(packet))) {
+			messenger::send({"engine", "network"}, E_MESSAGE::WARNING, "Dropped packet: the network thread queue is full");
+			return 2; // Return 2 when the main thread has fallen too far behind
+		}
+
+		return 0; // Return 0 on success
+	}
+	/*
+	* internal::thread_main() - Send the queued packets and receive new ones until the thread is stopped
+	*/
+	void internal::thread_main() {
+		UDPpacket** batch = network_packet_alloc_vector(BEE_NET_BATCH_SIZE, NetworkPacket::MAX_SIZE);
+		if (batch == nullptr) {
+			messenger::send({"engine", "network"}, E_MESSAGE::ERROR, "Failed to allocate the network thread receive buffers");
+			internal::is_thread_running = false;
+			return;
+		}
+
+		std::unique_ptr<NetworkPacket> packet;
+		while (true) {
+			const bool is_running = internal::is_thread_running;
+			bool is_idle = true;
+
+			// Write the packets from the main thread, the last ones are still sent when the thread is stopping
+			while (internal::outgoing_queue->pop(&packet)) {
+				queue_packet(packet->address, packet);
+				is_idle = false;
+			}
+			flush_packets(internal::thread_sock);
+
+			if (!is_running) {
+				break;
+			}
+
+			int r = network_udp_recv_batch(internal::thread_sock, batch, BEE_NET_BATCH_SIZE);
+			for (int i=0; i<r; ++i) {
+				thread_handle_datagram(batch[i]);
+			}
+			if (r > 0) {
+				flush_packets(internal::thread_sock); // Send the keepalive replies
+				is_idle = false;
+			}
+
+			// Drop packets whose remaining fragments were lost
+			const Uint32 now = get_ticks();
+			for (auto it=internal::thread_buffer.begin(); it!=internal::thread_buffer.end(); ) {
+				if (now - it->second->get_recv_time() > internal::thread_timeout) {
+					it = internal::thread_buffer.erase(it);
+				} else {
+					++it;
+				}
+			}
+
+			if (is_idle) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		}
+
+		network_packet_free_vector(batch);
+		internal::free_packet_pool();
+		internal::thread_buffer.clear();
+	}
+}}
+
+#endif // BEE_NETWORK_THREAD
@@ -0,0 +1,33 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef BEE_NETWORK_THREAD_H
+#define BEE_NETWORK_THREAD_H 1
+
+#include <memory>
+
+#include <SDL2/SDL_net.h>
+
+namespace bee {
+	// Forward declarations
+	struct NetworkClient;
+	class NetworkPacket;
+namespace net { namespace internal {
+	int thread_start(UDPsocket, int, bool, Uint32);
+	int thread_stop();
+	bool get_is_threaded();
+	int thread_set_id(int);
+
+	int thread_send(const NetworkClient&, std::unique_ptr<NetworkPacket> const &);
+	std::unique_ptr<NetworkPacket> thread_recv();
+
+	int thread_handle_datagram(UDPpacket*);
+	void thread_main();
+}}}
+
+#endif // BEE_NETWORK_THREAD_H
@@ -9,6 +9,8 @@
 #ifndef BEE_PHYSICS_BODY
 #define BEE_PHYSICS_BODY 1
 
+#include <algorithm> // Include the required library headers
+
 #include "body.hpp"
 
 #include "world.hpp"
@@ -25,10 +27,23 @@
 
 #include "../data/sidp.hpp"
 #include "../data/serialdata.hpp"
+#include "../data/serialschema.hpp"
 
 #include "../resource/room.hpp"
 
 namespace bee {
+	PhysicsBodyState::PhysicsBodyState() :
+		type(E_PHYS_SHAPE::NONE),
+		shape_param_amount(0),
+		shape_params(),
+		mass(0.0),
+		scale(1.0),
+		friction(0.0),
+		attached_id(-1),
+		vectors(),
+		collision_flags(0)
+	{}
+
 	PhysicsBody::PhysicsBody(PhysicsWorld* _world, Instance* _inst, E_PHYS_SHAPE _type, double _mass, double x, double y, double z, double* p) :
 		type(_type),
 		shape(nullptr),
@@ -151,59 +166,130 @@ namespace bee {
 		return *this;
 	}
 
+	/*
+	* PhysicsBody::get_schema() - Return the schema of the body record
+	*/
+	const SerialSchema& PhysicsBody::get_schema() {
+		static const SerialSchema schema ("PhysicsBody", {
+			{"type", E_DATA_TYPE::INT},
+			{"mass", E_DATA_TYPE::DOUBLE},
+			{"scale", E_DATA_TYPE::DOUBLE},
+			{"friction", E_DATA_TYPE::DOUBLE},
+			{"shape_params", E_DATA_TYPE::VECTOR, E_DATA_TYPE::DOUBLE},
+			{"attached_instance", E_DATA_TYPE::INT},
+			{"position", E_DATA_TYPE::VECTOR, E_DATA_TYPE::DOUBLE},
+			{"rotation", E_DATA_TYPE::VECTOR, E_DATA_TYPE::DOUBLE},
+			{"gravity", E_DATA_TYPE::VECTOR, E_DATA_TYPE::DOUBLE},
+			{"velocity", E_DATA_TYPE::VECTOR, E_DATA_TYPE::DOUBLE},
+			{"velocity_ang", E_DATA_TYPE::VECTOR, E_DATA_TYPE::DOUBLE},
+			{"collision_flags", E_DATA_TYPE::INT}
+		});
+		return schema;
+	}
+
 	std::string PhysicsBody::serialize(bool should_pretty_print) const {
-		std::vector<SIDP>* sp = new std::vector<SIDP>();
-		for (size_t i=0; i<shape_param_amount; ++i) {
-			sp->push_back(shape_params[i]);
+		SerialData sd (256, true);
+		serialize(&sd);
+		return get_schema().to_text(sd.get(), should_pretty_print);
+	}
+	std::string PhysicsBody::serialize() const {
+		return serialize(false);
+	}
+	/*
+	* PhysicsBody::serialize() - Append the body record to the given compact data
+	* ! Constraints aren't stored since they refer to other bodies which might not exist when the record is read
+	* @sd: the data to store in
+	*/
+	int PhysicsBody::serialize(SerialData* sd) const {
+		if ((!sd->get_is_writing())||(!sd->get_is_compact())) {
+			return 1; // Return 1 when the data can't be written to
 		}
 
-		std::vector<SIDP>* cons = new std::vector<SIDP>();
-		for (auto& c : constraints) {
-			size_t constraint_param_amount = attached_world->get_constraint_param_amount(std::get<0>(c));
-			std::vector<SIDP>* con = new std::vector<SIDP>();
-
-			for (size_t i=0; i<constraint_param_amount; ++i) {
-				con->push_back(std::get<1>(c)[i]);
-			}
-
-			cons->push_back(SIDP(con));
+		get_schema().store_header(sd);
+
+		int t = static_cast<int>(type);
+		double m = mass;
+		double s = scale;
+		double f = friction;
+		std::vector<double> sp (shape_params, shape_params+shape_param_amount);
+		int attached_id = (attached_instance != nullptr) ? attached_instance->id : -1;
+		sd->store_int(t);
+		sd->store_double(m);
+		sd->store_double(s);
+		sd->store_double(f);
+		sd->store_vector(sp);
+		sd->store_int(attached_id);
+
+		const btVector3 vectors[] = {
+			get_position(),
+			btVector3(get_rotation_x(), get_rotation_y(), get_rotation_z()),
+			body->getGravity(),
+			body->getLinearVelocity(),
+			body->getAngularVelocity()
+		};
+		for (auto& v : vectors) {
+			std::vector<double> d = {v.x(), v.y(), v.z()};
+			sd->store_vector(d);
 		}
 
-		std::map<std::string,SIDP> data;
-		data["type"] = static_cast<int>(type);
-		data["mass"] = mass;
-		data["scale"] = scale;
-		data["friction"] = friction;
-		data["shape_params"].vector(sp);
+		int collision_flags = body->getCollisionFlags();
+		sd->store_int(collision_flags);
 
-		data["attached_instance"] = attached_instance->id;
-		data["position"].vector(new std::vector<SIDP>({get_position().x(), get_position().y(), get_position().z()}));
-		data["rotation"].vector(new std::vector<SIDP>({get_rotation_x(), get_rotation_y(), get_rotation_z()}));
+		return 0; // Return 0 on success
+	}
+	/*
+	* PhysicsBody::read() - Read the next body record from the given compact data without applying it
+	* ! The vectors are read into the buffers of the given state so that reusing the state doesn't allocate unless the shape grows
+	* @sd: the data to read from
+	* @state: the state to read into
+	*/
+	int PhysicsBody::read(SerialData* sd, PhysicsBodyState* state) const {
+		if ((sd->get_is_writing())||(!sd->get_is_compact())) {
+			return 1; // Return 1 when the data can't be read from
+		}
+		if (get_schema().store_header(sd)) {
+			return 2; // Return 2 when the record has a different layout
+		}
 
-		data["gravity"].vector(new std::vector<SIDP>({body->getGravity().x(), body->getGravity().y(), body->getGravity().z()}));
-		data["velocity"].vector(new std::vector<SIDP>({body->getLinearVelocity().x(), body->getLinearVelocity().y(), body->getLinearVelocity().z()}));
-		data["velocity_ang"].vector(new std::vector<SIDP>({body->getAngularVelocity().x(), body->getAngularVelocity().y(), body->getAngularVelocity().z()}));
+		int t = 0;
+		bool is_valid = (
+			(!sd->store_int(t))
+			&&(!sd->store_double(state->mass))
+			&&(!sd->store_double(state->scale))
+			&&(!sd->store_double(state->friction))
+			&&(!sd->store_vector(state->shape_params))
+			&&(!sd->store_int(state->attached_id))
+		);
+		for (auto& v : state->vectors) {
+			is_valid = is_valid && (!sd->store_vector(v)) && (v.size() == 3);
+		}
+		is_valid = is_valid && (!sd->store_int(state->collision_flags));
 
-		data["collision_flags"] = body->getCollisionFlags();
-		data["constraints"].vector(cons);
+		state->type = static_cast<E_PHYS_SHAPE>(t);
+		state->shape_param_amount = get_shape_param_amount(state->type);
+		if ((!state->shape_params.empty())&&((state->type == E_PHYS_SHAPE::MULTISPHERE)||(state->type == E_PHYS_SHAPE::CONVEX_HULL))) {
+			state->shape_param_amount = get_shape_param_amount(state->type, static_cast<int>(state->shape_params[0]));
+		}
+		if ((!is_valid)||(state->shape_params.size() < state->shape_param_amount)) {
+			messenger::send({"engine", "physics"}, E_MESSAGE::WARNING, "Failed to deserialize physics body");
+			return 3; // Return 3 when the record is invalid
+		}
 
-		return map_serialize(data, should_pretty_print);
+		return 0; // Return 0 on success
 	}
-	std::string PhysicsBody::serialize() const {
-		return serialize(false);
-	}
-	int PhysicsBody::deserialize(std::map<SIDP,SIDP>& m, Instance* inst) {
-		mass = SIDP_d(m["mass"]);
-		scale = SIDP_d(m["scale"]);
-		friction = SIDP_d(m["friction"]);
-
-		E_PHYS_SHAPE previous_type = type;
-		type = static_cast<E_PHYS_SHAPE>(SIDP_i(m["type"]));
-		if (type != previous_type) {
-			shape_param_amount = get_shape_param_amount(type);
-			if ((type == E_PHYS_SHAPE::MULTISPHERE)||(type == E_PHYS_SHAPE::CONVEX_HULL)) {
-				shape_param_amount = get_shape_param_amount(type, static_cast<int>(SIDP_cd(m["shape_params"], 0)));
-			}
+	/*
+	* PhysicsBody::apply() - Replace the body state with the given state which was read by read()
+	* @state: the state to apply
+	* @inst: the instance to attach to
+	*/
+	int PhysicsBody::apply(const PhysicsBodyState& state, Instance* inst) {
+		mass = state.mass;
+		scale = state.scale;
+		friction = state.friction;
+
+		if (state.type != type) {
+			type = state.type;
+			shape_param_amount = state.shape_param_amount;
 
 			if (shape_params != nullptr) {
 				delete[] shape_params;
@@ -211,57 +297,52 @@ namespace bee {
 			}
 			if (shape_param_amount > 0) {
 				shape_params = new double[shape_param_amount];
-				for (size_t i=0; i<shape_param_amount; ++i) {
-					shape_params[i] = SIDP_cd(m["shape_params"], i);
-				}
+				std::copy(state.shape_params.begin(), state.shape_params.begin()+shape_param_amount, shape_params);
 			}
 
 			set_shape(type, shape_params);
 		}
 
 		attached_instance = inst;
-		body->setCollisionFlags(SIDP_i(m["collision_flags"]));
-
-		btVector3 position = btVector3(
-			btScalar(SIDP_cd(m["position"], 0)),
-			btScalar(SIDP_cd(m["position"], 1)),
-			btScalar(SIDP_cd(m["position"], 2))
-		);
-		btVector3 rotation = btVector3(
-			btScalar(SIDP_cd(m["rotation"], 0)),
-			btScalar(SIDP_cd(m["rotation"], 1)),
-			btScalar(SIDP_cd(m["rotation"], 2))
-		);
+		body->setCollisionFlags(state.collision_flags);
 
+		const std::vector<double>* vectors = state.vectors;
 		btTransform transform;
 		transform.setIdentity();
-		transform.setOrigin(position/btScalar(scale));
+		transform.setOrigin(btVector3(btScalar(vectors[0][0]), btScalar(vectors[0][1]), btScalar(vectors[0][2]))/btScalar(scale));
 		btQuaternion qt;
-		qt.setEuler(rotation.y(), rotation.x(), rotation.z());
+		qt.setEuler(vectors[1][1], vectors[1][0], vectors[1][2]);
 		transform.setRotation(qt);
 		body->setCenterOfMassTransform(transform);
 
-		btVector3 gravity = btVector3(
-			btScalar(SIDP_cd(m["gravity"], 0)),
-			btScalar(SIDP_cd(m["gravity"], 1)),
-			btScalar(SIDP_cd(m["gravity"], 2))
-		);
-		body->setGravity(gravity);
+		body->setGravity(btVector3(btScalar(vectors[2][0]), btScalar(vectors[2][1]), btScalar(vectors[2][2])));
+		body->setLinearVelocity(btVector3(btScalar(vectors[3][0]), btScalar(vectors[3][1]), btScalar(vectors[3][2])));
+		body->setAngularVelocity(btVector3(btScalar(vectors[4][0]), btScalar(vectors[4][1]), btScalar(vectors[4][2])));
 
-		btVector3 velocity = btVector3(
-			btScalar(SIDP_cd(m["velocity"], 0)),
-			btScalar(SIDP_cd(m["velocity"], 1)),
-			btScalar(SIDP_cd(m["velocity"], 2))
-		);
-		btVector3 velocity_ang = btVector3(
-			btScalar(SIDP_cd(m["velocity_ang"], 0)),
-			btScalar(SIDP_cd(m["velocity_ang"], 1)),
-			btScalar(SIDP_cd(m["velocity_ang"], 2))
-		);
-		body->setLinearVelocity(velocity);
-		body->setAngularVelocity(velocity_ang);
+		return 0; // Return 0 on success
+	}
+	/*
+	* PhysicsBody::deserialize() - Replace the body state with the next record in the given compact data
+	* ! The record is read into a reused state so that loading doesn't allocate unless the shape changes
+	* @sd: the data to read from
+	* @inst: the instance to attach to
+	*/
+	int PhysicsBody::deserialize(SerialData* sd, Instance* inst) {
+		thread_local PhysicsBodyState state;
 
-		return 0;
+		const int r = read(sd, &state);
+		if (r) {
+			return r; // Return 1, 2, or 3 when the record couldn't be read
+		}
+
+		return apply(state, inst);
+	}
+	int PhysicsBody::deserialize(std::map<SIDP,SIDP>& m, Instance* inst) {
+		SerialData sd (256, true);
+		get_schema().store(&sd, &m);
+
+		SerialData record (sd.get());
+		return deserialize(&record, inst);
 	}
 	int PhysicsBody::deserialize(const std::string& data, Instance* inst) {
 		std::map<SIDP,SIDP> m;
@@ -286,7 +367,7 @@ namespace bee {
 	}
 
 	std::vector<Uint8> PhysicsBody::serialize_net() {
-		SerialData data (128);
+		SerialData data (128, true);
 
 		data.store_double(mass);
 		data.store_double(friction);
@@ -396,6 +477,9 @@ namespace bee {
 	double PhysicsBody::get_mass() const {
 		return mass;
 	}
+	double PhysicsBody::get_friction() const {
+		return friction;
+	}
 	double PhysicsBody::get_scale() const {
 		return scale;
 	}
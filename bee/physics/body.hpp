@@ -22,10 +22,27 @@
 namespace bee {
 	// Forward declarations
 	class SIDP;
+	class SerialData;
+	class SerialSchema;
 	class Instance;
 	class PhysicsWorld;
 	class PhysicsDraw;
 
+	struct PhysicsBodyState { // The data struct which holds a body record after it has been read and before it is applied
+		E_PHYS_SHAPE type;
+		size_t shape_param_amount;
+		std::vector<double> shape_params;
+		double mass;
+		double scale;
+		double friction;
+		int attached_id;
+		std::vector<double> vectors[5]; // The position, rotation, gravity, velocity, and angular velocity
+		int collision_flags;
+
+		// See bee/physics/body.cpp for function comments
+		PhysicsBodyState();
+	};
+
 	class PhysicsBody {
 		private:
 			E_PHYS_SHAPE type;
@@ -50,8 +67,14 @@ namespace bee {
 
 			PhysicsBody& operator=(const PhysicsBody&);
 
+			static const SerialSchema& get_schema();
+
 			std::string serialize(bool) const;
 			std::string serialize() const;
+			int serialize(SerialData*) const;
+			int read(SerialData*, PhysicsBodyState*) const;
+			int apply(const PhysicsBodyState&, Instance*);
+			int deserialize(SerialData*, Instance*);
 			int deserialize(std::map<SIDP,SIDP>&, Instance*);
 			int deserialize(const std::string&, Instance*);
 			int deserialize(const std::string&);
@@ -63,6 +86,7 @@ namespace bee {
 			int remove();
 
 			double get_mass() const;
+			double get_friction() const;
 			double get_scale() const;
 			btVector3 get_inertia() const;
 			btRigidBody* get_body() const;
@@ -0,0 +1,565 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef BEE_RENDER_ATLAS
+#define BEE_RENDER_ATLAS 1
+
+#include "../defines.hpp"
+
+#include <sstream> // Include the required library headers
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+
+#include <SDL2/SDL_image.h> // Include the required SDL headers
+
+#include "atlas.hpp" // Include the engine headers
+
+#include "../engine.hpp"
+
+#include "../util/platform.hpp"
+#include "../util/debug.hpp"
+#include "../util/string.hpp"
+#include "../util/files.hpp"
+
+#include "../init/gameoptions.hpp"
+
+#include "../messenger/messenger.hpp"
+
+#include "../core/jobs.hpp"
+
+#include "../data/rectpacker.hpp"
+
+#include "render.hpp"
+#include "renderer.hpp"
+#include "shader.hpp"
+
+#include "../resource/texture.hpp"
+
+namespace bee {
+	AtlasPage::AtlasPage() :
+		width(0),
+		height(0),
+		gl_texture(-1),
+		vao(-1),
+		vbo_vertices(-1),
+		vbo_texcoords(-1),
+		ibo(-1)
+	{}
+
+	AtlasEntry::AtlasEntry() :
+		AtlasEntry(nullptr, "", 0, {0, 0, 0, 0})
+	{}
+	AtlasEntry::AtlasEntry(Texture* _texture, const std::string& _name, size_t _page, SDL_Rect _rect) :
+		texture(_texture),
+		name(_name),
+		page(_page),
+		rect(_rect)
+	{}
+namespace atlas {
+	namespace internal {
+		std::vector<Texture*> queued; // The textures which will be packed by the next call to bake() or build()
+		std::vector<AtlasPage> pages;
+		std::vector<int> packed_ids; // The ids of the textures which were packed into the pages
+	}
+
+	/*
+	* internal::decode() - Decode the image of each given texture on the job threads
+	* @textures: the textures to decode
+	* @surfaces: the location to store the decoded images, which are nullptr for the images that failed to decode
+	*/
+	int internal::decode(const std::vector<Texture*>& textures, std::vector<SDL_Surface*>* surfaces) {
+		surfaces->assign(textures.size(), nullptr);
+
+		jobs::parallel_for(textures.size(), [&textures, surfaces] (size_t begin, size_t end) {
+			for (size_t i=begin; i<end; ++i) {
+				(*surfaces)[i] = IMG_Load(textures[i]->get_path().c_str());
+				if ((*surfaces)[i] == nullptr) {
+					messenger::send({"engine", "atlas"}, E_MESSAGE::WARNING, "Failed to load texture \"" + textures[i]->get_name() + "\" for the atlas: " + IMG_GetError());
+				}
+			}
+		});
+
+		return 0;
+	}
+	/*
+	* internal::pack() - Find a place in the pages for each decoded image and return the amount of pages which are needed
+	* ! The images are packed from tallest to shortest, with the name as the tiebreaker so that offline builds are reproducible
+	* @textures: the textures to pack
+	* @surfaces: the decoded image of each texture
+	* @entries: the location to store the placement of each texture in the same order
+	*/
+	size_t internal::pack(const std::vector<Texture*>& textures, const std::vector<SDL_Surface*>& surfaces, std::vector<AtlasEntry>* entries) {
+		entries->clear();
+		std::vector<size_t> order;
+		for (size_t i=0; i<textures.size(); ++i) {
+			entries->emplace_back(textures[i], textures[i]->get_name(), 0, SDL_Rect({0, 0, 0, 0}));
+			if (surfaces[i] != nullptr) {
+				order.push_back(i);
+			}
+		}
+		std::sort(order.begin(), order.end(), [&surfaces, entries] (size_t a, size_t b) {
+			if (surfaces[a]->h != surfaces[b]->h) {
+				return (surfaces[a]->h > surfaces[b]->h);
+			}
+			if (surfaces[a]->w != surfaces[b]->w) {
+				return (surfaces[a]->w > surfaces[b]->w);
+			}
+			return ((*entries)[a].name < (*entries)[b].name);
+		});
+
+		std::vector<RectPacker> packers;
+		for (auto& i : order) {
+			AtlasEntry& e = (*entries)[i];
+
+			// Reserve the border on every side of the image so that compose() can extrude its edges
+			const int w = surfaces[i]->w + 2*BEE_ATLAS_PADDING;
+			const int h = surfaces[i]->h + 2*BEE_ATLAS_PADDING;
+
+			size_t p = 0;
+			for (; p<packers.size(); ++p) {
+				if (packers[p].insert(w, h, &e.rect)) {
+					break;
+				}
+			}
+			if (p == packers.size()) { // If the image doesn't fit in any of the pages, start a new one
+				packers.emplace_back(BEE_ATLAS_PAGE_SIZE, BEE_ATLAS_PAGE_SIZE, 0);
+				if (!packers.back().insert(w, h, &e.rect)) { // If the image is larger than a page, leave it to be loaded individually
+					packers.pop_back();
+					e.rect = {0, 0, 0, 0};
+					continue;
+				}
+			}
+			e.page = p;
+			e.rect = {e.rect.x + BEE_ATLAS_PADDING, e.rect.y + BEE_ATLAS_PADDING, surfaces[i]->w, surfaces[i]->h};
+		}
+
+		return packers.size();
+	}
+	/*
+	* internal::extrude() - Copy the edge pixels of the given rectangle into the border around it
+	* ! Without this, linear filtering at the edges of a packed texture would blend with the transparent border
+	* @surface: the 32-bit page surface
+	* @rect: the rectangle of the packed image, which must have BEE_ATLAS_PADDING pixels of space on every side
+	*/
+	int internal::extrude(SDL_Surface* surface, const SDL_Rect& rect) {
+		Uint32* pixels = static_cast<Uint32*>(surface->pixels);
+		const int stride = surface->pitch / 4;
+
+		for (int y=rect.y; y<rect.y+rect.h; ++y) { // Extrude the left and right edges
+			Uint32* row = pixels + y*stride;
+			for (int i=1; i<=BEE_ATLAS_PADDING; ++i) {
+				row[rect.x - i] = row[rect.x];
+				row[rect.x + rect.w - 1 + i] = row[rect.x + rect.w - 1];
+			}
+		}
+
+		const int x = rect.x - BEE_ATLAS_PADDING; // Extrude the top and bottom edges including the corners
+		const size_t size = (rect.w + 2*BEE_ATLAS_PADDING) * sizeof(Uint32);
+		for (int i=1; i<=BEE_ATLAS_PADDING; ++i) {
+			memcpy(pixels + (rect.y - i)*stride + x, pixels + rect.y*stride + x, size);
+			memcpy(pixels + (rect.y + rect.h - 1 + i)*stride + x, pixels + (rect.y + rect.h - 1)*stride + x, size);
+		}
+
+		return 0;
+	}
+	/*
+	* internal::compose() - Copy the decoded images into new page surfaces at their packed positions
+	* @page_amount: the amount of pages to create
+	* @entries: the placement of each image
+	* @surfaces: the decoded images in the same order as the entries
+	*/
+	std::vector<SDL_Surface*> internal::compose(size_t page_amount, const std::vector<AtlasEntry>& entries, const std::vector<SDL_Surface*>& surfaces) {
+		std::vector<SDL_Surface*> page_surfaces;
+		for (size_t p=0; p<page_amount; ++p) {
+			// Create the page with the same byte order as the images which are uploaded by Texture::load_from_surface()
+			page_surfaces.push_back(SDL_CreateRGBSurface(0, BEE_ATLAS_PAGE_SIZE, BEE_ATLAS_PAGE_SIZE, 32, 0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000));
+			if (page_surfaces.back() == nullptr) {
+				messenger::send({"engine", "atlas"}, E_MESSAGE::WARNING, "Failed to create atlas page: " + get_sdl_error());
+			}
+		}
+
+		// Copy each image into its rectangle, without blending so that the page keeps the image's alpha
+		for (size_t i=0; i<entries.size(); ++i) {
+			const AtlasEntry& e = entries[i];
+			if ((e.rect.w == 0)||(page_surfaces[e.page] == nullptr)) {
+				continue;
+			}
+
+			SDL_Rect dest (e.rect);
+			SDL_SetSurfaceBlendMode(surfaces[i], SDL_BLENDMODE_NONE);
+			SDL_BlitSurface(surfaces[i], nullptr, page_surfaces[e.page], &dest);
+
+			internal::extrude(page_surfaces[e.page], e.rect);
+		}
+
+		return page_surfaces;
+	}
+	/*
+	* internal::upload() - Create the OpenGL objects for a new page from the given surface
+	* @surface: the composed page
+	*/
+	int internal::upload(SDL_Surface* surface) {
+		if (surface == nullptr) {
+			return 1; // Return 1 when the page failed to compose
+		}
+
+		AtlasPage page;
+		page.width = surface->w;
+		page.height = surface->h;
+
+		// Generate the vertex array object for the page
+		glGenVertexArrays(1, &page.vao);
+		glBindVertexArray(page.vao);
+
+		// Generate the unit quad, which each draw scales to the size of its texture
+		GLfloat vertices[] = {
+			0.0, 0.0,
+			1.0, 0.0,
+			1.0, 1.0,
+			0.0, 1.0,
+		};
+		glGenBuffers(1, &page.vbo_vertices);
+		glBindBuffer(GL_ARRAY_BUFFER, page.vbo_vertices);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+		glGenBuffers(1, &page.vbo_texcoords);
+		glBindBuffer(GL_ARRAY_BUFFER, page.vbo_texcoords);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+		// Generate the indices of the two triangles which form the quad
+		GLushort elements[] = {
+			0, 1, 2,
+			2, 3, 0,
+		};
+		glGenBuffers(1, &page.ibo);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, page.ibo);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(elements), elements, GL_STATIC_DRAW);
+
+		// Bind the vertices to the VAO's vertex buffer
+		glEnableVertexAttribArray(render::get_program()->get_location("v_position"));
+		glBindBuffer(GL_ARRAY_BUFFER, page.vbo_vertices);
+		glVertexAttribPointer(
+			render::get_program()->get_location("v_position"),
+			2,
+			GL_FLOAT,
+			GL_FALSE,
+			0,
+			0
+		);
+
+		// Generate the texture from the page pixels
+		glGenTextures(1, &page.gl_texture);
+		glBindTexture(GL_TEXTURE_2D, page.gl_texture);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexImage2D(
+			GL_TEXTURE_2D,
+			0,
+			GL_RGBA,
+			page.width,
+			page.height,
+			0,
+			GL_RGBA,
+			GL_UNSIGNED_BYTE,
+			surface->pixels
+		);
+
+		glBindVertexArray(0); // Unbind VAO when done loading
+
+		pages.push_back(page);
+
+		return 0; // Return 0 on success
+	}
+	/*
+	* internal::assign() - Load each packed texture from its page
+	* @entries: the placement of each texture
+	* @page_ids: the index in the page list of each page in the entries, or -1 if the page failed to upload
+	*/
+	int internal::assign(const std::vector<AtlasEntry>& entries, const std::vector<size_t>& page_ids) {
+		for (auto& e : entries) {
+			if ((e.texture == nullptr)||(e.rect.w == 0)) {
+				continue;
+			}
+			if ((e.page >= page_ids.size())||(page_ids[e.page] == static_cast<size_t>(-1))) {
+				continue;
+			}
+
+			if (e.texture->get_is_loaded()) { // Replace the individually loaded texture with the packed one
+				e.texture->free();
+			}
+
+			if (!e.texture->load_from_atlas(page_ids[e.page], e.rect)) {
+				packed_ids.push_back(e.texture->get_id());
+			}
+		}
+
+		return 0;
+	}
+	/*
+	* internal::get_page() - Return the page with the given index, or nullptr if it doesn't exist
+	* @index: the index of the page
+	*/
+	const AtlasPage* internal::get_page(size_t index) {
+		if (index >= pages.size()) {
+			return nullptr;
+		}
+		return &pages[index];
+	}
+
+	/*
+	* add() - Queue the given texture to be packed by the next call to bake() or build()
+	* @texture: the texture to pack
+	*/
+	int add(Texture* texture) {
+		if (std::find(internal::queued.begin(), internal::queued.end(), texture) != internal::queued.end()) {
+			return 1; // Return 1 when the texture is already queued
+		}
+
+		internal::queued.push_back(texture);
+
+		return 0; // Return 0 on success
+	}
+	/*
+	* bake() - Pack the queued textures into new atlas pages and load them from the pages
+	* ! Textures which are too large for a page or can't be packed are loaded individually instead
+	*/
+	int bake() {
+		if (get_options().is_headless) {
+			internal::queued.clear();
+			return 1; // Return 1 when in headless mode
+		}
+
+		std::vector<Texture*> textures;
+		std::swap(textures, internal::queued);
+
+		if (!engine->renderer->is_atlas_enabled) { // If the shaders can't draw from atlas pages, load the textures individually
+			messenger::send({"engine", "atlas"}, E_MESSAGE::WARNING, "Failed to bake the texture atlas because the shaders don't support it, loading the textures individually");
+			for (auto& t : textures) {
+				if (!t->get_is_loaded()) {
+					t->load();
+				}
+			}
+			return 2; // Return 2 when atlases are unsupported
+		}
+
+		std::vector<SDL_Surface*> surfaces;
+		internal::decode(textures, &surfaces);
+
+		std::vector<AtlasEntry> entries;
+		const size_t page_amount = internal::pack(textures, surfaces, &entries);
+		std::vector<SDL_Surface*> page_surfaces = internal::compose(page_amount, entries, surfaces);
+
+		std::vector<size_t> page_ids;
+		for (auto& s : page_surfaces) {
+			page_ids.push_back((internal::upload(s) == 0) ? internal::pages.size()-1 : static_cast<size_t>(-1));
+			SDL_FreeSurface(s);
+		}
+
+		internal::assign(entries, page_ids);
+
+		size_t amount_packed = 0;
+		for (size_t i=0; i<textures.size(); ++i) {
+			if (surfaces[i] == nullptr) {
+				continue;
+			}
+			SDL_FreeSurface(surfaces[i]);
+
+			if (textures[i]->get_atlas_page() >= 0) {
+				++amount_packed;
+			} else if (!textures[i]->get_is_loaded()) { // Load the textures which didn't fit individually
+				textures[i]->load();
+			}
+		}
+
+		messenger::send({"engine", "atlas"}, E_MESSAGE::INFO, "Packed " + bee_itos(amount_packed) + " textures into " + bee_itos(page_amount) + " atlas pages");
+
+		return 0; // Return 0 on success
+	}
+	/*
+	* build() - Pack the queued textures into page images and write their layout to the given file so that it can be loaded with load()
+	* ! This doesn't use the renderer so it can run as an offline build step in headless mode
+	* ! The pages are written next to the layout file, e.g. "resources/atlas.csv" has the pages "resources/atlas_0.png", "resources/atlas_1.png", and so on
+	* @fname: the path of the layout file to write
+	*/
+	int build(const std::string& fname) {
+		std::vector<Texture*> textures;
+		std::swap(textures, internal::queued);
+
+		std::vector<SDL_Surface*> surfaces;
+		internal::decode(textures, &surfaces);
+
+		std::vector<AtlasEntry> entries;
+		const size_t page_amount = internal::pack(textures, surfaces, &entries);
+		std::vector<SDL_Surface*> page_surfaces = internal::compose(page_amount, entries, surfaces);
+
+		for (auto& s : surfaces) {
+			SDL_FreeSurface(s);
+		}
+
+		// Remove the extension from the layout filename so that it can be used as the page prefix
+		std::string prefix = fname;
+		const size_t dot = fname.find_last_of('.');
+		const size_t slash = fname.find_last_of("/\\");
+		if ((dot != std::string::npos)&&((slash == std::string::npos)||(dot > slash))) {
+			prefix = fname.substr(0, dot);
+		}
+
+		int r = 0;
+		std::string layout = "# BEE texture atlas layout\n";
+		for (size_t p=0; p<page_surfaces.size(); ++p) {
+			const std::string page_fname = prefix + "_" + bee_itos(p) + ".png";
+			if ((page_surfaces[p] == nullptr)||(IMG_SavePNG(page_surfaces[p], page_fname.c_str()))) {
+				messenger::send({"engine", "atlas"}, E_MESSAGE::WARNING, "Failed to write atlas page \"" + page_fname + "\": " + IMG_GetError());
+				r = 1;
+			}
+			SDL_FreeSurface(page_surfaces[p]);
+
+			layout += "!page\t" + file_basename(page_fname) + "\n";
+		}
+		for (auto& e : entries) {
+			if (e.rect.w == 0) {
+				continue;
+			}
+			layout += e.name + "\t" + bee_itos(e.page) + "\t" + bee_itos(e.rect.x) + "\t" + bee_itos(e.rect.y) + "\t" + bee_itos(e.rect.w) + "\t" + bee_itos(e.rect.h) + "\n";
+		}
+
+		if (file_put_contents(fname, layout) == 0) {
+			messenger::send({"engine", "atlas"}, E_MESSAGE::WARNING, "Failed to write atlas layout \"" + fname + "\"");
+			return 2; // Return 2 when the layout could not be written
+		}
+
+		if (r != 0) {
+			return 1; // Return 1 when a page could not be written
+		}
+
+		return 0; // Return 0 on success
+	}
+	/*
+	* load() - Load the atlas pages from a layout which was written by build() and load each of its textures from the pages
+	* ! The textures are found by name so they must already exist, and textures which aren't in the layout are unaffected
+	* @fname: the path of the layout file
+	*/
+	int load(const std::string& fname) {
+		if (get_options().is_headless) {
+			return 1; // Return 1 when in headless mode
+		}
+
+		if (!engine->renderer->is_atlas_enabled) {
+			messenger::send({"engine", "atlas"}, E_MESSAGE::WARNING, "Failed to load the texture atlas \"" + fname + "\" because the shaders don't support it");
+			return 2; // Return 2 when atlases are unsupported
+		}
+
+		if (!file_exists(fname)) {
+			messenger::send({"engine", "atlas"}, E_MESSAGE::WARNING, "Failed to load the texture atlas \"" + fname + "\": file does not exist");
+			return 3; // Return 3 when the layout doesn't exist
+		}
+
+		std::vector<size_t> page_ids;
+		std::vector<AtlasEntry> entries;
+
+		std::istringstream layout (file_get_contents(fname));
+		std::string line;
+		while (std::getline(layout, line)) {
+			line = trim(line);
+			if ((line.empty())||(line[0] == '#')) {
+				continue;
+			}
+
+			std::map<int,std::string> params = split(line, '\t');
+			if (params[0] == "!page") { // Load and upload each page as it is listed
+				if ((params.size() < 2)||(params[1].empty())) {
+					messenger::send({"engine", "atlas"}, E_MESSAGE::WARNING, "Invalid page in atlas layout \"" + fname + "\": " + line);
+					page_ids.push_back(static_cast<size_t>(-1)); // Keep the index of the following pages
+					continue;
+				}
+
+				const std::string page_fname = file_dirname(fname) + params[1];
+				SDL_Surface* surface = IMG_Load(page_fname.c_str());
+				if (surface == nullptr) {
+					messenger::send({"engine", "atlas"}, E_MESSAGE::WARNING, "Failed to load atlas page \"" + page_fname + "\": " + IMG_GetError());
+				}
+
+				page_ids.push_back((internal::upload(surface) == 0) ? internal::pages.size()-1 : static_cast<size_t>(-1));
+				SDL_FreeSurface(surface);
+				continue;
+			}
+
+			if (params.size() != 6) {
+				messenger::send({"engine", "atlas"}, E_MESSAGE::WARNING, "Invalid line in atlas layout \"" + fname + "\": " + line);
+				continue;
+			}
+
+			Texture* texture = Texture::get_by_name(params[0]);
+			if (texture == nullptr) {
+				messenger::send({"engine", "atlas"}, E_MESSAGE::WARNING, "Unknown texture in atlas layout \"" + fname + "\": " + params[0]);
+				continue;
+			}
+
+			size_t page;
+			SDL_Rect rect;
+			try {
+				page = std::stoul(params[1]);
+				rect = {std::stoi(params[2]), std::stoi(params[3]), std::stoi(params[4]), std::stoi(params[5])};
+			} catch (const std::logic_error&) { // Catch both std::invalid_argument and std::out_of_range
+				messenger::send({"engine", "atlas"}, E_MESSAGE::WARNING, "Invalid line in atlas layout \"" + fname + "\": " + line);
+				continue;
+			}
+
+			if (
+				(rect.x < 0)||(rect.y < 0)||(rect.w <= 0)||(rect.h <= 0)
+				||(rect.w > BEE_ATLAS_PAGE_SIZE - rect.x)||(rect.h > BEE_ATLAS_PAGE_SIZE - rect.y)
+			) {
+				messenger::send({"engine", "atlas"}, E_MESSAGE::WARNING, "Invalid rect in atlas layout \"" + fname + "\" for texture \"" + params[0] + "\"");
+				continue;
+			}
+
+			entries.emplace_back(texture, params[0], page, rect);
+		}
+
+		for (auto& e : entries) { // Check the page indices once every page has been listed
+			if (e.page >= page_ids.size()) {
+				messenger::send({"engine", "atlas"}, E_MESSAGE::WARNING, "Invalid page " + bee_itos(e.page) + " in atlas layout \"" + fname + "\" for texture \"" + e.name + "\"");
+			}
+		}
+
+		internal::assign(entries, page_ids);
+
+		return 0; // Return 0 on success
+	}
+	/*
+	* clear() - Unload every packed texture and free the atlas pages
+	*/
+	int clear() {
+		for (auto& id : internal::packed_ids) {
+			Texture* t = Texture::get(id);
+			if ((t != nullptr)&&(t->get_atlas_page() >= 0)) {
+				t->free();
+			}
+		}
+		internal::packed_ids.clear();
+
+		for (auto& p : internal::pages) {
+			glDeleteBuffers(1, &p.vbo_vertices);
+			glDeleteBuffers(1, &p.vbo_texcoords);
+			glDeleteBuffers(1, &p.ibo);
+			glDeleteTextures(1, &p.gl_texture);
+			glDeleteVertexArrays(1, &p.vao);
+		}
+		internal::pages.clear();
+
+		internal::queued.clear();
+
+		return 0;
+	}
+
+	size_t get_page_amount() {
+		return internal::pages.size();
+	}
+}}
+
+#endif // BEE_RENDER_ATLAS
@@ -0,0 +1,65 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef BEE_RENDER_ATLAS_H
+#define BEE_RENDER_ATLAS_H 1
+
+#include <string> // Include the required library headers
+#include <vector>
+
+#include <SDL2/SDL.h> // Include the required SDL headers
+
+#include <GL/glew.h> // Include the required OpenGL headers
+
+namespace bee {
+	// Forward declaration
+	class Texture;
+
+	struct AtlasPage { // The data struct which holds the OpenGL objects of a shared page that textures are packed into
+		int width, height; // The dimensions of the page
+		GLuint gl_texture; // The texture which contains every packed image
+		GLuint vao; // The Vertex Array Object of the unit quad which every packed texture is drawn with
+		GLuint vbo_vertices;
+		GLuint vbo_texcoords; // The texcoords of the whole page, each draw offsets them with its own texcoord rectangle
+		GLuint ibo;
+
+		// See bee/render/atlas.cpp for function comments
+		AtlasPage();
+	};
+	struct AtlasEntry { // The data struct which describes where a texture was packed
+		Texture* texture;
+		std::string name; // The name of the texture, which is used to find it when loading a prebuilt layout
+		size_t page; // The index of the page
+		SDL_Rect rect; // The rectangle of the texture in the page, which is empty when the texture wasn't packed
+
+		// See bee/render/atlas.cpp for function comments
+		AtlasEntry();
+		AtlasEntry(Texture*, const std::string&, size_t, SDL_Rect);
+	};
+namespace atlas {
+	namespace internal {
+		int decode(const std::vector<Texture*>&, std::vector<SDL_Surface*>*);
+		size_t pack(const std::vector<Texture*>&, const std::vector<SDL_Surface*>&, std::vector<AtlasEntry>*);
+		int extrude(SDL_Surface*, const SDL_Rect&);
+		std::vector<SDL_Surface*> compose(size_t, const std::vector<AtlasEntry>&, const std::vector<SDL_Surface*>&);
+		int upload(SDL_Surface*);
+		int assign(const std::vector<AtlasEntry>&, const std::vector<size_t>&);
+
+		const AtlasPage* get_page(size_t);
+	}
+
+	int add(Texture*);
+	int bake();
+	int build(const std::string&);
+	int load(const std::string&);
+	int clear();
+
+	size_t get_page_amount();
+}}
+
+#endif // BEE_RENDER_ATLAS_H
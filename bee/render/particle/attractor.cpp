@@ -9,6 +9,12 @@
 #ifndef BEE_RENDER_PARTICLE_ATTRACTOR
 #define BEE_RENDER_PARTICLE_ATTRACTOR 1
 
+#include <cmath> // Include the required library headers
+
+#ifdef __SSE2__ // Include the available vector extension headers
+	#include <emmintrin.h>
+#endif
+
 #include "attractor.hpp"
 
 #include "../../util/real.hpp"
@@ -66,30 +72,116 @@ namespace bee {
 		return default_y;
 	}
 
+	/*
+	* ParticleAttractor::handle() - Move every particle within the maximum distance towards the attractor
+	* ! This matches coord_approach() in bee/util/real.cpp, where particles which are closer than their force are moved directly to the attractor
+	* @pd: the particles to move
+	* @system_x: the x-coordinate of the particle system
+	* @system_y: the y-coordinate of the particle system
+	* @delta: the time in seconds since the last move
+	*/
 	int ParticleAttractor::handle(ParticleData* pd, double system_x, double system_y, double delta) {
 		int ax = static_cast<int>(get_following_x(system_x));
 		int ay = static_cast<int>(get_following_y(system_y));
 
-		double ds = dist_sqr(pd->x, pd->y, ax+x+w/2, ay+y+h/2);
-		if (ds < sqr(max_distance)) {
-			double f = 0.0;
+		const float cx = static_cast<float>(ax+x+w/2);
+		const float cy = static_cast<float>(ay+y+h/2);
+		const float md2 = static_cast<float>(sqr(max_distance));
+		const float fc = static_cast<float>(force);
+		const float dt = static_cast<float>(delta);
+
+		const size_t amount = pd->get_amount();
+		float* px = pd->x.data();
+		float* py = pd->y.data();
+		const float* dev = pd->deviation.data();
+
+		size_t i = 0;
+		#ifdef __SSE2__
+			const __m128 cx4 = _mm_set1_ps(cx);
+			const __m128 cy4 = _mm_set1_ps(cy);
+			const __m128 md24 = _mm_set1_ps(md2);
+			const __m128 fc4 = _mm_set1_ps(fc);
+			const __m128 dt4 = _mm_set1_ps(dt);
+			const __m128 zero = _mm_setzero_ps();
+			for (; i+4<=amount; i+=4) {
+				const __m128 x4 = _mm_loadu_ps(px+i);
+				const __m128 y4 = _mm_loadu_ps(py+i);
+				const __m128 dx = _mm_sub_ps(cx4, x4);
+				const __m128 dy = _mm_sub_ps(cy4, y4);
+				const __m128 ds = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+
+				const __m128 is_near = _mm_cmplt_ps(ds, md24);
+				if (_mm_movemask_ps(is_near) == 0) {
+					continue;
+				}
+
+				__m128 f = _mm_mul_ps(fc4, _mm_loadu_ps(dev+i));
+				const __m128 t = _mm_div_ps(_mm_sub_ps(md24, ds), md24);
+				switch (force_type) {
+					case E_PS_FORCE::CONSTANT: {
+						break;
+					}
+					case E_PS_FORCE::LINEAR:
+					default: {
+						f = _mm_mul_ps(f, t);
+						break;
+					}
+					case E_PS_FORCE::QUADRATIC: {
+						f = _mm_mul_ps(f, _mm_mul_ps(t, t));
+						break;
+					}
+				}
+
+				const __m128 d = _mm_sqrt_ps(ds);
+				const __m128 should_snap = _mm_or_ps(_mm_cmple_ps(d, f), _mm_cmpeq_ps(d, zero));
+				const __m128 r = _mm_mul_ps(_mm_div_ps(f, d), dt4);
+
+				// Select between the approached position, the attractor position, and the original position
+				__m128 nx = _mm_add_ps(x4, _mm_mul_ps(dx, r));
+				__m128 ny = _mm_add_ps(y4, _mm_mul_ps(dy, r));
+				nx = _mm_or_ps(_mm_and_ps(should_snap, cx4), _mm_andnot_ps(should_snap, nx));
+				ny = _mm_or_ps(_mm_and_ps(should_snap, cy4), _mm_andnot_ps(should_snap, ny));
+				nx = _mm_or_ps(_mm_and_ps(is_near, nx), _mm_andnot_ps(is_near, x4));
+				ny = _mm_or_ps(_mm_and_ps(is_near, ny), _mm_andnot_ps(is_near, y4));
+
+				_mm_storeu_ps(px+i, nx);
+				_mm_storeu_ps(py+i, ny);
+			}
+		#endif
+
+		for (; i<amount; ++i) {
+			const float dx = cx - px[i];
+			const float dy = cy - py[i];
+			const float ds = dx*dx + dy*dy;
+			if (ds >= md2) {
+				continue;
+			}
+
+			float f = fc * dev[i];
+			const float t = (md2 - ds) / md2;
 			switch (force_type) {
 				case E_PS_FORCE::CONSTANT: {
-					f = force * pd->get_deviation_percent();
 					break;
 				}
 				case E_PS_FORCE::LINEAR:
 				default: {
-					f = force * pd->get_deviation_percent() * (sqr(max_distance) - ds) / sqr(max_distance);
+					f *= t;
 					break;
 				}
 				case E_PS_FORCE::QUADRATIC: {
-					f = force * pd->get_deviation_percent() * sqr((sqr(max_distance) - ds) / sqr(max_distance));
+					f *= t*t;
 					break;
 				}
 			}
 
-			pd->set_position(coord_approach(pd->x, pd->y, ax+x+w/2, ay+y+h/2, f, delta));
+			const float d = std::sqrt(ds);
+			if ((d <= f)||(d == 0.0f)) {
+				px[i] = cx;
+				py[i] = cy;
+			} else {
+				px[i] += dx * f / d * dt;
+				py[i] += dy * f / d * dt;
+			}
 		}
 
 		return 0;
@@ -31,7 +31,9 @@ namespace bee {
 
 		shape(E_PS_SHAPE::RECTANGLE),
 
-		change_type(E_PS_CHANGE::ALL)
+		change_type(E_PS_CHANGE::ALL),
+
+		hits()
 	{}
 	ParticleChanger::ParticleChanger(double _x, double _y, unsigned int _w, unsigned int _h, Particle* _part_before, Particle* _part_after) :
 		ParticleChanger()
@@ -77,15 +79,23 @@ namespace bee {
 		return particle_after;
 	}
 
+	/*
+	* ParticleChanger::handle() - Change the type of every particle which intersects the changer
+	* @pd: the particles to check
+	* @system_x: the x-coordinate of the particle system
+	* @system_y: the y-coordinate of the particle system
+	*/
 	int ParticleChanger::handle(ParticleData* pd, double system_x, double system_y) {
 		double cx = get_following_x(system_x);
 		double cy = get_following_y(system_y);
 
-		SDL_Rect a = pd->get_rect();
 		SDL_Rect b = {static_cast<int>(cx+x), static_cast<int>(cy+y), static_cast<int>(w), static_cast<int>(h)};
-		if (check_collision(a, b)) {
-			if (pd->get_type() == get_part_before()) {
-				pd->set_type(get_part_after());
+		pd->check_collision(b, &hits);
+
+		const size_t amount = pd->get_amount();
+		for (size_t i=0; i<amount; ++i) {
+			if ((hits[i])&&(pd->types[i] == get_part_before())) {
+				pd->types[i] = get_part_after();
 			}
 		}
 
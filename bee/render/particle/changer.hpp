@@ -9,6 +9,10 @@
 #ifndef BEE_RENDER_PARTICLE_CHANGER_H
 #define BEE_RENDER_PARTICLE_CHANGER_H 1
 
+#include <vector> // Include the required library headers
+
+#include <SDL2/SDL.h> // Include the required SDL headers
+
 #include "../../enum.hpp"
 
 namespace bee {
@@ -30,6 +34,8 @@ namespace bee {
 
 			E_PS_CHANGE change_type;
 
+			std::vector<Uint32> hits; // The collision mask from the last handled particles
+
 			double get_following_x(double);
 			double get_following_y(double);
 		public:
@@ -9,6 +9,8 @@
 #ifndef BEE_RENDER_PARTICLE_DEFLECTOR
 #define BEE_RENDER_PARTICLE_DEFLECTOR 1
 
+#include <cmath> // Include the required library headers
+
 #include "deflector.hpp"
 
 #include "../../util/real.hpp"
@@ -28,7 +30,9 @@ namespace bee {
 		w(1),
 		h(1),
 
-		friction(1.0)
+		friction(1.0),
+
+		hits()
 	{}
 	ParticleDeflector::ParticleDeflector(double _x, double _y, unsigned int _w, unsigned int _h) :
 		ParticleDeflector()
@@ -61,15 +65,41 @@ namespace bee {
 		return default_y;
 	}
 
-	int ParticleDeflector::handle(ParticleData* pd, double old_px, double old_py, double system_x, double system_y) {
+	/*
+	* ParticleDeflector::handle() - Reverse the movement of every particle which intersects the deflector
+	* ! The particle's speed is scaled by the friction and it's sent back along the path that it moved since the previous positions
+	* @pd: the particles to check
+	* @old_x: the x-coordinates of the particles before they moved
+	* @old_y: the y-coordinates of the particles before they moved
+	* @system_x: the x-coordinate of the particle system
+	* @system_y: the y-coordinate of the particle system
+	*/
+	int ParticleDeflector::handle(ParticleData* pd, const std::vector<float>& old_x, const std::vector<float>& old_y, double system_x, double system_y) {
 		double dx = get_following_x(system_x);
 		double dy = get_following_y(system_y);
 
-		SDL_Rect a = pd->get_rect();
 		SDL_Rect b = {static_cast<int>(dx+x), static_cast<int>(dy+y), static_cast<int>(w), static_cast<int>(h)};
-		if (check_collision(a, b)) {
-			double dir = direction_of(old_px, old_py, pd->x, pd->y);
-			pd->set_velocity(pd->velocity.first * friction * -1, dir);
+		pd->check_collision(b, &hits);
+
+		const size_t amount = pd->get_amount();
+		const float f = static_cast<float>(friction);
+		for (size_t i=0; i<amount; ++i) {
+			if (!hits[i]) {
+				continue;
+			}
+
+			const float mx = pd->x[i] - old_x[i];
+			const float my = pd->y[i] - old_y[i];
+			const float len = std::sqrt(mx*mx + my*my);
+			if (len == 0.0f) {
+				pd->vx[i] *= -f;
+				pd->vy[i] *= -f;
+				continue;
+			}
+
+			const float speed = std::sqrt(pd->vx[i]*pd->vx[i] + pd->vy[i]*pd->vy[i]);
+			pd->vx[i] = -f * speed * mx / len;
+			pd->vy[i] = -f * speed * my / len;
 		}
 
 		return 0;
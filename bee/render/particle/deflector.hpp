@@ -9,6 +9,10 @@
 #ifndef BEE_RENDER_PARTICLE_DEFLECTOR_H
 #define BEE_RENDER_PARTICLE_DEFLECTOR_H 1
 
+#include <vector> // Include the required library headers
+
+#include <SDL2/SDL.h> // Include the required SDL headers
+
 #include "../../enum.hpp"
 
 namespace bee {
@@ -24,6 +28,8 @@ namespace bee {
 
 			double friction;
 
+			std::vector<Uint32> hits; // The collision mask from the last handled particles
+
 			double get_following_x(double);
 			double get_following_y(double);
 		public:
@@ -33,7 +39,7 @@ namespace bee {
 			int set_following(Instance*);
 			int set_friction(double);
 
-			int handle(ParticleData*, double, double, double, double);
+			int handle(ParticleData*, const std::vector<float>&, const std::vector<float>&, double, double);
 
 			int draw_debug(double, double, E_RGB);
 	};
@@ -28,7 +28,9 @@ namespace bee {
 		w(1),
 		h(1),
 
-		shape(E_PS_SHAPE::RECTANGLE)
+		shape(E_PS_SHAPE::RECTANGLE),
+
+		hits()
 	{}
 	ParticleDestroyer::ParticleDestroyer(double _x, double _y, unsigned int _w, unsigned int _h) :
 		ParticleDestroyer()
@@ -57,17 +59,26 @@ namespace bee {
 		return default_y;
 	}
 
-	bool ParticleDestroyer::handle(ParticleData* pd, double system_x, double system_y) {
+	/*
+	* ParticleDestroyer::handle() - Mark every particle which intersects the destroyer to be removed
+	* @pd: the particles to check
+	* @system_x: the x-coordinate of the particle system
+	* @system_y: the y-coordinate of the particle system
+	*/
+	int ParticleDestroyer::handle(ParticleData* pd, double system_x, double system_y) {
 		double dx = get_following_x(system_x);
 		double dy = get_following_y(system_y);
 
-		SDL_Rect a = pd->get_rect();
 		SDL_Rect b = {static_cast<int>(dx+x), static_cast<int>(dy+y), static_cast<int>(w), static_cast<int>(h)};
-		if (check_collision(a, b)) {
-			return true;
+		pd->check_collision(b, &hits);
+
+		const size_t amount = pd->get_amount();
+		Uint32* is_destroyed = pd->is_destroyed.data();
+		for (size_t i=0; i<amount; ++i) { // This loop is simple enough to be vectorized by the compiler
+			is_destroyed[i] |= hits[i];
 		}
 
-		return false;
+		return 0;
 	}
 
 	int ParticleDestroyer::draw_debug(double system_x, double system_y, E_RGB color) {
@@ -9,6 +9,10 @@
 #ifndef BEE_RENDER_PARTICLE_DESTROYER_H
 #define BEE_RENDER_PARTICLE_DESTROYER_H 1
 
+#include <vector> // Include the required library headers
+
+#include <SDL2/SDL.h> // Include the required SDL headers
+
 #include "../../enum.hpp"
 
 namespace bee {
@@ -24,6 +28,8 @@ namespace bee {
 
 			E_PS_SHAPE shape;
 
+			std::vector<Uint32> hits; // The collision mask from the last handled particles
+
 			double get_following_x(double);
 			double get_following_y(double);
 		public:
@@ -32,7 +38,7 @@ namespace bee {
 
 			int set_following(Instance*);
 
-			bool handle(ParticleData*, double, double);
+			int handle(ParticleData*, double, double);
 
 			int draw_debug(double, double, E_RGB);
 	};
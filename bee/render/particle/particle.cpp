@@ -12,7 +12,6 @@
 #include "../../defines.hpp"
 
 #include <sstream>
-#include <glm/gtc/matrix_transform.hpp>
 
 #include "particle.hpp"
 
@@ -41,7 +40,6 @@ namespace bee {
 
 		on_death_func(nullptr),
 		death_type(nullptr),
-		old_particles(),
 
 		scale(_scale),
 		velocity(),
@@ -49,8 +47,6 @@ namespace bee {
 		angle(0.0),
 		angle_increase(0.0),
 
-		rotation_cache(),
-
 		color({255, 255, 255, 255}),
 
 		max_time(_max_time),
@@ -140,25 +136,15 @@ namespace bee {
 		Particle(_shape, _scale, _max_time, 50)
 	{}
 	Particle::~Particle() {
-		remove_old_particles();
-
 		if (has_own_texture) {
 			delete texture;
 		}
 	}
 
 	int Particle::init() {
-		rotation_cache.reserve(360);
-		for (int a=0; a<360; a++) {
-			glm::mat4 r = glm::translate(glm::mat4(1.0f), glm::vec3(static_cast<float>(texture->get_subimage_width())/2.0f, static_cast<float>(texture->get_height())/2.0f, 0.0f));
-			r = glm::rotate(r, static_cast<float>(degtorad(a)), glm::vec3(0.0f, 0.0f, 1.0f));
-			r = glm::translate(r, glm::vec3(-static_cast<float>(texture->get_subimage_width())/2.0f, -static_cast<float>(texture->get_height())/2.0f, 0.0f));
-			rotation_cache.push_back(r);
-		}
-
-		on_death_func = [] (ParticleSystem* sys, ParticleData* pd, Particle* p) {
-			for (size_t i = 0; i < pd->get_type()->death_amount; i++) {
-				sys->add_particle(p, pd->x, pd->y);
+		on_death_func = [this] (ParticleSystem* sys, double x, double y, Particle* p) {
+			for (size_t i = 0; i < death_amount; i++) {
+				sys->add_particle(p, x, y);
 			}
 		};
 
@@ -200,35 +186,16 @@ namespace bee {
 		death_type = _death_type;
 		return 0;
 	}
-	int Particle::on_death(ParticleSystem* sys, ParticleData* pd) {
+	/*
+	* Particle::on_death() - Spawn the death particles at the position of a particle which is being removed
+	* @sys: the system which contains the particle
+	* @x: the x-coordinate of the particle
+	* @y: the y-coordinate of the particle
+	*/
+	int Particle::on_death(ParticleSystem* sys, double x, double y) {
 		if ((death_type != nullptr)&&(on_death_func != nullptr)) {
-			on_death_func(sys, pd, death_type);
-		}
-		add_old_particle(pd);
-		return 0;
-	}
-
-	int Particle::add_old_particle(ParticleData* pd) {
-		pd->make_old();
-		old_particles.push_back(pd);
-		return 0;
-	}
-	ParticleData* Particle::reuse_particle(double x, double y, Uint32 timestamp) {
-		if (old_particles.empty()) {
-			return (new ParticleData(this, x, y, timestamp));
-		}
-
-		ParticleData* pd = old_particles.back();
-		old_particles.pop_back();
-		pd->init(x, y, timestamp);
-
-		return pd;
-	}
-	int Particle::remove_old_particles() {
-		for (auto& pd : old_particles) {
-			delete pd;
+			on_death_func(sys, x, y, death_type);
 		}
-		old_particles.clear();
 		return 0;
 	}
 }
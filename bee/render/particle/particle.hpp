@@ -15,8 +15,6 @@
 #include <vector>
 #include <functional>
 
-#include <glm/glm.hpp> // Include the required OpenGL headers
-
 #include "../../enum.hpp"
 
 #include "../rgba.hpp"
@@ -35,11 +33,8 @@ namespace bee {
 
 			unsigned int deviation;
 
-			std::function<void (ParticleSystem*, ParticleData*, Particle*)> on_death_func;
+			std::function<void (ParticleSystem*, double, double, Particle*)> on_death_func;
 			Particle* death_type;
-			std::vector<ParticleData*> old_particles;
-
-			int add_old_particle(ParticleData*);
 		public:
 			double scale;
 			std::pair<double,double> velocity;
@@ -47,8 +42,6 @@ namespace bee {
 			double angle;
 			double angle_increase;
 
-			std::vector<glm::mat4> rotation_cache;
-
 			RGBA color;
 
 			Uint32 max_time;
@@ -71,10 +64,7 @@ namespace bee {
 			unsigned int get_deviation();
 
 			int set_death_type(Particle*);
-			int on_death(ParticleSystem*, ParticleData*);
-
-			ParticleData* reuse_particle(double, double, Uint32);
-			int remove_old_particles();
+			int on_death(ParticleSystem*, double, double);
 	};
 }
 
@@ -9,10 +9,23 @@
 #ifndef BEE_RENDER_PARTICLEDATA
 #define BEE_RENDER_PARTICLEDATA 1
 
+#include "../../defines.hpp"
+
+#include <cmath> // Include the required library headers
+
+#ifdef __SSE2__ // Include the available vector extension headers
+	#include <emmintrin.h>
+#endif
+#ifdef __AVX__
+	#include <immintrin.h>
+#endif
+
 #include "particledata.hpp"
 
 #include "particle.hpp"
 
+#include "../../engine.hpp"
+
 #include "../../util/real.hpp"
 
 #include "../drawing.hpp"
@@ -20,100 +33,196 @@
 #include "../../resource/texture.hpp"
 
 namespace bee {
-	ParticleData::ParticleData(Particle* _particle_type, double _x, double _y, Uint32 now) :
-		particle_type(_particle_type),
+	/*
+	* ParticleData::ParticleData() - Construct the empty storage
+	*/
+	ParticleData::ParticleData() :
+		types(),
+		x(),
+		y(),
+		vx(),
+		vy(),
+		w(),
+		h(),
+		deviation(),
+		creation(),
+		is_destroyed()
+	{}
 
-		w(1),
-		h(1),
-
-		depth(0),
-
-		creation_time(now),
-		is_old(true),
+	/*
+	* ParticleData::get_amount() - Return the amount of particles
+	*/
+	size_t ParticleData::get_amount() const {
+		return types.size();
+	}
+	/*
+	* ParticleData::add() - Add a particle of the given type with a random deviation
+	* @type: the type of the particle
+	* @_x: the x-coordinate of the particle
+	* @_y: the y-coordinate of the particle
+	* @now: the creation timestamp of the particle
+	*/
+	size_t ParticleData::add(Particle* type, double _x, double _y, Uint32 now) {
+		double dev = 1.0;
+		unsigned int d = type->get_deviation();
+		if (d > 0) {
+			dev = static_cast<double>(random(d) + d/2) / d;
+		}
 
-		deviation(particle_type->get_deviation()),
+		const double s = type->scale * dev;
+		const double m = type->velocity.first * dev;
+		const double dir = degtorad(type->velocity.second);
 
-		x(_x),
-		y(_y),
+		types.push_back(type);
+		x.push_back(static_cast<float>(_x));
+		y.push_back(static_cast<float>(_y));
+		vx.push_back(static_cast<float>(cos(dir) * m));
+		vy.push_back(static_cast<float>(-sin(dir) * m));
+		w.push_back(static_cast<float>(static_cast<int>(type->get_texture()->get_subimage_width() * s)));
+		h.push_back(static_cast<float>(static_cast<int>(type->get_texture()->get_height() * s)));
+		deviation.push_back(static_cast<float>(dev));
+		creation.push_back(now);
+		is_destroyed.push_back(0);
 
-		velocity()
-	{
-		init(x, y, now);
+		return types.size()-1;
 	}
+	/*
+	* ParticleData::remove() - Remove the given particle by moving the last particle into its place
+	* ! This changes the order of the particles but avoids moving every particle after it
+	* @i: the index of the particle to remove
+	*/
+	int ParticleData::remove(size_t i) {
+		if (i >= types.size()) {
+			return 1; // Return 1 when the index is out of range
+		}
 
-	int ParticleData::init(double _x, double _y, Uint32 now) {
-		x = _x;
-		y = _y;
-
-		unsigned int d = particle_type->get_deviation();
-		deviation = random(d) + d/2;
-		double s = particle_type->scale * get_deviation_percent();
-
-		w = static_cast<int>(particle_type->get_texture()->get_subimage_width() * s);
-		h = static_cast<int>(particle_type->get_texture()->get_height() * s);
+		const size_t last = types.size()-1;
+		if (i != last) {
+			types[i] = types[last];
+			x[i] = x[last];
+			y[i] = y[last];
+			vx[i] = vx[last];
+			vy[i] = vy[last];
+			w[i] = w[last];
+			h[i] = h[last];
+			deviation[i] = deviation[last];
+			creation[i] = creation[last];
+			is_destroyed[i] = is_destroyed[last];
+		}
 
-		velocity = particle_type->velocity;
-		creation_time = now;
-		is_old = false;
+		types.pop_back();
+		x.pop_back();
+		y.pop_back();
+		vx.pop_back();
+		vy.pop_back();
+		w.pop_back();
+		h.pop_back();
+		deviation.pop_back();
+		creation.pop_back();
+		is_destroyed.pop_back();
 
 		return 0;
 	}
-	int ParticleData::make_old() {
-		is_old = true;
-		return 0;
-	}
-	bool ParticleData::operator< (const ParticleData& other) {
-		if (depth == other.depth) {
-			return (creation_time <= other.creation_time);
-		}
-		return (depth > other.depth);
-	}
+	/*
+	* ParticleData::compact() - Remove every destroyed particle while keeping the order of the remaining particles
+	* ! Every particle after the first destroyed one is moved, so this should only be used when the order matters
+	*/
+	int ParticleData::compact() {
+		size_t j = 0;
+		for (size_t i=0; i<types.size(); ++i) {
+			if (is_destroyed[i]) {
+				continue;
+			}
 
-	int ParticleData::set_type(Particle* _type) {
-		particle_type = _type;
-		return 0;
-	}
-	int ParticleData::move(double delta) {
-		double m = velocity.first * (get_deviation_percent());
-		double dir = velocity.second;
+			if (i != j) {
+				types[j] = types[i];
+				x[j] = x[i];
+				y[j] = y[i];
+				vx[j] = vx[i];
+				vy[j] = vy[i];
+				w[j] = w[i];
+				h[j] = h[i];
+				deviation[j] = deviation[i];
+				creation[j] = creation[i];
+				is_destroyed[j] = 0;
+			}
+			++j;
+		}
 
-		x += cos(degtorad(dir)) * m * delta;
-		y += -sin(degtorad(dir)) * m * delta;
+		types.resize(j);
+		x.resize(j);
+		y.resize(j);
+		vx.resize(j);
+		vy.resize(j);
+		w.resize(j);
+		h.resize(j);
+		deviation.resize(j);
+		creation.resize(j);
+		is_destroyed.resize(j);
 
 		return 0;
 	}
-	int ParticleData::set_position(std::pair<double,double> pos) {
-		x = pos.first;
-		y = pos.second;
+	/*
+	* ParticleData::clear() - Remove every particle
+	*/
+	int ParticleData::clear() {
+		types.clear();
+		x.clear();
+		y.clear();
+		vx.clear();
+		vy.clear();
+		w.clear();
+		h.clear();
+		deviation.clear();
+		creation.clear();
+		is_destroyed.clear();
 		return 0;
 	}
-	int ParticleData::set_velocity(double magnitude, double direction) {
-		velocity.first = magnitude;
-		velocity.second = direction;
+	/*
+	* ParticleData::reserve() - Reserve space in every array for the given amount of particles
+	* @amount: the amount of particles to reserve
+	*/
+	int ParticleData::reserve(size_t amount) {
+		types.reserve(amount);
+		x.reserve(amount);
+		y.reserve(amount);
+		vx.reserve(amount);
+		vy.reserve(amount);
+		w.reserve(amount);
+		h.reserve(amount);
+		deviation.reserve(amount);
+		creation.reserve(amount);
+		is_destroyed.reserve(amount);
 		return 0;
 	}
 
-	Particle* ParticleData::get_type() {
-		return particle_type;
-	}
-	SDL_Rect ParticleData::get_rect() {
-		return {static_cast<int>(x), static_cast<int>(y), static_cast<int>(w), static_cast<int>(h)};
+	/*
+	* ParticleData::get_rect() - Return the bounding box of the given particle
+	* @i: the index of the particle
+	*/
+	SDL_Rect ParticleData::get_rect(size_t i) const {
+		return {static_cast<int>(x[i]), static_cast<int>(y[i]), static_cast<int>(w[i]), static_cast<int>(h[i])};
 	}
-	double ParticleData::get_w() {
-		return w;
+	/*
+	* ParticleData::get_angle() - Return the angle of the given particle after it has existed for the given time
+	* @i: the index of the particle
+	* @ticks: the age of the particle in milliseconds
+	*/
+	double ParticleData::get_angle(size_t i, Uint32 ticks) const {
+		return types[i]->angle + types[i]->angle_increase * ticks * deviation[i] * ((deviation[i] >= 0.5) ? 1 : -1);
 	}
-	double ParticleData::get_h() {
-		return h;
-	}
-	double ParticleData::get_angle(Uint32 ticks) {
-		return particle_type->angle + particle_type->angle_increase * ticks * get_deviation_percent() * ((get_deviation_percent() >= 0.5) ? 1 : -1);
-	}
-	Uint8 ParticleData::get_alpha(Uint32 ticks) {
-		Uint8 max_alpha = particle_type->color.a;
-		Uint32 max_time = static_cast<Uint32>(particle_type->max_time * get_deviation_percent());
+	/*
+	* ParticleData::get_alpha() - Return the alpha of the given particle after it has existed for the given time
+	* ! The alpha decreases linearly for the last 500ms of the particle's life
+	* @i: the index of the particle
+	* @ticks: the age of the particle in milliseconds
+	*/
+	Uint8 ParticleData::get_alpha(size_t i, Uint32 ticks) const {
+		Uint8 max_alpha = types[i]->color.a;
+		Uint32 max_time = static_cast<Uint32>(types[i]->max_time * deviation[i]);
 
 		double p = 1.0 - 500.0 / max_time;
-		if (ticks > max_time * p) { // Use a linear relationship to gradually decrease the alpha for the last 500ms of the particle's life
+		if (ticks > max_time * p) {
 			return static_cast<Uint8>(
 				max_alpha * (max_time - ticks) / (max_time * (1.0-p))
 			);
@@ -121,41 +230,205 @@ namespace bee {
 
 		return max_alpha;
 	}
-	Uint32 ParticleData::get_creation() {
-		return creation_time;
+	/*
+	* ParticleData::get_subimage() - Return the subimage of the given particle after it has existed for the given time
+	* @i: the index of the particle
+	* @ticks: the age of the particle in milliseconds
+	*/
+	unsigned int ParticleData::get_subimage(size_t i, Uint32 ticks) const {
+		Texture* texture = types[i]->get_texture();
+		if (texture->get_subimage_amount() <= 1) {
+			return 0;
+		}
+		return static_cast<unsigned int>(round(texture->get_speed()*ticks/get_fps_goal())) % texture->get_subimage_amount();
 	}
-	bool ParticleData::is_dead(Uint32 ticks) {
+	/*
+	* ParticleData::get_is_expired() - Return whether the given particle has finished its life after it has existed for the given time
+	* @i: the index of the particle
+	* @ticks: the age of the particle in milliseconds
+	*/
+	bool ParticleData::get_is_expired(size_t i, Uint32 ticks) const {
+		Particle* type = types[i];
 		if (
-			(!particle_type->should_reanimate) // If the particle should not reanimate
-			&&(particle_type->get_texture()->get_subimage_amount() > 1) // If the particle has multiple subimages, i.e. it has an animation
-			&&(!particle_type->get_texture()->get_is_animated()) // If the particle finished animating
+			(!type->should_reanimate) // If the particle should not reanimate
+			&&(type->get_texture()->get_subimage_amount() > 1) // If the particle has multiple subimages, i.e. it has an animation
+			&&(round(type->get_texture()->get_speed()*ticks/get_fps_goal()) >= type->get_texture()->get_subimage_amount()-1) // If the particle has drawn its last subimage
 		) {
 			return true; // Return true when finished animating
 		}
 
-		if (ticks > particle_type->max_time * get_deviation_percent()) {
+		if (ticks > type->max_time * deviation[i]) {
 			return true; // Return true when the particle has expired
 		}
 
 		return false; // Otherwise return false
 	}
-	bool ParticleData::get_is_old() {
-		return is_old;
+	/*
+	* ParticleData::set_velocity() - Set the velocity of the given particle
+	* @i: the index of the particle
+	* @magnitude: the speed of the particle, which should already include its deviation
+	* @direction: the direction of the particle in degrees
+	*/
+	int ParticleData::set_velocity(size_t i, double magnitude, double direction) {
+		vx[i] = static_cast<float>(cos(degtorad(direction)) * magnitude);
+		vy[i] = static_cast<float>(-sin(degtorad(direction)) * magnitude);
+		return 0;
+	}
+
+	/*
+	* ParticleData::move() - Move every particle by its velocity
+	* @delta: the time in seconds since the last move
+	*/
+	int ParticleData::move(double delta) {
+		const size_t amount = get_amount();
+		const float d = static_cast<float>(delta);
+		size_t i = 0;
+
+		#if defined(__AVX__)
+			const __m256 d8 = _mm256_set1_ps(d);
+			for (; i+8<=amount; i+=8) {
+				_mm256_storeu_ps(&x[i], _mm256_add_ps(_mm256_loadu_ps(&x[i]), _mm256_mul_ps(_mm256_loadu_ps(&vx[i]), d8)));
+				_mm256_storeu_ps(&y[i], _mm256_add_ps(_mm256_loadu_ps(&y[i]), _mm256_mul_ps(_mm256_loadu_ps(&vy[i]), d8)));
+			}
+		#elif defined(__SSE2__)
+			const __m128 d4 = _mm_set1_ps(d);
+			for (; i+4<=amount; i+=4) {
+				_mm_storeu_ps(&x[i], _mm_add_ps(_mm_loadu_ps(&x[i]), _mm_mul_ps(_mm_loadu_ps(&vx[i]), d4)));
+				_mm_storeu_ps(&y[i], _mm_add_ps(_mm_loadu_ps(&y[i]), _mm_mul_ps(_mm_loadu_ps(&vy[i]), d4)));
+			}
+		#endif
+
+		for (; i<amount; ++i) {
+			x[i] += vx[i] * d;
+			y[i] += vy[i] * d;
+		}
+
+		return 0;
 	}
-	unsigned int ParticleData::get_deviation() {
-		return deviation;
+	/*
+	* ParticleData::check_collision() - Fill the given mask with whether each particle's bounding box intersects the given rectangle
+	* ! This matches check_collision() in bee/util/collision.cpp, including the rectangle edges
+	* @b: the rectangle to check against
+	* @mask: the vector to fill with 0xffffffff for every intersecting particle and 0 for the rest
+	*/
+	int ParticleData::check_collision(const SDL_Rect& b, std::vector<Uint32>* mask) const {
+		const size_t amount = get_amount();
+		mask->resize(amount);
+
+		const int b_left = b.x;
+		const int b_right = b.x + b.w;
+		const int b_top = b.y;
+		const int b_bottom = b.y + b.h;
+
+		size_t i = 0;
+		#ifdef __SSE2__
+			const __m128i bl = _mm_set1_epi32(b_left);
+			const __m128i br = _mm_set1_epi32(b_right);
+			const __m128i bt = _mm_set1_epi32(b_top);
+			const __m128i bb = _mm_set1_epi32(b_bottom);
+			for (; i+4<=amount; i+=4) {
+				const __m128i left = _mm_cvttps_epi32(_mm_loadu_ps(&x[i]));
+				const __m128i top = _mm_cvttps_epi32(_mm_loadu_ps(&y[i]));
+				const __m128i right = _mm_add_epi32(left, _mm_cvttps_epi32(_mm_loadu_ps(&w[i])));
+				const __m128i bottom = _mm_add_epi32(top, _mm_cvttps_epi32(_mm_loadu_ps(&h[i])));
+
+				__m128i miss = _mm_cmplt_epi32(bottom, bt);
+				miss = _mm_or_si128(miss, _mm_cmpgt_epi32(top, bb));
+				miss = _mm_or_si128(miss, _mm_cmplt_epi32(right, bl));
+				miss = _mm_or_si128(miss, _mm_cmpgt_epi32(left, br));
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(&(*mask)[i]), _mm_andnot_si128(miss, _mm_set1_epi32(-1)));
+			}
+		#endif
+
+		for (; i<amount; ++i) {
+			const int left = static_cast<int>(x[i]);
+			const int top = static_cast<int>(y[i]);
+			const int right = left + static_cast<int>(w[i]);
+			const int bottom = top + static_cast<int>(h[i]);
+
+			const bool is_miss = ((bottom < b_top)||(top > b_bottom)||(right < b_left)||(left > b_right));
+			(*mask)[i] = (is_miss) ? 0 : 0xffffffff;
+		}
+
+		return 0;
 	}
-	double ParticleData::get_deviation_percent() {
-		return static_cast<double>(deviation) / particle_type->get_deviation();
+
+	/*
+	* ParticleData::write_instances() - Write the instance data of the given particles for render::map_particles()
+	* ! Every given particle must have the same type
+	* @indices: the indices of the particles to write
+	* @now: the current timestamp
+	* @data: the mapped buffer to write to
+	*/
+	int ParticleData::write_instances(const std::vector<size_t>& indices, Uint32 now, float* data) const {
+		if (indices.empty()) {
+			return 1; // Return 1 when there are no particles to write
+		}
+
+		Particle* type = types[indices.front()];
+		Texture* texture = type->get_texture();
+
+		int rect_width = texture->get_width();
+		if (texture->get_subimage_amount() > 1) {
+			rect_width = texture->get_subimage_width();
+		}
+		const int rect_height = texture->get_height();
+
+		for (auto& i : indices) {
+			Uint32 ticks = now - creation[i];
+			if (now < creation[i]) {
+				ticks = 0;
+			}
+
+			// Match the scaling in Texture::draw_subimage(), where unscaled dimensions draw at the full size
+			int pw = static_cast<int>(w[i]);
+			int ph = static_cast<int>(h[i]);
+			if (pw <= 0) {
+				pw = rect_width;
+			}
+			if (ph <= 0) {
+				ph = rect_height;
+			}
+
+			data[0] = static_cast<float>(static_cast<int>(x[i]) - static_cast<int>(w[i])/2);
+			data[1] = static_cast<float>(static_cast<int>(y[i]) - static_cast<int>(h[i])/2);
+			data[2] = static_cast<float>(pw) / rect_width;
+			data[3] = static_cast<float>(ph) / rect_height;
+			data[4] = static_cast<float>(degtorad(absolute_angle(get_angle(i, ticks))));
+			data[5] = static_cast<float>(get_subimage(i, ticks));
+			data[6] = type->color.r / 255.0f;
+			data[7] = type->color.g / 255.0f;
+			data[8] = type->color.b / 255.0f;
+			data[9] = get_alpha(i, ticks) / 255.0f;
+
+			data += BEE_PARTICLE_INSTANCE_SIZE;
+		}
+
+		return 0;
 	}
+	/*
+	* ParticleData::draw() - Draw the given particle centered on its position
+	* @i: the index of the particle
+	* @ticks: the age of the particle in milliseconds
+	*/
+	int ParticleData::draw(size_t i, Uint32 ticks) {
+		RGBA c (types[i]->color);
+		c.a = get_alpha(i, ticks);
 
-	int ParticleData::draw(double system_x, double system_y, Uint32 ticks) {
-		RGBA c (particle_type->color);
-		c.a = get_alpha(ticks);
-		return particle_type->get_texture()->draw(static_cast<int>(system_x+x) - w/2, static_cast<int>(system_y+y) - h/2, creation_time, w, h, absolute_angle(get_angle(ticks)), c);
+		const int pw = static_cast<int>(w[i]);
+		const int ph = static_cast<int>(h[i]);
+		return types[i]->get_texture()->draw(static_cast<int>(x[i]) - pw/2, static_cast<int>(y[i]) - ph/2, creation[i], pw, ph, absolute_angle(get_angle(i, ticks)), c);
 	}
-	int ParticleData::draw_debug(double system_x, double system_y, E_RGB color) {
-		return draw_rectangle(static_cast<int>(system_x+x) - w/2, static_cast<int>(system_y+y) - h/2, w, h, 1, RGBA(color));
+	/*
+	* ParticleData::draw_debug() - Draw the bounding box of the given particle
+	* @i: the index of the particle
+	* @color: the color to draw the box with
+	*/
+	int ParticleData::draw_debug(size_t i, E_RGB color) {
+		const int pw = static_cast<int>(w[i]);
+		const int ph = static_cast<int>(h[i]);
+		return draw_rectangle(static_cast<int>(x[i]) - pw/2, static_cast<int>(y[i]) - ph/2, pw, ph, 1, RGBA(color));
 	}
 }
 
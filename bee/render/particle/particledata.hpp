@@ -9,8 +9,7 @@
 #ifndef BEE_RENDER_PARTICLEDATA_H
 #define BEE_RENDER_PARTICLEDATA_H 1
 
-#include <utility> // Include the required library header for std::pair
-#include <list>
+#include <vector> // Include the required library headers
 
 #include <SDL2/SDL.h> // Include the required SDL headers
 
@@ -20,47 +19,39 @@ namespace bee {
 	// Forward declarations
 	class Particle;
 
-	class ParticleData {
-			Particle* particle_type;
-
-			unsigned int w, h;
-
-			int depth;
-
-			Uint32 creation_time;
-			bool is_old;
-
-			unsigned int deviation;
+	class ParticleData { // The structure-of-arrays storage for every particle in a system, which lets the particle modifiers run over contiguous arrays
 		public:
-			double x, y;
+			std::vector<Particle*> types; // The type of each particle
+			std::vector<float> x, y; // The position of each particle
+			std::vector<float> vx, vy; // The velocity of each particle in pixels per second, which already includes its deviation
+			std::vector<float> w, h; // The dimensions of each particle
+			std::vector<float> deviation; // The deviation percent of each particle, which scales its size, speed, and lifetime
+			std::vector<Uint32> creation; // The creation timestamp of each particle
+			std::vector<Uint32> is_destroyed; // Whether each particle should be removed, stored as a bitmask for the vectorized functions
+
+			// See bee/render/particle/particledata.cpp for function comments
+			ParticleData();
+
+			size_t get_amount() const;
+			size_t add(Particle*, double, double, Uint32);
+			int remove(size_t);
+			int compact();
+			int clear();
+			int reserve(size_t);
+
+			SDL_Rect get_rect(size_t) const;
+			double get_angle(size_t, Uint32) const;
+			Uint8 get_alpha(size_t, Uint32) const;
+			unsigned int get_subimage(size_t, Uint32) const;
+			bool get_is_expired(size_t, Uint32) const;
+			int set_velocity(size_t, double, double);
 
-			std::pair<double,double> velocity;
-
-			ParticleData(Particle*, double, double, Uint32);
-
-			int init(double, double, Uint32);
-			int make_old();
-			bool operator< (const ParticleData&);
-
-			int set_type(Particle*);
 			int move(double);
-			int set_position(std::pair<double,double>);
-			int set_velocity(double, double);
-
-			Particle* get_type();
-			SDL_Rect get_rect();
-			double get_w();
-			double get_h();
-			double get_angle(Uint32);
-			Uint8 get_alpha(Uint32);
-			Uint32 get_creation();
-			bool is_dead(Uint32);
-			bool get_is_old();
-			unsigned int get_deviation();
-			double get_deviation_percent();
+			int check_collision(const SDL_Rect&, std::vector<Uint32>*) const;
 
-			int draw(double, double, Uint32);
-			int draw_debug(double, double, E_RGB);
+			int write_instances(const std::vector<size_t>&, Uint32, float*) const;
+			int draw(size_t, Uint32);
+			int draw_debug(size_t, E_RGB);
 	};
 }
 
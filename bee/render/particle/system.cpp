@@ -10,6 +10,7 @@
 #define BEE_RENDER_PARTICLE_SYSTEM 1
 
 #include <algorithm>
+#include <tuple>
 
 #include "system.hpp"
 
@@ -38,6 +39,11 @@ namespace bee {
 
 		particle_types(),
 		particles(),
+		previous_x(),
+		previous_y(),
+		draw_type_ids(),
+		draw_types(),
+		draw_indices(),
 		emitters(),
 		attractors(),
 		destroyers(),
@@ -130,29 +136,60 @@ namespace bee {
 			draw(t+time_offset, 1.0/step, false);
 		}
 
-		particles.erase(
-			std::remove_if(
-				particles.begin(),
-				particles.end(),
-				[this, &t] (ParticleData* p) -> bool {
-					if (p->get_is_old()){
-						return true;
-					}
+		const Uint32 now = t+time_offset;
+		for (size_t i=0; i<particles.get_amount(); ++i) {
+			Uint32 ticks = now - particles.creation[i];
+			if (now < particles.creation[i]) {
+				ticks = 0;
+			}
 
-					Uint32 ticks = t+time_offset - p->get_creation();
-					if (t+time_offset < p->get_creation()) {
-						ticks = 0;
-					}
+			if (particles.get_is_expired(i, ticks)) {
+				particles.is_destroyed[i] = 0xffffffff;
+			}
+		}
+		remove_destroyed();
 
-					if (p->is_dead(ticks)) {
-						p->get_type()->on_death(this, p);
-						return true;
-					}
-					return false;
+		return 0;
+	}
+	/*
+	* ParticleSystem::remove_destroyed() - Remove every particle which has been marked as destroyed and spawn its death particles
+	* ! When is_oldfirst is set, the remaining particles keep their order, otherwise they are swap-removed
+	* ! The death particles are appended after the remaining particles
+	*/
+	int ParticleSystem::remove_destroyed() {
+		if (is_oldfirst) {
+			thread_local std::vector<std::tuple<Particle*,double,double>> deaths; // The type and position of each destroyed particle
+			deaths.clear();
+			for (size_t i=0; i<particles.get_amount(); ++i) {
+				if (particles.is_destroyed[i]) {
+					deaths.emplace_back(particles.types[i], particles.x[i], particles.y[i]);
 				}
-			),
-			particles.end()
-		);
+			}
+			if (deaths.empty()) {
+				return 0;
+			}
+
+			particles.compact();
+			for (auto& d : deaths) {
+				std::get<0>(d)->on_death(this, std::get<1>(d), std::get<2>(d));
+			}
+
+			return 0;
+		}
+
+		for (size_t i=0; i<particles.get_amount(); ) {
+			if (!particles.is_destroyed[i]) {
+				++i;
+				continue;
+			}
+
+			Particle* type = particles.types[i];
+			const double px = particles.x[i];
+			const double py = particles.y[i];
+
+			particles.remove(i);
+			type->on_death(this, px, py);
+		}
 
 		return 0;
 	}
@@ -163,41 +200,29 @@ namespace bee {
 			system_y += following->get_y();
 		}
 
-		for (auto it=particles.begin(); it!=particles.end(); ) {
-			ParticleData* pd = *it;
-
-			if (pd->get_is_old()){
-				it = particles.erase(it);
-				continue;
-			}
-
-			for (auto& d : destroyers) {
-				if (d->handle(pd, system_x, system_y)) {
-					pd->get_type()->on_death(this, pd);
-					break;
-				}
-			}
-			if (pd->get_is_old()) {
-				it = particles.erase(it);
-				continue;
-			}
+		// Run each modifier over every particle at once
+		for (auto& d : destroyers) {
+			d->handle(&particles, system_x, system_y);
+		}
+		remove_destroyed();
 
-			for (auto& c : changers) {
-				c->handle(pd, system_x, system_y);
-			}
+		for (auto& c : changers) {
+			c->handle(&particles, system_x, system_y);
+		}
 
-			double old_px = pd->x, old_py = pd->y;
-			pd->move(delta);
+		if (!deflectors.empty()) {
+			previous_x = particles.x;
+			previous_y = particles.y;
+		}
 
-			for (auto& a : attractors) {
-				a->handle(pd, system_x, system_y, delta);
-			}
+		particles.move(delta);
 
-			for (auto& d : deflectors) {
-				d->handle(pd, old_px, old_py, system_x, system_y);
-			}
+		for (auto& a : attractors) {
+			a->handle(&particles, system_x, system_y, delta);
+		}
 
-			++it;
+		for (auto& d : deflectors) {
+			d->handle(&particles, previous_x, previous_y, system_x, system_y);
 		}
 
 		for (auto& e : emitters) {
@@ -205,42 +230,60 @@ namespace bee {
 		}
 
 		if (should_draw) {
-			particles.erase(
-				std::remove_if(
-					particles.begin(),
-					particles.end(),
-					[this, &now] (ParticleData* p) -> bool {
-						if (p->get_is_old()) {
-							return true;
-						}
+			// Group the particles by type so that each type can be drawn with a single instanced call
+			for (auto& t : draw_indices) {
+				t.clear();
+			}
+			for (size_t i=0; i<particles.get_amount(); ++i) {
+				auto it = draw_type_ids.find(particles.types[i]);
+				if (it == draw_type_ids.end()) { // Draw new types after the existing ones so that the order doesn't depend on their addresses
+					it = draw_type_ids.emplace(particles.types[i], draw_types.size()).first;
+					draw_types.push_back(particles.types[i]);
+					draw_indices.emplace_back();
+				}
+				draw_indices[it->second].push_back(i);
+			}
 
-						Uint32 ticks = now - p->get_creation();
-						if (now < p->get_creation()) {
-							ticks = 0;
-						}
+			render::render_textures(); // Flush the queued textures so that they are drawn before the particles
 
-						int x = static_cast<int>(
-							xoffset + p->x - p->get_w()/2
-						);
-						int y = static_cast<int>(
-							yoffset + p->y - p->get_h()/2
-						);
-						if (following != nullptr) {
-							x += static_cast<int>(following->get_x());
-							y += static_cast<int>(following->get_y());
-						}
+			for (size_t t=0; t<draw_types.size(); ++t) {
+				const std::vector<size_t>& indices = draw_indices[t];
+				if (indices.empty()) {
+					continue;
+				}
 
-						p->draw(x, y, ticks);
+				Texture* texture = draw_types[t]->get_texture();
+				GLfloat* data = nullptr;
+				if (texture->get_is_loaded()) {
+					data = render::map_particles(indices.size());
+				}
 
-						if (p->is_dead(ticks)) {
-							p->get_type()->on_death(this, p);
-							return true;
+				if (data != nullptr) {
+					particles.write_instances(indices, now, data);
+					texture->draw_instanced(indices.size());
+				} else { // Fall back to queueing each particle when instancing is unavailable
+					for (auto& i : indices) {
+						Uint32 ticks = now - particles.creation[i];
+						if (now < particles.creation[i]) {
+							ticks = 0;
 						}
-						return false;
+						particles.draw(i, ticks);
 					}
-				),
-				particles.end()
-			);
+				}
+			}
+
+			for (size_t i=0; i<particles.get_amount(); ++i) {
+				Uint32 ticks = now - particles.creation[i];
+				if (now < particles.creation[i]) {
+					ticks = 0;
+				}
+
+				if (particles.get_is_expired(i, ticks)) {
+					particles.is_destroyed[i] = 0xffffffff;
+				}
+			}
+			remove_destroyed();
+
 			render::render_textures();
 		}
 
@@ -256,8 +299,8 @@ namespace bee {
 			system_y += following->get_y();
 		}
 
-		for (auto& p : particles) {
-			p->draw_debug(system_x, system_y, E_RGB::AQUA);
+		for (size_t i=0; i<particles.get_amount(); ++i) {
+			particles.draw_debug(i, E_RGB::AQUA);
 		}
 		for (auto& e : emitters) {
 			e->draw_debug(system_x, system_y, E_RGB::GREEN);
@@ -278,24 +321,23 @@ namespace bee {
 		return 0;
 	}
 	int ParticleSystem::clear() {
-		for (auto& pt : particle_types) {
-			pt->remove_old_particles();
-		}
-
-		for (auto& p : particles) {
-			delete p;
-		}
-
 		particles.clear();
+		previous_x.clear();
+		previous_y.clear();
+		draw_type_ids.clear();
+		draw_types.clear();
+		draw_indices.clear();
 
 		return 0;
 	}
 
 	int ParticleSystem::add_particle(Particle* p, double x, double y) {
-		ParticleData* pd = p->reuse_particle(x, y, get_ticks()+time_offset);
-		particles.push_back(pd);
+		particles.add(p, x, y, get_ticks()+time_offset);
 		return 0;
 	}
+	size_t ParticleSystem::get_particle_amount() const {
+		return particles.get_amount();
+	}
 }
 
 #endif // BEE_RENDER_PARTICLE_SYSTEM
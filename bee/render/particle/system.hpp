@@ -15,13 +15,14 @@
 
 #include <SDL2/SDL.h> // Include the required SDL headers
 
+#include "particledata.hpp"
+
 namespace bee {
 	// Forward declarations
 	class Instance;
 	struct TextureDrawData;
 
 	class Particle;
-	class ParticleData;
 	class ParticleEmitter;
 	class ParticleAttractor;
 	class ParticleDestroyer;
@@ -32,14 +33,20 @@ namespace bee {
 			Instance* following;
 
 			std::vector<Particle*> particle_types;
-			std::vector<ParticleData*> particles;
+			ParticleData particles; // The structure-of-arrays storage for every particle in the system
+			std::vector<float> previous_x, previous_y; // The particle positions before the last move, which are used by the deflectors
+			std::map<Particle*,size_t> draw_type_ids; // The draw order of each particle type, which is assigned when the type is first drawn
+			std::vector<Particle*> draw_types; // The particle types in draw order
+			std::vector<std::vector<size_t>> draw_indices; // The indices of the particles of each type in draw order, which are reused for every draw
 			std::vector<ParticleEmitter*> emitters;
 			std::vector<ParticleAttractor*> attractors;
 			std::vector<ParticleDestroyer*> destroyers;
 			std::vector<ParticleDeflector*> deflectors;
 			std::vector<ParticleChanger*> changers;
+
+			int remove_destroyed();
 		public:
-			bool is_oldfirst;
+			bool is_oldfirst; // Whether the particles keep their creation order so that older particles are drawn first, otherwise they are reordered by the faster swap-remove
 			int depth;
 
 			double xoffset, yoffset;
@@ -67,6 +74,7 @@ namespace bee {
 			int clear();
 
 			int add_particle(Particle*, double, double);
+			size_t get_particle_amount() const;
 	};
 }
 
@@ -11,6 +11,8 @@
 
 #include "../defines.hpp"
 
+#include <algorithm> // Include the required library headers
+
 #include <GL/glew.h> // Include the required OpenGL headers
 #include <SDL2/SDL_opengl.h>
 #include <glm/glm.hpp>
@@ -43,7 +45,10 @@ namespace bee { namespace render {
 	namespace internal {
 		GLuint target = 0;
 
-		std::map<const Texture*,std::list<TextureDrawData>> textures;
+		std::map<GLuint,std::list<TextureDrawData>> textures; // The queued draws grouped by their GL texture so that textures which share an atlas page are batched together
+		std::vector<const TextureDrawData*> texture_batch;
+		std::vector<GLfloat> instance_data;
+		size_t particle_offset = 0; // The offset in bytes of the currently mapped range of the particle buffer
 
 		ShaderProgram* program = nullptr;
 	}
@@ -213,6 +218,9 @@ namespace bee { namespace render {
 		glUniformMatrix4fv(get_program()->get_location("model"), 1, GL_FALSE, glm::value_ptr(td.model));
 		glUniformMatrix4fv(get_program()->get_location("rotation"), 1, GL_FALSE, glm::value_ptr(td.rotation));
 		glUniform4fv(get_program()->get_location("colorize"), 1, glm::value_ptr(td.color));
+		if (engine->renderer->is_atlas_enabled) {
+			glUniform4fv(get_program()->get_location("texrect"), 1, glm::value_ptr(td.texrect));
+		}
 
 		// Bind the texture coordinates
 		glEnableVertexAttribArray(get_program()->get_location("v_texcoord"));
@@ -233,16 +241,136 @@ namespace bee { namespace render {
 
 		return 0;
 	}
-	int queue_texture(const Texture* texture, const TextureDrawData& data) {
-		if (internal::textures.find(texture) == internal::textures.end()) {
-			internal::textures.emplace(texture, std::list<TextureDrawData>({data}));
+	/*
+	* bind_instance_attrib() - Point the given attribute at the bound instance buffer with a per-instance divisor
+	* ! Matrix attributes occupy one location per column so each column is bound separately
+	* @location: the first location of the attribute
+	* @columns: the amount of columns in the attribute
+	* @size: the amount of floats in each column
+	* @stride: the amount of floats in each instance
+	* @offset: the amount of floats from the start of the buffer to the attribute of the first instance
+	*/
+	static void bind_instance_attrib(GLint location, int columns, int size, size_t stride, size_t offset) {
+		for (int i=0; i<columns; i++) {
+			glEnableVertexAttribArray(location+i);
+			glVertexAttribPointer(
+				location+i,
+				size,
+				GL_FLOAT,
+				GL_FALSE,
+				stride*sizeof(GLfloat),
+				reinterpret_cast<GLvoid*>((offset+size*i)*sizeof(GLfloat))
+			);
+			glVertexAttribDivisor(location+i, 1);
+		}
+	}
+	/*
+	* unbind_instance_attrib() - Reset the given attribute so that it no longer reads from the instance buffer
+	* @location: the first location of the attribute
+	* @columns: the amount of vec4 columns in the attribute
+	*/
+	static void unbind_instance_attrib(GLint location, int columns) {
+		for (int i=0; i<columns; i++) {
+			glVertexAttribDivisor(location+i, 0);
+			glDisableVertexAttribArray(location+i);
+		}
+	}
+	/*
+	* internal::render_texture_instanced() - Draw all of the given subimages with a single instanced call
+	* ! Every TextureDrawData in the batch must share the same VAO, texture, and texcoord buffer
+	* @batch: the queued draws to submit
+	*/
+	int internal::render_texture_instanced(const std::vector<const TextureDrawData*>& batch) {
+		// Pack the model matrix, rotation matrix, color, and texcoord rectangle of each draw into the instance data
+		instance_data.clear();
+		instance_data.reserve(batch.size()*(16+16+4+4));
+		for (auto& td : batch) {
+			const GLfloat* model = glm::value_ptr(td->model);
+			const GLfloat* rotation = glm::value_ptr(td->rotation);
+			const GLfloat* color = glm::value_ptr(td->color);
+			const GLfloat* texrect = glm::value_ptr(td->texrect);
+			instance_data.insert(instance_data.end(), model, model+16);
+			instance_data.insert(instance_data.end(), rotation, rotation+16);
+			instance_data.insert(instance_data.end(), color, color+4);
+			instance_data.insert(instance_data.end(), texrect, texrect+4);
+		}
+
+		// Bind the texture coordinates
+		glEnableVertexAttribArray(get_program()->get_location("v_texcoord"));
+		glBindBuffer(GL_ARRAY_BUFFER, batch.front()->buffer);
+		glVertexAttribPointer(
+			get_program()->get_location("v_texcoord"),
+			2,
+			GL_FLOAT,
+			GL_FALSE,
+			0,
+			0
+		);
+
+		// Upload the instance data, orphaning the previous buffer contents so that the driver doesn't need to synchronize
+		glBindBuffer(GL_ARRAY_BUFFER, engine->renderer->instance_vbo);
+		glBufferData(GL_ARRAY_BUFFER, instance_data.size()*sizeof(GLfloat), nullptr, GL_STREAM_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, instance_data.size()*sizeof(GLfloat), instance_data.data());
+
+		bind_instance_attrib(get_program()->get_location("v_model"), 4, 4, 16+16+4+4, 0);
+		bind_instance_attrib(get_program()->get_location("v_rotation"), 4, 4, 16+16+4+4, 16);
+		bind_instance_attrib(get_program()->get_location("v_colorize"), 1, 4, 16+16+4+4, 32);
+		if (engine->renderer->is_atlas_enabled) {
+			bind_instance_attrib(get_program()->get_location("v_texrect"), 1, 4, 16+16+4+4, 36);
+		}
+
+		glUniform1i(get_program()->get_location("is_instanced"), 1);
+
+		// Draw every instance of the rectangular subimage
+		int size;
+		glGetBufferParameteriv(GL_ELEMENT_ARRAY_BUFFER, GL_BUFFER_SIZE, &size);
+		glDrawElementsInstanced(GL_TRIANGLES, size/sizeof(GLushort), GL_UNSIGNED_SHORT, 0, batch.size());
+
+		// Reset the instancing state
+		glUniform1i(get_program()->get_location("is_instanced"), 0);
+
+		unbind_instance_attrib(get_program()->get_location("v_model"), 4);
+		unbind_instance_attrib(get_program()->get_location("v_rotation"), 4);
+		unbind_instance_attrib(get_program()->get_location("v_colorize"), 1);
+		if (engine->renderer->is_atlas_enabled) {
+			unbind_instance_attrib(get_program()->get_location("v_texrect"), 1);
+		}
+
+		return 0;
+	}
+	/*
+	* internal::render_texture_batch() - Draw the given batch, only using instancing when it is supported and worthwhile
+	* @batch: the queued draws to submit
+	*/
+	int internal::render_texture_batch(const std::vector<const TextureDrawData*>& batch) {
+		if (batch.empty()) {
+			return 1;
+		}
+
+		if ((batch.size() == 1)||(!engine->renderer->is_instancing_enabled)) {
+			for (auto& td : batch) {
+				render_texture(*td);
+			}
+			return 0;
+		}
+
+		return render_texture_instanced(batch);
+	}
+	int queue_texture(const TextureDrawData& data) {
+		if (internal::textures.find(data.texture) == internal::textures.end()) {
+			internal::textures.emplace(data.texture, std::list<TextureDrawData>({data}));
 		} else {
-			internal::textures.at(texture).push_back(data);
+			internal::textures.at(data.texture).push_back(data);
 		}
 		return 0;
 	}
+	/*
+	* render_textures() - Draw all queued textures
+	* ! Consecutive draws of the same subimage are batched into a single instanced draw call in order to preserve the draw order
+	* ! Every texture which was packed into the same atlas page shares a texcoord buffer, so their draws are batched together
+	*/
 	int render_textures() {
-		for (auto t : internal::textures) {
+		for (auto& t : internal::textures) {
 			glBindVertexArray(t.second.front().vao); // Bind the VAO for the texture
 
 			glUniform1i(get_program()->get_location("f_texture"), 0);
@@ -250,21 +378,135 @@ namespace bee { namespace render {
 
 			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, t.second.front().ibo);
 
+			internal::texture_batch.clear();
 			for (auto& td : t.second) {
-				internal::render_texture(td);
+				if ((!internal::texture_batch.empty())&&(internal::texture_batch.front()->buffer != td.buffer)) { // Flush the batch when the subimage changes
+					internal::render_texture_batch(internal::texture_batch);
+					internal::texture_batch.clear();
+				}
+				internal::texture_batch.push_back(&td);
 			}
+			internal::render_texture_batch(internal::texture_batch);
+			internal::texture_batch.clear();
 
 			glBindVertexArray(0); // Unbind the VAO
 		}
 
 		glUniformMatrix4fv(get_program()->get_location("model"), 1, GL_FALSE, glm::value_ptr(glm::mat4(1.0f))); // Reset the partial transformation matrix
 		glUniformMatrix4fv(get_program()->get_location("rotation"), 1, GL_FALSE, glm::value_ptr(glm::mat4(1.0f))); // Reset the rotation matrix
+		if (engine->renderer->is_atlas_enabled) {
+			glUniform4fv(get_program()->get_location("texrect"), 1, glm::value_ptr(glm::vec4(0.0f, 0.0f, 1.0f, 1.0f))); // Reset the texcoord rectangle
+		}
 
 		internal::textures.clear();
 
 		return 0;
 	}
 
+	/*
+	* map_particles() - Map a range of the particle buffer which can hold the given amount of particles
+	* ! The buffer is streamed as a ring, each range is mapped without synchronization after the previously drawn ranges and the buffer is orphaned when it wraps so that the driver never waits on a range which is still in use
+	* ! Each particle is BEE_PARTICLE_INSTANCE_SIZE floats: x, y, horizontal scale, vertical scale, angle in radians, subimage, and the normalized color
+	* ! The range must be drawn with render_particles() before any other buffer is mapped
+	* @amount: the amount of particles to map
+	*/
+	GLfloat* map_particles(size_t amount) {
+		if ((!engine->renderer->is_particle_instancing_enabled)||(amount == 0)) {
+			return nullptr; // Return nullptr when particle instancing is not supported
+		}
+
+		const size_t size = amount*BEE_PARTICLE_INSTANCE_SIZE*sizeof(GLfloat);
+
+		glBindBuffer(GL_ARRAY_BUFFER, engine->renderer->particle_vbo);
+		if (size > engine->renderer->particle_vbo_size) { // Grow the buffer when the particles won't fit
+			engine->renderer->particle_vbo_size = std::max(size, 2*engine->renderer->particle_vbo_size);
+			glBufferData(GL_ARRAY_BUFFER, engine->renderer->particle_vbo_size, nullptr, GL_STREAM_DRAW);
+			engine->renderer->particle_vbo_offset = 0;
+		} else if (engine->renderer->particle_vbo_offset + size > engine->renderer->particle_vbo_size) { // Orphan the buffer when it wraps
+			glBufferData(GL_ARRAY_BUFFER, engine->renderer->particle_vbo_size, nullptr, GL_STREAM_DRAW);
+			engine->renderer->particle_vbo_offset = 0;
+		}
+
+		GLvoid* data = glMapBufferRange(GL_ARRAY_BUFFER, engine->renderer->particle_vbo_offset, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+		if (data == nullptr) {
+			return nullptr; // Return nullptr when the buffer could not be mapped
+		}
+
+		internal::particle_offset = engine->renderer->particle_vbo_offset;
+		engine->renderer->particle_vbo_offset += size;
+
+		return static_cast<GLfloat*>(data);
+	}
+	/*
+	* render_particles() - Unmap the particle buffer and draw the given amount of particles with a single instanced call
+	* ! See map_particles() for the particle data format
+	* @data: the texture draw data, where the buffer is the texcoords of the first subimage
+	* @origin: the rotation origin of the texture
+	* @subimage_width: the width of a single subimage as a percentage of the full texture width
+	* @scale: the scale from the quad of the texture to its size in pixels, which is only needed for atlas pages since their quad is the unit square
+	* @amount: the amount of particles which were written to the mapped range
+	*/
+	int render_particles(const TextureDrawData& data, glm::vec2 origin, GLfloat subimage_width, glm::vec2 scale, size_t amount) {
+		glBindBuffer(GL_ARRAY_BUFFER, engine->renderer->particle_vbo);
+		if (glUnmapBuffer(GL_ARRAY_BUFFER) == GL_FALSE) {
+			return 1; // Return 1 when the mapped data was corrupted
+		}
+
+		glBindVertexArray(data.vao);
+
+		glUniform1i(get_program()->get_location("f_texture"), 0);
+		glBindTexture(GL_TEXTURE_2D, data.texture);
+
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, data.ibo);
+
+		// Bind the texture coordinates
+		glEnableVertexAttribArray(get_program()->get_location("v_texcoord"));
+		glBindBuffer(GL_ARRAY_BUFFER, data.buffer);
+		glVertexAttribPointer(
+			get_program()->get_location("v_texcoord"),
+			2,
+			GL_FLOAT,
+			GL_FALSE,
+			0,
+			0
+		);
+
+		// Bind the mapped range of the particle buffer
+		const size_t offset = internal::particle_offset/sizeof(GLfloat);
+		glBindBuffer(GL_ARRAY_BUFFER, engine->renderer->particle_vbo);
+		bind_instance_attrib(get_program()->get_location("v_particle"), 1, 4, BEE_PARTICLE_INSTANCE_SIZE, offset);
+		bind_instance_attrib(get_program()->get_location("v_particle_extra"), 1, 2, BEE_PARTICLE_INSTANCE_SIZE, offset+4);
+		bind_instance_attrib(get_program()->get_location("v_colorize"), 1, 4, BEE_PARTICLE_INSTANCE_SIZE, offset+6);
+
+		glUniform1i(get_program()->get_location("is_instanced"), 2);
+		glUniform2fv(get_program()->get_location("particle_origin"), 1, glm::value_ptr(origin));
+		glUniform1f(get_program()->get_location("particle_subimage_width"), subimage_width);
+		if (engine->renderer->is_atlas_enabled) {
+			glUniform2fv(get_program()->get_location("particle_scale"), 1, glm::value_ptr(scale));
+			glUniform4fv(get_program()->get_location("texrect"), 1, glm::value_ptr(data.texrect));
+		}
+
+		// Draw every particle as an instance of the rectangular subimage
+		int size;
+		glGetBufferParameteriv(GL_ELEMENT_ARRAY_BUFFER, GL_BUFFER_SIZE, &size);
+		glDrawElementsInstanced(GL_TRIANGLES, size/sizeof(GLushort), GL_UNSIGNED_SHORT, 0, amount);
+
+		// Reset the instancing state
+		glUniform1i(get_program()->get_location("is_instanced"), 0);
+		if (engine->renderer->is_atlas_enabled) {
+			glUniform2fv(get_program()->get_location("particle_scale"), 1, glm::value_ptr(glm::vec2(1.0f)));
+			glUniform4fv(get_program()->get_location("texrect"), 1, glm::value_ptr(glm::vec4(0.0f, 0.0f, 1.0f, 1.0f)));
+		}
+
+		unbind_instance_attrib(get_program()->get_location("v_particle"), 1);
+		unbind_instance_attrib(get_program()->get_location("v_particle_extra"), 1);
+		unbind_instance_attrib(get_program()->get_location("v_colorize"), 1);
+
+		glBindVertexArray(0);
+
+		return 0;
+	}
+
 	/*
 	* reset_target() - Set the rendering target back to the screen
 	* ! See https://wiki.libsdl.org/SDL_SetRenderTarget for details
@@ -10,6 +10,10 @@
 #define BEE_RENDER_H 1
 
 #include <string>
+#include <vector>
+
+#include <GL/glew.h> // Include the required OpenGL headers
+#include <glm/glm.hpp>
 
 #include "camera.hpp"
 
@@ -22,6 +26,8 @@ namespace bee {
 namespace render {
 	namespace internal {
 		int render_texture(const TextureDrawData&);
+		int render_texture_instanced(const std::vector<const TextureDrawData*>&);
+		int render_texture_batch(const std::vector<const TextureDrawData*>&);
 	}
 
 	int set_is_lightable(bool);
@@ -37,9 +43,12 @@ namespace render {
 
 	int set_viewport(ViewPort*);
 
-	int queue_texture(const Texture*, const TextureDrawData&);
+	int queue_texture(const TextureDrawData&);
 	int render_textures();
 
+	GLfloat* map_particles(size_t);
+	int render_particles(const TextureDrawData&, glm::vec2, GLfloat, glm::vec2, size_t);
+
 	int reset_target();
 	int set_target(Texture*);
 	int set_program(ShaderProgram*);
@@ -10,6 +10,7 @@
 #define BEE_RENDERER 1
 
 #include <string>
+#include <vector>
 
 #include <SDL2/SDL.h> // Include the required SDL headers
 
@@ -26,6 +27,7 @@
 #include "../core/enginestate.hpp"
 #include "../core/resources.hpp"
 
+#include "atlas.hpp"
 #include "camera.hpp"
 #include "drawing.hpp"
 #include "render.hpp"
@@ -33,8 +35,67 @@
 #include "shader.hpp"
 
 #include "../resource/texture.hpp"
+#include "../resource/light.hpp"
 
 namespace bee {
+	namespace internal {
+		/*
+		* internal::renderer_create_program() - Compile the given shader stages and link them into a new program with the engine inputs
+		* @vs_fn: the path of the vertex shader
+		* @gs_fn: the path of the geometry shader
+		* @fs_fn: the path of the fragment shader
+		* @_program: the location to store the new program, even when it failed to link
+		*/
+		int renderer_create_program(const std::string& vs_fn, const std::string& gs_fn, const std::string& fs_fn, ShaderProgram** _program) {
+			ShaderProgram* program = new ShaderProgram();
+
+			Shader vertex_shader (vs_fn, GL_VERTEX_SHADER);
+			program->add_shader(vertex_shader);
+
+			program->add_attrib("v_position", true);
+			//program->add_attrib("v_normal", true);
+			program->add_attrib("v_texcoord", true);
+			program->add_attrib("v_model", false);
+			program->add_attrib("v_rotation", false);
+			program->add_attrib("v_colorize", false);
+			program->add_attrib("v_texrect", false);
+			program->add_attrib("v_particle", false);
+			program->add_attrib("v_particle_extra", false);
+
+			program->add_uniform("projection", true);
+			program->add_uniform("view", true);
+			program->add_uniform("model", true);
+			program->add_uniform("port", true);
+			program->add_uniform("rotation", true);
+			program->add_uniform("colorize", true);
+			program->add_uniform("is_instanced", false);
+			program->add_uniform("particle_origin", false);
+			program->add_uniform("particle_subimage_width", false);
+			program->add_uniform("particle_scale", false);
+			program->add_uniform("texrect", false);
+
+			Shader geometry_shader (gs_fn, GL_GEOMETRY_SHADER);
+			program->add_shader(geometry_shader);
+
+			Shader fragment_shader (fs_fn, GL_FRAGMENT_SHADER);
+			program->add_shader(fragment_shader);
+
+			program->add_uniform("f_texture", true);
+			program->add_uniform("is_primitive", true);
+			program->add_uniform("flip", true);
+
+			program->add_uniform("time", false);
+
+			program->add_uniform("is_lightable", false);
+			program->add_uniform_block("LightBlock", BEE_LIGHT_BINDING, false);
+			program->add_uniform_block("LightableBlock", BEE_LIGHTABLE_BINDING, false);
+
+			*_program = program;
+
+			return program->link();
+		}
+	}
+
 	Renderer::Renderer() :
 		window(nullptr),
 		sdl_renderer(nullptr),
@@ -48,7 +109,21 @@ namespace bee {
 
 		triangle_vao(-1),
 		triangle_vbo(-1),
-		triangle_ibo(-1)
+		triangle_ibo(-1),
+
+		is_instancing_enabled(false),
+		instance_vbo(-1),
+
+		is_particle_instancing_enabled(false),
+		particle_vbo(-1),
+		particle_vbo_size(0),
+		particle_vbo_offset(0),
+
+		is_atlas_enabled(false),
+
+		is_lighting_enabled(false),
+		light_ubo(-1),
+		lightable_ubo(-1)
 	{}
 	Renderer::~Renderer() {
 		if (render_camera != nullptr) {
@@ -66,6 +141,7 @@ namespace bee {
 		}
 
 		if (context != nullptr) {
+			atlas::clear();
 			opengl_close();
 		}
 		if (sdl_renderer != nullptr) {
@@ -129,57 +205,45 @@ namespace bee {
 			}
 		}
 
-		program = new ShaderProgram();
-
-		Shader vertex_shader (vs_fn, GL_VERTEX_SHADER);
-		program->add_shader(vertex_shader);
-
-		program->add_attrib("v_position", true);
-		//program->add_attrib("v_normal", true);
-		program->add_attrib("v_texcoord", true);
+		int r = internal::renderer_create_program(vs_fn, gs_fn, fs_fn, &program);
+		if ((r != 0)&&((vs_fn == vs_fn_user)||(gs_fn == gs_fn_user)||(fs_fn == fs_fn_user)||(fs_fn == fs_fn_basic_user))) {
+			messenger::send({"engine", "renderer"}, E_MESSAGE::WARNING, "Failed to link the user shaders, falling back to the default shaders. User shaders which replace a single stage must use the interface of the default shaders, see bee/render/shader/default.vertex.glsl");
 
-		program->add_uniform("projection", true);
-		program->add_uniform("view", true);
-		program->add_uniform("model", true);
-		program->add_uniform("port", true);
-
-		Shader geometry_shader (gs_fn, GL_GEOMETRY_SHADER);
-		program->add_shader(geometry_shader);
-
-		program->add_uniform("rotation", true);
-
-		Shader fragment_shader (fs_fn, GL_FRAGMENT_SHADER);
-		program->add_shader(fragment_shader);
-
-		program->add_uniform("f_texture", true);
-		program->add_uniform("colorize", true);
-		program->add_uniform("is_primitive", true);
-		program->add_uniform("flip", true);
-
-		program->add_uniform("time", false);
+			delete program;
+			program = nullptr;
 
-		program->add_uniform("is_lightable", false);
-		program->add_uniform("light_amount", false);
-		for (size_t i=0; i<BEE_MAX_LIGHTS; i++) {
-			program->add_uniform("lighting[" + bee_itos(i) + "].type", false);
-			program->add_uniform("lighting[" + bee_itos(i) + "].position", false);
-			program->add_uniform("lighting[" + bee_itos(i) + "].direction", false);
-			program->add_uniform("lighting[" + bee_itos(i) + "].attenuation", false);
-			program->add_uniform("lighting[" + bee_itos(i) + "].color", false);
+			fs_fn = (get_options().is_basic_shaders_enabled) ? fs_fn_basic_default : fs_fn_default;
+			internal::renderer_create_program(vs_fn_default, gs_fn_default, fs_fn, &program);
 		}
-
-		program->add_uniform("lightable_amount", false);
-		for (size_t i=0; i<BEE_MAX_LIGHTABLES; i++) {
-			program->add_uniform("lightable[" + bee_itos(i) + "].position", false);
-			program->add_uniform("lightable[" + bee_itos(i) + "].vertex_amount", false);
-			for (size_t j=0; j<BEE_MAX_MASK_VERTICES; j++) {
-				program->add_uniform("lightable[" + bee_itos(i) + "].mask[" + bee_itos(j) + "]", false);
-			}
-		}
-
-		program->link();
 		render::set_program(program);
 
+		// Only batch textures when the shaders support per-instance attributes
+		is_instancing_enabled = (
+			(program->has_input("v_model"))
+			&&(program->has_input("v_rotation"))
+			&&(program->has_input("v_colorize"))
+			&&(program->has_input("is_instanced"))
+		);
+		is_particle_instancing_enabled = (
+			(program->has_input("v_particle"))
+			&&(program->has_input("v_particle_extra"))
+			&&(program->has_input("v_colorize"))
+			&&(program->has_input("is_instanced"))
+			&&(program->has_input("particle_origin"))
+			&&(program->has_input("particle_subimage_width"))
+		);
+		// Only pack textures into atlas pages when the shaders can offset the texcoords of each draw
+		is_atlas_enabled = (
+			(program->has_input("texrect"))
+			&&(program->has_input("v_texrect"))
+			&&(program->has_input("particle_scale"))
+		);
+		// Only upload lights when the shaders declare the lighting blocks, e.g. not with the basic shaders
+		is_lighting_enabled = (
+			(program->has_input("LightBlock"))
+			&&(program->has_input("LightableBlock"))
+		);
+
 		draw_set_color({255, 255, 255, 255});
 		glEnable(GL_TEXTURE_2D);
 
@@ -217,12 +281,44 @@ namespace bee {
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, triangle_ibo);
 		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(elements), elements, GL_STATIC_DRAW);
 
+		// Generate the per-frame buffer for instanced texture drawing
+		glGenBuffers(1, &instance_vbo);
+
+		// Generate the streaming buffer for instanced particle drawing
+		particle_vbo_size = BEE_PARTICLE_BUFFER_SIZE*BEE_PARTICLE_INSTANCE_SIZE*sizeof(GLfloat);
+		particle_vbo_offset = 0;
+		glGenBuffers(1, &particle_vbo);
+		glBindBuffer(GL_ARRAY_BUFFER, particle_vbo);
+		glBufferData(GL_ARRAY_BUFFER, particle_vbo_size, nullptr, GL_STREAM_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		// Generate the uniform buffers for the lights and lightables, the block header holds the amount and is padded to 16 bytes
+		glGenBuffers(1, &light_ubo);
+		glBindBuffer(GL_UNIFORM_BUFFER, light_ubo);
+		glBufferData(GL_UNIFORM_BUFFER, 4*sizeof(GLint) + BEE_MAX_LIGHTS*sizeof(LightUniform), nullptr, GL_DYNAMIC_DRAW);
+		glBindBufferBase(GL_UNIFORM_BUFFER, BEE_LIGHT_BINDING, light_ubo);
+
+		glGenBuffers(1, &lightable_ubo);
+		glBindBuffer(GL_UNIFORM_BUFFER, lightable_ubo);
+		glBufferData(GL_UNIFORM_BUFFER, 4*sizeof(GLint) + BEE_MAX_LIGHTABLES*sizeof(LightableUniform), nullptr, GL_DYNAMIC_DRAW);
+		glBindBufferBase(GL_UNIFORM_BUFFER, BEE_LIGHTABLE_BINDING, lightable_ubo);
+
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
 		return 0; // Return 0 on success
 	}
 	int Renderer::opengl_close() {
 		glDeleteBuffers(1, &triangle_vao);
 		glDeleteBuffers(1, &triangle_vbo);
 		glDeleteBuffers(1, &triangle_ibo);
+		glDeleteBuffers(1, &instance_vbo);
+		is_instancing_enabled = false;
+		glDeleteBuffers(1, &particle_vbo);
+		is_particle_instancing_enabled = false;
+		is_atlas_enabled = false;
+		glDeleteBuffers(1, &light_ubo);
+		glDeleteBuffers(1, &lightable_ubo);
+		is_lighting_enabled = false;
 
 		delete projection_cache;
 
@@ -271,18 +367,23 @@ namespace bee {
 	}
 
 	int Renderer::reset() {
+		std::vector<Texture*> loaded_textures;
+		for (size_t i=0; i<Texture::get_amount(); i++) {
+			Texture* t = Texture::get(i);
+			if ((t != nullptr)&&(t->get_is_loaded())) {
+				loaded_textures.push_back(t);
+			}
+		}
+
+		atlas::clear(); // The atlas pages are lost with the context so the packed textures are reloaded individually below
+
 		opengl_close();
 		opengl_init();
 
 		// Reload textures
-		for (size_t i=0; i<Texture::get_amount(); i++) {
-			Texture* t = Texture::get(i);
-			if (t != nullptr) {
-				if (t->get_is_loaded()) {
-					t->free();
-					t->load();
-				}
-			}
+		for (auto& t : loaded_textures) {
+			t->free();
+			t->load();
 		}
 
 		return 0;
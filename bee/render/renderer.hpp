@@ -44,6 +44,24 @@ namespace bee {
 			GLuint triangle_vbo;
 			GLuint triangle_ibo;
 
+			// These should only be used internally by render::render_textures() in bee/render/render.cpp
+			bool is_instancing_enabled;
+			GLuint instance_vbo;
+
+			// These should only be used internally by render::map_particles() and render::render_particles() in bee/render/render.cpp
+			bool is_particle_instancing_enabled;
+			GLuint particle_vbo;
+			size_t particle_vbo_size; // The capacity of the particle buffer in bytes
+			size_t particle_vbo_offset; // The offset in bytes where the next range of particles will be mapped
+
+			// This should only be used internally by the functions in bee/render/atlas.cpp
+			bool is_atlas_enabled;
+
+			// These should only be used internally by Room::handle_lights() in bee/resource/room.cpp
+			bool is_lighting_enabled;
+			GLuint light_ubo;
+			GLuint lightable_ubo;
+
 			Renderer();
 			~Renderer();
 
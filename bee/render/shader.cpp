@@ -24,11 +24,16 @@
 namespace bee {
 	ShaderInput::ShaderInput() :
 		is_attrib(false),
+		is_block(false),
 		is_required(true),
 		location(-1)
 	{}
 	ShaderInput::ShaderInput(bool _is_attrib, bool _is_required) :
+		ShaderInput(_is_attrib, false, _is_required)
+	{}
+	ShaderInput::ShaderInput(bool _is_attrib, bool _is_block, bool _is_required) :
 		is_attrib(_is_attrib),
+		is_block(_is_block),
 		is_required(_is_required),
 		location(-1)
 	{}
@@ -101,6 +106,19 @@ namespace bee {
 		inputs.emplace(name, ShaderInput(false, is_required));
 		return 0;
 	}
+	/*
+	* ShaderProgram::add_uniform_block() - Add a uniform block which will be assigned to the given binding point when the program is linked
+	* ! The buffer for the block should be bound to the same binding point with glBindBufferBase()
+	* @name: the name of the uniform block
+	* @binding: the binding point to assign to the block
+	* @is_required: whether linking should fail when the block is not present
+	*/
+	int ShaderProgram::add_uniform_block(const std::string& name, GLuint binding, bool is_required) {
+		ShaderInput input (false, true, is_required);
+		input.location = binding;
+		inputs.emplace(name, input);
+		return 0;
+	}
 	int ShaderProgram::link() {
 		glLinkProgram(program);
 
@@ -123,6 +141,13 @@ namespace bee {
 		for (auto& input : _inputs) {
 			if (input.second.is_attrib) {
 				input.second.location = glGetAttribLocation(program, input.first.c_str());
+			} else if (input.second.is_block) {
+				GLuint index = glGetUniformBlockIndex(program, input.first.c_str());
+				if (index == GL_INVALID_INDEX) {
+					input.second.location = -1;
+				} else {
+					glUniformBlockBinding(program, index, input.second.location);
+				}
 			} else {
 				input.second.location = glGetUniformLocation(program, input.first.c_str());
 			}
@@ -154,6 +179,9 @@ namespace bee {
 
 		return inputs.at(input).location;
 	}
+	bool ShaderProgram::has_input(const std::string& input) const {
+		return (inputs.find(input) != inputs.end());
+	}
 
 	int ShaderProgram::apply() {
 		if (program == static_cast<GLuint>(-1)) {
@@ -24,11 +24,13 @@
 namespace bee {
 	struct ShaderInput {
 		bool is_attrib;
+		bool is_block;
 		bool is_required;
-		GLint location;
+		GLint location; // The location of the attribute or uniform, or the binding point of the uniform block
 
 		ShaderInput();
 		explicit ShaderInput(bool, bool);
+		ShaderInput(bool, bool, bool);
 	};
 
 	class Shader {
@@ -55,10 +57,12 @@ namespace bee {
 			int add_shader(Shader&);
 			int add_attrib(const std::string&, bool);
 			int add_uniform(const std::string&, bool);
+			int add_uniform_block(const std::string&, GLuint, bool);
 			int link();
 
 			GLuint get_program() const;
 			GLint get_location(const std::string&) const;
+			bool has_input(const std::string&) const;
 
 			int apply();
 	};
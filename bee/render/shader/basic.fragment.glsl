@@ -10,18 +10,18 @@
 
 in vec4 f_position;
 in vec2 f_texcoord;
+flat in vec4 f_colorize;
 
 out vec4 f_fragment;
 
 uniform sampler2D f_texture;
-uniform vec4 colorize = vec4(1.0, 1.0, 1.0, 1.0);
 uniform int is_primitive = 0;
 uniform int flip = 0;
 
 void main() {
 	f_fragment = vec4(0.0, 0.0, 0.0, 0.0);
 	if (is_primitive == 1) {
-		f_fragment = colorize;
+		f_fragment = f_colorize;
 	} else {
 		if (flip == 1) {
 			f_fragment = texture(f_texture, vec2(1.0-f_texcoord.x, f_texcoord.y));
@@ -33,6 +33,6 @@ void main() {
 			f_fragment = texture(f_texture, f_texcoord);
 		}
 
-		f_fragment *= colorize;
+		f_fragment *= f_colorize;
 	}
 }
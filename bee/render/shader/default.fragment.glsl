@@ -10,11 +10,11 @@
 
 in vec4 f_position;
 in vec2 f_texcoord;
+flat in vec4 f_colorize;
 
 out vec4 f_fragment;
 
 uniform sampler2D f_texture;
-uniform vec4 colorize = vec4(1.0, 1.0, 1.0, 1.0);
 uniform int is_primitive = 0;
 uniform int flip = 0;
 uniform vec4 port;
@@ -33,7 +33,6 @@ const int BEE_LIGHT_SPOT = 4;
 
 const int BEE_MAX_LIGHTS = 8;
 
-uniform int light_amount = 0;
 struct Light {
 	int type;
 	vec4 position;
@@ -41,19 +40,24 @@ struct Light {
 	vec4 attenuation;
 	vec4 color;
 };
-uniform Light lighting[BEE_MAX_LIGHTS];
+layout(std140) uniform LightBlock { // See LightUniform in bee/resource/light.hpp for the matching layout
+	int light_amount;
+	Light lighting[BEE_MAX_LIGHTS];
+};
 
 // Shadows
 const int BEE_MAX_LIGHTABLES = 96;
 const int BEE_MAX_MASK_VERTICES = 8;
 
-uniform int lightable_amount = 0;
 struct Lightable {
 	vec4 position;
 	int vertex_amount;
 	vec4 mask[BEE_MAX_MASK_VERTICES];
 };
-uniform Lightable lightables[BEE_MAX_LIGHTABLES];
+layout(std140) uniform LightableBlock { // See LightableUniform in bee/resource/light.hpp for the matching layout
+	int lightable_amount;
+	Lightable lightables[BEE_MAX_LIGHTABLES];
+};
 
 float calc_attenuation_point(vec4 a, float d) {
 	return 10000.0 / (a.x + a.y * d + a.z * d*d);
@@ -146,7 +150,7 @@ float calc_shadow_point(Light l, Lightable s) {
 void main() {
 	f_fragment = vec4(0.0, 0.0, 0.0, 0.0);
 	if (is_primitive == 1) {
-		f_fragment = colorize;
+		f_fragment = f_colorize;
 	} else {
 		if (flip == 1) {
 			f_fragment = texture(f_texture, vec2(1.0-f_texcoord.x, f_texcoord.y));
@@ -158,7 +162,7 @@ void main() {
 			f_fragment = texture(f_texture, f_texcoord);
 		}
 
-		f_fragment *= colorize;
+		f_fragment *= f_colorize;
 
 		// Lighting
 		if (is_lightable > 0) {
@@ -8,29 +8,32 @@
 
 // Version is included before OpenGL initialization
 
+// See default.vertex.glsl for the stage interface which user shaders must match
+
 layout (triangles) in;
 
 layout (triangle_strip, max_vertices = 3) out;
 
 in vec4 g_position[3];
 in vec2 g_texcoord[3];
+in mat4 g_transform[3];
+in vec4 g_colorize[3];
 
 out vec4 f_position;
 out vec2 f_texcoord;
+flat out vec4 f_colorize;
 
-uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 
-uniform mat4 rotation;
-
 void main() {
-	mat4 mr = model * rotation;
+	mat4 mr = g_transform[0];
 	mat4 pvmr = projection * view * mr;
 	for(int i=0; i<3; i++) {
 		gl_Position = pvmr * gl_in[i].gl_Position;
 		f_position = mr * g_position[i];
 		f_texcoord = g_texcoord[i];
+		f_colorize = g_colorize[i];
 
 		EmitVertex();
 	}
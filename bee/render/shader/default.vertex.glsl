@@ -8,18 +8,79 @@
 
 // Version is included before OpenGL initialization
 
+/*
+* The stage interface of the default shaders, which must be matched by user shaders that only replace some of the stages
+* vertex to geometry: vec4 g_position, vec2 g_texcoord, mat4 g_transform (the model and rotation matrix), vec4 g_colorize
+* geometry to fragment: vec4 f_position, vec2 f_texcoord, flat vec4 f_colorize
+* The model, rotation, and colorize uniforms are only read by the vertex stage so that it can use the per-instance attributes instead
+* If the user shaders fail to link, e.g. because they use the old interface, then all of the default shaders are used instead
+*/
+
 in vec3 v_position;
 in vec3 v_normal;
 in vec2 v_texcoord;
 
+// Per-instance attributes, used when rendering batched textures
+in mat4 v_model;
+in mat4 v_rotation;
+in vec4 v_colorize;
+in vec4 v_texrect; // The offset and scale of the texcoords, used when rendering textures from an atlas page
+
+// Per-instance attributes, used when rendering particles
+in vec4 v_particle; // The position and scale of each particle
+in vec2 v_particle_extra; // The angle in radians and subimage of each particle
+
 out vec2 g_texcoord;
 out vec4 g_position;
+out mat4 g_transform;
+out vec4 g_colorize;
 
 uniform vec4 port;
 
+uniform mat4 model;
+uniform mat4 rotation;
+uniform vec4 colorize = vec4(1.0, 1.0, 1.0, 1.0);
+uniform int is_instanced = 0;
+uniform vec2 particle_origin; // The rotation origin of the particle texture
+uniform float particle_subimage_width; // The width of a single subimage as a percentage of the full texture width
+uniform vec2 particle_scale = vec2(1.0, 1.0); // The scale from the quad to the particle texture, used when the quad is the unit square of an atlas page
+uniform vec4 texrect = vec4(0.0, 0.0, 1.0, 1.0);
+
 void main() {
 	gl_Position = vec4(v_position.xy + port.xy, v_position.z, 1.0);
 
 	g_position = vec4(v_position, 1.0);
 	g_texcoord = v_texcoord;
+
+	if (is_instanced == 1) {
+		g_transform = v_model * v_rotation;
+		g_colorize = v_colorize;
+		g_texcoord = v_texrect.xy + g_texcoord * v_texrect.zw;
+	} else if (is_instanced == 2) {
+		// Build the same translation, scaling, and rotation as Texture::draw_subimage() from the compact particle data
+		mat4 m = mat4(1.0);
+		m[0][0] = v_particle.z;
+		m[1][1] = v_particle.w;
+		m[3] = vec4(v_particle.xy, -0.5, 1.0);
+
+		float c = cos(v_particle_extra.x);
+		float s = sin(v_particle_extra.x);
+		mat4 r = mat4(1.0);
+		r[0] = vec4(c, s, 0.0, 0.0);
+		r[1] = vec4(-s, c, 0.0, 0.0);
+		r[3] = vec4(particle_origin - mat2(c, s, -s, c) * particle_origin, 0.0, 1.0);
+
+		mat4 p = mat4(1.0);
+		p[0][0] = particle_scale.x;
+		p[1][1] = particle_scale.y;
+
+		g_transform = m * r * p;
+		g_colorize = v_colorize;
+		g_texcoord.x += v_particle_extra.y * particle_subimage_width;
+		g_texcoord = texrect.xy + g_texcoord * texrect.zw;
+	} else {
+		g_transform = model * rotation;
+		g_colorize = colorize;
+		g_texcoord = texrect.xy + g_texcoord * texrect.zw;
+	}
 }
@@ -10,6 +10,7 @@
 #define BEE_FONT 1
 
 #include <sstream> // Include the required library headers
+#include <algorithm>
 
 #include "font.hpp" // Include the class resource header
 
@@ -69,6 +70,7 @@ namespace bee {
 
 	std::map<int,Font*> Font::list;
 	int Font::next_id = 0;
+	NameIndex<Font> Font::names;
 
 	/*
 	* Font::Font() - Construct the font and set its engine pointer
@@ -89,7 +91,13 @@ namespace bee {
 		has_draw_failed(false),
 
 		sprite_font(nullptr),
-		is_sprite(false)
+		is_sprite(false),
+
+		is_atlas_enabled(true),
+		glyph_atlases(),
+		glyph_atlas_columns(0),
+		has_atlas_failed(false),
+		glyph_advances()
 	{}
 	/*
 	* Font::Font() - Construct the font, reset all variables, add it to the font resource list, and set the new name and path
@@ -117,6 +125,7 @@ namespace bee {
 	*/
 	Font::~Font() {
 		this->free(); // Free all font data
+		names.remove(name, this);
 		list.erase(id); // Remove the font from the resource list
 	}
 
@@ -127,6 +136,7 @@ namespace bee {
 		if (id < 0) { // If the resource needs to be added to the resource list
 			id = next_id++;
 			list.emplace(id, this); // Add the resource and with the new id
+			names.add(name, this);
 		}
 
 		return 0; // Return 0 on success
@@ -148,13 +158,34 @@ namespace bee {
 		return nullptr;
 	}
 	/*
+	* Font::get_by_name() - Return the font resource with the given name, or nullptr if there isn't one
+	* @name: the name of the desired font
+	*/
+	Font* Font::get_by_name(const std::string& name) {
+		return names.find(name);
+	}
+	/*
+	* Font::get_name_handle() - Return a handle for the given name which can be cached and passed to get_by_handle()
+	* @name: the name to get the handle of
+	*/
+	size_t Font::get_name_handle(const std::string& name) {
+		return names.get_handle(name);
+	}
+	/*
+	* Font::get_by_handle() - Return the font resource which currently has the name of the given handle, or nullptr if there isn't one
+	* @handle: the name handle
+	*/
+	Font* Font::get_by_handle(size_t handle) {
+		return names.get(handle);
+	}
+	/*
 	* Font::reset() - Reset all resource variables for reinitialization
 	*/
 	int Font::reset() {
 		this->free(); // Free all memory used by this resource
 
 		// Reset all properties
-		name = "";
+		set_name("");
 		path = "";
 		font_size = 24;
 		style = TTF_STYLE_NORMAL;
@@ -169,6 +200,9 @@ namespace bee {
 		sprite_font = nullptr;
 		is_sprite = false;
 
+		// Reset glyph atlas data
+		is_atlas_enabled = true;
+
 		return 0; // Return 0 on success
 	}
 	/*
@@ -189,6 +223,8 @@ namespace bee {
 		"\n	has_draw_failed " << has_draw_failed <<
 		"\n	is_sprite       " << is_sprite <<
 		"\n	sprite_font     " << sprite_font <<
+		"\n	is_atlas_enabled " << is_atlas_enabled <<
+		"\n	glyph_atlases   " << glyph_atlases.size() <<
 		"\n}\n";
 		messenger::send({"engine", "resource"}, E_MESSAGE::INFO, s.str()); // Send the info to the messaging system for output
 
@@ -224,6 +260,9 @@ namespace bee {
 
 		return TTF_FontLineSkip(font); // Return the lineskip on success
 	}
+	bool Font::get_is_atlas_enabled() const {
+		return is_atlas_enabled;
+	}
 	std::string Font::get_fontname() {
 		std::string fontname = ""; // Create the fontname in the following format "family style", i.e. "Liberation Mono Regular"
 		fontname.append(TTF_FontFaceFamilyName(font));
@@ -236,6 +275,13 @@ namespace bee {
 	* Font::set_*() - Set the requested resource data
 	*/
 	int Font::set_name(const std::string& new_name) {
+		if (id >= 0) { // If the font is in the resource list, reindex it under the new name
+			names.remove(name, this);
+			name = new_name;
+			names.add(name, this);
+			return 0;
+		}
+
 		name = new_name;
 		return 0;
 	}
@@ -259,12 +305,25 @@ namespace bee {
 
 		style = new_style; // Store the style
 		TTF_SetFontStyle(font, style); // Set the style of the loaded font
+		free_atlas(); // Free the glyph atlas so that it will be rasterized with the new style
 		return 0; // Return 0 on success
 	}
 	int Font::set_lineskip(int new_lineskip) {
 		lineskip = new_lineskip;
 		return 0;
 	}
+	/*
+	* Font::set_is_atlas_enabled() - Set whether draw_fast() should draw TTF text from the glyph atlas
+	* ! When disabled, each line is rasterized into a temporary texture every time that it is drawn
+	* @new_is_atlas_enabled: whether to enable the glyph atlas
+	*/
+	int Font::set_is_atlas_enabled(bool new_is_atlas_enabled) {
+		is_atlas_enabled = new_is_atlas_enabled;
+		if (!is_atlas_enabled) {
+			free_atlas();
+		}
+		return 0;
+	}
 
 	/*
 	* Font::load() - Load the font from its given filename
@@ -291,10 +350,6 @@ namespace bee {
 			is_loaded = true;
 			has_draw_failed = false;
 		} else { // Otherwise load the sprite's TTF file
-			if ((get_options().renderer_type == E_RENDERER::OPENGL3)||(get_options().renderer_type == E_RENDERER::OPENGL4)) { // If the engine is rendering in OpenGL mode, output a warning about fast font drawing
-				messenger::send({"engine", "font"}, E_MESSAGE::WARNING, "Please note that TTF fast font rendering is currently broken in OpenGL mode\nThe current behavior is to draw slowly and discard the texture data");
-			}
-
 			font = TTF_OpenFont(path.c_str(), font_size); // Open the TTF file with the desired font size
 			if (font == nullptr) { // If the font failed to load, output a warning
 				messenger::send({"engine", "font"}, E_MESSAGE::WARNING, "Failed to load font \"" + path + "\": " + TTF_GetError());
@@ -319,6 +374,8 @@ namespace bee {
 				delete sprite_font;
 				sprite_font = nullptr;
 			} else {
+				free_atlas(); // Free the glyph atlas
+
 				// Delete the TTF font
 				TTF_CloseFont(font);
 				font = nullptr;
@@ -468,6 +525,215 @@ namespace bee {
 		return draw(textdata, x, y, text, {0, 0, 0, 255}); // Return the result of drawing the text in black
 	}
 
+	/*
+	* Font::load_atlas() - Rasterize the glyphs from BEE_FONT_ATLAS_FIRST to BEE_FONT_ATLAS_LAST into the glyph atlas
+	* ! The glyphs are rendered in white so that they can be colorized when drawn
+	* ! Each glyph is placed in an equally sized cell with a transparent border so that the cells can be drawn as subimages without bleeding into each other
+	* ! The cells are split into rows of separate textures so that each texture fits in GL_MAX_TEXTURE_SIZE
+	* ! When the atlas fails to load, it won't be rasterized again until it is freed, e.g. by changing the style
+	*/
+	int Font::load_atlas() {
+		if ((!is_loaded)||(is_sprite)) {
+			return 1; // Return 1 when the font is not a loaded TTF font
+		}
+
+		free_atlas();
+
+		const int amount = BEE_FONT_ATLAS_LAST - BEE_FONT_ATLAS_FIRST + 1;
+		std::vector<SDL_Surface*> glyphs;
+		glyphs.reserve(amount);
+
+		// Render each glyph and find the widest one
+		int cell_width = 0;
+		for (int c=BEE_FONT_ATLAS_FIRST; c<=BEE_FONT_ATLAS_LAST; ++c) {
+			const char glyph[] = {static_cast<char>(c), '\0'};
+			SDL_Surface* tmp_surface = TTF_RenderUTF8_Blended(font, glyph, {255, 255, 255, 255});
+			if (tmp_surface != nullptr) {
+				cell_width = std::max(cell_width, tmp_surface->w);
+			}
+			glyphs.push_back(tmp_surface);
+
+			int advance = 0;
+			TTF_GlyphMetrics(font, static_cast<Uint16>(c), nullptr, nullptr, nullptr, nullptr, &advance);
+			glyph_advances.push_back(advance);
+		}
+		cell_width += 2;
+
+		// Split the glyphs into as many textures as needed to keep each one within the maximum texture size
+		GLint max_size = 0;
+		glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_size);
+		const int height = TTF_FontHeight(font);
+		if ((cell_width > max_size)||(height > max_size)) {
+			for (auto& g : glyphs) {
+				SDL_FreeSurface(g);
+			}
+			glyph_advances.clear();
+			has_atlas_failed = true;
+
+			messenger::send({"engine", "font"}, E_MESSAGE::WARNING, "Failed to create the glyph atlas for \"" + name + "\": the glyphs are larger than the maximum texture size " + bee_itos(max_size));
+			return 3; // Return 3 when a single glyph doesn't fit in a texture
+		}
+		glyph_atlas_columns = std::min(amount, max_size / cell_width);
+
+		int r = 0;
+		for (int start=0; start<amount; start+=glyph_atlas_columns) {
+			const int columns = std::min(glyph_atlas_columns, amount - start);
+
+			// Copy each glyph into its cell, without blending so that the atlas keeps the glyph's alpha
+			SDL_Surface* atlas_surface = SDL_CreateRGBSurface(0, cell_width*columns, height, 32, 0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000);
+			if (atlas_surface == nullptr) {
+				messenger::send({"engine", "font"}, E_MESSAGE::WARNING, "Failed to create the glyph atlas for \"" + name + "\": " + get_sdl_error());
+				r = 2;
+				break;
+			}
+			for (int i=0; i<columns; ++i) {
+				SDL_Surface* g = glyphs[start+i];
+				if (g != nullptr) {
+					SDL_Rect dest = {i*cell_width + 1, 0, 0, 0};
+					SDL_SetSurfaceBlendMode(g, SDL_BLENDMODE_NONE);
+					SDL_BlitSurface(g, nullptr, atlas_surface, &dest);
+				}
+			}
+
+			Texture* atlas = new Texture();
+			atlas->set_subimage_amount(columns, cell_width);
+			const int lr = atlas->load_from_surface(atlas_surface);
+			SDL_FreeSurface(atlas_surface);
+			glyph_atlases.push_back(atlas);
+
+			if ((lr != 0)||(!atlas->get_is_loaded())) {
+				messenger::send({"engine", "font"}, E_MESSAGE::WARNING, "Failed to load the glyph atlas for \"" + name + "\"");
+				r = 2;
+				break;
+			}
+		}
+
+		for (auto& g : glyphs) {
+			SDL_FreeSurface(g);
+		}
+
+		if (r != 0) {
+			free_atlas();
+			has_atlas_failed = true;
+			return 2; // Return 2 when the atlas textures could not be created
+		}
+
+		return 0; // Return 0 on success
+	}
+	/*
+	* Font::free_atlas() - Free the glyph atlas so that it will be rasterized again when it is next used
+	*/
+	int Font::free_atlas() {
+		for (auto& a : glyph_atlases) {
+			delete a;
+		}
+		glyph_atlases.clear();
+		glyph_atlas_columns = 0;
+		has_atlas_failed = false;
+		glyph_advances.clear();
+
+		return 0;
+	}
+	/*
+	* Font::draw_fast_atlas() - Draw the given line of text from the glyph atlas with a single instanced call for each atlas texture
+	* ! When instancing is not available, each glyph is queued as a subimage of the atlas instead
+	* @x: the x-coordinate to draw the text at
+	* @y: the y-coordinate to draw the text at
+	* @text: the line to draw
+	* @color: the color to draw the text in
+	*/
+	int Font::draw_fast_atlas(int x, int y, const std::string& text, RGBA color) {
+		for (const char& c : text) {
+			const unsigned char uc = static_cast<unsigned char>(c);
+			if ((uc < BEE_FONT_ATLAS_FIRST)||(uc > BEE_FONT_ATLAS_LAST)) {
+				return 1; // Return 1 when the text contains characters which are not in the atlas
+			}
+		}
+
+		if (glyph_atlases.empty()) {
+			if ((has_atlas_failed)||(load_atlas())) {
+				return 2; // Return 2 when the atlas could not be loaded
+			}
+		}
+
+		// Find the position of each glyph before drawing them by atlas texture
+		thread_local std::vector<int> pens;
+		pens.clear();
+		pens.reserve(text.size());
+		int pen = x;
+		Uint16 previous = 0;
+		for (const char& ch : text) {
+			const Uint16 glyph = static_cast<unsigned char>(ch);
+			#ifdef SDL_TTF_VERSION_ATLEAST
+				#if SDL_TTF_VERSION_ATLEAST(2,0,14)
+					if (previous != 0) {
+						pen += TTF_GetFontKerningSizeGlyphs(font, previous, glyph); // Apply the kerning between the glyph and the previous one
+					}
+				#endif
+			#endif
+
+			pens.push_back(pen);
+			pen += glyph_advances[glyph - BEE_FONT_ATLAS_FIRST];
+			previous = glyph;
+		}
+
+		render::render_textures(); // Flush the queued textures so that they are drawn before the text
+
+		const glm::vec4 c (color.r/255.0f, color.g/255.0f, color.b/255.0f, color.a/255.0f);
+		for (size_t a=0; a<glyph_atlases.size(); ++a) {
+			Texture* atlas = glyph_atlases[a];
+			const unsigned int first = a * glyph_atlas_columns;
+			const unsigned int last = first + atlas->get_subimage_amount();
+
+			size_t amount = 0;
+			for (const char& ch : text) {
+				const unsigned int index = static_cast<unsigned char>(ch) - BEE_FONT_ATLAS_FIRST;
+				if ((index >= first)&&(index < last)) {
+					++amount;
+				}
+			}
+			if (amount == 0) {
+				continue;
+			}
+
+			const int w = atlas->get_subimage_width();
+			const int h = atlas->get_height();
+			GLfloat* data = render::map_particles(amount);
+
+			for (size_t i=0; i<text.size(); ++i) {
+				const unsigned int index = static_cast<unsigned char>(text[i]) - BEE_FONT_ATLAS_FIRST;
+				if ((index < first)||(index >= last)) {
+					continue;
+				}
+
+				const unsigned int subimage = index - first;
+				if (data != nullptr) {
+					data[0] = static_cast<GLfloat>(pens[i] - 1); // Offset the cell border
+					data[1] = static_cast<GLfloat>(y);
+					data[2] = 1.0f;
+					data[3] = 1.0f;
+					data[4] = 0.0f;
+					data[5] = static_cast<GLfloat>(subimage);
+					data[6] = c.r;
+					data[7] = c.g;
+					data[8] = c.b;
+					data[9] = c.a;
+					data += BEE_PARTICLE_INSTANCE_SIZE;
+				} else {
+					atlas->draw_subimage(pens[i] - 1, y, subimage, w, h, 0.0, color);
+				}
+			}
+
+			if (data != nullptr) {
+				atlas->draw_instanced(amount);
+			} else {
+				render::render_textures();
+			}
+		}
+
+		return 0; // Return 0 on success
+	}
+
 	/*
 	* Font::draw_fast_internal() - Draw the given text with the given attributes without storing the rendered text
 	* @x: the x-coordinate to draw the text at
@@ -497,7 +763,9 @@ namespace bee {
 			for (char& c : t) {
 				sprite_font->draw_subimage(x+(i++), y, static_cast<int>(c), w, h, 0.0, {color.r, color.g, color.b, color.a});
 			}
-		} else { // Otherwise, draw the font normally
+		} else if ((is_atlas_enabled)&&(draw_fast_atlas(x, y, t, color) == 0)) { // Otherwise, draw the text from the glyph atlas when possible
+			return 0; // Return 0 on success
+		} else { // Otherwise, render the entire line
 			// Render the text to a temporary surface
 			SDL_Surface* tmp_surface;
 			tmp_surface = TTF_RenderUTF8_Blended(font, t.c_str(), {color.r, color.g, color.b, color.a}); // Use the slow but pretty TTF rendering mode
@@ -9,13 +9,18 @@
 #ifndef BEE_FONT_H
 #define BEE_FONT_H 1
 
+#include "../defines.hpp"
+
 #include <string> // Include the required library headers
 #include <map>
+#include <vector>
 
 #include <SDL2/SDL_ttf.h> // Include the required SDL headers
 
 #include "resource.hpp"
 
+#include "../data/nameindex.hpp"
+
 #include "../render/rgba.hpp"
 
 namespace bee {
@@ -37,6 +42,7 @@ namespace bee {
 	class Font: public Resource { // The font class is used to render all text as textures
 			static std::map<int,Font*> list;
 			static int next_id;
+			static NameIndex<Font> names; // The index of the resources by name
 
 			int id; // The id of the resource
 			std::string name; // An arbitrary name for the resource
@@ -51,6 +57,17 @@ namespace bee {
 
 			Texture* sprite_font; // The optional internal sprite font used for rendering
 			bool is_sprite; // Whether the font is a sprite font
+
+			bool is_atlas_enabled; // Whether draw_fast() should draw TTF text from the glyph atlas
+			std::vector<Texture*> glyph_atlases; // The textures which contain the glyphs from BEE_FONT_ATLAS_FIRST to BEE_FONT_ATLAS_LAST, with each glyph as a subimage and as many glyphs per texture as fit in GL_MAX_TEXTURE_SIZE
+			int glyph_atlas_columns; // The amount of glyphs in each atlas texture
+			bool has_atlas_failed; // Whether the atlas has previously failed to load, this prevents it from being rasterized again on every draw
+			std::vector<int> glyph_advances; // The horizontal advance of each glyph in the atlas
+
+			// See bee/resources/font.cpp for function comments
+			int load_atlas();
+			int free_atlas();
+			int draw_fast_atlas(int, int, const std::string&, RGBA);
 		public:
 			// See bee/resources/font.cpp for function comments
 			Font();
@@ -60,6 +77,9 @@ namespace bee {
 			int add_to_resources();
 			static size_t get_amount();
 			static Font* get(int);
+			static Font* get_by_name(const std::string&);
+			static size_t get_name_handle(const std::string&);
+			static Font* get_by_handle(size_t);
 			int reset();
 			int print() const;
 
@@ -70,6 +90,7 @@ namespace bee {
 			int get_style() const;
 			int get_lineskip() const;
 			int get_lineskip_default();
+			bool get_is_atlas_enabled() const;
 			std::string get_fontname();
 
 			int set_name(const std::string&);
@@ -77,6 +98,7 @@ namespace bee {
 			int set_font_size(int);
 			int set_style(int);
 			int set_lineskip(int);
+			int set_is_atlas_enabled(bool);
 
 			int load();
 			int free();
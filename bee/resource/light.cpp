@@ -38,6 +38,7 @@ namespace bee {
 
 	std::map<int,Light*> Light::list;
 	int Light::next_id = 0;
+	NameIndex<Light> Light::names;
 
 	/*
 	* Light::Light() - Default construct the light
@@ -71,6 +72,7 @@ namespace bee {
 	* Light::~Light() - Remove the light from the resouce list
 	*/
 	Light::~Light() {
+		names.remove(name, this);
 		list.erase(id); // Remove the light from the resource list
 	}
 
@@ -81,6 +83,7 @@ namespace bee {
 		if (id < 0) { // If the resource needs to be added to the resource list
 			id = next_id++;
 			list.emplace(id, this); // Add the resource and with the new id
+			names.add(name, this);
 		}
 
 		return 0; // Return 0 on success
@@ -102,11 +105,32 @@ namespace bee {
 		return nullptr;
 	}
 	/*
+	* Light::get_by_name() - Return the light resource with the given name, or nullptr if there isn't one
+	* @name: the name of the desired light
+	*/
+	Light* Light::get_by_name(const std::string& name) {
+		return names.find(name);
+	}
+	/*
+	* Light::get_name_handle() - Return a handle for the given name which can be cached and passed to get_by_handle()
+	* @name: the name to get the handle of
+	*/
+	size_t Light::get_name_handle(const std::string& name) {
+		return names.get_handle(name);
+	}
+	/*
+	* Light::get_by_handle() - Return the light resource which currently has the name of the given handle, or nullptr if there isn't one
+	* @handle: the name handle
+	*/
+	Light* Light::get_by_handle(size_t handle) {
+		return names.get(handle);
+	}
+	/*
 	* Light::reset() - Reset all resource variables for reinitialization
 	*/
 	int Light::reset() {
 		// Reset all properties
-		name = "";
+		set_name("");
 		path = "";
 
 		lighting.type = E_LIGHT::AMBIENT;
@@ -190,6 +214,13 @@ namespace bee {
 	* Light::set_*() - Set the requested resource data
 	*/
 	int Light::set_name(const std::string& new_name) {
+		if (id >= 0) { // If the light is in the resource list, reindex it under the new name
+			names.remove(name, this);
+			name = new_name;
+			names.add(name, this);
+			return 0;
+		}
+
 		name = new_name;
 		return 0;
 	}
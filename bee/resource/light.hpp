@@ -19,6 +19,8 @@
 
 #include "resource.hpp"
 
+#include "../data/nameindex.hpp"
+
 #include "../enum.hpp"
 
 #include "../render/rgba.hpp"
@@ -39,9 +41,25 @@ namespace bee {
 		std::vector<glm::vec4> mask; // The mask for the object, relative to the position
 	};
 
+	struct LightUniform { // The std140 layout of a single light in the LightBlock uniform block
+		int type;
+		int padding[3];
+		glm::vec4 position;
+		glm::vec4 direction;
+		glm::vec4 attenuation;
+		glm::vec4 color; // The light color, normalized from 0.0 to 1.0
+	};
+	struct LightableUniform { // The std140 layout of a single lightable in the LightableBlock uniform block
+		glm::vec4 position;
+		int vertex_amount;
+		int padding[3];
+		glm::vec4 mask[BEE_MAX_MASK_VERTICES];
+	};
+
 	class Light: public Resource { // The light resource class is used to draw all lighting effects
 			static std::map<int,Light*> list;
 			static int next_id;
+			static NameIndex<Light> names; // The index of the resources by name
 
 			int id; // The id of the resource
 			std::string name; // An arbitrary name for the resource
@@ -57,6 +75,9 @@ namespace bee {
 			int add_to_resources();
 			static size_t get_amount();
 			static Light* get(int);
+			static Light* get_by_name(const std::string&);
+			static size_t get_name_handle(const std::string&);
+			static Light* get_by_handle(size_t);
 			int reset();
 			int print() const;
 
@@ -41,6 +41,7 @@
 namespace bee {
 	std::map<int,Mesh*> Mesh::list;
 	int Mesh::next_id = 0;
+	NameIndex<Mesh> Mesh::names;
 
 	/*
 	* Mesh::Mesh() - Default construct the mesh
@@ -65,6 +66,7 @@ namespace bee {
 		normals(nullptr),
 		uv_array(nullptr),
 		indices(nullptr),
+		texture_surface(nullptr),
 
 		vao(-1),
 		vbo_vertices(-1),
@@ -93,6 +95,7 @@ namespace bee {
 	*/
 	Mesh::~Mesh() {
 		this->free(); // Free all the mesh data
+		names.remove(name, this);
 		list.erase(id); // Remove the mesh from the resource list
 	}
 	/*
@@ -102,6 +105,7 @@ namespace bee {
 		if (id < 0) { // If the resource needs to be added to the resource list
 			id = next_id++;
 			list.emplace(id, this); // Add the resource and with the new id
+			names.add(name, this);
 		}
 
 		return 0; // Return 0 on success
@@ -123,13 +127,34 @@ namespace bee {
 		return nullptr;
 	}
 	/*
+	* Mesh::get_by_name() - Return the mesh resource with the given name, or nullptr if there isn't one
+	* @name: the name of the desired mesh
+	*/
+	Mesh* Mesh::get_by_name(const std::string& name) {
+		return names.find(name);
+	}
+	/*
+	* Mesh::get_name_handle() - Return a handle for the given name which can be cached and passed to get_by_handle()
+	* @name: the name to get the handle of
+	*/
+	size_t Mesh::get_name_handle(const std::string& name) {
+		return names.get_handle(name);
+	}
+	/*
+	* Mesh::get_by_handle() - Return the mesh resource which currently has the name of the given handle, or nullptr if there isn't one
+	* @handle: the name handle
+	*/
+	Mesh* Mesh::get_by_handle(size_t handle) {
+		return names.get(handle);
+	}
+	/*
 	* Mesh::reset() - Reset all resource variables for reinitialization
 	*/
 	int Mesh::reset() {
 		this->free(); // Free all memory used by this resource
 
 		// Reset all properties
-		name = "";
+		set_name("");
 		path = "";
 
 		// Reset mesh data
@@ -175,6 +200,13 @@ namespace bee {
 	* Mesh::set_*() - Set the requested resource data
 	*/
 	int Mesh::set_name(const std::string& new_name) {
+		if (id >= 0) { // If the mesh is in the resource list, reindex it under the new name
+			names.remove(name, this);
+			name = new_name;
+			names.add(name, this);
+			return 0;
+		}
+
 		name = new_name;
 		return 0;
 	}
@@ -184,14 +216,17 @@ namespace bee {
 	}
 
 	/*
-	* Mesh::load() - Load the desired mesh from its given filename
+	* Mesh::decode() - Import the desired mesh and its texture from the object file so that load() only has to upload them
+	* ! This doesn't make any OpenGL calls so it can be called from a loader thread
 	* @mesh_index: the desired mesh index from the imported scene
 	*/
-	int Mesh::load(int mesh_index) {
-		if (is_loaded) { // If the mesh has already been loaded, output a warning
-			messenger::send({"engine", "mesh"}, E_MESSAGE::WARNING, "Failed to load mesh \"" + name + "\" because it is already loaded");
+	int Mesh::decode(int mesh_index) {
+		if (is_loaded) { // Do not attempt to decode the mesh if it has already been loaded
 			return 1; // Return 1 when already loaded
 		}
+		if (scene != nullptr) {
+			return 0; // Return 0 when already decoded since load() can still upload it
+		}
 
 		if (get_options().is_headless) {
 			return 2; // Return 2 when in headless mode
@@ -244,6 +279,56 @@ namespace bee {
 			indices[i*3+2] = face.mIndices[2];
 		}
 
+		if (mesh->HasTextureCoords(0)) { // If the mesh has a texture, load it
+			material = scene->mMaterials[mesh->mMaterialIndex]; // Get the material for the mesh
+			aiString tex_path;
+			if (material->GetTexture(aiTextureType_DIFFUSE, 0, &tex_path, nullptr, nullptr, nullptr, nullptr, nullptr) == AI_SUCCESS) { // Attempt to fetch the texture's path into tex_path
+				std::string fullpath = "resources/meshes/" + std::string(tex_path.C_Str()); // Create the full path for the texture
+
+				// Attempt to load the texure as a surface
+				texture_surface = IMG_Load(fullpath.c_str());
+				if (texture_surface == nullptr) { // If the surface could not be loaded, output a warning
+					free_decoded();
+					messenger::send({"engine", "sprite"}, E_MESSAGE::WARNING, "Failed to load the texture for mesh \"" + name + "\": " + IMG_GetError());
+					return 4; // Return 4 on texture load failure
+				}
+			} else {
+				free_decoded();
+				messenger::send({"engine", "mesh"}, E_MESSAGE::WARNING, "Failed to load the texture for mesh \"" + name + "\", the material reported a texture with no file path");
+				return 5; // Return 5 on missing texture file
+			}
+		}
+
+		return 0; // Return 0 on success
+	}
+	/*
+	* Mesh::decode() - Import the first mesh from the object file
+	*/
+	int Mesh::decode() {
+		return decode(0); // Return the attempt to decode the first mesh in the scene
+	}
+	/*
+	* Mesh::load() - Load the desired mesh from its given filename
+	* ! If the mesh was already decoded by decode(), only the OpenGL buffers are created here
+	* @mesh_index: the desired mesh index from the imported scene
+	*/
+	int Mesh::load(int mesh_index) {
+		if (is_loaded) { // If the mesh has already been loaded, output a warning
+			messenger::send({"engine", "mesh"}, E_MESSAGE::WARNING, "Failed to load mesh \"" + name + "\" because it is already loaded");
+			return 1; // Return 1 when already loaded
+		}
+
+		if (get_options().is_headless) {
+			return 2; // Return 2 when in headless mode
+		}
+
+		if (scene == nullptr) {
+			int r = decode(mesh_index);
+			if (r != 0) {
+				return r; // Return 3, 4, or 5 on import failure
+			}
+		}
+
 		// Convert the data into an OpenGL format
 		glGenVertexArrays(1, &vao); // Generate the vertex object array
 		glBindVertexArray(vao);
@@ -274,48 +359,28 @@ namespace bee {
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
 		glBufferData(GL_ELEMENT_ARRAY_BUFFER, 3 * mesh->mNumFaces * sizeof(GLuint), indices, GL_STATIC_DRAW);
 
-		if (mesh->HasTextureCoords(0)) { // If the mesh has a texture, load it
-			material = scene->mMaterials[mesh->mMaterialIndex]; // Get the material for the mesh
-			aiString tex_path;
-			if (material->GetTexture(aiTextureType_DIFFUSE, 0, &tex_path, nullptr, nullptr, nullptr, nullptr, nullptr) == AI_SUCCESS) { // Attempt to fetch the texture's path into tex_path
-				std::string fullpath = "resources/meshes/" + std::string(tex_path.C_Str()); // Create the full path for the texture
-
-				// Attempt to load the texure as a temporary surface
-				SDL_Surface* tmp_surface;
-				tmp_surface = IMG_Load(fullpath.c_str());
-				if (tmp_surface == nullptr) { // If the surface could not be loaded, output a warning
-					free_internal();
-					messenger::send({"engine", "sprite"}, E_MESSAGE::WARNING, "Failed to load the texture for mesh \"" + name + "\": " + IMG_GetError());
-					return 4; // Return 4 on texture load failure
-				}
-
-				// Generate the texture from the surface pixels
-				glGenTextures(1, &gl_texture);
-				glBindTexture(GL_TEXTURE_2D, gl_texture);
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-				glTexImage2D(
-					GL_TEXTURE_2D,
-					0,
-					GL_RGBA,
-					tmp_surface->w,
-					tmp_surface->h,
-					0,
-					GL_RGBA,
-					GL_UNSIGNED_BYTE,
-					tmp_surface->pixels
-				);
-
-				SDL_FreeSurface(tmp_surface); // Free the temporary surface
-
-				// Set the texture boolean
-				has_texture = true;
-			} else {
-				glBindVertexArray(0); // Unbind the mesh vao
-
-				free_internal();
-				messenger::send({"engine", "mesh"}, E_MESSAGE::WARNING, "Failed to load the texture for mesh \"" + name + "\", the material reported a texture with no file path");
-				return 5; // Return 5 on missing texture file
-			}
+		if (texture_surface != nullptr) { // If the mesh has a texture, upload it
+			// Generate the texture from the surface pixels
+			glGenTextures(1, &gl_texture);
+			glBindTexture(GL_TEXTURE_2D, gl_texture);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTexImage2D(
+				GL_TEXTURE_2D,
+				0,
+				GL_RGBA,
+				texture_surface->w,
+				texture_surface->h,
+				0,
+				GL_RGBA,
+				GL_UNSIGNED_BYTE,
+				texture_surface->pixels
+			);
+
+			SDL_FreeSurface(texture_surface); // Free the decoded surface
+			texture_surface = nullptr;
+
+			// Set the texture boolean
+			has_texture = true;
 		}
 
 		glBindVertexArray(0); // Unbind the mesh vao
@@ -333,10 +398,10 @@ namespace bee {
 		return load(0); // Return the attempt to load the first mesh in the scene
 	}
 	/*
-	* Mesh::free_internal() - Free the mesh buffers and release the scene
-	* ! This function is only called directly if there was a failure in the middle of a call to load(), for all other cases use free()
+	* Mesh::free_decoded() - Free the arrays, texture surface, and scene import from decode()
+	* ! This doesn't make any OpenGL calls so it is used when decoding fails or when the mesh was decoded but never loaded
 	*/
-	int Mesh::free_internal() {
+	int Mesh::free_decoded() {
 		// Delete the vertex array
 		delete[] vertices;
 		delete[] normals;
@@ -347,6 +412,22 @@ namespace bee {
 		uv_array = nullptr;
 		indices = nullptr;
 
+		SDL_FreeSurface(texture_surface);
+		texture_surface = nullptr;
+
+		// Release the scene import
+		aiReleaseImport(scene);
+		scene = nullptr;
+		mesh = nullptr;
+		material = nullptr;
+
+		return 0; // Return 0 on success
+	}
+	/*
+	* Mesh::free_internal() - Free the mesh buffers and release the scene
+	* ! This function is only called directly if there was a failure in the middle of a call to load(), for all other cases use free()
+	*/
+	int Mesh::free_internal() {
 		// Delete the vertex buffers
 		glDeleteBuffers(1, &vbo_vertices);
 		glDeleteBuffers(1, &vbo_normals);
@@ -357,9 +438,8 @@ namespace bee {
 		glDeleteTextures(1, &gl_texture);
 		glDeleteVertexArrays(1, &vao);
 
-		// Finally, release the scene import
-		aiReleaseImport(scene);
-		scene = nullptr;
+		// Finally, delete the arrays and release the scene import
+		free_decoded();
 
 		// Reset the loaded booleans
 		has_texture = false;
@@ -372,7 +452,7 @@ namespace bee {
 	*/
 	int Mesh::free() {
 		if (!is_loaded) { // Do not attempt to free the buffers if the mesh hasn't been loaded
-			return 0; // Return 0 on success
+			return free_decoded(); // Return the attempt to free the data if it was decoded but never loaded
 		}
 
 		return free_internal(); // Return the attempt to free the mesh buffers
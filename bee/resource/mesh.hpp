@@ -17,12 +17,15 @@
 
 #include "resource.hpp"
 
+#include "../data/nameindex.hpp"
+
 #include "../render/rgba.hpp"
 
 namespace bee {
 	class Mesh: public Resource { // The mesh resource class is used to draw all 3D on-screen objects
 			static std::map<int,Mesh*> list;
 			static int next_id;
+			static NameIndex<Mesh> names; // The index of the resources by name
 
 			int id; // The id of the resource
 			std::string name; // An arbitrary name for the resource
@@ -40,6 +43,7 @@ namespace bee {
 			float* normals; // An array of the mesh's normals
 			float* uv_array; // An array of the mesh's UVs
 			unsigned int* indices; // An array of the mesh's indices
+			SDL_Surface* texture_surface; // The texture which was decoded by decode() and is waiting to be uploaded by load()
 
 			GLuint vao; // The Vertex Array Object which contains most of the following data
 			GLuint vbo_vertices; // The Vertex Buffer Object which contains the vertices of the faces
@@ -49,6 +53,7 @@ namespace bee {
 			GLuint gl_texture; // The internal texture storage for OpenGL mode
 
 			// See bee/resources/mesh.cpp for function comments
+			int free_decoded();
 			int free_internal();
 		public:
 			// See bee/resources/mesh.cpp for function comments
@@ -59,6 +64,9 @@ namespace bee {
 			int add_to_resources();
 			static size_t get_amount();
 			static Mesh* get(int);
+			static Mesh* get_by_name(const std::string&);
+			static size_t get_name_handle(const std::string&);
+			static Mesh* get_by_handle(size_t);
 			int reset();
 			int print() const;
 
@@ -70,6 +78,8 @@ namespace bee {
 			int set_name(const std::string&);
 			int set_path(const std::string&);
 
+			int decode(int);
+			int decode();
 			int load(int);
 			int load();
 			int free();
@@ -22,14 +22,17 @@
 #include "../messenger/messenger.hpp"
 
 #include "../core/instance.hpp"
+#include "../core/rooms.hpp"
 
 #include "../network/network.hpp"
 
 #include "texture.hpp"
+#include "room.hpp"
 
 namespace bee {
 	std::map<int,Object*> Object::list;
 	int Object::next_id = 0;
+	NameIndex<Object> Object::names;
 
 	/*
 	* Object::Object() - Default construct the object
@@ -51,6 +54,8 @@ namespace bee {
 		xoffset(0),
 		yoffset(0),
 		is_pausable(true),
+		is_batched(false),
+		is_step_reentrant(false),
 
 		instances(),
 		s(nullptr),
@@ -83,6 +88,7 @@ namespace bee {
 	* Object::~Object() - Remove the object from the resource list
 	*/
 	Object::~Object() {
+		names.remove(name, this);
 		list.erase(id); // Remove the object from the resource list
 	}
 
@@ -94,6 +100,7 @@ namespace bee {
 		if (id < 0) { // If the resource needs to be added to the resource list
 			id = next_id++;
 			list.emplace(id, this); // Add the resource and with the new id
+			names.add(name, this);
 		}
 
 		return 0; // Return 0 on success
@@ -115,11 +122,32 @@ namespace bee {
 		return nullptr;
 	}
 	/*
+	* Object::get_by_name() - Return the object resource with the given name, or nullptr if there isn't one
+	* @name: the name of the desired object
+	*/
+	Object* Object::get_by_name(const std::string& name) {
+		return names.find(name);
+	}
+	/*
+	* Object::get_name_handle() - Return a handle for the given name which can be cached and passed to get_by_handle()
+	* @name: the name to get the handle of
+	*/
+	size_t Object::get_name_handle(const std::string& name) {
+		return names.get_handle(name);
+	}
+	/*
+	* Object::get_by_handle() - Return the object resource which currently has the name of the given handle, or nullptr if there isn't one
+	* @handle: the name handle
+	*/
+	Object* Object::get_by_handle(size_t handle) {
+		return names.get(handle);
+	}
+	/*
 	* Object::reset() - Reset all resource variables for reinitialization
 	*/
 	int Object::reset() {
 		// Reset all properties
-		name = "";
+		set_name("");
 		path = "";
 		sprite = nullptr;
 		is_solid = false;
@@ -131,6 +159,8 @@ namespace bee {
 		xoffset = 0;
 		yoffset = 0;
 		is_pausable = true;
+		is_batched = false;
+		is_step_reentrant = false;
 
 		// Clear instance data
 		instances.clear();
@@ -173,6 +203,8 @@ namespace bee {
 		}
 		ss <<
 		"\n	is_pausable   " << is_pausable <<
+		"\n	is_batched    " << is_batched <<
+		"\n	is_step_reentrant " << is_step_reentrant <<
 		"\n	instances\n" << debug_indent(instance_string, 2) <<
 		"\n}\n";
 		messenger::send({"engine", "resource"}, E_MESSAGE::INFO, ss.str()); // Send the info to the messaging system for output
@@ -219,11 +251,24 @@ namespace bee {
 	bool Object::get_is_pausable() const {
 		return is_pausable;
 	}
+	bool Object::get_is_batched() const {
+		return is_batched;
+	}
+	bool Object::get_is_step_reentrant() const {
+		return is_step_reentrant;
+	}
 
 	/*
 	* Object::set_*() - Set the requested resource data
 	*/
 	int Object::set_name(const std::string& new_name) {
+		if (id >= 0) { // If the object is in the resource list, reindex it under the new name
+			names.remove(name, this);
+			name = new_name;
+			names.add(name, this);
+			return 0;
+		}
+
 		name = new_name;
 		return 0;
 	}
@@ -234,7 +279,7 @@ namespace bee {
 	int Object::set_sprite(Texture* new_sprite) {
 		sprite = new_sprite;
 		if (mask == nullptr) { // If there is no mask, set it to the new sprite
-			mask = new_sprite;
+			set_mask(new_sprite);
 		}
 		return 0;
 	}
@@ -265,6 +310,14 @@ namespace bee {
 	}
 	int Object::set_mask(Texture* new_mask) {
 		mask = new_mask;
+
+		// Update the collision grid since the size of every instance has changed
+		if (get_current_room() != nullptr) {
+			for (auto& i : instances) {
+				get_current_room()->update_instance_grid(i.second);
+			}
+		}
+
 		return 0;
 	}
 	int Object::set_mask_offset(const std::pair<int,int>& new_offset) {
@@ -280,6 +333,36 @@ namespace bee {
 		is_pausable = new_is_pausable;
 		return 0;
 	}
+	/*
+	* Object::set_is_batched() - Set whether the step events should be dispatched to all of the object's instances at once
+	* ! Batched instances are grouped at the position of the object's first instance in the depth order, so their depth is no longer interleaved with other objects
+	* @new_is_batched: whether to batch the step events
+	*/
+	int Object::set_is_batched(bool new_is_batched) {
+		if (is_batched != new_is_batched) {
+			is_batched = new_is_batched;
+			if (get_current_room() != nullptr) {
+				get_current_room()->sort_instances(); // Regroup the event lists
+			}
+		}
+		return 0;
+	}
+	/*
+	* Object::set_is_step_reentrant() - Set whether the step events can be run for multiple instances at once on the job threads
+	* ! Reentrant step events are called without update() so they must only use the given instance instead of s or current_instance,
+	*   they must not create instances or change other instances, and destroyed instances and grid updates are merged after all of them finish
+	* ! When there are no job threads, the object's instances are dispatched as if the object was batched
+	* @new_is_step_reentrant: whether the step events are reentrant
+	*/
+	int Object::set_is_step_reentrant(bool new_is_step_reentrant) {
+		if (is_step_reentrant != new_is_step_reentrant) {
+			is_step_reentrant = new_is_step_reentrant;
+			if (get_current_room() != nullptr) {
+				get_current_room()->sort_instances(); // Regroup the event lists
+			}
+		}
+		return 0;
+	}
 
 	/*
 	* Object::add_instance() - Add an instance of this object to its list
@@ -371,6 +454,29 @@ namespace bee {
 	void Object::step_begin(Instance* inst) {
 		inst->pos_previous = inst->get_position();
 	}
+	/*
+	* Object::step_*_batch() - Update all of the given instances for the step event when the object is batched
+	* ! Objects can override these to process their instances in a single loop without a virtual call for each instance
+	* @insts: the instances to update, sorted by depth
+	*/
+	void Object::step_begin_batch(const std::vector<Instance*>& insts) {
+		for (auto& inst : insts) {
+			update(inst);
+			step_begin(inst);
+		}
+	}
+	void Object::step_mid_batch(const std::vector<Instance*>& insts) {
+		for (auto& inst : insts) {
+			update(inst);
+			step_mid(inst);
+		}
+	}
+	void Object::step_end_batch(const std::vector<Instance*>& insts) {
+		for (auto& inst : insts) {
+			update(inst);
+			step_end(inst);
+		}
+	}
 }
 
 #endif // BEE_OBJECT
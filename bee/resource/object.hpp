@@ -12,14 +12,18 @@
 #include <string> // Include the required library headers
 #include <map>
 #include <set>
+#include <vector>
 
 #include <SDL2/SDL.h> // Include the required SDL headers
 
 #include "resource.hpp"
 
+#include "../data/nameindex.hpp"
+
 #include "../enum.hpp"
 
 #include "../data/sidp.hpp"
+#include "../data/datamap.hpp"
 
 namespace bee {
 	// Forward declarations
@@ -31,6 +35,7 @@ namespace bee {
 	class Object: public Resource { // The object resource class is used to handle all events and instance data
 			static std::map<int,Object*> list;
 			static int next_id;
+			static NameIndex<Object> names; // The index of the resources by name
 
 			int id; // The id of the resource
 			std::string name; // An arbitrary name for the resource
@@ -44,10 +49,12 @@ namespace bee {
 			Texture* mask; // An alternate texture to use as the object's collision mask
 			int xoffset, yoffset; // How far the sprite and mask should be offset from the object position
 			bool is_pausable; // Whether the object is pausable or not
+			bool is_batched; // Whether the step events should be dispatched once for all of the object's instances instead of once per instance
+			bool is_step_reentrant; // Whether the step events only modify the given instance so that they can be run on multiple threads at once
 
 			std::map<int,Instance*> instances; // A list of all the instances of this object type
 		protected:
-			std::map<std::string,SIDP>* s; // A pointer to the data map for the instance that is currently being processed
+			DataMap* s; // A pointer to the data map for the instance that is currently being processed
 			Instance* current_instance; // A pointer to the instance that is currently being processed
 
 			// See bee/resources/object.cpp for function comments
@@ -62,6 +69,9 @@ namespace bee {
 			int add_to_resources();
 			static size_t get_amount();
 			static Object* get(int);
+			static Object* get_by_name(const std::string&);
+			static size_t get_name_handle(const std::string&);
+			static Object* get_by_handle(size_t);
 			int reset();
 			int print() const;
 
@@ -77,6 +87,8 @@ namespace bee {
 			Texture* get_mask() const;
 			std::pair<int,int> get_mask_offset() const;
 			bool get_is_pausable() const;
+			bool get_is_batched() const;
+			bool get_is_step_reentrant() const;
 
 			int set_name(const std::string&);
 			int set_path(const std::string&);
@@ -90,6 +102,8 @@ namespace bee {
 			int set_mask_offset(const std::pair<int,int>&);
 			int set_mask_offset(int, int);
 			int set_is_pausable(bool);
+			int set_is_batched(bool);
+			int set_is_step_reentrant(bool);
 
 			int add_instance(int, Instance*);
 			int remove_instance(int);
@@ -106,6 +120,9 @@ namespace bee {
 			virtual void step_begin(Instance*);
 			virtual void step_mid(Instance*) {};
 			virtual void step_end(Instance*) {};
+			virtual void step_begin_batch(const std::vector<Instance*>&);
+			virtual void step_mid_batch(const std::vector<Instance*>&);
+			virtual void step_end_batch(const std::vector<Instance*>&);
 			virtual void keyboard_press(Instance*, SDL_Event*) {};
 			virtual void mouse_press(Instance*, SDL_Event*) {};
 			virtual void keyboard_input(Instance*, SDL_Event*) {};
@@ -27,6 +27,7 @@
 namespace bee {
 	std::map<int,Path*> Path::list;
 	int Path::next_id = 0;
+	NameIndex<Path> Path::names;
 
 	/*
 	* Path::Path() - Default construct the path
@@ -63,6 +64,7 @@ namespace bee {
 	* Path::~Path() - Remove the path from the resource list
 	*/
 	Path::~Path() {
+		names.remove(name, this);
 		list.erase(id); // Remove the path from the resource list
 	}
 
@@ -73,6 +75,7 @@ namespace bee {
 		if (id < 0) { // If the resource needs to be added to the resource list
 			id = next_id++;
 			list.emplace(id, this); // Add the resource and with the new id
+			names.add(name, this);
 		}
 
 		return 0; // Return 0 on success
@@ -94,11 +97,32 @@ namespace bee {
 		return nullptr;
 	}
 	/*
+	* Path::get_by_name() - Return the path resource with the given name, or nullptr if there isn't one
+	* @name: the name of the desired path
+	*/
+	Path* Path::get_by_name(const std::string& name) {
+		return names.find(name);
+	}
+	/*
+	* Path::get_name_handle() - Return a handle for the given name which can be cached and passed to get_by_handle()
+	* @name: the name to get the handle of
+	*/
+	size_t Path::get_name_handle(const std::string& name) {
+		return names.get_handle(name);
+	}
+	/*
+	* Path::get_by_handle() - Return the path resource which currently has the name of the given handle, or nullptr if there isn't one
+	* @handle: the name handle
+	*/
+	Path* Path::get_by_handle(size_t handle) {
+		return names.get(handle);
+	}
+	/*
 	* Path::reset() - Reset all resource variables for reinitialization
 	*/
 	int Path::reset() {
 		// Reset all properties
-		name = "";
+		set_name("");
 		path = "";
 		coordinate_list.clear();
 		is_curved = false;
@@ -172,6 +196,13 @@ namespace bee {
 	* Path::set_*() - Set the requested resource data
 	*/
 	int Path::set_name(const std::string& new_name) {
+		if (id >= 0) { // If the path is in the resource list, reindex it under the new name
+			names.remove(name, this);
+			name = new_name;
+			names.add(name, this);
+			return 0;
+		}
+
 		name = new_name;
 		return 0;
 	}
@@ -15,12 +15,15 @@
 
 #include "resource.hpp"
 
+#include "../data/nameindex.hpp"
+
 namespace bee {
 	typedef std::tuple<double, double, double, double> path_coord_t; // {x, y, z, speed}
 
 	class Path: public Resource { // The path resource class is used to repeatedly move instances in complex, predefined patterns
 			static std::map<int,Path*> list;
 			static int next_id;
+			static NameIndex<Path> names; // The index of the resources by name
 
 			int id; // The id of the resource
 			std::string name; // An arbitrary name for the resource
@@ -37,6 +40,9 @@ namespace bee {
 			int add_to_resources();
 			static size_t get_amount();
 			static Path* get(int);
+			static Path* get_by_name(const std::string&);
+			static size_t get_name_handle(const std::string&);
+			static Path* get_by_handle(size_t);
 			int reset();
 			int print() const;
 
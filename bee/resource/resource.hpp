@@ -17,6 +17,7 @@ namespace bee {
 			virtual int print() const =0;
 			virtual int get_id() const =0;
 			virtual std::string get_name() const {return "";}
+			virtual int decode() {return 0;} // Read and decode the resource's files without touching the renderer, which is safe to call from a loader thread
 			virtual int load() {return 0;}
 			virtual int free() {return 0;}
 	};
@@ -15,7 +15,6 @@
 #include <fstream>
 #include <algorithm>
 #include <set>
-#include <iterator>
 
 #include <glm/gtc/type_ptr.hpp> // Include the required OpenGL headers
 
@@ -34,8 +33,11 @@
 
 #include "../messenger/messenger.hpp"
 
+#include "../data/instancemap.hpp"
+
 #include "../core/console.hpp"
 #include "../core/enginestate.hpp"
+#include "../core/jobs.hpp"
 #include "../core/resources.hpp"
 #include "../core/rooms.hpp"
 
@@ -56,12 +58,6 @@
 #include "object.hpp"
 
 namespace bee {
-	namespace internal {
-		std::pair<Instance*,int> flip_instancemap_pair(const std::pair<int,Instance*>& p) {
-			return std::pair<Instance*,int>(p.second, p.first);
-		}
-	}
-
 	/*
 	* BackgroundData::BackgroundData() - Construct the data struct and initiliaze all values
 	*/
@@ -81,6 +77,208 @@ namespace bee {
 		transform(_x, _y, _is_horizontal_tile, _is_vertical_tile, _horizontal_speed, _vertical_speed, _is_stretched)
 	{}
 
+	/*
+	* SortedInstance::SortedInstance() - Construct the data struct and initiliaze all values
+	*/
+	SortedInstance::SortedInstance() :
+		inst(nullptr),
+		depth(0),
+		id(-1)
+	{}
+	/*
+	* SortedInstance::SortedInstance() - Construct the data struct with the current depth and id of the given instance
+	* @_inst: the instance to sort
+	*/
+	SortedInstance::SortedInstance(Instance* _inst) :
+		inst(_inst),
+		depth(_inst->depth),
+		id(_inst->id)
+	{}
+	/*
+	* SortedInstance::operator<() - Compare the stored values in the same order as Instance::operator<()
+	* ! The stored values are used instead of the instance's values so that the list stays sorted when instances are removed or their depth changes
+	* @rhs: the other instance to compare against
+	*/
+	bool SortedInstance::operator<(const SortedInstance& rhs) const {
+		if (depth == rhs.depth) {
+			return (id < rhs.id);
+		}
+		return (depth > rhs.depth);
+	}
+
+	/*
+	* InstanceGroup::InstanceGroup() - Construct the data struct and initialize all values
+	*/
+	InstanceGroup::InstanceGroup() :
+		object(nullptr),
+		index(0),
+		indices()
+	{}
+	/*
+	* InstanceGroup::InstanceGroup() - Construct the data struct with the given object and first index
+	* @_object: the batched object, or nullptr for an unbatched instance
+	* @_index: the index of the first instance in the sorted list
+	*/
+	InstanceGroup::InstanceGroup(Object* _object, size_t _index) :
+		object(_object),
+		index(_index),
+		indices()
+	{
+		if (object != nullptr) {
+			indices.push_back(index);
+		}
+	}
+
+	/*
+	* InstanceList::InstanceList() - Construct the empty list
+	*/
+	InstanceList::InstanceList() :
+		sorted(),
+		pending(),
+		removed_amount(0),
+		should_resort(false),
+		groups(),
+		should_regroup(false)
+	{}
+	/*
+	* InstanceList::add() - Queue the given instance to be merged into the list when it is next sorted
+	* ! The instance is not added immediately so that instances can be created while the list is being iterated
+	* @inst: the instance to add
+	*/
+	int InstanceList::add(Instance* inst) {
+		pending.emplace_back(inst);
+		return 0;
+	}
+	/*
+	* InstanceList::remove() - Remove the given instance from the list
+	* ! Instances in the sorted list are replaced with nullptr so that the list can be safely modified while it's being iterated
+	* @inst: the instance to remove
+	*/
+	int InstanceList::remove(Instance* inst) {
+		for (auto it=pending.begin(); it!=pending.end(); ++it) {
+			if (it->inst == inst) {
+				pending.erase(it);
+				return 0;
+			}
+		}
+
+		// Search using the instance's current depth, falling back to a linear search if it has changed since the last sort
+		auto it = std::lower_bound(sorted.begin(), sorted.end(), SortedInstance(inst));
+		if ((it == sorted.end())||(it->inst != inst)) {
+			it = std::find_if(sorted.begin(), sorted.end(), [inst] (const SortedInstance& s) {
+				return (s.inst == inst);
+			});
+			if (it == sorted.end()) {
+				return 1; // Return 1 when the instance is not in the list
+			}
+		}
+
+		it->inst = nullptr;
+		++removed_amount;
+
+		return 0;
+	}
+	/*
+	* InstanceList::clear() - Remove all instances from the list
+	*/
+	int InstanceList::clear() {
+		sorted.clear();
+		pending.clear();
+		removed_amount = 0;
+		should_resort = false;
+		groups.clear();
+		should_regroup = false;
+		return 0;
+	}
+	/*
+	* InstanceList::request_sort() - Resort every instance with its current depth the next time the list is used
+	*/
+	int InstanceList::request_sort() {
+		should_resort = true;
+		return 0;
+	}
+	/*
+	* InstanceList::sort() - Compact the removed instances and merge the pending instances into the sorted list
+	*/
+	int InstanceList::sort() {
+		if (removed_amount > 0) {
+			sorted.erase(std::remove_if(sorted.begin(), sorted.end(), [] (const SortedInstance& s) {
+				return (s.inst == nullptr);
+			}), sorted.end());
+			removed_amount = 0;
+		}
+
+		if (should_resort) { // Update the stored depth of every instance and resort them all
+			for (auto& s : sorted) {
+				s = SortedInstance(s.inst);
+			}
+			sorted.insert(sorted.end(), pending.begin(), pending.end());
+			std::sort(sorted.begin(), sorted.end());
+
+			should_resort = false;
+		} else if (!pending.empty()) { // Otherwise only sort the new instances and merge them in
+			std::sort(pending.begin(), pending.end());
+
+			size_t middle = sorted.size();
+			sorted.insert(sorted.end(), pending.begin(), pending.end());
+			std::inplace_merge(sorted.begin(), sorted.begin()+middle, sorted.end());
+		}
+		pending.clear();
+		should_regroup = true;
+
+		return 0;
+	}
+	/*
+	* InstanceList::size() - Return the amount of instances in the list
+	*/
+	size_t InstanceList::size() const {
+		return sorted.size() - removed_amount + pending.size();
+	}
+	/*
+	* InstanceList::get() - Sort the list if necessary and return it
+	* ! The returned list may contain removed instances as nullptr
+	*/
+	const std::vector<SortedInstance>& InstanceList::get() {
+		if ((removed_amount > 0)||(!pending.empty())||(should_resort)) {
+			sort();
+		}
+		return sorted;
+	}
+	/*
+	* InstanceList::get_groups() - Sort the list if necessary and return it split into groups for batched event dispatch
+	* ! Unbatched instances each get their own group so that they keep their depth order,
+	*   while each batched or reentrant object gets a single group at the position of its first instance
+	* ! The groups store indices into the sorted list, which should be checked for removed instances
+	*/
+	const std::vector<InstanceGroup>& InstanceList::get_groups() {
+		get();
+
+		if (should_regroup) {
+			groups.clear();
+
+			std::map<Object*,size_t> batches; // A map of batched objects with the index of their group
+			for (size_t i=0; i<sorted.size(); ++i) {
+				Object* obj = sorted[i].inst->get_object();
+				if ((!obj->get_is_batched())&&(!obj->get_is_step_reentrant())) {
+					groups.emplace_back(nullptr, i);
+					continue;
+				}
+
+				auto b = batches.find(obj);
+				if (b == batches.end()) {
+					batches.emplace(obj, groups.size());
+					groups.emplace_back(obj, i);
+				} else {
+					groups[b->second].indices.push_back(i);
+				}
+			}
+
+			should_regroup = false;
+		}
+
+		return groups;
+	}
+
 	const std::list<E_EVENT> Room::event_list = {
 		E_EVENT::CREATE,
 		E_EVENT::DESTROY,
@@ -115,6 +313,7 @@ namespace bee {
 
 	std::map<int,Room*> Room::list;
 	int Room::next_id = 0;
+	NameIndex<Room> Room::names;
 
 	Room::Room() :
 		Resource(),
@@ -138,6 +337,9 @@ namespace bee {
 		created_instances(),
 		destroyed_instances(),
 		should_sort(false),
+		instance_grid(),
+		is_step_parallel(false),
+		destroy_mutex(),
 
 		instances_sorted_events(),
 
@@ -145,6 +347,8 @@ namespace bee {
 
 		lights(),
 		lightables(),
+		light_uniforms(),
+		lightable_uniforms(),
 		light_map(nullptr),
 
 		physics_world(nullptr),
@@ -176,6 +380,7 @@ namespace bee {
 
 		instances.clear();
 		instances_sorted.clear();
+		instance_grid.clear();
 		particle_systems.clear();
 		destroyed_instances.clear();
 		instances_sorted_events.clear();
@@ -191,6 +396,7 @@ namespace bee {
 			physics_world = nullptr;
 		}
 
+		names.remove(name, this);
 		list.erase(id); // Remove the room from the resource list
 	}
 
@@ -198,6 +404,7 @@ namespace bee {
 		if (id < 0) { // If the resource needs to be added to the resource list
 			id = next_id++;
 			list.emplace(id, this); // Add the resource and with the new id
+			names.add(name, this);
 		}
 
 		return 0;
@@ -218,8 +425,29 @@ namespace bee {
 		}
 		return nullptr;
 	}
+	/*
+	* Room::get_by_name() - Return the room resource with the given name, or nullptr if there isn't one
+	* @name: the name of the desired room
+	*/
+	Room* Room::get_by_name(const std::string& name) {
+		return names.find(name);
+	}
+	/*
+	* Room::get_name_handle() - Return a handle for the given name which can be cached and passed to get_by_handle()
+	* @name: the name to get the handle of
+	*/
+	size_t Room::get_name_handle(const std::string& name) {
+		return names.get_handle(name);
+	}
+	/*
+	* Room::get_by_handle() - Return the room resource which currently has the name of the given handle, or nullptr if there isn't one
+	* @handle: the name handle
+	*/
+	Room* Room::get_by_handle(size_t handle) {
+		return names.get(handle);
+	}
 	int Room::reset() {
-		name = "";
+		set_name("");
 		path = "";
 		width = DEFAULT_WINDOW_WIDTH;
 		height = DEFAULT_WINDOW_HEIGHT;
@@ -241,6 +469,7 @@ namespace bee {
 		}
 		instances.clear();
 		instances_sorted.clear();
+		instance_grid.clear();
 		created_instances.clear();
 		destroyed_instances.clear();
 		instances_sorted_events.clear();
@@ -371,18 +600,42 @@ namespace bee {
 	const std::map<int,Instance*>& Room::get_instances() const {
 		return instances;
 	}
+	/*
+	* Room::get_instances_near() - Return the instances whose collision grid cells overlap the given rectangle
+	* ! The returned instances are only candidates and should still be checked with check_collision()
+	* @rect: the rectangle to search
+	*/
+	std::vector<Instance*> Room::get_instances_near(const SDL_Rect& rect) const {
+		std::vector<int> ids;
+		instance_grid.query(rect, ids);
+
+		std::vector<Instance*> near_instances;
+		near_instances.reserve(ids.size());
+		for (auto& id : ids) {
+			auto it = instances.find(id);
+			if (it != instances.end()) {
+				near_instances.push_back(it->second);
+			}
+		}
+
+		return near_instances;
+	}
 	std::string Room::get_instance_string() const {
 		if (instances.size() > 0) {
 			std::vector<std::vector<std::string>> table;
 			table.push_back({"(id", "object", "x", "y", "z)"});
 
-			for (auto& i : instances_sorted) {
+			InstanceList sorted_instances (instances_sorted); // Copy the list since sorting it would modify the room
+			for (auto& i : sorted_instances.get()) {
+				if (i.inst == nullptr) {
+					continue;
+				}
 				table.push_back({
-					bee_itos(i.first->id),
-					i.first->get_object()->get_name(),
-					bee_itos(static_cast<int>(i.first->get_x())),
-					bee_itos(static_cast<int>(i.first->get_y())),
-					bee_itos(static_cast<int>(i.first->get_z()))
+					bee_itos(i.inst->id),
+					i.inst->get_object()->get_name(),
+					bee_itos(static_cast<int>(i.inst->get_x())),
+					bee_itos(static_cast<int>(i.inst->get_y())),
+					bee_itos(static_cast<int>(i.inst->get_z()))
 				});
 			}
 
@@ -401,6 +654,13 @@ namespace bee {
 	}
 
 	int Room::set_name(const std::string& new_name) {
+		if (id >= 0) { // If the room is in the resource list, reindex it under the new name
+			names.remove(name, this);
+			name = new_name;
+			names.add(name, this);
+			return 0;
+		}
+
 		name = new_name;
 		return 0;
 	}
@@ -469,6 +729,8 @@ namespace bee {
 			remove_instance(index);
 		}
 		instances.insert(std::pair<int,Instance*>(index, new_instance));
+		instances_sorted.add(new_instance);
+		instance_grid.update(index, new_instance->get_aabb());
 		return 0;
 	}
 	Instance* Room::add_instance(int index, Object* object, double x, double y, double z) {
@@ -491,11 +753,10 @@ namespace bee {
 
 		Instance* new_instance = new Instance(index, object, x, y, z);
 		set_instance(index, new_instance);
-		sort_instances();
 		object->add_instance(index, new_instance);
 
 		for (E_EVENT e : object->implemented_events) {
-			instances_sorted_events[e].emplace(new_instance, new_instance->id);
+			instances_sorted_events[e].add(new_instance);
 		}
 
 		if (new_instance->get_physbody() != nullptr) {
@@ -548,10 +809,11 @@ namespace bee {
 
 			inst->get_object()->remove_instance(index);
 			instances.erase(index);
-			instances_sorted.erase(inst);
+			instances_sorted.remove(inst);
+			instance_grid.remove(index);
 
 			for (E_EVENT e : inst->get_object()->implemented_events) {
-				instances_sorted_events[e].erase(inst);
+				instances_sorted_events[e].remove(inst);
 			}
 
 			delete inst;
@@ -560,8 +822,52 @@ namespace bee {
 		}
 		return 1;
 	}
+	/*
+	* Room::update_instance_grid() - Update the bounding box of the given instance in the collision grid
+	* ! This should be called whenever an instance is moved outside of the physics simulation
+	* @inst: the instance to update
+	*/
+	int Room::update_instance_grid(Instance* inst) {
+		if (is_step_parallel) {
+			return 2; // Return 2 when reentrant step events are running, the instance will be updated after they finish
+		}
+
+		auto it = instances.find(inst->id);
+		if ((it == instances.end())||(it->second != inst)) {
+			return 1; // Return 1 when the instance is not in this room
+		}
+
+		instance_grid.update(inst->id, inst->get_aabb());
+
+		return 0;
+	}
+	/*
+	* Room::update_instance_grid() - Update the bounding boxes of the instances which use the given texture as their mask
+	* ! This should be called when a texture finishes loading since masks have no size until then, e.g. when they are loaded lazily
+	* @mask: the texture which was loaded
+	*/
+	int Room::update_instance_grid(const Texture* mask) {
+		if (is_step_parallel) {
+			return 2; // Return 2 when reentrant step events are running
+		}
+
+		for (auto& i : instances) {
+			if (i.second->get_object()->get_mask() == mask) {
+				instance_grid.update(i.first, i.second->get_aabb());
+			}
+		}
+
+		return 0;
+	}
+	/*
+	* Room::sort_instances() - Resort all instance lists the next time they are iterated
+	* ! This should be called after an instance's depth has changed
+	*/
 	int Room::sort_instances() {
-		std::transform(instances.begin(), instances.end(), std::inserter(instances_sorted, instances_sorted.begin()), internal::flip_instancemap_pair);
+		instances_sorted.request_sort();
+		for (auto& event_list : instances_sorted_events) {
+			event_list.second.request_sort();
+		}
 		return 0;
 	}
 	int Room::request_instance_sort() {
@@ -594,48 +900,71 @@ namespace bee {
 		lights.push_back(lighting);
 		return 0;
 	}
+	/*
+	* Room::handle_lights() - Upload the queued lights and lightables to their uniform buffers and reset them
+	* ! The block headers hold the amounts and are padded to 16 bytes, followed by the arrays in the std140 layout of LightUniform and LightableUniform
+	*/
 	int Room::handle_lights() {
-		int i = 0;
+		if (!engine->renderer->is_lighting_enabled) {
+			reset_lights();
+			return 1; // Return 1 when the shaders don't support lighting
+		}
+
+		lightable_uniforms.clear();
 		for (auto& l : lightables) {
-			if (i >= BEE_MAX_LIGHTABLES) {
+			if (lightable_uniforms.size() >= BEE_MAX_LIGHTABLES) {
 				break;
 			}
 
-			glUniform4fv(render::get_program()->get_location("lightable[" + bee_itos(i) + "].position"), 1, glm::value_ptr(l->position));
+			LightableUniform lu;
+			lu.position = l->position;
 			int j = 0;
 			for (auto& v : l->mask) {
 				if (j >= BEE_MAX_MASK_VERTICES) {
 					break;
 				}
 
-				glUniform4fv(render::get_program()->get_location("lightable[" + bee_itos(i) + "].mask[" + bee_itos(j) + "]"), 1, glm::value_ptr(v));
+				lu.mask[j] = v;
 
 				j++;
 			}
-			glUniform1i(render::get_program()->get_location("lightable[" + bee_itos(i) + "].vertex_amount"), j);
+			lu.vertex_amount = j;
 
-			i++;
+			lightable_uniforms.push_back(lu);
 		}
-		glUniform1i(render::get_program()->get_location("lightable_amount"), i);
 
-		i = 0;
+		light_uniforms.clear();
 		for (auto& l : lights) {
-			if (i >= BEE_MAX_LIGHTS) {
+			if (light_uniforms.size() >= BEE_MAX_LIGHTS) {
 				break;
 			}
 
-			glm::vec4 c (l.color.r, l.color.g, l.color.b, l.color.a);
-			c /= 255.0f;
+			LightUniform lu;
+			lu.type = static_cast<int>(l.type);
+			lu.position = l.position;
+			lu.direction = l.direction;
+			lu.attenuation = l.attenuation;
+			lu.color = glm::vec4(l.color.r, l.color.g, l.color.b, l.color.a);
+			lu.color /= 255.0f;
 
-			glUniform1i(render::get_program()->get_location("lighting[" + bee_itos(i) + "].type"), static_cast<int>(l.type));
-			glUniform4fv(render::get_program()->get_location("lighting[" + bee_itos(i) + "].position"), 1, glm::value_ptr(l.position));
-			glUniform4fv(render::get_program()->get_location("lighting[" + bee_itos(i) + "].direction"), 1, glm::value_ptr(l.direction));
-			glUniform4fv(render::get_program()->get_location("lighting[" + bee_itos(i) + "].attenuation"), 1, glm::value_ptr(l.attenuation));
-			glUniform4fv(render::get_program()->get_location("lighting[" + bee_itos(i) + "].color"), 1, glm::value_ptr(c));
+			light_uniforms.push_back(lu);
+		}
 
-			i++;
+		GLint amount = lightable_uniforms.size();
+		glBindBuffer(GL_UNIFORM_BUFFER, engine->renderer->lightable_ubo);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(GLint), &amount);
+		if (!lightable_uniforms.empty()) {
+			glBufferSubData(GL_UNIFORM_BUFFER, 4*sizeof(GLint), lightable_uniforms.size()*sizeof(LightableUniform), lightable_uniforms.data());
 		}
-		glUniform1i(render::get_program()->get_location("light_amount"), i);
+
+		amount = light_uniforms.size();
+		glBindBuffer(GL_UNIFORM_BUFFER, engine->renderer->light_ubo);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(GLint), &amount);
+		if (!light_uniforms.empty()) {
+			glBufferSubData(GL_UNIFORM_BUFFER, 4*sizeof(GLint), light_uniforms.size()*sizeof(LightUniform), light_uniforms.data());
+		}
+
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
 
 		reset_lights();
 
@@ -650,8 +979,17 @@ namespace bee {
 		return 0;
 	}
 	int Room::clear_lights() {
-		glUniform1i(render::get_program()->get_location("lightable_amount"), 0);
-		glUniform1i(render::get_program()->get_location("light_amount"), 0);
+		if (!engine->renderer->is_lighting_enabled) {
+			return 1; // Return 1 when the shaders don't support lighting
+		}
+
+		const GLint amount = 0;
+		glBindBuffer(GL_UNIFORM_BUFFER, engine->renderer->lightable_ubo);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(GLint), &amount);
+		glBindBuffer(GL_UNIFORM_BUFFER, engine->renderer->light_ubo);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(GLint), &amount);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
 		return 0;
 	}
 
@@ -665,29 +1003,19 @@ namespace bee {
 		// Remove all instances except persistent instances
 		for (auto it=instances.begin(); it!=instances.end(); ) {
 			if (!it->second->get_is_persistent()) {
+				instances_sorted.remove(it->second);
+				for (E_EVENT e : it->second->get_object()->implemented_events) {
+					instances_sorted_events[e].remove(it->second);
+				}
+				instance_grid.remove(it->first);
+
 				it = instances.erase(it);
 			} else {
 				++it;
 			}
 		}
-		for (auto it=instances_sorted.begin(); it!=instances_sorted.end(); ) {
-			if (!it->first->get_is_persistent()) {
-				it = instances_sorted.erase(it);
-			} else {
-				++it;
-			}
-		}
 		created_instances.clear();
 		next_instance_id = 0;
-		for (auto& event_map : instances_sorted_events) {
-			for (auto it=event_map.second.begin(); it!=event_map.second.end(); ) {
-				if (!it->first->get_is_persistent()) {
-					it = event_map.second.erase(it);
-				} else {
-					++it;
-				}
-			}
-		}
 
 		lights.clear();
 		if (light_map != nullptr) {
@@ -722,11 +1050,10 @@ namespace bee {
 			int index = next_instance_id++;
 			Instance* inst_control = new Instance(index, obj_control, 0.0, 0.0, 0.0);
 			set_instance(index, inst_control);
-			sort_instances();
 			obj_control->add_instance(index, inst_control);
 
 			for (E_EVENT e : obj_control->implemented_events) {
-				instances_sorted_events[e].emplace(inst_control, inst_control->id);
+				instances_sorted_events[e].add(inst_control);
 			}
 
 			created_instances.push_back(inst_control);
@@ -742,6 +1069,7 @@ namespace bee {
 
 		instances.clear();
 		instances_sorted.clear();
+		instance_grid.clear();
 		instances_sorted_events.clear();
 
 		for (auto& inst : old_instances) {
@@ -755,10 +1083,9 @@ namespace bee {
 			}
 
 			for (E_EVENT e : inst.second->get_object()->implemented_events) {
-				instances_sorted_events[e].emplace(inst.second, inst.first);
+				instances_sorted_events[e].add(inst.second);
 			}
 		}
-		sort_instances();
 
 		return 0;
 	}
@@ -775,6 +1102,12 @@ namespace bee {
 		savefile.close();
 		return 0;
 	}
+	/*
+	* Room::load_instance_map() - Add the instances from the given instance map, which may be either a text or binary map
+	* ! Each object in the map is only looked up once and then its instances are added in bulk
+	* ! Instances from !set blocks are added at their place in the file so that the instance ids and event order match the text
+	* @fname: the path of the instance map
+	*/
 	int Room::load_instance_map(const std::string& fname) {
 		if (get_is_ready()) {
 			instance_map = fname;
@@ -782,13 +1115,49 @@ namespace bee {
 			return 0;
 		}
 
-		std::string datastr = file_get_contents(fname);
-		if (datastr.empty()) {
+		InstanceMap map;
+		if (map.load(fname)) {
+			messenger::send({"engine", "room"}, E_MESSAGE::WARNING, "Failed to load instance map \"" + fname + "\"");
+			return 1; // Return 1 when the instance map could not be loaded
+		}
+		if ((map.get_amount() == 0)&&(map.sets.empty())) {
 			messenger::send({"engine", "room"}, E_MESSAGE::WARNING, "No instances loaded");
 			return 1;
 		}
 
-		std::istringstream data_stream (datastr);
+		std::vector<Object*> objects;
+		objects.reserve(map.objects.size());
+		for (auto& o : map.objects) {
+			Object* object = get_object_by_name(o);
+			if (object == nullptr) {
+				messenger::send({"engine", "room"}, E_MESSAGE::WARNING, "Error while loading instance map: unknown object " + o);
+			}
+			objects.push_back(object);
+		}
+
+		size_t set = 0;
+		for (size_t i=0; i<map.get_amount(); ++i) {
+			for (; (set < map.sets.size())&&(map.set_positions[set] <= i); ++set) { // Add the !set blocks which came before this instance
+				load_instance_map_sets(map.sets[set]);
+			}
+
+			Object* object = objects[map.object_ids[i]];
+			if (object != nullptr) {
+				add_instance(-1, object, map.x[i], map.y[i], map.z[i]);
+			}
+		}
+		for (; set < map.sets.size(); ++set) {
+			load_instance_map_sets(map.sets[set]);
+		}
+
+		return 0;
+	}
+	/*
+	* Room::load_instance_map_sets() - Add the instances from the given !set blocks of an instance map
+	* @data: the text of the !set blocks
+	*/
+	int Room::load_instance_map_sets(const std::string& data) {
+		std::istringstream data_stream (data);
 
 		while (!data_stream.eof()) {
 			std::string tmp;
@@ -806,131 +1175,55 @@ namespace bee {
 				}
 			}
 			p.clear();
-			std::string v = params[0];
-
-			if (params[0][0] == '#') {
+			if (params[0] != "!set") {
 				continue;
-			} else if (params[0][0] == '!') {
-				if (v == "!tilex") {
-					unsigned int tile_amount = std::stoi(params[1]);
-					double grid_x = std::stod(params[2]);
+			}
 
-					std::string o = params[3];
-					Object* object = get_object_by_name(o);
+			std::string o = params[1];
+			Object* object = get_object_by_name(o);
+			if (object == nullptr) {
+				messenger::send({"engine", "room"}, E_MESSAGE::WARNING, "Error while loading instance map: unknown object " + o);
+				continue;
+			}
 
-					if (object == nullptr) {
-						messenger::send({"engine", "room"}, E_MESSAGE::WARNING, "Error while loading instance map: unknown object " + o);
-						continue;
-					}
+			double x = std::stod(params[2]);
+			double y = std::stod(params[3]);
+			double z = std::stod(params[4]);
 
-					double x = std::stod(params[4]);
-					double y = std::stod(params[5]);
-					double z = std::stod(params[6]);
+			Instance* inst = add_instance(-1, object, x, y, z);
 
-					for (size_t i=0; i<tile_amount; ++i) {
-						add_instance(-1, object, x + i*grid_x, y, z);
-					}
+			while (!data_stream.eof()) {
+				std::string tmp_set;
+				getline(data_stream, tmp_set);
 
+				if (tmp_set.empty()) {
 					continue;
-				} else if (v == "!tiley") {
-					unsigned int tile_amount = std::stoi(params[1]);
-					double grid_y = std::stod(params[2]);
-
-					std::string o = params[3];
-					Object* object = get_object_by_name(o);
-
-					if (object == nullptr) {
-						messenger::send({"engine", "room"}, E_MESSAGE::WARNING, "Error while loading instance map: unknown object " + o);
-						continue;
-					}
-
-					double x = std::stod(params[4]);
-					double y = std::stod(params[5]);
-					double z = std::stod(params[6]);
+				}
 
-					for (size_t i=0; i<tile_amount; ++i) {
-						add_instance(-1, object, x, y + i*grid_y, z);
+				std::map<int,std::string> sp = split(trim(tmp_set), '\t');
+				std::map<int,std::string> set_params;
+				for (auto& e : sp) { // Remove empty values
+					if (!e.second.empty()) {
+						set_params.emplace(set_params.size(), e.second);
 					}
-
-					continue;
-				} else if (v == "!tilez") {
-					unsigned int tile_amount = std::stoi(params[1]);
-					double grid_z = std::stod(params[2]);
-
-					std::string o = params[3];
-					Object* object = get_object_by_name(o);
-
-					if (object == nullptr) {
-						messenger::send({"engine", "room"}, E_MESSAGE::WARNING, "Error while loading instance map: unknown object " + o);
+				}
+				sp.clear();
+
+				if (set_params[0][0] == '@') {
+					if (set_params[0] == "@sprite") {
+						inst->set_sprite(get_texture_by_name(set_params[1]));
+					} else if (set_params[0] == "@solid") {
+						inst->set_is_solid(SIDP_i(SIDP(set_params[1])));
+					} else if (set_params[0] == "@depth") {
+						inst->depth = SIDP_i(SIDP(set_params[1]));
+					} else {
+						messenger::send({"engine", "room"}, E_MESSAGE::WARNING, "Error while loading instance map: unknown setter \"" + set_params[0] + "\"");
 						continue;
 					}
-
-					double x = std::stod(params[4]);
-					double y = std::stod(params[5]);
-					double z = std::stod(params[6]);
-
-					for (size_t i=0; i<tile_amount; ++i) {
-						add_instance(-1, object, x, y, z + i*grid_z);
-					}
-
-					continue;
-				} else if (v == "!set") {
-					std::string o = params[1];
-					Object* object = get_object_by_name(o);
-
-					double x = std::stod(params[2]);
-					double y = std::stod(params[3]);
-					double z = std::stod(params[4]);
-
-					Instance* inst = add_instance(-1, object, x, y, z);
-
-					while (!data_stream.eof()) {
-						std::string tmp_set;
-						getline(data_stream, tmp_set);
-
-						if (tmp_set.empty()) {
-							continue;
-						}
-
-						std::map<int,std::string> set_params = split(trim(tmp_set), '\t');
-
-						if (set_params[0][0] == '@') {
-							if (set_params[0] == "@sprite") {
-								inst->set_sprite(get_texture_by_name(set_params[1]));
-							} else if (set_params[0] == "@solid") {
-								inst->set_is_solid(SIDP_i(SIDP(set_params[1])));
-							} else if (set_params[0] == "@depth") {
-								inst->depth = SIDP_i(SIDP(set_params[1]));
-							} else {
-								messenger::send({"engine", "room"}, E_MESSAGE::WARNING, "Error while loading instance map: unknown setter \"" + v + "\"");
-								continue;
-							}
-						} else if (set_params[0] == "!setend") {
-							break;
-						} else {
-							inst->set_data(set_params[1], SIDP(set_params[2]));
-						}
-					}
-
-					continue;
-				} else if (v == "!setend") {
-					messenger::send({"engine", "room"}, E_MESSAGE::WARNING, "Error while loading instance map: stray !setend");
-					continue;
-				} else {
-					messenger::send({"engine", "room"}, E_MESSAGE::WARNING, "Error while loading instance map: unknown command \"" + v + "\"");
-					continue;
-				}
-			} else {
-				double x = std::stod(params[1]);
-				double y = std::stod(params[2]);
-				double z = std::stod(params[3]);
-
-				Object* object = get_object_by_name(v);
-				if (object == nullptr) {
-					messenger::send({"engine", "room"}, E_MESSAGE::WARNING, "Error while loading instance map: unknown object " + v);
-					continue;
+				} else if (set_params[0] == "!setend") {
+					break;
 				} else {
-					add_instance(-1, object, x, y, z);
+					inst->set_data(set_params[1], SIDP(set_params[2]));
 				}
 			}
 		}
@@ -986,27 +1279,125 @@ namespace bee {
 		return 0;
 	}
 	int Room::destroy(Instance* inst) {
+		if (is_step_parallel) {
+			std::lock_guard<std::mutex> lock (destroy_mutex);
+			destroyed_instances.push_back(inst);
+			return 0;
+		}
+
 		destroyed_instances.push_back(inst);
 		return 0;
 	}
 	int Room::destroy_all(Object* obj) {
+		std::unique_lock<std::mutex> lock (destroy_mutex, std::defer_lock);
+		if (is_step_parallel) {
+			lock.lock();
+		}
+
 		for (auto& i : obj->get_instances()) {
 			destroyed_instances.push_back(i.second);
 		}
 
 		return 0;
 	}
+	/*
+	* Room::dispatch_step() - Call the given step event for every instance which implements it
+	* ! Batched objects have their batch event called once with all of their instances so that the pause state and virtual dispatch are only checked once per object
+	* ! Reentrant objects are run on the job threads after all other instances, then the instances that they destroyed and moved are merged in a deterministic order
+	* @event: the event to dispatch
+	* @step: the event to call for unbatched instances
+	* @step_batch: the event to call for batched objects
+	*/
+	int Room::dispatch_step(E_EVENT event, void (Object::*step)(Instance*), void (Object::*step_batch)(const std::vector<Instance*>&)) {
+		const bool is_paused = get_is_paused();
+
+		InstanceList& list = instances_sorted_events[event];
+		const std::vector<InstanceGroup>& groups = list.get_groups();
+		const std::vector<SortedInstance>& sorted = list.get();
+
+		const bool is_parallel_enabled = (jobs::get_worker_amount() > 0);
+
+		std::vector<Instance*> batch;
+		std::vector<size_t> parallel_indices;
+		for (auto& g : groups) {
+			if (g.object == nullptr) {
+				Instance* inst = sorted[g.index].inst;
+				if (inst == nullptr) {
+					continue;
+				}
+				if ((is_paused)&&(inst->get_object()->get_is_pausable())) {
+					continue;
+				}
+				inst->get_object()->update(inst);
+				(inst->get_object()->*step)(inst);
+				continue;
+			}
+
+			if ((is_paused)&&(g.object->get_is_pausable())) {
+				continue;
+			}
+
+			if ((is_parallel_enabled)&&(g.object->get_is_step_reentrant())) {
+				parallel_indices.insert(parallel_indices.end(), g.indices.begin(), g.indices.end());
+				continue;
+			}
+
+			batch.clear();
+			for (size_t i : g.indices) {
+				if (sorted[i].inst != nullptr) { // Skip instances which were removed by an earlier group
+					batch.push_back(sorted[i].inst);
+				}
+			}
+			if (!batch.empty()) {
+				(g.object->*step_batch)(batch);
+			}
+		}
+
+		if (!parallel_indices.empty()) {
+			std::vector<Instance*> parallel;
+			for (size_t i : parallel_indices) {
+				if (sorted[i].inst != nullptr) { // Skip instances which were removed by the other groups
+					parallel.push_back(sorted[i].inst);
+				}
+			}
+
+			const size_t destroyed_amount = destroyed_instances.size();
+
+			is_step_parallel = true;
+			jobs::parallel_for(parallel.size(), [&parallel, step] (size_t begin, size_t end) {
+				for (size_t i=begin; i<end; ++i) {
+					(parallel[i]->get_object()->*step)(parallel[i]);
+				}
+			});
+			is_step_parallel = false;
+
+			// Sort the instances that were destroyed in parallel so that they're destroyed in the same order every time
+			std::sort(destroyed_instances.begin()+destroyed_amount, destroyed_instances.end(), [] (const Instance* a, const Instance* b) {
+				return (a->id < b->id);
+			});
+			for (auto& inst : parallel) {
+				update_instance_grid(inst);
+			}
+		}
+
+		return 0;
+	}
 	int Room::check_alarms() {
-		for (auto& i : instances_sorted_events[E_EVENT::ALARM]) {
-			if ((get_is_paused())&&(i.first->get_object()->get_is_pausable())) {
+		const bool is_paused = get_is_paused();
+
+		for (auto& i : instances_sorted_events[E_EVENT::ALARM].get()) {
+			if (i.inst == nullptr) {
+				continue;
+			}
+			if ((is_paused)&&(i.inst->get_object()->get_is_pausable())) {
 				continue;
 			}
 			for (size_t e=0; e<BEE_ALARM_COUNT; ++e) {
-				if (i.first->alarm_end[e] != 0xffffffff) {
-					if (get_ticks() >= i.first->alarm_end[e]) {
-						i.first->alarm_end[e] = 0xffffffff; // Reset alarm
-						i.first->get_object()->update(i.first);
-						i.first->get_object()->alarm(i.first, e);
+				if (i.inst->alarm_end[e] != 0xffffffff) {
+					if (get_ticks() >= i.inst->alarm_end[e]) {
+						i.inst->alarm_end[e] = 0xffffffff; // Reset alarm
+						i.inst->get_object()->update(i.inst);
+						i.inst->get_object()->alarm(i.inst, e);
 					}
 				}
 			}
@@ -1015,55 +1406,48 @@ namespace bee {
 		return 0;
 	}
 	int Room::step_begin() {
-		for (auto& i : instances_sorted_events[E_EVENT::STEP_BEGIN]) {
-			if ((get_is_paused())&&(i.first->get_object()->get_is_pausable())) {
-				continue;
-			}
-			i.first->get_object()->update(i.first);
-			i.first->get_object()->step_begin(i.first);
-		}
+		dispatch_step(E_EVENT::STEP_BEGIN, &Object::step_begin, &Object::step_begin_batch);
 
 		return 0;
 	}
 	int Room::step_mid() {
-		for (auto& i : instances_sorted_events[E_EVENT::STEP_MID]) {
-			if ((get_is_paused())&&(i.first->get_object()->get_is_pausable())) {
-				continue;
-			}
-			i.first->get_object()->update(i.first);
-			i.first->get_object()->step_mid(i.first);
-		}
+		const bool is_paused = get_is_paused();
+
+		dispatch_step(E_EVENT::STEP_MID, &Object::step_mid, &Object::step_mid_batch);
 
 		// Move instances along their paths
-		for (auto& i : instances_sorted) {
-			if (i.first->has_path()) {
+		for (auto& i : instances_sorted.get()) {
+			if (i.inst == nullptr) {
+				continue;
+			}
+			if (i.inst->has_path()) {
 				if (
-					(get_is_paused())
-					&&(i.first->get_object()->get_is_pausable())
-					&&(i.first->get_path_pausable())
+					(is_paused)
+					&&(i.inst->get_object()->get_is_pausable())
+					&&(i.inst->get_path_pausable())
 				) {
 					continue;
 				}
 
-				i.first->path_update_node();
+				i.inst->path_update_node();
 
 				path_coord_t c (0.0, 0.0, 0.0, 0.0);
-				if (i.first->get_path_speed() >= 0) {
-					if (i.first->get_path_node()+1 < static_cast<int>(i.first->get_path_coords().size())) {
-						c = i.first->get_path_coords().at(i.first->get_path_node()+1);
+				if (i.inst->get_path_speed() >= 0) {
+					if (i.inst->get_path_node()+1 < static_cast<int>(i.inst->get_path_coords().size())) {
+						c = i.inst->get_path_coords().at(i.inst->get_path_node()+1);
 					} else {
 						break;
 					}
-				} else if (i.first->get_path_node() >= 0) {
-					c = i.first->get_path_coords().at(i.first->get_path_node());
+				} else if (i.inst->get_path_node() >= 0) {
+					c = i.inst->get_path_coords().at(i.inst->get_path_node());
 				}
 
-				i.first->set_position(
-					i.first->get_position()
-					+ btScalar(std::get<3>(c)*abs(i.first->get_path_speed()))
+				i.inst->set_position(
+					i.inst->get_position()
+					+ btScalar(std::get<3>(c)*abs(i.inst->get_path_speed()))
 					* direction_of(
-						i.first->get_x(), i.first->get_y(), i.first->get_z(),
-						i.first->path_pos_start.x()+std::get<0>(c), i.first->path_pos_start.y()+std::get<1>(c), i.first->path_pos_start.z()+std::get<2>(c)
+						i.inst->get_x(), i.inst->get_y(), i.inst->get_z(),
+						i.inst->path_pos_start.x()+std::get<0>(c), i.inst->path_pos_start.y()+std::get<1>(c), i.inst->path_pos_start.z()+std::get<2>(c)
 					) * btScalar(get_delta())
 				);
 			}
@@ -1086,162 +1470,216 @@ namespace bee {
 		return 0;
 	}
 	int Room::step_end() {
-		for (auto& i : instances_sorted_events[E_EVENT::STEP_END]) {
-			if ((get_is_paused())&&(i.first->get_object()->get_is_pausable())) {
-				continue;
-			}
-			i.first->get_object()->update(i.first);
-			i.first->get_object()->step_end(i.first);
-		}
+		dispatch_step(E_EVENT::STEP_END, &Object::step_end, &Object::step_end_batch);
 
 		return 0;
 	}
 	int Room::keyboard_press(SDL_Event* e) {
-		for (auto& i : instances_sorted_events[E_EVENT::KEYBOARD_PRESS]) {
-			if ((get_is_paused())&&(i.first->get_object()->get_is_pausable())) {
+		const bool is_paused = get_is_paused();
+
+		for (auto& i : instances_sorted_events[E_EVENT::KEYBOARD_PRESS].get()) {
+			if (i.inst == nullptr) {
 				continue;
 			}
-			i.first->get_object()->update(i.first);
-			i.first->get_object()->keyboard_press(i.first, e);
+			if ((is_paused)&&(i.inst->get_object()->get_is_pausable())) {
+				continue;
+			}
+			i.inst->get_object()->update(i.inst);
+			i.inst->get_object()->keyboard_press(i.inst, e);
 		}
 
 		return 0;
 	}
 	int Room::mouse_press(SDL_Event* e) {
-		for (auto& i : instances_sorted_events[E_EVENT::MOUSE_PRESS]) {
-			if ((get_is_paused())&&(i.first->get_object()->get_is_pausable())) {
+		const bool is_paused = get_is_paused();
+
+		for (auto& i : instances_sorted_events[E_EVENT::MOUSE_PRESS].get()) {
+			if (i.inst == nullptr) {
 				continue;
 			}
-			i.first->get_object()->update(i.first);
-			i.first->get_object()->mouse_press(i.first, e);
+			if ((is_paused)&&(i.inst->get_object()->get_is_pausable())) {
+				continue;
+			}
+			i.inst->get_object()->update(i.inst);
+			i.inst->get_object()->mouse_press(i.inst, e);
 		}
 
 		return 0;
 	}int Room::keyboard_input(SDL_Event* e) {
-		for (auto& i : instances_sorted_events[E_EVENT::KEYBOARD_INPUT]) {
-			if ((get_is_paused())&&(i.first->get_object()->get_is_pausable())) {
+		const bool is_paused = get_is_paused();
+
+		for (auto& i : instances_sorted_events[E_EVENT::KEYBOARD_INPUT].get()) {
+			if (i.inst == nullptr) {
+				continue;
+			}
+			if ((is_paused)&&(i.inst->get_object()->get_is_pausable())) {
 				continue;
 			}
-			i.first->get_object()->update(i.first);
-			i.first->get_object()->keyboard_input(i.first, e);
+			i.inst->get_object()->update(i.inst);
+			i.inst->get_object()->keyboard_input(i.inst, e);
 		}
 
 		return 0;
 	}
 	int Room::mouse_input(SDL_Event* e) {
-		for (auto& i : instances_sorted_events[E_EVENT::MOUSE_INPUT]) {
-			if ((get_is_paused())&&(i.first->get_object()->get_is_pausable())) {
+		const bool is_paused = get_is_paused();
+
+		for (auto& i : instances_sorted_events[E_EVENT::MOUSE_INPUT].get()) {
+			if (i.inst == nullptr) {
+				continue;
+			}
+			if ((is_paused)&&(i.inst->get_object()->get_is_pausable())) {
 				continue;
 			}
-			i.first->get_object()->update(i.first);
-			i.first->get_object()->mouse_input(i.first, e);
+			i.inst->get_object()->update(i.inst);
+			i.inst->get_object()->mouse_input(i.inst, e);
 		}
 
 		return 0;
 	}
 	int Room::keyboard_release(SDL_Event* e) {
-		for (auto& i : instances_sorted_events[E_EVENT::KEYBOARD_RELEASE]) {
-			if ((get_is_paused())&&(i.first->get_object()->get_is_pausable())) {
+		const bool is_paused = get_is_paused();
+
+		for (auto& i : instances_sorted_events[E_EVENT::KEYBOARD_RELEASE].get()) {
+			if (i.inst == nullptr) {
+				continue;
+			}
+			if ((is_paused)&&(i.inst->get_object()->get_is_pausable())) {
 				continue;
 			}
-			i.first->get_object()->update(i.first);
-			i.first->get_object()->keyboard_release(i.first, e);
+			i.inst->get_object()->update(i.inst);
+			i.inst->get_object()->keyboard_release(i.inst, e);
 		}
 
 		return 0;
 	}
 	int Room::mouse_release(SDL_Event* e) {
-		for (auto& i : instances_sorted_events[E_EVENT::MOUSE_RELEASE]) {
-			if ((get_is_paused())&&(i.first->get_object()->get_is_pausable())) {
+		const bool is_paused = get_is_paused();
+
+		for (auto& i : instances_sorted_events[E_EVENT::MOUSE_RELEASE].get()) {
+			if (i.inst == nullptr) {
 				continue;
 			}
-			i.first->get_object()->update(i.first);
-			i.first->get_object()->mouse_release(i.first, e);
+			if ((is_paused)&&(i.inst->get_object()->get_is_pausable())) {
+				continue;
+			}
+			i.inst->get_object()->update(i.inst);
+			i.inst->get_object()->mouse_release(i.inst, e);
 		}
 
 		return 0;
 	}
 	int Room::controller_axis(SDL_Event* e) {
-		for (auto& i : instances_sorted_events[E_EVENT::CONTROLLER_AXIS]) {
-			if ((get_is_paused())&&(i.first->get_object()->get_is_pausable())) {
+		const bool is_paused = get_is_paused();
+
+		for (auto& i : instances_sorted_events[E_EVENT::CONTROLLER_AXIS].get()) {
+			if (i.inst == nullptr) {
 				continue;
 			}
-			i.first->get_object()->update(i.first);
-			i.first->get_object()->controller_axis(i.first, e);
+			if ((is_paused)&&(i.inst->get_object()->get_is_pausable())) {
+				continue;
+			}
+			i.inst->get_object()->update(i.inst);
+			i.inst->get_object()->controller_axis(i.inst, e);
 		}
 
 		return 0;
 	}
 	int Room::controller_press(SDL_Event* e) {
-		for (auto& i : instances_sorted_events[E_EVENT::CONTROLLER_PRESS]) {
-			if ((get_is_paused())&&(i.first->get_object()->get_is_pausable())) {
+		const bool is_paused = get_is_paused();
+
+		for (auto& i : instances_sorted_events[E_EVENT::CONTROLLER_PRESS].get()) {
+			if (i.inst == nullptr) {
+				continue;
+			}
+			if ((is_paused)&&(i.inst->get_object()->get_is_pausable())) {
 				continue;
 			}
-			i.first->get_object()->update(i.first);
-			i.first->get_object()->controller_press(i.first, e);
+			i.inst->get_object()->update(i.inst);
+			i.inst->get_object()->controller_press(i.inst, e);
 		}
 
 		return 0;
 	}
 	int Room::controller_release(SDL_Event* e) {
-		for (auto& i : instances_sorted_events[E_EVENT::CONTROLLER_RELEASE]) {
-			if ((get_is_paused())&&(i.first->get_object()->get_is_pausable())) {
+		const bool is_paused = get_is_paused();
+
+		for (auto& i : instances_sorted_events[E_EVENT::CONTROLLER_RELEASE].get()) {
+			if (i.inst == nullptr) {
+				continue;
+			}
+			if ((is_paused)&&(i.inst->get_object()->get_is_pausable())) {
 				continue;
 			}
-			i.first->get_object()->update(i.first);
-			i.first->get_object()->controller_release(i.first, e);
+			i.inst->get_object()->update(i.inst);
+			i.inst->get_object()->controller_release(i.inst, e);
 		}
 
 		return 0;
 	}
 	int Room::controller_modify(SDL_Event* e) {
-		for (auto& i : instances_sorted_events[E_EVENT::CONTROLLER_MODIFY]) {
-			if ((get_is_paused())&&(i.first->get_object()->get_is_pausable())) {
+		const bool is_paused = get_is_paused();
+
+		for (auto& i : instances_sorted_events[E_EVENT::CONTROLLER_MODIFY].get()) {
+			if (i.inst == nullptr) {
+				continue;
+			}
+			if ((is_paused)&&(i.inst->get_object()->get_is_pausable())) {
 				continue;
 			}
-			i.first->get_object()->update(i.first);
-			i.first->get_object()->controller_modify(i.first, e);
+			i.inst->get_object()->update(i.inst);
+			i.inst->get_object()->controller_modify(i.inst, e);
 		}
 
 		return 0;
 	}
 	int Room::commandline_input(const std::string& input) {
-		for (auto& i : instances_sorted_events[E_EVENT::COMMANDLINE_INPUT]) {
-			if ((get_is_paused())&&(i.first->get_object()->get_is_pausable())) {
+		const bool is_paused = get_is_paused();
+
+		for (auto& i : instances_sorted_events[E_EVENT::COMMANDLINE_INPUT].get()) {
+			if (i.inst == nullptr) {
+				continue;
+			}
+			if ((is_paused)&&(i.inst->get_object()->get_is_pausable())) {
 				continue;
 			}
-			i.first->get_object()->update(i.first);
-			i.first->get_object()->commandline_input(i.first, input);
+			i.inst->get_object()->update(i.inst);
+			i.inst->get_object()->commandline_input(i.inst, input);
 		}
 
 		return 0;
 	}
 	int Room::check_paths() {
-		for (auto& i : instances_sorted) {
-			if (i.first->has_path()) {
+		const bool is_paused = get_is_paused();
+
+		for (auto& i : instances_sorted.get()) {
+			if (i.inst == nullptr) {
+				continue;
+			}
+			if (i.inst->has_path()) {
 				if (
-					(get_is_paused())
-					&&(i.first->get_object()->get_is_pausable())
-					&&(i.first->get_path_pausable())
+					(is_paused)
+					&&(i.inst->get_object()->get_is_pausable())
+					&&(i.inst->get_path_pausable())
 				) {
 					continue;
 				}
 
 				if (
 					(
-						(i.first->get_path_speed() >= 0)
-						&&(i.first->get_path_node() == static_cast<int>(i.first->get_path_coords().size())-1)
+						(i.inst->get_path_speed() >= 0)
+						&&(i.inst->get_path_node() == static_cast<int>(i.inst->get_path_coords().size())-1)
 					)
 					||(
-						(i.first->get_path_speed() < 0)
-						&&(i.first->get_path_node() == -1)
+						(i.inst->get_path_speed() < 0)
+						&&(i.inst->get_path_node() == -1)
 					)
 				) {
-					if (instances_sorted_events[E_EVENT::PATH_END].find(i.first) != instances_sorted_events[E_EVENT::PATH_END].end()) {
-						i.first->get_object()->update(i.first);
-						i.first->get_object()->path_end(i.first);
+					if (i.inst->get_object()->implemented_events.find(E_EVENT::PATH_END) != i.inst->get_object()->implemented_events.end()) {
+						i.inst->get_object()->update(i.inst);
+						i.inst->get_object()->path_end(i.inst);
 					}
-					i.first->handle_path_end();
+					i.inst->handle_path_end();
 				}
 			}
 		}
@@ -1249,16 +1687,21 @@ namespace bee {
 		return 0;
 	}
 	int Room::outside_room() {
-		for (auto& i : instances_sorted_events[E_EVENT::OUTSIDE_ROOM]) {
-			if ((get_is_paused())&&(i.first->get_object()->get_is_pausable())) {
+		const bool is_paused = get_is_paused();
+
+		for (auto& i : instances_sorted_events[E_EVENT::OUTSIDE_ROOM].get()) {
+			if (i.inst == nullptr) {
 				continue;
 			}
-			if (i.first->get_object()->get_mask() != nullptr) {
-				SDL_Rect a = i.first->get_aabb();
+			if ((is_paused)&&(i.inst->get_object()->get_is_pausable())) {
+				continue;
+			}
+			if (i.inst->get_object()->get_mask() != nullptr) {
+				SDL_Rect a = i.inst->get_aabb();
 				SDL_Rect b = {0, 0, get_width(), get_height()};
 				if (!check_collision(a, b)) {
-					i.first->get_object()->update(i.first);
-					i.first->get_object()->outside_room(i.first);
+					i.inst->get_object()->update(i.inst);
+					i.inst->get_object()->outside_room(i.inst);
 				}
 			}
 		}
@@ -1266,12 +1709,17 @@ namespace bee {
 		return 0;
 	}
 	int Room::intersect_boundary() {
-		for (auto& i : instances_sorted_events[E_EVENT::INTERSECT_BOUNDARY]) {
-			if ((get_is_paused())&&(i.first->get_object()->get_is_pausable())) {
+		const bool is_paused = get_is_paused();
+
+		for (auto& i : instances_sorted_events[E_EVENT::INTERSECT_BOUNDARY].get()) {
+			if (i.inst == nullptr) {
 				continue;
 			}
-			i.first->get_object()->update(i.first);
-			i.first->get_object()->intersect_boundary(i.first);
+			if ((is_paused)&&(i.inst->get_object()->get_is_pausable())) {
+				continue;
+			}
+			i.inst->get_object()->update(i.inst);
+			i.inst->get_object()->intersect_boundary(i.inst);
 		}
 
 		return 0;
@@ -1283,6 +1731,13 @@ namespace bee {
 
 		physics_world->step(get_delta());
 
+		// Update the collision grid for every instance which could have been moved by the simulation
+		for (auto& i : instances) {
+			if (i.second->get_mass() != 0.0) {
+				instance_grid.update(i.first, i.second->get_aabb());
+			}
+		}
+
 		return 0;
 	}
 	void Room::collision_internal(btDynamicsWorld* w, btScalar timestep) {
@@ -1418,10 +1873,13 @@ namespace bee {
 		render::render_textures();
 
 		// Draw instances
-		for (auto& i : instances_sorted_events[E_EVENT::DRAW]) {
-			if (i.first->get_object()->get_is_visible()) {
-				i.first->get_object()->update(i.first);
-				i.first->get_object()->draw(i.first);
+		for (auto& i : instances_sorted_events[E_EVENT::DRAW].get()) {
+			if (i.inst == nullptr) {
+				continue;
+			}
+			if (i.inst->get_object()->get_is_visible()) {
+				i.inst->get_object()->update(i.inst);
+				i.inst->get_object()->draw(i.inst);
 			}
 		}
 		render::render_textures();
@@ -1440,10 +1898,13 @@ namespace bee {
 		}
 
 		// Draw instance paths
-		for (auto& i : instances_sorted) {
-			if (i.first->has_path()) {
-				if ((get_options().is_debug_enabled)||(i.first->get_path_drawn())) {
-					i.first->draw_path();
+		for (auto& i : instances_sorted.get()) {
+			if (i.inst == nullptr) {
+				continue;
+			}
+			if (i.inst->has_path()) {
+				if ((get_options().is_debug_enabled)||(i.inst->get_path_drawn())) {
+					i.inst->draw_path();
 				}
 			}
 		}
@@ -1471,11 +1932,14 @@ namespace bee {
 		return 0;
 	}
 	int Room::animation_end() {
-		for (auto& i : instances_sorted_events[E_EVENT::ANIMATION_END]) {
-			if (i.first->get_object()->get_sprite() != nullptr) {
-				if (!i.first->get_object()->get_sprite()->get_is_animated()) {
-					i.first->get_object()->update(i.first);
-					i.first->get_object()->animation_end(i.first);
+		for (auto& i : instances_sorted_events[E_EVENT::ANIMATION_END].get()) {
+			if (i.inst == nullptr) {
+				continue;
+			}
+			if (i.inst->get_object()->get_sprite() != nullptr) {
+				if (!i.inst->get_object()->get_sprite()->get_is_animated()) {
+					i.inst->get_object()->update(i.inst);
+					i.inst->get_object()->animation_end(i.inst);
 				}
 			}
 		}
@@ -1483,25 +1947,35 @@ namespace bee {
 		return 0;
 	}
 	int Room::room_start() {
+		const bool is_paused = get_is_paused();
+
 		this->start();
 
-		for (auto& i : instances_sorted_events[E_EVENT::ROOM_START]) {
-			if ((get_is_paused())&&(i.first->get_object()->get_is_pausable())) {
+		for (auto& i : instances_sorted_events[E_EVENT::ROOM_START].get()) {
+			if (i.inst == nullptr) {
+				continue;
+			}
+			if ((is_paused)&&(i.inst->get_object()->get_is_pausable())) {
 				continue;
 			}
-			i.first->get_object()->update(i.first);
-			i.first->get_object()->room_start(i.first);
+			i.inst->get_object()->update(i.inst);
+			i.inst->get_object()->room_start(i.inst);
 		}
 
 		return 0;
 	}
 	int Room::room_end() {
-		for (auto& i : instances_sorted_events[E_EVENT::ROOM_END]) {
-			if ((get_is_paused())&&(i.first->get_object()->get_is_pausable())) {
+		const bool is_paused = get_is_paused();
+
+		for (auto& i : instances_sorted_events[E_EVENT::ROOM_END].get()) {
+			if (i.inst == nullptr) {
+				continue;
+			}
+			if ((is_paused)&&(i.inst->get_object()->get_is_pausable())) {
 				continue;
 			}
-			i.first->get_object()->update(i.first);
-			i.first->get_object()->room_end(i.first);
+			i.inst->get_object()->update(i.inst);
+			i.inst->get_object()->room_end(i.inst);
 		}
 
 		for (auto& i : instances) {
@@ -1514,23 +1988,33 @@ namespace bee {
 		return 0;
 	}
 	int Room::game_start() {
-		for (auto& i : instances_sorted_events[E_EVENT::GAME_START]) {
-			if ((get_is_paused())&&(i.first->get_object()->get_is_pausable())) {
+		const bool is_paused = get_is_paused();
+
+		for (auto& i : instances_sorted_events[E_EVENT::GAME_START].get()) {
+			if (i.inst == nullptr) {
+				continue;
+			}
+			if ((is_paused)&&(i.inst->get_object()->get_is_pausable())) {
 				continue;
 			}
-			i.first->get_object()->update(i.first);
-			i.first->get_object()->game_start(i.first);
+			i.inst->get_object()->update(i.inst);
+			i.inst->get_object()->game_start(i.inst);
 		}
 
 		return 0;
 	}
 	int Room::game_end() {
-		for (auto& i : instances_sorted_events[E_EVENT::GAME_END]) {
-			if ((get_is_paused())&&(i.first->get_object()->get_is_pausable())) {
+		const bool is_paused = get_is_paused();
+
+		for (auto& i : instances_sorted_events[E_EVENT::GAME_END].get()) {
+			if (i.inst == nullptr) {
 				continue;
 			}
-			i.first->get_object()->update(i.first);
-			i.first->get_object()->game_end(i.first);
+			if ((is_paused)&&(i.inst->get_object()->get_is_pausable())) {
+				continue;
+			}
+			i.inst->get_object()->update(i.inst);
+			i.inst->get_object()->game_end(i.inst);
 		}
 
 		for (auto& i : instances) {
@@ -1542,23 +2026,33 @@ namespace bee {
 		return 0;
 	}
 	int Room::window(SDL_Event* e) {
-		for (auto& i : instances_sorted_events[E_EVENT::WINDOW]) {
-			if ((get_is_paused())&&(i.first->get_object()->get_is_pausable())) {
+		const bool is_paused = get_is_paused();
+
+		for (auto& i : instances_sorted_events[E_EVENT::WINDOW].get()) {
+			if (i.inst == nullptr) {
 				continue;
 			}
-			i.first->get_object()->update(i.first);
-			i.first->get_object()->window(i.first, e);
+			if ((is_paused)&&(i.inst->get_object()->get_is_pausable())) {
+				continue;
+			}
+			i.inst->get_object()->update(i.inst);
+			i.inst->get_object()->window(i.inst, e);
 		}
 
 		return 0;
 	}
 	int Room::network(const NetworkEvent& e) {
-		for (auto& i :instances_sorted_events[E_EVENT::NETWORK]) {
-			if ((get_is_paused())&&(i.first->get_object()->get_is_pausable())) {
+		const bool is_paused = get_is_paused();
+
+		for (auto& i : instances_sorted_events[E_EVENT::NETWORK].get()) {
+			if (i.inst == nullptr) {
+				continue;
+			}
+			if ((is_paused)&&(i.inst->get_object()->get_is_pausable())) {
 				continue;
 			}
-			i.first->get_object()->update(i.first);
-			i.first->get_object()->network(i.first, e);
+			i.inst->get_object()->update(i.inst);
+			i.inst->get_object()->network(i.inst, e);
 		}
 
 		return 0;
@@ -13,13 +13,18 @@
 #include <map>
 #include <list>
 #include <vector>
+#include <mutex>
 
 #include <btBulletDynamicsCommon.h> // Include the required Bullet headers
 
 #include "resource.hpp"
 
+#include "../data/nameindex.hpp"
+
 #include "../core/instance.hpp"
 
+#include "../data/spatialgrid.hpp"
+
 #include "../render/rgba.hpp"
 
 #include "texture.hpp"
@@ -35,11 +40,6 @@ namespace bee {
 
 	struct NetworkEvent;
 
-	// Declare a function to flip <int,Instance*> to <Instance*,int> for use with instances_sorted
-	namespace internal {
-		std::pair<Instance*,int> flip_instancemap_pair(const std::pair<int,Instance*>&);
-	}
-
 	struct BackgroundData { // The data struct which is used to pass data to the Room class
 		Texture* texture; // A pointer to the texture to use this data with
 		bool is_visible; // Whether to draw the background
@@ -51,15 +51,53 @@ namespace bee {
 		BackgroundData(Texture*, bool, bool, int, int, bool, bool, int, int, bool);
 	};
 
-	struct InstanceSort { // This struct is used as the comparator for the instances_sorted member of the Room class
-		bool operator() (Instance* lhs, Instance* rhs) const {
-			return (*lhs) < (*rhs); // Compare the values instead of the pointers
-		}
+	struct SortedInstance { // The data struct which is used to store an instance with the depth and id that it was sorted by
+		Instance* inst; // A pointer to the instance, this is set to nullptr when the instance is removed
+		int depth; // The depth of the instance when it was sorted
+		int id; // The id of the instance
+
+		// See bee/resources/room.cpp for function comments
+		SortedInstance();
+		explicit SortedInstance(Instance*);
+
+		bool operator<(const SortedInstance&) const;
+	};
+	struct InstanceGroup { // The data struct which is used to dispatch an event to either a single instance or all of a batched object's instances
+		Object* object; // The batched or reentrant object of the group, or nullptr when the group is a single unbatched instance
+		size_t index; // The index of the group's first instance in the sorted list
+		std::vector<size_t> indices; // The indices of all of the batched object's instances in the sorted list
+
+		// See bee/resources/room.cpp for function comments
+		InstanceGroup();
+		InstanceGroup(Object*, size_t);
+	};
+
+	class InstanceList { // A contiguous list of instances sorted by depth, then by id, which is used to iterate over instances for each event
+			std::vector<SortedInstance> sorted; // The sorted list of instances, which may contain removed instances as nullptr
+			std::vector<SortedInstance> pending; // A list of instances that have been added since the last sort
+			size_t removed_amount; // The amount of removed instances in the sorted list
+			bool should_resort; // Whether every instance should be resorted, e.g. when their depth has changed
+			std::vector<InstanceGroup> groups; // The sorted list split into groups for batched event dispatch
+			bool should_regroup; // Whether the groups need to be rebuilt after the sorted list has changed
+		public:
+			// See bee/resources/room.cpp for function comments
+			InstanceList();
+
+			int add(Instance*);
+			int remove(Instance*);
+			int clear();
+			int request_sort();
+			int sort();
+
+			size_t size() const;
+			const std::vector<SortedInstance>& get();
+			const std::vector<InstanceGroup>& get_groups();
 	};
 
 	class Room: public Resource { // The room resource class is used to handle all instance event calls and instantiation
 			static std::map<int,Room*> list;
 			static int next_id;
+			static NameIndex<Room> names; // The index of the resources by name
 
 			int id; // The id of the resource
 			std::string name; // An arbitrary name for the resource
@@ -75,18 +113,23 @@ namespace bee {
 
 			int next_instance_id; // The id for the next created instance, always increasing
 			std::map<int,Instance*> instances; // A map of all instances with their associated id
-			std::map<Instance*,int,InstanceSort> instances_sorted; // A map of all instance sorted by depth, then by id
+			InstanceList instances_sorted; // A list of all instances sorted by depth, then by id
 			std::vector<Instance*> created_instances; // A list of instances that should have their create event called after the room is loaded
 			std::vector<Instance*> destroyed_instances; // A list of instances that should have their destroy event called after the event loop
 			bool should_sort; // Whether the sorted instance list needs to be resorted after the event loop
+			SpatialGrid instance_grid; // A grid of instance bounding boxes which is used to find nearby instances for the Instance::is_place_*() functions
+			bool is_step_parallel; // Whether reentrant step events are currently running on the job threads
+			std::mutex destroy_mutex; // The mutex which protects the destroyed instance list while step events are running in parallel
 
 			static const std::list<E_EVENT> event_list; // A list of the available events
-			std::map<E_EVENT,std::map<Instance*,int,InstanceSort>> instances_sorted_events; // A map of all events and the instance which implement those events
+			std::map<E_EVENT,InstanceList> instances_sorted_events; // A map of all events and the sorted instances which implement those events
 
 			std::vector<ParticleSystem*> particle_systems; // A list of the particle systems that the room should run draw
 
 			std::vector<LightData> lights; // A list of all the queued lights to be drawn
 			std::vector<LightableData*> lightables; // A list of all the lightables which can cast shadows
+			std::vector<LightUniform> light_uniforms; // The lights in their uniform block layout, which are reused for every upload
+			std::vector<LightableUniform> lightable_uniforms; // The lightables in their uniform block layout, which are reused for every upload
 			Texture* light_map; // A texture used for SDL light rendering
 
 			PhysicsWorld* physics_world; // The world used to simulate all physics objects in the room
@@ -95,6 +138,9 @@ namespace bee {
 			std::string instance_map; // The path of the instance map file to load instance from when the room starts
 
 			ViewPort* view_current; // A pointer to the current view that is being drawn
+
+			// See bee/resources/room.cpp for function comments
+			int dispatch_step(E_EVENT, void (Object::*)(Instance*), void (Object::*)(const std::vector<Instance*>&));
 		public:
 			// See bee/resources/room.cpp for function comments
 			Room();
@@ -104,6 +150,9 @@ namespace bee {
 			int add_to_resources();
 			static size_t get_amount();
 			static Room* get(int);
+			static Room* get_by_name(const std::string&);
+			static size_t get_name_handle(const std::string&);
+			static Room* get_by_handle(size_t);
 			int reset();
 			int print() const;
 			std::string get_print() const;
@@ -122,6 +171,7 @@ namespace bee {
 			std::vector<ViewPort*> get_views() const;
 			std::string get_view_string() const;
 			const std::map<int,Instance*>& get_instances() const;
+			std::vector<Instance*> get_instances_near(const SDL_Rect&) const;
 			std::string get_instance_string() const;
 			ViewPort* get_current_view() const;
 			PhysicsWorld* get_phys_world() const;
@@ -142,6 +192,8 @@ namespace bee {
 			Instance* add_instance(int, Object*, double, double, double);
 			int add_instance_grid(int, Object*, double, double, double);
 			int remove_instance(int);
+			int update_instance_grid(Instance*);
+			int update_instance_grid(const Texture*);
 			int sort_instances();
 			int request_instance_sort();
 			int add_physbody(Instance*, PhysicsBody*);
@@ -159,6 +211,7 @@ namespace bee {
 			int save_instance_map(const std::string&);
 			int load_instance_map(const std::string&);
 			int load_instance_map();
+			int load_instance_map_sets(const std::string&);
 			std::string get_instance_map() const;
 			int set_instance_map(const std::string&);
 
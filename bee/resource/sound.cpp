@@ -28,6 +28,7 @@
 namespace bee {
 	std::map<int,Sound*> Sound::list;
 	int Sound::next_id = 0;
+	NameIndex<Sound> Sound::names;
 
 	/*
 	* Sound::Sound() - Default construct the sound
@@ -83,6 +84,7 @@ namespace bee {
 	*/
 	Sound::~Sound() {
 		this->free(); // Free all sound data
+		names.remove(name, this);
 		list.erase(id); // Remove the sound from the resource list
 	}
 
@@ -93,6 +95,7 @@ namespace bee {
 		if (id < 0) { // If the resource needs to be added to the resource list
 			id = next_id++;
 			list.emplace(id, this); // Add the resource and with the new id
+			names.add(name, this);
 		}
 
 		return 0; // Return 0 on success
@@ -114,13 +117,34 @@ namespace bee {
 		return nullptr;
 	}
 	/*
+	* Sound::get_by_name() - Return the sound resource with the given name, or nullptr if there isn't one
+	* @name: the name of the desired sound
+	*/
+	Sound* Sound::get_by_name(const std::string& name) {
+		return names.find(name);
+	}
+	/*
+	* Sound::get_name_handle() - Return a handle for the given name which can be cached and passed to get_by_handle()
+	* @name: the name to get the handle of
+	*/
+	size_t Sound::get_name_handle(const std::string& name) {
+		return names.get_handle(name);
+	}
+	/*
+	* Sound::get_by_handle() - Return the sound resource which currently has the name of the given handle, or nullptr if there isn't one
+	* @handle: the name handle
+	*/
+	Sound* Sound::get_by_handle(size_t handle) {
+		return names.get(handle);
+	}
+	/*
 	* Sound::reset() - Reset all resource variables for reinitialization
 	*/
 	int Sound::reset() {
 		this->free(); // Free all memory used by this resource
 
 		// Reset all properties
-		name = "";
+		set_name("");
 		path = "";
 		volume = 1.0;
 		pan = 0.0;
@@ -218,6 +242,13 @@ namespace bee {
 	* Sound::set_*() - Set the requested resource data
 	*/
 	int Sound::set_name(const std::string& new_name) {
+		if (id >= 0) { // If the sound is in the resource list, reindex it under the new name
+			names.remove(name, this);
+			name = new_name;
+			names.add(name, this);
+			return 0;
+		}
+
 		name = new_name;
 		return 0;
 	}
@@ -296,21 +327,22 @@ namespace bee {
 	}
 
 	/*
-	* Sound::load() - Load the sound from its given filename
+	* Sound::decode() - Decode the sound file so that load() only has to set up the sound
+	* ! This doesn't play anything so it can be called from a loader thread
 	*/
-	int Sound::load() {
-		if (is_loaded) { // If the sound has already been loaded, output a warning
-			messenger::send({"engine", "sound"}, E_MESSAGE::WARNING, "Failed to load sound \"" + name + "\" because it has already been loaded");
+	int Sound::decode() {
+		if (is_loaded) { // Do not attempt to decode the sound if it has already been loaded
 			return 1; // Return 1 when already loaded
 		}
+		if ((music != nullptr)||(chunk != nullptr)) {
+			return 0; // Return 0 when already decoded since load() can still set it up
+		}
 
 		if (get_options().is_headless) {
 			has_play_failed = true;
 			return 2; // Return 2 when in headless mode
 		}
 
-		effect_reset_data(); // Reset the effect data structs
-
 		if (is_music) { // If the sound should be treated as music, load it appropriately
 			music = Mix_LoadMUS(path.c_str()); // Load the sound file as mixer music
 			if (music == nullptr) { // If the music could not be loaded, output a warning
@@ -326,6 +358,32 @@ namespace bee {
 
 		}
 
+		return 0; // Return 0 on success
+	}
+	/*
+	* Sound::load() - Load the sound from its given filename
+	* ! If the sound was already decoded by decode(), it is only set up here
+	*/
+	int Sound::load() {
+		if (is_loaded) { // If the sound has already been loaded, output a warning
+			messenger::send({"engine", "sound"}, E_MESSAGE::WARNING, "Failed to load sound \"" + name + "\" because it has already been loaded");
+			return 1; // Return 1 when already loaded
+		}
+
+		if (get_options().is_headless) {
+			has_play_failed = true;
+			return 2; // Return 2 when in headless mode
+		}
+
+		effect_reset_data(); // Reset the effect data structs
+
+		if ((music == nullptr)&&(chunk == nullptr)) {
+			int r = decode();
+			if (r != 0) {
+				return r; // Return 3 or 4 on loading failure
+			}
+		}
+
 		// Set the volume for the now-loaded sound
 		update_volume();
 
@@ -356,6 +414,12 @@ namespace bee {
 		equalizer_data = nullptr;
 
 		if (!is_loaded) { // Do not attempt to free more data if the sound has not been loaded
+			// Free the sound data if it was decoded but never loaded
+			Mix_FreeMusic(music);
+			music = nullptr;
+			Mix_FreeChunk(chunk);
+			chunk = nullptr;
+
 			return 0; // Return 0 on success
 		}
 
@@ -17,12 +17,15 @@
 
 #include "resource.hpp"
 
+#include "../data/nameindex.hpp"
+
 #include "../util/soundeffects.hpp"
 
 namespace bee {
 	class Sound: public Resource { // The sound resource class is used to play all audio
 			static std::map<int,Sound*> list;
 			static int next_id;
+			static NameIndex<Sound> names; // The index of the resources by name
 
 			int id; // The id of the resource
 			std::string name; // An arbitrary name for the resource
@@ -65,6 +68,9 @@ namespace bee {
 			int add_to_resources();
 			static size_t get_amount();
 			static Sound* get(int);
+			static Sound* get_by_name(const std::string&);
+			static size_t get_name_handle(const std::string&);
+			static Sound* get_by_handle(size_t);
 			int reset();
 			int print() const;
 
@@ -86,6 +92,7 @@ namespace bee {
 			int update_volume();
 			int set_pan(double);
 
+			int decode();
 			int load();
 			int free();
 			int finished(int);
@@ -23,6 +23,7 @@
 #include "../engine.hpp"
 
 #include "../util/real.hpp"
+#include "../util/platform.hpp"
 #include "../util/debug.hpp"
 
 #include "../init/gameoptions.hpp"
@@ -33,6 +34,7 @@
 #include "../core/rooms.hpp"
 #include "../core/window.hpp"
 
+#include "../render/atlas.hpp"
 #include "../render/drawing.hpp"
 #include "../render/render.hpp"
 #include "../render/renderer.hpp"
@@ -71,11 +73,13 @@ namespace bee {
 		model(_model),
 		rotation(_rotation),
 		color(_color),
-		buffer(_buffer)
+		buffer(_buffer),
+		texrect(0.0f, 0.0f, 1.0f, 1.0f)
 	{}
 
 	std::map<int,Texture*> Texture::list;
 	int Texture::next_id = 0;
+	NameIndex<Texture> Texture::names;
 
 	/*
 	* Texture::Texture() - Default construct the texture
@@ -100,6 +104,7 @@ namespace bee {
 		rotate_y(0.5),
 
 		texture(nullptr),
+		decoded_surface(nullptr),
 		is_loaded(false),
 		has_draw_failed(false),
 
@@ -109,7 +114,10 @@ namespace bee {
 		gl_texture(-1),
 		vbo_texcoords(),
 
-		framebuffer(-1)
+		framebuffer(-1),
+
+		atlas_page(-1),
+		atlas_rect({0,0,0,0})
 	{}
 	/*
 	* Texture::Texture() - Construct the texture, add it to the texture resource list, and set the new name and path
@@ -132,6 +140,7 @@ namespace bee {
 	*/
 	Texture::~Texture() {
 		this->free(); // Free all texture data
+		names.remove(name, this);
 		list.erase(id); // Remove the texture from the resource list
 	}
 
@@ -142,6 +151,7 @@ namespace bee {
 		if (id < 0) { // If the resource needs to be added to the resource list
 			id = next_id++;
 			list.emplace(id, this); // Add the resource and with the new id
+			names.add(name, this);
 		}
 
 		return id; // Return the id on success
@@ -163,13 +173,34 @@ namespace bee {
 		return nullptr;
 	}
 	/*
+	* Texture::get_by_name() - Return the texture resource with the given name, or nullptr if there isn't one
+	* @name: the name of the desired texture
+	*/
+	Texture* Texture::get_by_name(const std::string& name) {
+		return names.find(name);
+	}
+	/*
+	* Texture::get_name_handle() - Return a handle for the given name which can be cached and passed to get_by_handle()
+	* @name: the name to get the handle of
+	*/
+	size_t Texture::get_name_handle(const std::string& name) {
+		return names.get_handle(name);
+	}
+	/*
+	* Texture::get_by_handle() - Return the texture resource which currently has the name of the given handle, or nullptr if there isn't one
+	* @handle: the name handle
+	*/
+	Texture* Texture::get_by_handle(size_t handle) {
+		return names.get(handle);
+	}
+	/*
 	* Texture::reset() - Reset all resource variables for reinitialization
 	*/
 	int Texture::reset() {
 		this->free(); // Free all memory used by this resource
 
 		// Reset all properties
-		name = "";
+		set_name("");
 		path = "";
 		width = 0;
 		height = 0;
@@ -267,11 +298,45 @@ namespace bee {
 	bool Texture::get_is_loaded() const {
 		return is_loaded;
 	}
+	int Texture::get_atlas_page() const {
+		return atlas_page;
+	}
+	/*
+	* Texture::get_atlas_texrect() - Return the texcoord offset and scale of the given subimage in the texture's atlas page
+	* @subimage: the subimage to return the rectangle of
+	*/
+	glm::vec4 Texture::get_atlas_texrect(unsigned int subimage) const {
+		const AtlasPage* page = atlas::internal::get_page(atlas_page);
+		if (page == nullptr) {
+			return glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+		}
+
+		GLfloat x = atlas_rect.x + crop.x;
+		GLfloat w = crop.w;
+		if (subimage_amount > 1) {
+			x += subimage_width*subimage;
+			w = subimage_width;
+		}
+
+		return glm::vec4(
+			x / page->width,
+			static_cast<GLfloat>(atlas_rect.y + crop.y) / page->height,
+			w / page->width,
+			static_cast<GLfloat>(crop.h) / page->height
+		);
+	}
 
 	/*
 	* Texture::set_*() - Set the requested resource data
 	*/
 	int Texture::set_name(const std::string& new_name) {
+		if (id >= 0) { // If the texture is in the resource list, reindex it under the new name
+			names.remove(name, this);
+			name = new_name;
+			names.add(name, this);
+			return 0;
+		}
+
 		name = new_name;
 		return 0;
 	}
@@ -331,6 +396,10 @@ namespace bee {
 		subimage_amount = new_subimage_amount;
 		subimage_width = new_subimage_width;
 
+		if (atlas_page >= 0) {
+			return 0; // Return 0 for atlas textures since their subimages are selected by get_atlas_texrect()
+		}
+
 		// Destroy all old texcoords
 		if (!vbo_texcoords.empty()) {
 			for (auto& t : vbo_texcoords) {
@@ -384,6 +453,10 @@ namespace bee {
 		// Set the subimage properties to the crop properties
 		set_subimage_amount(1, crop.w);
 
+		if (atlas_page >= 0) {
+			return 0; // Return 0 for atlas textures since their crop is applied by get_atlas_texrect()
+		}
+
 		// Destroy all old texcoords
 		if (!vbo_texcoords.empty()) {
 			for (auto& t : vbo_texcoords) {
@@ -513,10 +586,90 @@ namespace bee {
 		is_loaded = true;
 		has_draw_failed = false;
 
+		if (get_current_room() != nullptr) { // Give the instances which use this texture as a mask their real size in the collision grid
+			get_current_room()->update_instance_grid(this);
+		}
+
+		return 0; // Return 0 on success
+	}
+	/*
+	* Texture::load_from_atlas() - Load the texture from a rectangle of an atlas page
+	* ! The page's OpenGL objects are shared so the texture doesn't create any of its own
+	* @page: the index of the atlas page
+	* @rect: the rectangle of the texture in the page
+	*/
+	int Texture::load_from_atlas(int page, SDL_Rect rect) {
+		if (is_loaded) { // If the texture has already been loaded, output a warning
+			messenger::send({"engine", "texture"}, E_MESSAGE::WARNING, "Failed to load texture \"" + name + "\" from atlas because it has already been loaded");
+			return 1; // Return 1 when already loaded
+		}
+
+		if (get_options().is_headless) {
+			return 2; // Return 2 when texture rendering is not applicable
+		}
+
+		if (atlas::internal::get_page(page) == nullptr) {
+			messenger::send({"engine", "texture"}, E_MESSAGE::WARNING, "Failed to load texture \"" + name + "\" from atlas page " + bee_itos(page) + " because it doesn't exist");
+			return 3; // Return 3 when the page doesn't exist
+		}
+
+		if (decoded_surface != nullptr) { // Free the image if it was decoded before being packed
+			SDL_FreeSurface(decoded_surface);
+			decoded_surface = nullptr;
+		}
+
+		// Set the texture dimensions
+		atlas_page = page;
+		atlas_rect = rect;
+		width = rect.w;
+		height = rect.h;
+
+		// Set the subimage dimensions
+		if (subimage_amount <= 1) {
+			set_subimage_amount(1, width);
+		} else {
+			set_subimage_amount(subimage_amount, width/subimage_amount);
+		}
+		crop = {0, 0, static_cast<int>(width), static_cast<int>(height)}; // Set the default crop to be the entire image
+
+		// Set the loaded booleans
+		is_loaded = true;
+		has_draw_failed = false;
+
+		if (get_current_room() != nullptr) { // Give the instances which use this texture as a mask their real size in the collision grid
+			get_current_room()->update_instance_grid(this);
+		}
+
+		return 0; // Return 0 on success
+	}
+	/*
+	* Texture::decode() - Decode the image file into a surface which will be uploaded by load()
+	* ! This doesn't use the renderer so it can be called from a loader thread
+	*/
+	int Texture::decode() {
+		if (is_loaded) { // Do not attempt to decode the texture if it has already been loaded
+			return 1; // Return 1 when already loaded
+		}
+		if (decoded_surface != nullptr) {
+			return 0; // Return 0 when already decoded since load() can still upload it
+		}
+
+		if (get_options().is_headless) {
+			return 2; // Return 2 when texture rendering is not applicable
+		}
+
+		// Load the texture into a temporary surface
+		decoded_surface = IMG_Load(path.c_str());
+		if (decoded_surface == nullptr) { // If the surface could not be loaded, output a warning
+			messenger::send({"engine", "texture"}, E_MESSAGE::WARNING, "Failed to load texture \"" + name + "\": " + IMG_GetError());
+			return 3; // Return 3 on loding failure
+		}
+
 		return 0; // Return 0 on success
 	}
 	/*
 	* Texture::load() - Load the texture from its given filename
+	* ! If the image was already decoded by decode(), only the upload is done here
 	*/
 	int Texture::load() {
 		if (is_loaded) { // Do not attempt to load the texture if it has already been loaded
@@ -528,16 +681,16 @@ namespace bee {
 			return 2; // Return 2 when texture rendering is not applicable
 		}
 
-		// Load the texture into a temporary surface
-		SDL_Surface* tmp_surface;
-		tmp_surface = IMG_Load(path.c_str());
-		if (tmp_surface == nullptr) { // If the surface could not be loaded, output a warning
-			messenger::send({"engine", "texture"}, E_MESSAGE::WARNING, "Failed to load texture \"" + name + "\": " + IMG_GetError());
-			return 3; // Return 3 on loding failure
+		if (decoded_surface == nullptr) {
+			int r = decode();
+			if (r != 0) {
+				return r; // Return 3 on loading failure
+			}
 		}
 
-		load_from_surface(tmp_surface); // Load the surface into a texture
-		SDL_FreeSurface(tmp_surface); // Free the temporary surface
+		load_from_surface(decoded_surface); // Load the surface into a texture
+		SDL_FreeSurface(decoded_surface); // Free the temporary surface
+		decoded_surface = nullptr;
 
 		return 0; // Return 0 on success
 	}
@@ -643,10 +796,25 @@ namespace bee {
 	* Texture::free() - Free the texture texture and delete all of its buffers
 	*/
 	int Texture::free() {
+		if (decoded_surface != nullptr) { // Free the image if it was decoded but never uploaded
+			SDL_FreeSurface(decoded_surface);
+			decoded_surface = nullptr;
+		}
+
 		if (!is_loaded) { // Do not attempt to free the textures if the texture has not been loaded
 			return 0; // Return 0 on success
 		}
 
+		if (atlas_page >= 0) { // Atlas textures don't own their OpenGL objects, they are deleted by atlas::clear()
+			atlas_page = -1;
+			atlas_rect = {0, 0, 0, 0};
+
+			is_loaded = false;
+			has_draw_failed = false;
+
+			return 0; // Return 0 on success
+		}
+
 		// Delete the vertex and index buffer
 		glDeleteBuffers(1, &vbo_vertices);
 		glDeleteBuffers(1, &ibo);
@@ -767,10 +935,22 @@ namespace bee {
 		td.color = glm::vec4(new_color.r, new_color.g, new_color.b, new_color.a); // Normalize the color values from 0.0 to 1.0
 		td.color /= 255.0f;
 
-		// Bind the texture coordinates of the current subimage
-		td.buffer = vbo_texcoords[current_subimage];
+		if (atlas_page >= 0) { // Draw the unit quad of the atlas page scaled to the size of the subimage
+			const AtlasPage* page = atlas::internal::get_page(atlas_page);
+			td.vao = page->vao;
+			td.texture = page->gl_texture;
+			td.ibo = page->ibo;
+			td.rotation = glm::scale(td.rotation, glm::vec3(static_cast<float>(rect_width), static_cast<float>(height), 1.0f));
 
-		render::queue_texture(this, td);
+			// Bind the texcoords of the whole page and select the current subimage from them
+			td.buffer = page->vbo_texcoords;
+			td.texrect = get_atlas_texrect(current_subimage);
+		} else {
+			// Bind the texture coordinates of the current subimage
+			td.buffer = vbo_texcoords[current_subimage];
+		}
+
+		render::queue_texture(td);
 
 		// If the texture has reached the end of its subimage cycle, set the animation boolean
 		if ((is_animated)&&(current_subimage == subimage_amount-1)) {
@@ -808,6 +988,47 @@ namespace bee {
 	int Texture::draw(int x, int y, Uint32 subimage_time) {
 		return draw(x, y, subimage_time, -1, -1, 0.0, {255, 255, 255, 255}); // Return the result of drawing the texture
 	}
+	/*
+	* Texture::draw_instanced() - Draw the given amount of particles from the mapped particle buffer with a single instanced call
+	* ! The particles must already be written to the range returned by render::map_particles(), see it for the data format
+	* ! Unlike the other draw functions, the particles are drawn immediately instead of being queued
+	* @amount: the amount of particles to draw
+	*/
+	int Texture::draw_instanced(size_t amount) {
+		int rect_width = width;
+		if (subimage_amount > 1) {
+			rect_width = subimage_width;
+		}
+
+		// Offset the texcoords of the first subimage in the shader instead of binding the texcoords of each subimage
+		GLfloat w = 0.0f;
+		if ((subimage_amount > 1)&&(width > 0)) {
+			w = static_cast<GLfloat>(subimage_width) / width;
+		}
+
+		if (atlas_page >= 0) {
+			const AtlasPage* page = atlas::internal::get_page(atlas_page);
+			TextureDrawData td (page->vao, page->gl_texture, page->ibo);
+			td.buffer = page->vbo_texcoords;
+			td.texrect = get_atlas_texrect(0);
+
+			// The subimages are offset by whole multiples of the first subimage's texrect
+			if (render::render_particles(td, glm::vec2(rotate_x*rect_width, rotate_y*height), (subimage_amount > 1) ? 1.0f : 0.0f, glm::vec2(static_cast<float>(rect_width), static_cast<float>(height)), amount)) {
+				return 1; // Return 1 when the particles failed to draw
+			}
+
+			return 0; // Return 0 on success
+		}
+
+		TextureDrawData td (vao, gl_texture, ibo);
+		td.buffer = vbo_texcoords[0];
+
+		if (render::render_particles(td, glm::vec2(rotate_x*rect_width, rotate_y*height), w, glm::vec2(1.0f), amount)) {
+			return 1; // Return 1 when the particles failed to draw
+		}
+
+		return 0; // Return 0 on success
+	}
 	int Texture::draw_transform(const TextureTransform& tr) {
 		if (!is_loaded) { // Do not attempt to draw the texture if it has not been loaded
 			if (!has_draw_failed) { // If the draw call hasn't failed before, output a warning
@@ -24,6 +24,8 @@
 
 #include "resource.hpp"
 
+#include "../data/nameindex.hpp"
+
 #include "../render/rgba.hpp"
 
 namespace bee {
@@ -47,6 +49,7 @@ namespace bee {
 		glm::mat4 rotation;
 		glm::vec4 color;
 		GLuint buffer;
+		glm::vec4 texrect; // The texcoord offset and scale of the drawn region, which selects the texture from an atlas page
 
 		// See bee/resources/texture.cpp for function comments
 		TextureDrawData(GLuint, GLuint, GLuint);
@@ -56,6 +59,7 @@ namespace bee {
 	class Texture: public Resource { // The texture resource class is used to draw all on-screen objects
 			static std::map<int,Texture*> list;
 			static int next_id;
+			static NameIndex<Texture> names; // The index of the resources by name
 
 			int id; // The id of the resource
 			std::string name; // An arbitrary name for the resource
@@ -69,6 +73,7 @@ namespace bee {
 			double rotate_x, rotate_y; // The origin around which the texture is rotated, scaled from 0.0 to 1.0 in both width and height
 
 			SDL_Texture* texture; // The internal texture storage for SDL mode
+			SDL_Surface* decoded_surface; // The image which was decoded by decode() and is waiting to be uploaded by load()
 			bool is_loaded; // Whether the image file was successfully loaded into a texture
 			bool has_draw_failed; // Whether the draw function has previously failed, this prevents continuous warning outputs
 
@@ -80,7 +85,12 @@ namespace bee {
 
 			GLuint framebuffer; // The framebuffer object used by set_as_target()
 
+			int atlas_page; // The atlas page which the texture was packed into, or -1 when it is loaded individually
+			SDL_Rect atlas_rect; // The rectangle of the texture in its atlas page
+
 			// See bee/resources/texture.cpp for function comments
+			glm::vec4 get_atlas_texrect(unsigned int) const;
+
 			int drawing_begin();
 			int drawing_end();
 
@@ -95,6 +105,9 @@ namespace bee {
 			int add_to_resources();
 			static size_t get_amount();
 			static Texture* get(int);
+			static Texture* get_by_name(const std::string&);
+			static size_t get_name_handle(const std::string&);
+			static Texture* get_by_handle(size_t);
 			int reset();
 			int print() const;
 
@@ -113,6 +126,7 @@ namespace bee {
 			double get_rotate_y() const;
 			SDL_Texture* get_texture() const;
 			bool get_is_loaded() const;
+			int get_atlas_page() const;
 
 			int set_name(const std::string&);
 			int set_path(const std::string&);
@@ -131,6 +145,8 @@ namespace bee {
 			int crop_image_height(int);
 
 			int load_from_surface(SDL_Surface*);
+			int load_from_atlas(int, SDL_Rect);
+			int decode();
 			int load();
 			int load_as_target(int, int);
 			int free();
@@ -138,6 +154,7 @@ namespace bee {
 			int draw_subimage(int, int, unsigned int, int, int, double, RGBA);
 			int draw(int, int, Uint32, int, int, double, RGBA);
 			int draw(int, int, Uint32);
+			int draw_instanced(size_t);
 			int draw_transform(const TextureTransform&);
 			GLuint set_as_target();
 	};
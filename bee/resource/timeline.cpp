@@ -24,6 +24,7 @@
 namespace bee {
 	std::map<int,Timeline*> Timeline::list;
 	int Timeline::next_id = 0;
+	NameIndex<Timeline> Timeline::names;
 
 	/*
 	* Timeline::Timeline() - Default construct the timeline
@@ -67,6 +68,7 @@ namespace bee {
 	* Timeline::~Timeline() - Remove the timeline from the resource list
 	*/
 	Timeline::~Timeline() {
+		names.remove(name, this);
 		list.erase(id); // Remove the timeline from the resource list
 	}
 
@@ -77,6 +79,7 @@ namespace bee {
 		if (id < 0) { // If the resource needs to be added to the resource list
 			id = next_id++;
 			list.emplace(id, this); // Add the resource and with the new id
+			names.add(name, this);
 		}
 
 		return 0; // Return 0 on success
@@ -98,11 +101,32 @@ namespace bee {
 		return nullptr;
 	}
 	/*
+	* Timeline::get_by_name() - Return the timeline resource with the given name, or nullptr if there isn't one
+	* @name: the name of the desired timeline
+	*/
+	Timeline* Timeline::get_by_name(const std::string& name) {
+		return names.find(name);
+	}
+	/*
+	* Timeline::get_name_handle() - Return a handle for the given name which can be cached and passed to get_by_handle()
+	* @name: the name to get the handle of
+	*/
+	size_t Timeline::get_name_handle(const std::string& name) {
+		return names.get_handle(name);
+	}
+	/*
+	* Timeline::get_by_handle() - Return the timeline resource which currently has the name of the given handle, or nullptr if there isn't one
+	* @handle: the name handle
+	*/
+	Timeline* Timeline::get_by_handle(size_t handle) {
+		return names.get(handle);
+	}
+	/*
 	* Timeline::reset() - Reset all resource variables for reinitialization
 	*/
 	int Timeline::reset() {
 		// Reset all properties
-		name = "";
+		set_name("");
 		path = "";
 		action_list.clear();
 		next_action = action_list.end();
@@ -184,6 +208,13 @@ namespace bee {
 	* Timeline::set_*() - Set the requested resource data
 	*/
 	int Timeline::set_name(const std::string& new_name) {
+		if (id >= 0) { // If the timeline is in the resource list, reindex it under the new name
+			names.remove(name, this);
+			name = new_name;
+			names.add(name, this);
+			return 0;
+		}
+
 		name = new_name;
 		return 0;
 	}
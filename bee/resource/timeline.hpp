@@ -17,12 +17,15 @@
 
 #include "resource.hpp"
 
+#include "../data/nameindex.hpp"
+
 namespace bee {
 	typedef std::multimap<Uint32, std::pair<std::string,std::function<void()>>> timeline_list_t;
 
 	class Timeline: public Resource { // The timeline resource class is used to execute specific actions at a given time offset
 			static std::map<int,Timeline*> list;
 			static int next_id;
+			static NameIndex<Timeline> names; // The index of the resources by name
 
 			int id; // The id of resource
 			std::string name; // An arbitrary name for the resource
@@ -46,6 +49,9 @@ namespace bee {
 			int add_to_resources();
 			static size_t get_amount();
 			static Timeline* get(int);
+			static Timeline* get_by_name(const std::string&);
+			static size_t get_name_handle(const std::string&);
+			static Timeline* get_by_handle(size_t);
 			int reset();
 			int print() const;
 
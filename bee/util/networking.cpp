@@ -12,12 +12,71 @@
 // Networking functions
 
 #include <iostream>
+#include <algorithm>
 #include <string.h> // Required for Windows memcpy()
 
 #include "networking.hpp" // Include the function definitions
 
 #include "platform.hpp" // Include the required inet_ntop() function
 
+#if defined(__linux__)&&!defined(BEE_NETWORK_NO_MMSG)
+	#define BEE_NETWORK_MMSG 1 // Use recvmmsg() and sendmmsg() to transfer multiple datagrams per system call
+
+	#include <unordered_map>
+	#include <mutex>
+	#include <errno.h>
+	#include <sys/socket.h>
+	#include <netinet/in.h>
+
+	namespace {
+		const int mmsg_size = 64; // The maximum amount of datagrams which are transferred per system call
+
+		// The leading members of SDL_net's private struct _UDPsocket, copied from SDLnetUDP.c in SDL_net 2.0.1
+		// ! The layout is unchanged through SDL_net 2.2, other versions are still verified by network_udp_get_fd() before use
+		struct network_sdl_udpsocket {
+			int ready;
+			int channel; // The OS socket
+			IPaddress address; // The local address of the socket, as filled by getsockname() in SDLNet_UDP_Open()
+		};
+		std::unordered_map<UDPsocket,int> mmsg_sockets; // The OS sockets which have been verified for each UDP socket, or -1 when it must fall back to SDL_net
+		std::mutex mmsg_mutex; // The mutex which protects the verified sockets since the network thread can use them while others are closed
+		bool has_mmsg_failed = false; // Whether a socket has already failed verification, so that the fallback is only logged once
+
+		/*
+		* network_udp_get_fd() - Return the OS socket of the given UDP socket, or -1 when it can't be verified
+		* ! SDL_net doesn't expose the socket so it is read from the private struct and then verified against the OS
+		* @udp: the socket to get the OS socket for
+		*/
+		int network_udp_get_fd(UDPsocket udp) {
+			std::lock_guard<std::mutex> lock (mmsg_mutex);
+			auto it = mmsg_sockets.find(udp);
+			if (it != mmsg_sockets.end()) {
+				return it->second;
+			}
+
+			const network_sdl_udpsocket* s = reinterpret_cast<const network_sdl_udpsocket*>(udp);
+			int fd = s->channel;
+
+			sockaddr_in sa;
+			socklen_t sa_size = sizeof(sa);
+			if (
+				(getsockname(fd, reinterpret_cast<sockaddr*>(&sa), &sa_size) != 0)
+				||(sa.sin_family != AF_INET)
+				||(sa.sin_port != s->address.port)
+			) {
+				if (!has_mmsg_failed) {
+					has_mmsg_failed = true;
+					std::cerr << "NET ERR Failed to verify UDP socket against the SDL_net " << SDL_NET_MAJOR_VERSION << "." << SDL_NET_MINOR_VERSION << "." << SDL_NET_PATCHLEVEL << " socket layout, falling back to SDL_net for batched transfers\n";
+				}
+				fd = -1;
+			}
+
+			mmsg_sockets.emplace(udp, fd);
+			return fd;
+		}
+	}
+#endif
+
 /*
 * network_init() - Initialize SDL's networking functionality
 */
@@ -187,6 +246,13 @@ std::pair<int,UDPsocket> network_udp_open_range(int port, size_t range) {
 * @udp: the socket to close
 */
 int network_udp_close(UDPsocket* udp) {
+	#ifdef BEE_NETWORK_MMSG
+		{
+			std::lock_guard<std::mutex> lock (mmsg_mutex);
+			mmsg_sockets.erase(*udp); // Forget the OS socket since the pointer might be reused
+		}
+	#endif
+
 	SDLNet_UDP_Close(*udp); // Close the socket
 	*udp = nullptr; // Clear the pointer
 	return 0; // Return 0 on success
@@ -312,6 +378,130 @@ int network_udp_send_vector(UDPsocket udp, UDPpacket** packets, int amount) {
 int network_udp_recv_vector(UDPsocket udp, UDPpacket** packets) {
 	return SDLNet_UDP_RecvV(udp, packets); // Return the attempt to receive the data
 }
+/*
+* network_udp_send_batch() - Send multiple data packets via UDP to the address of each packet
+* ! On Linux this uses sendmmsg() so that an entire batch only requires a few system calls
+* @udp: the socket to send the data through
+* @packets: a pointer to an array of packet data
+* @amount: the amount of packets in the array
+*/
+int network_udp_send_batch(UDPsocket udp, UDPpacket** packets, int amount) {
+	#ifdef BEE_NETWORK_MMSG
+		const int fd = network_udp_get_fd(udp);
+		if (fd >= 0) {
+			mmsghdr msgs[mmsg_size];
+			iovec iovs[mmsg_size];
+			sockaddr_in addrs[mmsg_size];
+
+			int sent = 0;
+			while (sent < amount) {
+				const int n = std::min(amount - sent, mmsg_size);
+				for (int i=0; i<n; ++i) {
+					UDPpacket* p = packets[sent+i];
+
+					addrs[i] = sockaddr_in();
+					addrs[i].sin_family = AF_INET;
+					addrs[i].sin_addr.s_addr = p->address.host; // The address is already in Network Byte Order
+					addrs[i].sin_port = p->address.port;
+
+					iovs[i].iov_base = p->data;
+					iovs[i].iov_len = p->len;
+
+					msgs[i] = mmsghdr();
+					msgs[i].msg_hdr.msg_name = &addrs[i];
+					msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+					msgs[i].msg_hdr.msg_iov = &iovs[i];
+					msgs[i].msg_hdr.msg_iovlen = 1;
+				}
+
+				int r = sendmmsg(fd, msgs, n, 0);
+				if (r <= 0) {
+					if ((r < 0)&&(errno == EINTR)) {
+						continue;
+					}
+					std::cerr << "NET ERR Failed to send UDP batch: " << strerror(errno) << "\n";
+					break;
+				}
+
+				for (int i=0; i<r; ++i) {
+					packets[sent+i]->status = msgs[i].msg_len;
+				}
+				sent += r;
+			}
+
+			return sent; // Return the amount of packets which were sent
+		}
+	#endif
+
+	int sent = 0;
+	for (int i=0; i<amount; ++i) {
+		if (SDLNet_UDP_Send(udp, -1, packets[i]) > 0) { // Send the packet to its own address
+			++sent;
+		}
+	}
+	return sent; // Return the amount of packets which were sent
+}
+/*
+* network_udp_recv_batch() - Receive up to the given amount of data packets via UDP without blocking
+* ! On Linux this uses recvmmsg() so that an entire batch only requires a single system call
+* ! The channel of each packet is always set to -1
+* @udp: the socket to receive the data from
+* @packets: a pointer to an array of packets which have each been allocated
+* @amount: the maximum amount of packets to receive
+*/
+int network_udp_recv_batch(UDPsocket udp, UDPpacket** packets, int amount) {
+	#ifdef BEE_NETWORK_MMSG
+		const int fd = network_udp_get_fd(udp);
+		if (fd >= 0) {
+			mmsghdr msgs[mmsg_size];
+			iovec iovs[mmsg_size];
+			sockaddr_in addrs[mmsg_size];
+
+			const int n = std::min(amount, mmsg_size);
+			for (int i=0; i<n; ++i) {
+				iovs[i].iov_base = packets[i]->data;
+				iovs[i].iov_len = packets[i]->maxlen;
+
+				msgs[i] = mmsghdr();
+				msgs[i].msg_hdr.msg_name = &addrs[i];
+				msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+				msgs[i].msg_hdr.msg_iov = &iovs[i];
+				msgs[i].msg_hdr.msg_iovlen = 1;
+			}
+
+			int r = recvmmsg(fd, msgs, n, MSG_DONTWAIT, nullptr);
+			if (r < 0) {
+				if ((errno == EAGAIN)||(errno == EWOULDBLOCK)||(errno == EINTR)) {
+					return 0; // Return 0 when there is nothing to receive
+				}
+				std::cerr << "NET ERR Failed to receive UDP batch: " << strerror(errno) << "\n";
+				return -1; // Return -1 on failure
+			}
+
+			for (int i=0; i<r; ++i) {
+				packets[i]->channel = -1;
+				packets[i]->len = msgs[i].msg_len;
+				packets[i]->status = msgs[i].msg_len;
+				packets[i]->address.host = addrs[i].sin_addr.s_addr;
+				packets[i]->address.port = addrs[i].sin_port;
+			}
+
+			return r; // Return the amount of packets which were received
+		}
+	#endif
+
+	int received = 0;
+	while (received < amount) {
+		int r = SDLNet_UDP_Recv(udp, packets[received]);
+		if (r < 0) {
+			return (received > 0) ? received : -1; // Return -1 on failure when nothing was received
+		} else if (r == 0) {
+			break;
+		}
+		++received;
+	}
+	return received; // Return the amount of packets which were received
+}
 
 /*
 * network_packet_alloc() - Allocate space for packet data of a given size
@@ -43,6 +43,8 @@ int network_udp_send(UDPsocket, int, size_t, const Uint8*);
 int network_udp_recv(UDPsocket, UDPpacket*);
 int network_udp_send_vector(UDPsocket, UDPpacket**, int);
 int network_udp_recv_vector(UDPsocket, UDPpacket**);
+int network_udp_send_batch(UDPsocket, UDPpacket**, int);
+int network_udp_recv_batch(UDPsocket, UDPpacket**, int);
 
 UDPpacket* network_packet_alloc(int);
 UDPpacket* network_packet_resize(UDPpacket*, int);
@@ -13,6 +13,18 @@
 
 #include <random>
 #include <time.h>
+#include <cstdint>
+
+// Enable the carry-less multiplication checksum path on x86 compilers which support choosing it at runtime
+#if (defined(_MSC_VER))&&((defined(_M_X64))||(defined(_M_IX86)))
+	#include <intrin.h>
+	#define BEE_CHECKSUM_CLMUL 1
+	#define BEE_CHECKSUM_TARGET
+#elif (defined(__GNUC__))&&((defined(__x86_64__))||(defined(__i386__)))
+	#include <immintrin.h>
+	#define BEE_CHECKSUM_CLMUL 1
+	#define BEE_CHECKSUM_TARGET __attribute__((target("pclmul,sse4.1")))
+#endif
 
 #include "real.hpp" // Include the function definitions
 
@@ -424,31 +436,42 @@ template double qmod<double>(double, unsigned int);
 * @index: the index of the value to return
 */
 unsigned int checksum_internal_table(size_t index) {
-	static std::vector<unsigned int> table;
-
-	static bool is_initialized = false;
-	if (!is_initialized) {
-		unsigned int polynomial = 0x04C11DB7; // Use the official polynomial used by most implementations
-
-		table.resize(256);
-		for (unsigned int i=0; i<256; ++i) {
-			table[i] = checksum_internal_reflect(i, 8) << 24;
-
-			for (unsigned int j=0; j<8; ++j) {
-				table[i] =
-					(table[i] << 1)
-					^ (
-						(table[i] & (1 << 31)) ? polynomial : 0
-					);
+	return checksum_internal_slices()[0][index];
+}
+/*
+* checksum_internal_slices() - Return the 8 CRC lookup tables used by slicing-by-8
+* ! The first table is the standard byte-at-a-time table, and each following table advances the checksum by one more byte of zeros
+*/
+const unsigned int (*checksum_internal_slices())[256] {
+	static const struct ChecksumTables {
+		unsigned int tables[8][256];
+
+		ChecksumTables() {
+			unsigned int polynomial = 0x04C11DB7; // Use the official polynomial used by most implementations
+
+			for (unsigned int i=0; i<256; ++i) {
+				unsigned int value = checksum_internal_reflect(i, 8) << 24;
+
+				for (unsigned int j=0; j<8; ++j) {
+					value =
+						(value << 1)
+						^ (
+							(value & (1u << 31)) ? polynomial : 0
+						);
+				}
+
+				tables[0][i] = checksum_internal_reflect(value, 32);
 			}
 
-			table[i] = checksum_internal_reflect(table[i], 32);
+			for (unsigned int i=0; i<256; ++i) {
+				for (size_t k=1; k<8; ++k) {
+					tables[k][i] = (tables[k-1][i] >> 8) ^ tables[0][tables[k-1][i] & 0xff];
+				}
+			}
 		}
+	} t; // Build the tables once in a thread-safe static initializer
 
-		is_initialized = true;
-	}
-
-	return table[index];
+	return t.tables;
 }
 /*
 * checksum_internal_reflect() - Reflect the CRC table value to conform to the CRC standard
@@ -458,9 +481,9 @@ unsigned int checksum_internal_table(size_t index) {
 unsigned int checksum_internal_reflect(unsigned int reflect, const char bits) {
 	unsigned int value = 0;
 
-	for (int i=0; i<(bits+1); ++i) { // Swap bits
+	for (int i=0; i<bits; ++i) { // Swap bits
 		if (reflect & 1) {
-			value |= (1 << (bits-i));
+			value |= (1u << (bits-1-i));
 		}
 		reflect >>= 1;
 	}
@@ -468,19 +491,184 @@ unsigned int checksum_internal_reflect(unsigned int reflect, const char bits) {
 	return value;
 }
 /*
+* checksum_internal_slice8() - Advance the given CRC state over the given data 8 bytes at a time
+* @crc: the inverted CRC state
+* @data: the data to process
+* @size: the amount of bytes to process
+*/
+unsigned int checksum_internal_slice8(unsigned int crc, const unsigned char* data, size_t size) {
+	const unsigned int (*t)[256] = checksum_internal_slices();
+
+	while (size >= 8) {
+		const unsigned int one = crc ^ (data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<unsigned int>(data[3]) << 24));
+		const unsigned int two = data[4] | (data[5] << 8) | (data[6] << 16) | (static_cast<unsigned int>(data[7]) << 24);
+		crc =
+			t[7][one & 0xff] ^ t[6][(one >> 8) & 0xff] ^ t[5][(one >> 16) & 0xff] ^ t[4][one >> 24]
+			^ t[3][two & 0xff] ^ t[2][(two >> 8) & 0xff] ^ t[1][(two >> 16) & 0xff] ^ t[0][two >> 24];
+
+		data += 8;
+		size -= 8;
+	}
+
+	while (size-- > 0) { // Finish the remaining bytes one at a time
+		crc = (crc >> 8) ^ t[0][(crc & 0xff) ^ *data++];
+	}
+
+	return crc;
+}
+#ifdef BEE_CHECKSUM_CLMUL
+/*
+* checksum_internal_fold() - Advance the given CRC state over the given data by folding 64 bytes at a time with carry-less multiplication
+* ! See "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction" by Gopal et al. for the derivation of the constants
+* @crc: the inverted CRC state
+* @data: the data to process, which must be at least 64 bytes
+* @size: the amount of bytes to process, which must be a multiple of 16
+*/
+BEE_CHECKSUM_TARGET unsigned int checksum_internal_fold(unsigned int crc, const unsigned char* data, size_t size) {
+	alignas(16) static const uint64_t k1k2[] = {0x0154442bd4, 0x01c6e41596};
+	alignas(16) static const uint64_t k3k4[] = {0x01751997d0, 0x00ccaa009e};
+	alignas(16) static const uint64_t k5k0[] = {0x0163cd6124, 0x0000000000};
+	alignas(16) static const uint64_t poly[] = {0x01db710641, 0x01f7011641};
+
+	__m128i x0, x1, x2, x3, x4, x5, x6, x7, x8;
+
+	x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x00));
+	x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x10));
+	x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x20));
+	x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x30));
+	x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(crc)));
+	x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k1k2));
+	data += 64;
+	size -= 64;
+
+	while (size >= 64) { // Fold the four accumulators forward by 64 bytes
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+		x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+		x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+		x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+		x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x00)));
+		x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x10)));
+		x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x20)));
+		x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x30)));
+		data += 64;
+		size -= 64;
+	}
+
+	// Fold the four accumulators into one
+	x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k3k4));
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+	while (size >= 16) { // Fold the remaining 16 byte blocks
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data))), x5);
+		data += 16;
+		size -= 16;
+	}
+
+	// Fold 128 bits down to 64 bits
+	x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+	x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+	x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+	x0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(k5k0));
+	x2 = _mm_srli_si128(x1, 4);
+	x1 = _mm_and_si128(x1, x3);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+
+	// Barrett reduce 64 bits down to the 32 bit CRC state
+	x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(poly));
+	x2 = _mm_and_si128(x1, x3);
+	x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+	x2 = _mm_and_si128(x2, x3);
+	x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+
+	return static_cast<unsigned int>(_mm_extract_epi32(x1, 1));
+}
+#endif // BEE_CHECKSUM_CLMUL
+/*
+* checksum_internal_has_clmul() - Return whether the CPU supports the carry-less multiplication path
+* ! The result is checked once at runtime so that the same binary runs on CPUs without PCLMULQDQ or SSE4.1
+*/
+bool checksum_internal_has_clmul() {
+#ifdef BEE_CHECKSUM_CLMUL
+	#ifdef _MSC_VER
+		static const bool has_clmul = [] () {
+			int info[4];
+			__cpuid(info, 1);
+			return ((info[2] & (1 << 1)) != 0)&&((info[2] & (1 << 19)) != 0); // Check for PCLMULQDQ and SSE4.1
+		}();
+	#else
+		static const bool has_clmul = (__builtin_cpu_supports("pclmul"))&&(__builtin_cpu_supports("sse4.1"));
+	#endif
+	return has_clmul;
+#else
+	return false;
+#endif // BEE_CHECKSUM_CLMUL
+}
+/*
+* checksum_internal_clmul() - Advance the given CRC state over the given data with the accelerated path when it's available
+* ! Data which is too short to fold or which doesn't fill a 16 byte block is processed by slicing-by-8
+* @crc: the inverted CRC state
+* @data: the data to process
+* @size: the amount of bytes to process
+*/
+unsigned int checksum_internal_clmul(unsigned int crc, const unsigned char* data, size_t size) {
+#ifdef BEE_CHECKSUM_CLMUL
+	if ((size >= 64)&&(checksum_internal_has_clmul())) {
+		const size_t folded = size & ~static_cast<size_t>(15);
+		crc = checksum_internal_fold(crc, data, folded);
+		data += folded;
+		size -= folded;
+	}
+#endif // BEE_CHECKSUM_CLMUL
+	return checksum_internal_slice8(crc, data, size);
+}
+/*
 * get_checksum() - Return the CRC32 checksum for the given data
-* @data: the data vector to generate a checksum for
+* @data: the data to generate a checksum for
+* @size: the amount of bytes in the data
 */
-unsigned int get_checksum(const std::vector<unsigned char>& data) {
+unsigned int get_checksum(const unsigned char* data, size_t size) {
 	unsigned int crc = 0xffffffff; // Initialize the checksum
 
-	for (auto& d : data) {
-		crc = (crc >> 8) ^ checksum_internal_table((crc & 0xff) ^ d);
-	}
+	crc = checksum_internal_clmul(crc, data, size);
 
 	return (crc ^ 0xffffffff); // Finalize and return the checksum
 }
 /*
+* get_checksum() - Return the CRC32 checksum for the given data
+* @data: the data vector to generate a checksum for
+*/
+unsigned int get_checksum(const std::vector<unsigned char>& data) {
+	return get_checksum(data.data(), data.size());
+}
+/*
+* get_checksum() - Return the CRC32 checksum for the given data after skipping the given amount of bytes
+* ! This allows a checksum to be stored at the beginning of the data that it covers
+* @data: the data vector to generate a checksum for
+* @offset: the amount of bytes to skip
+*/
+unsigned int get_checksum(const std::vector<unsigned char>& data, size_t offset) {
+	if (offset >= data.size()) {
+		return get_checksum(nullptr, 0);
+	}
+	return get_checksum(data.data()+offset, data.size()-offset);
+}
+/*
 * verify_checksum() - Return whether the data matches the checksum
 * @data: the data to check
 * @crc: the checksum to verify against
@@ -488,5 +676,14 @@ unsigned int get_checksum(const std::vector<unsigned char>& data) {
 bool verify_checksum(const std::vector<unsigned char>& data, unsigned int crc) {
 	return (get_checksum(data) == crc);
 }
+/*
+* verify_checksum() - Return whether the data after the given amount of bytes matches the checksum
+* @data: the data to check
+* @offset: the amount of bytes to skip
+* @crc: the checksum to verify against
+*/
+bool verify_checksum(const std::vector<unsigned char>& data, size_t offset, unsigned int crc) {
+	return (get_checksum(data, offset) == crc);
+}
 
 #endif // BEE_UTIL_REAL
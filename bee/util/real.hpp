@@ -65,8 +65,15 @@ template <typename T>
 extern T qmod(T, unsigned int);
 
 unsigned int checksum_internal_table(size_t);
+const unsigned int (*checksum_internal_slices())[256];
 unsigned int checksum_internal_reflect(unsigned int, const char);
+unsigned int checksum_internal_slice8(unsigned int, const unsigned char*, size_t);
+bool checksum_internal_has_clmul();
+unsigned int checksum_internal_clmul(unsigned int, const unsigned char*, size_t);
+unsigned int get_checksum(const unsigned char*, size_t);
 unsigned int get_checksum(const std::vector<unsigned char>&);
+unsigned int get_checksum(const std::vector<unsigned char>&, size_t);
 bool verify_checksum(const std::vector<unsigned char>&, unsigned int);
+bool verify_checksum(const std::vector<unsigned char>&, size_t, unsigned int);
 
 #endif // BEE_UTIL_REAL_H
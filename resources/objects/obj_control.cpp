@@ -171,8 +171,13 @@ void ObjControl::destroy(bee::Instance* self) {
 	Object::destroy(self);
 }
 void ObjControl::step_mid(bee::Instance* self) {
+	// Resolve the data keys once instead of looking up the names every step
+	static const Uint32 camx = bee::DataMap::get_key("camx");
+	static const Uint32 camy = bee::DataMap::get_key("camy");
+	static const Uint32 camz = bee::DataMap::get_key("camz");
+
 	if (bee::render::get_3d()) {
-		bee::render::set_camera(new bee::Camera(glm::vec3(_d("camx"), _d("camy"), -540.0 + _d("camz")), glm::vec3((-1920.0/2.0+bee::get_mouse_global_x())/1920.0*2.0, (-1080.0/2.0+bee::get_mouse_global_y())/1080.0*2.0, 1.0), glm::vec3(0.0, -1.0, 0.0)));
+		bee::render::set_camera(new bee::Camera(glm::vec3(_d(camx), _d(camy), -540.0 + _d(camz)), glm::vec3((-1920.0/2.0+bee::get_mouse_global_x())/1920.0*2.0, (-1080.0/2.0+bee::get_mouse_global_y())/1080.0*2.0, 1.0), glm::vec3(0.0, -1.0, 0.0)));
 	}
 }
 void ObjControl::mouse_press(bee::Instance* self, SDL_Event* e) {
@@ -18,6 +18,22 @@
 #include "util/debug.hpp"
 #include "util/template.hpp"
 
+#include "core/jobs.hpp"
+
+#include "data/datamap.hpp"
+#include "data/instancemap.hpp"
+#include "data/mpscqueue.hpp"
+#include "data/nameindex.hpp"
+#include "data/rectpacker.hpp"
 #include "data/serialdata.hpp"
+#include "data/serialschema.hpp"
+#include "data/sidp.hpp"
+#include "data/spatialgrid.hpp"
+#include "data/spscqueue.hpp"
+
+#include "network/packet.hpp"
+#include "network/snapshot.hpp"
 
 #include "render/rgba.hpp"
+
+#include "resource/instancelist.hpp"
@@ -0,0 +1,53 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef TESTS_CORE_JOBS
+#define TESTS_CORE_JOBS 1
+
+#include <vector>
+
+#include "doctest.h" // Include the required unit testing library
+
+#include "../../bee/core/jobs.hpp"
+
+TEST_SUITE_BEGIN("core");
+
+TEST_CASE("jobs/parallel_for") {
+	std::vector<int> v (1000, 0);
+	auto func = [&v] (size_t begin, size_t end) {
+		for (size_t i=begin; i<end; ++i) {
+			v[i] += static_cast<int>(i);
+		}
+	};
+
+	REQUIRE(bee::jobs::parallel_for(v.size(), func) == 0); // Without workers the range is run on the calling thread
+	REQUIRE(v[999] == 999);
+
+	REQUIRE(bee::jobs::internal::init(3) == 0);
+	REQUIRE(bee::jobs::get_worker_amount() == 3);
+
+	for (int j=0; j<10; ++j) {
+		REQUIRE(bee::jobs::parallel_for(v.size(), func) == 0);
+	}
+	REQUIRE(bee::jobs::get_is_running() == false);
+
+	bool is_correct = true;
+	for (size_t i=0; i<v.size(); ++i) {
+		if (v[i] != 11*static_cast<int>(i)) {
+			is_correct = false;
+		}
+	}
+	REQUIRE(is_correct);
+
+	REQUIRE(bee::jobs::internal::close() == 0);
+	REQUIRE(bee::jobs::get_worker_amount() == 0);
+}
+
+TEST_SUITE_END();
+
+#endif // TESTS_CORE_JOBS
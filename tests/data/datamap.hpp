@@ -0,0 +1,64 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef TESTS_DATA_DATAMAP
+#define TESTS_DATA_DATAMAP 1
+
+#include "doctest.h" // Include the required unit testing library
+
+#include "../../bee/data/datamap.hpp"
+
+TEST_SUITE_BEGIN("data");
+
+TEST_CASE("datamap/keys") {
+	const Uint32 a = bee::DataMap::get_key("datamap_test_a");
+	const Uint32 b = bee::DataMap::get_key("datamap_test_b");
+	REQUIRE(a != b);
+	REQUIRE(bee::DataMap::get_key("datamap_test_a") == a);
+	REQUIRE(bee::DataMap::get_key_name(b) == "datamap_test_b");
+
+	Uint32 c = 0;
+	REQUIRE(bee::DataMap::get_key("datamap_test_missing", &c) == false);
+	REQUIRE(bee::DataMap::get_key("datamap_test_b", &c));
+	REQUIRE(c == b);
+}
+TEST_CASE("datamap/values") {
+	bee::DataMap m;
+	REQUIRE(m.empty());
+
+	bee::SIDP& hp = m["hp"];
+	hp = 10;
+	const Uint32 hp_key = bee::DataMap::get_key("hp");
+	for (int i=0; i<100; ++i) { // References must stay valid while other keys are inserted
+		m["datamap_test_" + std::to_string(i)] = i;
+	}
+	REQUIRE(&m[hp_key] == &hp);
+	REQUIRE(SIDP_i(m[hp_key]) == 10);
+	REQUIRE(m.size() == 101);
+
+	REQUIRE(m.find("datamap_test_missing") == nullptr);
+	REQUIRE(m.find(std::string("hp")) == &hp);
+
+	REQUIRE(m.erase(hp_key) == 0);
+	REQUIRE(m.erase(hp_key) == 1);
+	REQUIRE(m.find(hp_key) == nullptr);
+	m["speed"] = 2.5;
+	REQUIRE(m.size() == 101);
+
+	std::map<std::string,bee::SIDP> named = m.get_map();
+	REQUIRE(named.size() == 101);
+	REQUIRE(SIDP_d(named["speed"]) == 2.5);
+
+	bee::DataMap m2 (named);
+	REQUIRE(m2.size() == 101);
+	REQUIRE(SIDP_i(m2["datamap_test_42"]) == 42);
+}
+
+TEST_SUITE_END();
+
+#endif // TESTS_DATA_DATAMAP
@@ -0,0 +1,85 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef TESTS_DATA_INSTANCEMAP
+#define TESTS_DATA_INSTANCEMAP 1
+
+#include <cstring>
+
+#include "doctest.h" // Include the required unit testing library
+
+#include "../../bee/data/instancemap.hpp"
+
+TEST_SUITE_BEGIN("data");
+
+TEST_CASE("instancemap/compile") {
+	bee::InstanceMap map;
+	REQUIRE(map.compile(
+		"# comment\n"
+		"obj_player\t10\t20\t0\n"
+		"!tilex\t3\t32\tobj_wall\t0\t64\t0\n"
+		"!set\tobj_player\t1\t2\t3\n"
+		"@depth\t5\n"
+		"!setend\n"
+		"!tiley\t2\t16\tobj_wall\t0\t0\t1\n"
+	) == 0);
+
+	REQUIRE(map.get_amount() == 6);
+	REQUIRE(map.objects == std::vector<std::string>({"obj_player", "obj_wall"}));
+	REQUIRE(map.object_ids == std::vector<Uint32>({0, 1, 1, 1, 1, 1}));
+	REQUIRE(map.x == std::vector<double>({10.0, 0.0, 32.0, 64.0, 0.0, 0.0}));
+	REQUIRE(map.y == std::vector<double>({20.0, 64.0, 64.0, 64.0, 0.0, 16.0}));
+	REQUIRE(map.z == std::vector<double>({0.0, 0.0, 0.0, 0.0, 1.0, 1.0}));
+	REQUIRE(map.sets == std::vector<std::string>({"!set\tobj_player\t1\t2\t3\n@depth\t5\n!setend\n"}));
+	REQUIRE(map.set_positions == std::vector<Uint32>({4}));
+}
+TEST_CASE("instancemap/serialize") {
+	bee::InstanceMap map;
+	map.add("obj_a", 1.5, 2.5, 3.5);
+	map.add("obj_bb", -4.0, 0.0, 8.0);
+	map.add("obj_a", 5.0, 6.0, 7.0);
+	map.add_set("!set\tobj_a\t0\t0\t0\n!setend\n");
+	map.add("obj_a", 0.0, 0.0, 0.0);
+	map.add_set("!set\tobj_bb\t1\t1\t1\n@depth\t2\n!setend\n");
+
+	const std::string data = map.serialize();
+	REQUIRE(bee::InstanceMap::get_is_compiled(data));
+	REQUIRE(bee::InstanceMap::get_is_compiled("obj_a\t0\t0\t0\n") == false);
+
+	bee::InstanceMap loaded;
+	REQUIRE(loaded.deserialize(data) == 0);
+	REQUIRE(loaded.objects == map.objects);
+	REQUIRE(loaded.object_ids == map.object_ids);
+	REQUIRE(loaded.x == map.x);
+	REQUIRE(loaded.y == map.y);
+	REQUIRE(loaded.z == map.z);
+	REQUIRE(loaded.sets == map.sets);
+	REQUIRE(loaded.set_positions == map.set_positions);
+
+	// Adding to a loaded map should reuse its object table
+	loaded.add("obj_bb", 0.0, 0.0, 0.0);
+	REQUIRE(loaded.objects.size() == 2);
+	REQUIRE(loaded.object_ids.back() == 1);
+
+	REQUIRE(loaded.deserialize(data.substr(0, data.size()-10)) == 2);
+	REQUIRE(loaded.get_amount() == 0);
+
+	// Claim a huge amount of instances and objects in the header without the data for them
+	std::string corrupt (data);
+	const Uint32 amount = 0xffffffff;
+	memcpy(&corrupt[8 + 3*sizeof(Uint32)], &amount, sizeof(amount));
+	REQUIRE(loaded.deserialize(corrupt) == 2);
+	REQUIRE(loaded.get_amount() == 0);
+	memcpy(&corrupt[8 + 2*sizeof(Uint32)], &amount, sizeof(amount));
+	REQUIRE(loaded.deserialize(corrupt) == 2);
+	REQUIRE(loaded.objects.empty());
+}
+
+TEST_SUITE_END();
+
+#endif // TESTS_DATA_INSTANCEMAP
@@ -0,0 +1,84 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef TESTS_DATA_MPSCQUEUE
+#define TESTS_DATA_MPSCQUEUE 1
+
+#include <thread>
+#include <memory>
+#include <vector>
+
+#include "doctest.h" // Include the required unit testing library
+
+#include "../../bee/data/mpscqueue.hpp"
+
+TEST_SUITE_BEGIN("data");
+
+TEST_CASE("mpscqueue/basic") {
+	bee::MPSCQueue<int> q (3);
+	REQUIRE(q.get_capacity() == 4);
+	REQUIRE(q.get_is_empty());
+
+	int v = 0;
+	REQUIRE(q.pop(&v) == false);
+
+	for (int i=0; i<4; ++i) {
+		REQUIRE(q.push(std::move(i)));
+	}
+	REQUIRE(q.push(5) == false);
+
+	REQUIRE(q.pop(&v));
+	REQUIRE(v == 0);
+	REQUIRE(q.push(4));
+	for (int i=1; i<5; ++i) {
+		REQUIRE(q.pop(&v));
+		REQUIRE(v == i);
+	}
+	REQUIRE(q.get_is_empty());
+}
+TEST_CASE("mpscqueue/threads") {
+	bee::MPSCQueue<std::unique_ptr<int>> q (64);
+	const int producer_amount = 4;
+	const int amount = 25000;
+
+	std::vector<std::thread> producers;
+	for (int p=0; p<producer_amount; ++p) {
+		producers.emplace_back([&q, p, amount] () {
+			for (int i=0; i<amount; ) {
+				if (q.push(std::unique_ptr<int>(new int(p*amount + i)))) {
+					++i;
+				}
+			}
+		});
+	}
+
+	// Each producer's items must arrive in order and none can be lost
+	std::vector<int> last (producer_amount, -1);
+	bool is_ordered = true;
+	std::unique_ptr<int> item;
+	for (int i=0; i<producer_amount*amount; ) {
+		if (q.pop(&item)) {
+			const int p = *item / amount;
+			if (*item % amount != last[p]+1) {
+				is_ordered = false;
+			}
+			last[p] = *item % amount;
+			++i;
+		}
+	}
+	for (auto& t : producers) {
+		t.join();
+	}
+
+	REQUIRE(is_ordered);
+	REQUIRE(q.get_is_empty());
+}
+
+TEST_SUITE_END();
+
+#endif // TESTS_DATA_MPSCQUEUE
@@ -0,0 +1,64 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef TESTS_DATA_NAMEINDEX
+#define TESTS_DATA_NAMEINDEX 1
+
+#include "doctest.h" // Include the required unit testing library
+
+#include "../../bee/data/nameindex.hpp"
+
+namespace {
+	struct NamedResource {
+		int id;
+		int get_id() const {
+			return id;
+		}
+	};
+}
+
+TEST_SUITE_BEGIN("data");
+
+TEST_CASE("nameindex") {
+	bee::NameIndex<NamedResource> names;
+	NamedResource a {0}, b {1}, c {2};
+
+	REQUIRE(names.find("a") == nullptr);
+	REQUIRE(names.add("", &a) == 1);
+	REQUIRE(names.add("a", &a) == 0);
+	REQUIRE(names.add("b", &b) == 0);
+	REQUIRE(names.find("a") == &a);
+	REQUIRE(names.find("b") == &b);
+
+	const size_t h = names.get_handle("c");
+	REQUIRE(names.get_handle("c") == h);
+	REQUIRE(names.get(h) == nullptr);
+	REQUIRE(names.add("c", &c) == 0);
+	REQUIRE(names.get(h) == &c);
+
+	// Duplicate names resolve to the resource with the lowest id
+	REQUIRE(names.remove("c", &c) == 0);
+	REQUIRE(names.add("a", &c) == 0);
+	REQUIRE(names.add("b", &a) == 0);
+	REQUIRE(names.find("a") == &a);
+	REQUIRE(names.find("b") == &a);
+	REQUIRE(names.remove("b", &a) == 0);
+	REQUIRE(names.find("b") == &b);
+	REQUIRE(names.remove("a", &a) == 0);
+	REQUIRE(names.find("a") == &c);
+
+	REQUIRE(names.get(h) == nullptr);
+	REQUIRE(names.remove("a", &a) == 2);
+	REQUIRE(names.remove("d", &a) == 1);
+	REQUIRE(names.find("d") == nullptr);
+	REQUIRE(names.get(h+100) == nullptr);
+}
+
+TEST_SUITE_END();
+
+#endif // TESTS_DATA_NAMEINDEX
@@ -0,0 +1,74 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef TESTS_DATA_RECTPACKER
+#define TESTS_DATA_RECTPACKER 1
+
+#include <vector>
+
+#include "doctest.h" // Include the required unit testing library
+
+#include "../../bee/data/rectpacker.hpp"
+
+TEST_SUITE_BEGIN("data");
+
+TEST_CASE("rectpacker/insert") {
+	bee::RectPacker packer (64, 64, 1);
+	SDL_Rect r;
+
+	REQUIRE(packer.insert(0, 10, &r) == false);
+	REQUIRE(packer.insert(65, 10, &r) == false);
+
+	REQUIRE(packer.insert(64, 32, &r));
+	REQUIRE(r.x == 0);
+	REQUIRE(r.y == 0);
+	REQUIRE(packer.insert(31, 31, &r));
+	REQUIRE(r.y == 33);
+	REQUIRE(packer.insert(32, 31, &r));
+	REQUIRE(r.x == 32);
+	REQUIRE(r.y == 33);
+	REQUIRE(packer.insert(1, 1, &r) == false);
+
+	packer.clear();
+	REQUIRE(packer.get_occupancy() == 0.0);
+	REQUIRE(packer.insert(64, 64, &r));
+	REQUIRE(packer.get_occupancy() == 1.0);
+}
+TEST_CASE("rectpacker/overlap") {
+	bee::RectPacker packer (256, 256, 2);
+	std::vector<SDL_Rect> rects;
+
+	// Insert a deterministic spread of sizes until the area is full
+	for (int i=0; i<500; ++i) {
+		SDL_Rect r;
+		if (packer.insert(4 + (i*7)%29, 4 + (i*13)%23, &r)) {
+			rects.push_back(r);
+		}
+	}
+	REQUIRE(rects.size() > 50);
+	REQUIRE(packer.get_occupancy() > 0.5);
+
+	bool is_valid = true;
+	for (size_t i=0; i<rects.size(); ++i) {
+		const SDL_Rect& a = rects[i];
+		if ((a.x < 0)||(a.y < 0)||(a.x+a.w > 256)||(a.y+a.h > 256)) {
+			is_valid = false;
+		}
+		for (size_t e=i+1; e<rects.size(); ++e) {
+			const SDL_Rect& b = rects[e];
+			if ((a.x < b.x+b.w+2)&&(b.x < a.x+a.w+2)&&(a.y < b.y+b.h+2)&&(b.y < a.y+a.h+2)) { // Rectangles must be separated by the padding
+				is_valid = false;
+			}
+		}
+	}
+	REQUIRE(is_valid);
+}
+
+TEST_SUITE_END();
+
+#endif // TESTS_DATA_RECTPACKER
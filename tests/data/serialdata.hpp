@@ -154,6 +154,111 @@ TEST_CASE("serialdata4") {
 	REQUIRE(b1 == b3);
 }
 
+TEST_CASE("serialdata/compact") {
+	unsigned char a1 = 'H', a2;
+	int b1 = -70000, b2;
+	float c1 = 3.14159f, c2;
+	double d1 = 3.141592653589793, d2;
+	std::string e1 = "Hello!", e2;
+	std::vector<Uint8> f1 = {1, 2, 3}, f2;
+	std::map<std::string,std::vector<Uint8>> g1 {
+		{"inst1", {4, 5}},
+		{"inst2", {}}
+	}, g2;
+
+	// Writing
+	bee::SerialData sd1 (32, true);
+	sd1.store_char(a1);
+	sd1.store_int(b1);
+	sd1.store_float(c1);
+	sd1.store_double(d1);
+	sd1.store_string(e1);
+	sd1.store_serial_v(f1);
+	sd1.store_serial_m(g1);
+
+	// Reading
+	bee::SerialData sd2 (sd1.get());
+	REQUIRE(sd2.get_is_compact());
+	REQUIRE(sd2.store_char(a2) == 0);
+	REQUIRE(sd2.store_int(b2) == 0);
+	REQUIRE(sd2.store_float(c2) == 0);
+	REQUIRE(sd2.store_double(d2) == 0);
+	REQUIRE(sd2.store_string(e2) == 0);
+	REQUIRE(sd2.store_serial_v(f2) == 0);
+	REQUIRE(sd2.store_serial_m(g2) == 0);
+
+	REQUIRE(sd1.get().front() == bee::SerialData::COMPACT_HEADER);
+	REQUIRE(a1 == a2);
+	REQUIRE(b1 == b2);
+	REQUIRE(c1 == c2);
+	REQUIRE(d1 == d2);
+	REQUIRE(e1 == e2);
+	REQUIRE(f1 == f2);
+	REQUIRE(g1 == g2);
+	REQUIRE(sd2.store_char(a2) == 1);
+}
+TEST_CASE("serialdata/compact_containers") {
+	std::vector<double> a1 = {0.1, -2.5, 1e300}, a2;
+	std::vector<int> b1, b2;
+	for (int i=0; i<70000; ++i) {
+		b1.push_back(i - 35000);
+	}
+	std::map<std::string,int> c1 {
+		{"config_value1", 1},
+		{"config_value2", -2}
+	}, c2;
+	std::map<int,std::vector<std::string>> d1 {
+		{1, {"a", "b"}},
+		{2, {}}
+	}, d2;
+
+	// Writing
+	bee::SerialData sd1 (256, true);
+	sd1.store_vector(a1);
+	sd1.store_vector(b1);
+	sd1.store_map(c1);
+	sd1.store_map_v<std::string>(d1);
+
+	// Reading
+	bee::SerialData sd2 (sd1.get());
+	REQUIRE(sd2.store_vector(a2) == 0);
+	REQUIRE(sd2.store_vector(b2) == 0);
+	REQUIRE(sd2.store_map(c2) == 0);
+	REQUIRE(sd2.store_map_v<std::string>(d2) == 0);
+
+	REQUIRE(a1 == a2);
+	REQUIRE(b1 == b2);
+	REQUIRE(c1 == c2);
+	REQUIRE(d1 == d2);
+
+	// Reading with the wrong element type
+	sd2.rewind();
+	std::vector<float> e;
+	REQUIRE(sd2.store_vector(e) == 2);
+}
+TEST_CASE("serialdata/compact_size") {
+	std::vector<int> a = {1, 2, 3, 4, 5, 6, 7, 8};
+	std::map<std::string,int> b {
+		{"x", 1},
+		{"y", 2}
+	};
+
+	bee::SerialData sd1;
+	sd1.store_vector(a);
+	sd1.store_map(b);
+
+	bee::SerialData sd2 (32, true);
+	sd2.store_vector(a);
+	sd2.store_map(b);
+
+	REQUIRE(sd2.get().size() < sd1.get().size());
+
+	// Reject lengths which are larger than the remaining data
+	bee::SerialData sd3 (std::vector<Uint8>({bee::SerialData::COMPACT_HEADER, 0xff, 0xff, 0x03}));
+	std::string s;
+	REQUIRE(sd3.store_string(s) == 1);
+}
+
 TEST_SUITE_END();
 
 #endif // TESTS_DATA_SERIALDATA
@@ -0,0 +1,98 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef TESTS_DATA_SERIALSCHEMA
+#define TESTS_DATA_SERIALSCHEMA 1
+
+#include "doctest.h" // Include the required unit testing library
+
+#include "../../bee/data/serialschema.hpp"
+#include "../../bee/data/serialdata.hpp"
+#include "../../bee/data/sidp.hpp"
+
+TEST_SUITE_BEGIN("data");
+
+TEST_CASE("serialschema/record") {
+	const bee::SerialSchema inner ("Inner", {
+		{"mass", bee::E_DATA_TYPE::DOUBLE},
+		{"params", bee::E_DATA_TYPE::VECTOR, bee::E_DATA_TYPE::DOUBLE}
+	});
+	const bee::SerialSchema outer ("Outer", {
+		{"id", bee::E_DATA_TYPE::INT},
+		{"name", bee::E_DATA_TYPE::STRING},
+		{"body", &inner},
+		{"is_solid", bee::E_DATA_TYPE::CHAR},
+		{"data", bee::E_DATA_TYPE::MAP, bee::E_DATA_TYPE::SIDP}
+	});
+	REQUIRE(inner.get_hash() != outer.get_hash());
+
+	// Write a record in the schema order
+	bee::SerialData sd1 (64, true);
+	int id = 7;
+	std::string name = "obj_player";
+	double mass = 1.5;
+	std::vector<double> params = {2.25, -3.0};
+	unsigned char is_solid = 1;
+	std::map<std::string,bee::SIDP> data {
+		{"health", bee::SIDP(100)},
+		{"speed", bee::SIDP(2.5)},
+		{"weapon", bee::SIDP("sword", false)}
+	};
+	REQUIRE(outer.store_header(&sd1) == 0);
+	sd1.store_int(id);
+	sd1.store_string(name);
+	REQUIRE(inner.store_header(&sd1) == 0);
+	sd1.store_double(mass);
+	sd1.store_vector(params);
+	sd1.store_char(is_solid);
+	sd1.store_map(data);
+
+	// Read it back through the schema
+	bee::SerialData sd2 (sd1.get());
+	std::map<bee::SIDP,bee::SIDP> m;
+	REQUIRE(outer.store(&sd2, &m) == 0);
+	REQUIRE(SIDP_i(m[bee::SIDP("id", false)]) == 7);
+	REQUIRE(SIDP_s(m[bee::SIDP("name", false)]) == "obj_player");
+	std::map<bee::SIDP,bee::SIDP>& body = SIDP_m(m[bee::SIDP("body", false)]);
+	REQUIRE(SIDP_cd(body[bee::SIDP("params", false)], 1) == -3.0);
+
+	// The text format must produce the same record
+	const std::string text = outer.to_text(sd1.get(), true);
+	REQUIRE(text.empty() == false);
+	std::vector<Uint8> record;
+	REQUIRE(outer.from_text(text, &record) == 0);
+	REQUIRE(record == sd1.get());
+
+	// Records with a different layout are rejected
+	REQUIRE(inner.to_text(sd1.get(), false).empty());
+	bee::SerialData sd3 (sd1.get());
+	REQUIRE(inner.store(&sd3, &m) == 2);
+}
+TEST_CASE("serialschema/defaults") {
+	const bee::SerialSchema schema ("Defaults", {
+		{"id", bee::E_DATA_TYPE::INT},
+		{"position", bee::E_DATA_TYPE::VECTOR, bee::E_DATA_TYPE::DOUBLE}
+	});
+
+	// Missing fields are stored as their default values
+	std::vector<Uint8> record;
+	REQUIRE(schema.from_text("{id:3}", &record) == 0);
+
+	bee::SerialData sd (record);
+	int id = 0;
+	std::vector<double> position = {1.0};
+	REQUIRE(schema.store_header(&sd) == 0);
+	REQUIRE(sd.store_int(id) == 0);
+	REQUIRE(sd.store_vector(position) == 0);
+	REQUIRE(id == 3);
+	REQUIRE(position.empty());
+}
+
+TEST_SUITE_END();
+
+#endif // TESTS_DATA_SERIALSCHEMA
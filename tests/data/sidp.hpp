@@ -0,0 +1,69 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef TESTS_DATA_SIDP
+#define TESTS_DATA_SIDP 1
+
+#include "doctest.h" // Include the required unit testing library
+
+#include "../../bee/data/sidp.hpp"
+
+TEST_SUITE_BEGIN("data");
+
+TEST_CASE("sidp/strings") {
+	REQUIRE(sizeof(bee::SIDP) <= 24);
+
+	const std::string long_str = "a string which is too long to be stored inline";
+	bee::SIDP a ("short", false);
+	bee::SIDP b (long_str, false);
+	REQUIRE(SIDP_s(a) == "short");
+	REQUIRE(SIDP_s(b) == long_str);
+
+	bee::SIDP c (b);
+	REQUIRE(SIDP_s(c) == long_str);
+	c += a;
+	REQUIRE(SIDP_s(c) == long_str + "short");
+	REQUIRE(SIDP_s(b) == long_str);
+
+	a = b;
+	REQUIRE(SIDP_s(a) == long_str);
+	b = "tiny";
+	REQUIRE(SIDP_s(b) == "tiny");
+	REQUIRE(SIDP_s(bee::SIDP("\"\"")).empty());
+	REQUIRE(SIDP_s(bee::SIDP("")).empty());
+
+	REQUIRE(bee::SIDP("abc", false) < bee::SIDP("abd", false));
+	REQUIRE(bee::SIDP("ab", false) < bee::SIDP("abc", false));
+	REQUIRE((bee::SIDP("abc", false) < bee::SIDP("ab", false)) == false);
+}
+TEST_CASE("sidp/move") {
+	const std::string long_str = "another string which is too long to be stored inline";
+	bee::SIDP a (long_str, false);
+	bee::SIDP b (std::move(a));
+	REQUIRE(SIDP_s(b) == long_str);
+	REQUIRE(a.get_type() == -1);
+
+	bee::SIDP v ("[1,2,3]");
+	std::vector<bee::SIDP>* p = &SIDP_v(v);
+	bee::SIDP w;
+	w = std::move(v);
+	REQUIRE(&SIDP_v(w) == p);
+	REQUIRE(SIDP_i(SIDP_v(w)[2]) == 3);
+	REQUIRE(v.get_type() == -1);
+
+	std::vector<bee::SIDP> vec;
+	for (int i=0; i<100; ++i) { // Growing the vector moves the elements
+		vec.emplace_back(long_str + std::to_string(i), false);
+	}
+	REQUIRE(SIDP_s(vec[0]) == long_str + "0");
+	REQUIRE(SIDP_s(vec[99]) == long_str + "99");
+}
+
+TEST_SUITE_END();
+
+#endif // TESTS_DATA_SIDP
@@ -0,0 +1,64 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef TESTS_DATA_SPATIALGRID
+#define TESTS_DATA_SPATIALGRID 1
+
+#include "doctest.h" // Include the required unit testing library
+
+#include "../../bee/data/spatialgrid.hpp"
+
+TEST_SUITE_BEGIN("data");
+
+TEST_CASE("spatialgrid/query") {
+	bee::SpatialGrid grid (32);
+	grid.update(0, {0, 0, 10, 10});
+	grid.update(1, {100, 100, 10, 10});
+	grid.update(2, {-40, -40, 80, 80}); // Spans multiple cells including negative ones
+
+	std::vector<int> ids;
+	REQUIRE(grid.query({5, 5, 1, 1}, ids) == 2);
+	REQUIRE(ids == std::vector<int>({0, 2}));
+
+	REQUIRE(grid.query({105, 105, 1, 1}, ids) == 1);
+	REQUIRE(ids.front() == 1);
+
+	REQUIRE(grid.query({-35, -35, 1, 1}, ids) == 1);
+	REQUIRE(ids.front() == 2);
+
+	REQUIRE(grid.query({500, 500, 10, 10}, ids) == 0);
+}
+TEST_CASE("spatialgrid/update") {
+	bee::SpatialGrid grid (32);
+	std::vector<int> ids;
+
+	grid.update(0, {0, 0, 10, 10});
+	grid.update(0, {200, 200, 10, 10});
+	REQUIRE(grid.get_amount() == 1);
+	REQUIRE(grid.query({5, 5, 1, 1}, ids) == 0);
+	REQUIRE(grid.query({205, 205, 1, 1}, ids) == 1);
+
+	REQUIRE(grid.set_cell_size(128) == 0);
+	REQUIRE(grid.query({205, 205, 1, 1}, ids) == 1);
+
+	REQUIRE(grid.remove(0) == 0);
+	REQUIRE(grid.remove(0) == 1);
+	REQUIRE(grid.has(0) == false);
+	REQUIRE(grid.query({205, 205, 1, 1}, ids) == 0);
+}
+TEST_CASE("spatialgrid/edges") {
+	bee::SpatialGrid grid (32);
+	std::vector<int> ids;
+
+	grid.update(0, {0, 0, 32, 32}); // The right and bottom edges touch the next cells
+	REQUIRE(grid.query({32, 32, 0, 0}, ids) == 1);
+}
+
+TEST_SUITE_END();
+
+#endif // TESTS_DATA_SPATIALGRID
@@ -0,0 +1,73 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef TESTS_DATA_SPSCQUEUE
+#define TESTS_DATA_SPSCQUEUE 1
+
+#include <thread>
+#include <memory>
+
+#include "doctest.h" // Include the required unit testing library
+
+#include "../../bee/data/spscqueue.hpp"
+
+TEST_SUITE_BEGIN("data");
+
+TEST_CASE("spscqueue/basic") {
+	bee::SPSCQueue<int> q (3);
+	REQUIRE(q.get_capacity() == 4);
+	REQUIRE(q.get_is_empty());
+
+	int v = 0;
+	REQUIRE(q.pop(&v) == false);
+
+	for (int i=0; i<4; ++i) {
+		REQUIRE(q.push(std::move(i)));
+	}
+	REQUIRE(q.push(5) == false);
+
+	REQUIRE(q.pop(&v));
+	REQUIRE(v == 0);
+	REQUIRE(q.push(4));
+	for (int i=1; i<5; ++i) {
+		REQUIRE(q.pop(&v));
+		REQUIRE(v == i);
+	}
+	REQUIRE(q.get_is_empty());
+}
+TEST_CASE("spscqueue/threads") {
+	bee::SPSCQueue<std::unique_ptr<int>> q (64);
+	const int amount = 100000;
+
+	std::thread producer ([&q, amount] () {
+		for (int i=0; i<amount; ) {
+			if (q.push(std::unique_ptr<int>(new int(i)))) {
+				++i;
+			}
+		}
+	});
+
+	bool is_ordered = true;
+	std::unique_ptr<int> p;
+	for (int i=0; i<amount; ) {
+		if (q.pop(&p)) {
+			if (*p != i) {
+				is_ordered = false;
+			}
+			++i;
+		}
+	}
+	producer.join();
+
+	REQUIRE(is_ordered);
+	REQUIRE(q.get_is_empty());
+}
+
+TEST_SUITE_END();
+
+#endif // TESTS_DATA_SPSCQUEUE
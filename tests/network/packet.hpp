@@ -0,0 +1,125 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef TESTS_NETWORK_PACKET
+#define TESTS_NETWORK_PACKET 1
+
+#include <algorithm>
+
+#include "doctest.h" // Include the required unit testing library
+
+#include "../../bee/defines.hpp"
+
+#include "../../bee/util/real.hpp"
+
+#include "../../bee/network/packet.hpp"
+
+TEST_SUITE_BEGIN("network");
+
+TEST_CASE("packet/fragments") {
+	std::vector<Uint8> payload (100000);
+	for (size_t i=0; i<payload.size(); ++i) {
+		payload[i] = static_cast<Uint8>(i*7 + 3);
+	}
+
+	bee::NetworkPacket src (3, bee::E_NETSIG1::SERVER_INFO, bee::E_NETSIG2::KEYFRAME, payload);
+	REQUIRE(src.get_size() > bee::NetworkPacket::MAX_SIZE);
+
+	size_t amount = src.prepare_net();
+	REQUIRE(amount > 8);
+
+	std::vector<std::vector<Uint8>> fragments;
+	for (size_t i=0; i<amount; ++i) {
+		std::vector<Uint8> f (bee::NetworkPacket::MAX_SIZE);
+		UDPpacket u;
+		u.data = f.data();
+		u.len = 0;
+		REQUIRE(src.write_net(&u, i) == 0);
+		REQUIRE(u.len <= static_cast<int>(bee::NetworkPacket::MAX_SIZE));
+		REQUIRE(bee::NetworkPacketView(&u).get_is_valid());
+
+		f.resize(u.len);
+		fragments.push_back(f);
+	}
+	REQUIRE(src.write_net(nullptr, amount) == 1);
+
+	// Deliver the fragments out of order with a duplicate
+	std::reverse(fragments.begin(), fragments.end());
+	fragments.push_back(fragments[0]);
+
+	std::unique_ptr<bee::NetworkPacket> dst;
+	for (auto& f : fragments) {
+		UDPpacket u;
+		u.data = f.data();
+		u.len = f.size();
+		if (dst == nullptr) {
+			dst = std::make_unique<bee::NetworkPacket>(&u);
+		} else {
+			REQUIRE(dst->append_net(&u) == 0);
+		}
+	}
+
+	REQUIRE(dst->get_is_sequence_complete());
+	REQUIRE(dst->get_packet_id() == src.get_packet_id());
+	REQUIRE(dst->id == 3);
+	REQUIRE(dst->get_signal2() == bee::E_NETSIG2::KEYFRAME);
+	REQUIRE(dst->get_raw() == payload);
+}
+
+TEST_CASE("packet/malformed") {
+	bee::NetworkPacket src (3, bee::E_NETSIG1::SERVER_INFO, bee::E_NETSIG2::KEYFRAME, std::vector<Uint8>(10));
+	REQUIRE(src.prepare_net() == 1);
+
+	std::vector<Uint8> f (bee::NetworkPacket::MAX_SIZE);
+	UDPpacket u;
+	u.data = f.data();
+	u.len = 0;
+	REQUIRE(src.write_net(&u, 0) == 0);
+
+	// Truncate the datagram before the length field
+	u.len = 5;
+	REQUIRE(bee::NetworkPacketView(&u).get_is_valid() == false);
+	bee::NetworkPacket truncated (&u);
+	REQUIRE(truncated.get_signal1() == bee::E_NETSIG1::INVALID);
+	REQUIRE(truncated.get_is_sequence_complete() == false);
+
+	// Corrupt the payload so that the checksum fails
+	u.len = static_cast<int>(bee::NetworkPacket::META_SIZE + 10);
+	f[bee::NetworkPacket::META_SIZE] ^= 0xff;
+	bee::NetworkPacket corrupted (&u);
+	REQUIRE(corrupted.get_signal1() == bee::E_NETSIG1::INVALID);
+}
+
+TEST_CASE("packet/limits") {
+	bee::NetworkPacket src (3, bee::E_NETSIG1::SERVER_INFO, bee::E_NETSIG2::KEYFRAME, std::vector<Uint8>(10));
+	REQUIRE(src.prepare_net() == 1);
+
+	std::vector<Uint8> f (bee::NetworkPacket::MAX_SIZE);
+	UDPpacket u;
+	u.data = f.data();
+	u.len = 0;
+	REQUIRE(src.write_net(&u, 0) == 0);
+
+	// Claim the last fragment of an oversized packet and fix the checksum so that only the amount is wrong
+	f[8] = 0xff; f[9] = 0xfe;
+	f[10] = 0xff; f[11] = 0xff;
+	Uint32 checksum = get_checksum(f.data()+4, u.len-4);
+	f[0] = checksum >> 24; f[1] = checksum >> 16; f[2] = checksum >> 8; f[3] = checksum;
+	REQUIRE(bee::NetworkPacketView(&u).get_is_valid());
+
+	bee::NetworkPacket oversized (&u);
+	REQUIRE(oversized.get_signal1() == bee::E_NETSIG1::INVALID);
+	REQUIRE(oversized.get_raw().empty());
+
+	bee::NetworkPacket large (3, bee::E_NETSIG1::SERVER_INFO, bee::E_NETSIG2::KEYFRAME, std::vector<Uint8>((BEE_NET_MAX_FRAGMENTS+1)*bee::NetworkPacket::FRAGMENT_SIZE));
+	REQUIRE(large.prepare_net() == 0);
+}
+
+TEST_SUITE_END();
+
+#endif // TESTS_NETWORK_PACKET
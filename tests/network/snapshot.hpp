@@ -0,0 +1,79 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef TESTS_NETWORK_SNAPSHOT
+#define TESTS_NETWORK_SNAPSHOT 1
+
+#include "doctest.h" // Include the required unit testing library
+
+#include "../../bee/network/snapshot.hpp"
+
+TEST_SUITE_BEGIN("network");
+
+TEST_CASE("snapshot/keyframe") {
+	bee::NetworkSnapshot s;
+	s.sequence = 65535;
+	s.instances["inst_1"].sprite = "spr_bee";
+	s.instances["inst_1"].subimage_time = 123456;
+	s.instances["inst_1"].mass = 1.5;
+	s.instances["inst_1"].values[0] = -4096;
+	s.instances["inst_1"].values[14] = 1 << 30;
+	s.instances["player_2"].friction = 0.25;
+
+	bee::NetworkSnapshot k;
+	REQUIRE(k.deserialize_keyframe(s.serialize_keyframe()) == 0);
+	REQUIRE(k.sequence == 65535);
+	REQUIRE(k.instances.size() == 2);
+	REQUIRE(k.instances["inst_1"].get_changes(s.instances["inst_1"]) == 0);
+	REQUIRE(k.instances["player_2"].get_changes(s.instances["player_2"]) == 0);
+
+	std::vector<Uint8> data = s.serialize_keyframe();
+	data.pop_back();
+	REQUIRE(k.deserialize_keyframe(data) == 2);
+}
+TEST_CASE("snapshot/delta") {
+	std::map<Uint16,bee::NetworkSnapshot> history;
+	bee::NetworkSnapshot& base = history[10];
+	base.sequence = 10;
+	base.instances["inst_1"].sprite = "spr_bee";
+	base.instances["inst_1"].values[0] = 640;
+	base.instances["inst_2"].values[1] = 320;
+	base.instances["inst_3"].sprite = "spr_removed";
+
+	bee::NetworkSnapshot s = base;
+	s.sequence = 12;
+	s.instances["inst_1"].values[0] = 641; // Moved
+	s.instances.erase("inst_3"); // Removed
+	s.instances["inst_4"].sprite = "spr_new"; // Added
+
+	REQUIRE(s.instances["inst_1"].get_changes(base.instances["inst_1"]) == 0x08);
+	REQUIRE(s.instances["inst_2"].get_changes(base.instances["inst_2"]) == 0);
+
+	const std::vector<Uint8> delta = s.serialize_delta(base);
+	REQUIRE(delta.size() < s.serialize_keyframe().size());
+
+	bee::NetworkSnapshot d;
+	REQUIRE(d.deserialize_delta(history, delta) == 0);
+	REQUIRE(d.sequence == 12);
+	REQUIRE(d.instances.size() == 3);
+	REQUIRE(d.instances["inst_1"].values[0] == 641);
+	REQUIRE(d.instances["inst_1"].sprite == "spr_bee");
+	REQUIRE(d.instances["inst_2"].values[1] == 320);
+	REQUIRE(d.instances["inst_4"].sprite == "spr_new");
+	REQUIRE(d.instances.find("inst_3") == d.instances.end());
+
+	history.clear();
+	REQUIRE(d.deserialize_delta(history, delta) == 2);
+
+	REQUIRE(bee::NetworkSnapshot::get_is_newer(1, 65535));
+	REQUIRE(bee::NetworkSnapshot::get_is_newer(65535, 1) == false);
+}
+
+TEST_SUITE_END();
+
+#endif // TESTS_NETWORK_SNAPSHOT
@@ -0,0 +1,192 @@
+/*
+* Copyright (c) 2015-17 Luke Montalvo <lukemontalvo@gmail.com>
+*
+* This file is part of BEE.
+* BEE is free software and comes with ABSOLUTELY NO WARANTY.
+* See LICENSE for more details.
+*/
+
+#ifndef TESTS_RESOURCE_INSTANCELIST
+#define TESTS_RESOURCE_INSTANCELIST 1
+
+#include <vector>
+
+#include "doctest.h" // Include the required unit testing library
+
+#include "../../bee/core/instance.hpp"
+
+#include "../../bee/resource/object.hpp"
+#include "../../bee/resource/room.hpp"
+
+namespace tests {
+	class InstanceListObject : public bee::Object { // A minimal object which isn't added to the resource list
+		public:
+			void create(bee::Instance*) {}
+	};
+
+	/*
+	* instancelist_init() - Set the id, depth, and object of the given instance without a room
+	*/
+	void instancelist_init(bee::Instance* inst, int id, int depth, bee::Object* object) {
+		inst->id = id;
+		inst->depth = depth;
+		inst->set_object(object);
+	}
+	/*
+	* instancelist_ids() - Return the ids of the given sorted list, or -1 for removed instances
+	*/
+	std::vector<int> instancelist_ids(const std::vector<bee::SortedInstance>& sorted) {
+		std::vector<int> ids;
+		for (auto& s : sorted) {
+			ids.push_back((s.inst != nullptr) ? s.inst->id : -1);
+		}
+		return ids;
+	}
+}
+
+TEST_SUITE_BEGIN("resource");
+
+TEST_CASE("instancelist/sort") {
+	tests::InstanceListObject obj;
+	bee::Instance insts[5];
+	const int depths[] = {0, 10, 0, -5, 10};
+	for (int i=0; i<5; ++i) {
+		tests::instancelist_init(&insts[i], i, depths[i], &obj);
+	}
+
+	bee::InstanceList list;
+	for (int i=4; i>=0; --i) {
+		list.add(&insts[i]);
+	}
+	REQUIRE(list.size() == 5);
+
+	// Higher depths come first, then lower ids
+	REQUIRE(tests::instancelist_ids(list.get()) == std::vector<int>({1, 4, 0, 2, 3}));
+
+	// Depth changes only take effect when a resort is requested
+	insts[3].depth = 20;
+	REQUIRE(tests::instancelist_ids(list.get()) == std::vector<int>({1, 4, 0, 2, 3}));
+	list.request_sort();
+	REQUIRE(tests::instancelist_ids(list.get()) == std::vector<int>({3, 1, 4, 0, 2}));
+
+	list.clear();
+	REQUIRE(list.size() == 0);
+	REQUIRE(list.get().empty());
+}
+TEST_CASE("instancelist/remove") {
+	tests::InstanceListObject obj;
+	bee::Instance insts[4];
+	for (int i=0; i<4; ++i) {
+		tests::instancelist_init(&insts[i], i, 0, &obj);
+	}
+
+	bee::InstanceList list;
+	for (auto& inst : insts) {
+		list.add(&inst);
+	}
+
+	// Remove instances while iterating, which should leave the iterated list in place
+	const std::vector<bee::SortedInstance>& sorted = list.get();
+	for (auto& s : sorted) {
+		if ((s.inst != nullptr)&&(s.inst->id % 2 == 0)) {
+			REQUIRE(list.remove(s.inst) == 0);
+		}
+	}
+	REQUIRE(sorted.size() == 4);
+	REQUIRE(tests::instancelist_ids(sorted) == std::vector<int>({-1, 1, -1, 3}));
+	REQUIRE(list.size() == 2);
+
+	// The removed instances are compacted on the next access
+	REQUIRE(tests::instancelist_ids(list.get()) == std::vector<int>({1, 3}));
+
+	REQUIRE(list.remove(&insts[0]) == 1);
+
+	// A pending instance can be removed before it's merged
+	list.add(&insts[2]);
+	REQUIRE(list.remove(&insts[2]) == 0);
+	REQUIRE(tests::instancelist_ids(list.get()) == std::vector<int>({1, 3}));
+
+	// Removal still works after the depth has changed without a resort
+	insts[3].depth = 100;
+	REQUIRE(list.remove(&insts[3]) == 0);
+	REQUIRE(tests::instancelist_ids(list.get()) == std::vector<int>({1}));
+}
+TEST_CASE("instancelist/pending") {
+	tests::InstanceListObject obj;
+	bee::Instance insts[6];
+	const int depths[] = {5, 0, -5, 5, 0, -5};
+	for (int i=0; i<6; ++i) {
+		tests::instancelist_init(&insts[i], i, depths[i], &obj);
+	}
+
+	bee::InstanceList list;
+	for (int i=0; i<3; ++i) {
+		list.add(&insts[i]);
+	}
+	REQUIRE(tests::instancelist_ids(list.get()) == std::vector<int>({0, 1, 2}));
+
+	// Instances added after the sort are merged into their place, not appended
+	list.add(&insts[5]);
+	list.add(&insts[3]);
+	list.add(&insts[4]);
+	REQUIRE(list.size() == 6);
+	REQUIRE(tests::instancelist_ids(list.get()) == std::vector<int>({0, 3, 1, 4, 2, 5}));
+
+	// Merging and compacting at the same time
+	list.remove(&insts[1]);
+	list.add(&insts[1]);
+	REQUIRE(tests::instancelist_ids(list.get()) == std::vector<int>({0, 3, 1, 4, 2, 5}));
+}
+TEST_CASE("instancelist/groups") {
+	tests::InstanceListObject obj_single, obj_batched, obj_reentrant;
+	obj_batched.set_is_batched(true);
+	obj_reentrant.set_is_step_reentrant(true);
+
+	bee::Instance insts[6];
+	tests::instancelist_init(&insts[0], 0, 10, &obj_single);
+	tests::instancelist_init(&insts[1], 1, 10, &obj_batched);
+	tests::instancelist_init(&insts[2], 2, 5, &obj_single);
+	tests::instancelist_init(&insts[3], 3, 5, &obj_batched);
+	tests::instancelist_init(&insts[4], 4, 0, &obj_reentrant);
+	tests::instancelist_init(&insts[5], 5, 0, &obj_reentrant);
+
+	bee::InstanceList list;
+	for (auto& inst : insts) {
+		list.add(&inst);
+	}
+
+	// Unbatched instances get their own group and batched objects get one group at their first instance
+	const std::vector<bee::InstanceGroup>& groups = list.get_groups();
+	REQUIRE(groups.size() == 4);
+	REQUIRE(groups[0].object == nullptr);
+	REQUIRE(groups[0].index == 0);
+	REQUIRE(groups[1].object == &obj_batched);
+	REQUIRE(groups[1].indices == std::vector<size_t>({1, 3}));
+	REQUIRE(groups[2].object == nullptr);
+	REQUIRE(groups[2].index == 2);
+	REQUIRE(groups[3].object == &obj_reentrant);
+	REQUIRE(groups[3].indices == std::vector<size_t>({4, 5}));
+
+	// Removing and adding instances rebuilds the groups
+	list.remove(&insts[1]);
+	bee::Instance extra;
+	tests::instancelist_init(&extra, 6, 7, &obj_batched);
+	list.add(&extra);
+
+	const std::vector<bee::InstanceGroup>& regrouped = list.get_groups();
+	REQUIRE(tests::instancelist_ids(list.get()) == std::vector<int>({0, 6, 2, 3, 4, 5}));
+	REQUIRE(regrouped.size() == 4);
+	REQUIRE(regrouped[0].index == 0);
+	REQUIRE(regrouped[1].object == &obj_batched);
+	REQUIRE(regrouped[1].indices == std::vector<size_t>({1, 3}));
+	REQUIRE(regrouped[2].index == 2);
+	REQUIRE(regrouped[3].indices == std::vector<size_t>({4, 5}));
+
+	// Removing a batched instance removes it from its group
+	list.remove(&insts[3]);
+	REQUIRE(list.get_groups()[1].indices == std::vector<size_t>({1}));
+}
+
+TEST_SUITE_END();
+
+#endif // TESTS_RESOURCE_INSTANCELIST
@@ -9,10 +9,14 @@
 #ifndef TESTS_UTIL_REAL
 #define TESTS_UTIL_REAL 1
 
+#include <chrono>
+
 #include "doctest.h" // Include the required unit testing library
 
 #include "../../bee/util/real.hpp"
 
+#include "../../bee/messenger/messenger.hpp"
+
 TEST_SUITE_BEGIN("util");
 
 TEST_CASE("real/random") {
@@ -99,19 +103,83 @@ TEST_CASE("real/checksum") {
 	REQUIRE(checksum_internal_table(0) == 0);
 	REQUIRE(checksum_internal_table(2) == 3993919788);
 	REQUIRE(checksum_internal_reflect(0, 8) == 0);
-	REQUIRE(checksum_internal_reflect(2, 8) == 128);
+	REQUIRE(checksum_internal_reflect(2, 8) == 64);
 	REQUIRE(checksum_internal_reflect(0, 32) == 0);
-	REQUIRE(checksum_internal_reflect(2, 32) == 2147483648);
+	REQUIRE(checksum_internal_reflect(2, 32) == 1073741824);
 
 	std::vector<unsigned char> v1 = {65, 66, 67};
 	unsigned int crc1 = get_checksum(v1);
-	REQUIRE(crc1 == 1625830473);
+	REQUIRE(crc1 == 2743272264);
 	REQUIRE(verify_checksum(v1, crc1) == true);
 
 	std::vector<unsigned char> v2 = {120, 121, 122};
 	unsigned int crc2 = get_checksum(v2);
-	REQUIRE(crc2 == 1178330758);
+	REQUIRE(crc2 == 3951999591);
 	REQUIRE(verify_checksum(v2, crc2) == true);
+
+	std::vector<unsigned char> v3 = {255, 255, 49, 50, 51, 52, 53, 54, 55, 56, 57};
+	REQUIRE(get_checksum(v3, 2) == 0xCBF43926);
+	REQUIRE(verify_checksum(v3, 2, 0xCBF43926) == true);
+	v3[10] ^= 1;
+	REQUIRE(verify_checksum(v3, 2, 0xCBF43926) == false);
+
+	// Every path should agree for all lengths and alignments
+	std::vector<unsigned char> v4 (1024);
+	for (size_t i=0; i<v4.size(); ++i) {
+		v4[i] = static_cast<unsigned char>(i*31 + 7);
+	}
+	for (size_t size=0; size<300; ++size) {
+		for (size_t offset=0; offset<3; ++offset) {
+			unsigned int crc = 0xffffffff;
+			for (size_t i=0; i<size; ++i) {
+				crc = (crc >> 8) ^ checksum_internal_table((crc & 0xff) ^ v4[offset+i]);
+			}
+
+			REQUIRE(checksum_internal_slice8(0xffffffff, v4.data()+offset, size) == crc);
+			REQUIRE(checksum_internal_clmul(0xffffffff, v4.data()+offset, size) == crc);
+		}
+	}
+}
+TEST_CASE("real/checksum_benchmark" * doctest::skip()) {
+	std::vector<unsigned char> data (1 << 20);
+	for (size_t i=0; i<data.size(); ++i) {
+		data[i] = static_cast<unsigned char>(random(256));
+	}
+
+	const int iterations = 64;
+	unsigned int crc[3] = {0xffffffff, 0xffffffff, 0xffffffff};
+	double times[3];
+
+	auto t0 = std::chrono::steady_clock::now();
+	for (int i=0; i<iterations; ++i) {
+		for (auto& d : data) {
+			crc[0] = (crc[0] >> 8) ^ checksum_internal_table((crc[0] & 0xff) ^ d);
+		}
+	}
+	auto t1 = std::chrono::steady_clock::now();
+	for (int i=0; i<iterations; ++i) {
+		crc[1] = checksum_internal_slice8(crc[1], data.data(), data.size());
+	}
+	auto t2 = std::chrono::steady_clock::now();
+	for (int i=0; i<iterations; ++i) {
+		crc[2] = checksum_internal_clmul(crc[2], data.data(), data.size());
+	}
+	auto t3 = std::chrono::steady_clock::now();
+
+	times[0] = std::chrono::duration<double>(t1-t0).count();
+	times[1] = std::chrono::duration<double>(t2-t1).count();
+	times[2] = std::chrono::duration<double>(t3-t2).count();
+
+	REQUIRE(crc[1] == crc[0]);
+	REQUIRE(crc[2] == crc[0]);
+
+	const double mb = iterations * data.size() / 1048576.0;
+	bee::messenger::send({"tests"}, bee::E_MESSAGE::INFO,
+		"Checksum throughput (MB/s):"
+		"\n\tbytewise\t" + std::to_string(mb / times[0]) +
+		"\n\tslicing-by-8\t" + std::to_string(mb / times[1]) +
+		"\n\tclmul\t" + std::to_string(mb / times[2]) + ((checksum_internal_has_clmul()) ? "" : " (unsupported, uses slicing-by-8)")
+	);
 }
 
 TEST_SUITE_END();